@@ -0,0 +1,153 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+// 引擎性能测试的命令行入口：不创建窗口，只注册测试所需的子系统
+
+#include <Urho3D/Audio/Audio.h>
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+#ifdef URHO3D_NETWORK
+#include <Urho3D/Network/QuantizedReplication.h>
+#endif
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <Urho3D/DebugNew.h>
+
+using namespace Urho3D;
+
+int main(int argc, char** argv);
+void Run(const Vector<String>& arguments);
+void RunReplication(Context* context, const Vector<String>& arguments);
+void RunAudioMix(Context* context, const Vector<String>& arguments);
+
+int main(int argc, char** argv)
+{
+    Vector<String> arguments;
+
+#ifdef WIN32
+    arguments = ParseArguments(GetCommandLineW());
+#else
+    arguments = ParseArguments(argc, argv);
+#endif
+
+    Run(arguments);
+    return 0;
+}
+
+void Run(const Vector<String>& arguments)
+{
+    if (arguments.Empty())
+    {
+        ErrorExit(
+            "Usage: EngineBenchmark <benchmark> [arguments]\n"
+            "\n"
+            "Benchmarks:\n"
+            "replication [clients] [nodes] [ticks] [packet loss] [-2d]\n"
+            "  Loopback replication of moving nodes, default vs. quantized mode.\n"
+            "  Defaults: 40 clients, 500 nodes, 300 ticks, no packet loss.\n"
+            "audio [sources] [seconds]\n"
+            "  Offline software mixing of looping sound sources.\n"
+            "  Defaults: 128 sources, 2 seconds. Set SDL_AUDIO_DRIVER=dummy on\n"
+            "  machines without an audio device.\n"
+        );
+    }
+
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem(new FileSystem(context));
+#ifdef URHO3D_LOGGING
+    context->RegisterSubsystem(new Log(context));
+#endif
+    context->RegisterSubsystem(new ResourceCache(context));
+    context->RegisterSubsystem(new WorkQueue(context));
+    context->RegisterSubsystem(new Audio(context));
+    RegisterSceneLibrary(context);
+    RegisterAudioLibrary(context);
+
+    const String& benchmark = arguments[0];
+    if (benchmark == "replication")
+        RunReplication(context, arguments);
+    else if (benchmark == "audio")
+        RunAudioMix(context, arguments);
+    else
+        ErrorExit("Unknown benchmark " + benchmark);
+}
+
+void RunReplication(Context* context, const Vector<String>& arguments)
+{
+#ifdef URHO3D_NETWORK
+    unsigned numClients = 40;
+    unsigned numNodes = 500;
+    unsigned numTicks = 300;
+    float packetLoss = 0.0f;
+    TransformQuantization settings;
+
+    unsigned position = 0;
+    for (i32 i = 1; i < arguments.Size(); ++i)
+    {
+        if (arguments[i] == "-2d")
+        {
+            settings.twoDimensional_ = true;
+            continue;
+        }
+
+        switch (position++)
+        {
+        case 0:
+            numClients = ToU32(arguments[i]);
+            break;
+
+        case 1:
+            numNodes = ToU32(arguments[i]);
+            break;
+
+        case 2:
+            numTicks = ToU32(arguments[i]);
+            break;
+
+        case 3:
+            packetLoss = ToFloat(arguments[i]);
+            break;
+
+        default:
+            ErrorExit("Unexpected argument " + arguments[i]);
+        }
+    }
+
+    ReplicationBenchmarkResult result = RunReplicationBenchmark(context, numClients, numNodes, numTicks, packetLoss, settings);
+
+    PrintLine(ToString("Replication of %u nodes to %u clients, %u ticks, averaged per tick:", numNodes, numClients, numTicks));
+    PrintLine(ToString("  default:   %.0f bytes, %.1f us server", result.defaultBytes_, result.defaultUSec_));
+    PrintLine(ToString("  quantized: %.0f bytes, %.1f us server, %.1f us client", result.quantizedBytes_, result.quantizedUSec_,
+        result.quantizedClientUSec_));
+    PrintLine(ToString("  max position error %f", result.maxPositionError_));
+#else
+    ErrorExit("The replication benchmark requires URHO3D_NETWORK");
+#endif
+}
+
+void RunAudioMix(Context* context, const Vector<String>& arguments)
+{
+    if (arguments.Size() > 3)
+        ErrorExit("Unexpected argument " + arguments[3]);
+
+    unsigned numSources = arguments.Size() > 1 ? ToU32(arguments[1]) : 128;
+    float seconds = arguments.Size() > 2 ? ToFloat(arguments[2]) : 2.0f;
+
+    AudioMixBenchmarkResult result = RunAudioMixBenchmark(context, numSources, seconds);
+    if (!result.numSources_)
+        ErrorExit("Could not run the audio mix benchmark");
+
+    PrintLine(ToString("Mixing %u sources:", result.numSources_));
+    PrintLine(ToString("  %.1f us per second of output without sources", result.baseUSec_));
+    PrintLine(ToString("  %.2f us per source per second of output", result.perSourceUSec_));
+    PrintLine(ToString("  %.2f%% of real time", result.load_ * 100.0f));
+}
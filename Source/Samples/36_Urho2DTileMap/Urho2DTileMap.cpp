@@ -183,23 +183,22 @@ void Urho2DTileMap::HandleMouseButtonDown(StringHash eventType, VariantMap& even
     int x, y;
     if (map->PositionToTileIndex(x, y, pos))
     {
-        // Get tile's sprite. Note that layer.GetTile(x, y).sprite is read-only, so we get the sprite through tile's node
-        Node* n = layer->GetTileNode(x, y);
-        if (!n)
+        // Tiles are edited through their gids. Only the chunk containing the tile is rebuilt
+        unsigned gid = layer->GetTileGid(x, y);
+        if (!gid)
             return;
-        auto* sprite = n->GetComponent<StaticSprite2D>();
 
         if (input->GetMouseButtonDown(MOUSEB_RIGHT))
         {
             // Swap grass and water
-            if (layer->GetTile(x, y)->GetGid() < 9) // First 8 sprites in the "isometric_grass_and_water.png" tileset are mostly grass and from 9 to 24 they are mostly water
-                sprite->SetSprite(layer->GetTile(0, 0)->GetSprite()); // Replace grass by water sprite used in top tile
+            if ((gid & ~FLIP_ALL) < 9) // First 8 sprites in the "isometric_grass_and_water.png" tileset are mostly grass and from 9 to 24 they are mostly water
+                layer->SetTileGid(x, y, layer->GetTileGid(0, 0)); // Replace grass by water sprite used in top tile
             else
-                sprite->SetSprite(layer->GetTile(24, 24)->GetSprite()); // Replace water by grass sprite used in bottom tile
+                layer->SetTileGid(x, y, layer->GetTileGid(24, 24)); // Replace water by grass sprite used in bottom tile
         }
         else
         {
-            sprite->SetSprite(nullptr); // 'Remove' sprite
+            layer->SetTileGid(x, y, 0); // Remove tile
         }
     }
 }
@@ -167,19 +167,19 @@ void Urho2DPlatformer::SubscribeToEvents()
     SubscribeToEvent(E_POSTRENDERUPDATE, URHO3D_HANDLER(Urho2DPlatformer, HandlePostRenderUpdate));
 
     // Subscribe to Box2D contact listeners
-    SubscribeToEvent(E_PHYSICSBEGINCONTACT2D, URHO3D_HANDLER(Urho2DPlatformer, HandleCollisionBegin));
-    SubscribeToEvent(E_PHYSICSENDCONTACT2D, URHO3D_HANDLER(Urho2DPlatformer, HandleCollisionEnd));
+    SubscribeToEvent(E_PHYSICSBEGINCONTACT2D, URHO3D_TYPED_HANDLER(Urho2DPlatformer, HandleCollisionBegin));
+    SubscribeToEvent(E_PHYSICSENDCONTACT2D, URHO3D_TYPED_HANDLER(Urho2DPlatformer, HandleCollisionEnd));
 
     // Unsubscribe the SceneUpdate event from base class to prevent camera pitch and yaw in 2D sample
     UnsubscribeFromEvent(E_SCENEUPDATE);
 }
 
-void Urho2DPlatformer::HandleCollisionBegin(StringHash eventType, VariantMap& eventData)
+void Urho2DPlatformer::HandleCollisionBegin(StringHash eventType, const PhysicsContact2DPayload& contact)
 {
     // Get colliding node
-    auto* hitNode = static_cast<Node*>(eventData[PhysicsBeginContact2D::P_NODEA].GetPtr());
+    Node* hitNode = contact.nodeA_;
     if (hitNode->GetName() == "Imp")
-        hitNode = static_cast<Node*>(eventData[PhysicsBeginContact2D::P_NODEB].GetPtr());
+        hitNode = contact.nodeB_;
     String nodeName = hitNode->GetName();
     Node* character2DNode = scene_->GetChild("Imp", true);
 
@@ -284,12 +284,12 @@ void Urho2DPlatformer::HandleCollisionBegin(StringHash eventType, VariantMap& ev
         character2D_->onSlope_ = true;
 }
 
-void Urho2DPlatformer::HandleCollisionEnd(StringHash eventType, VariantMap& eventData)
+void Urho2DPlatformer::HandleCollisionEnd(StringHash eventType, const PhysicsContact2DPayload& contact)
 {
     // Get colliding node
-    auto* hitNode = static_cast<Node*>(eventData[PhysicsEndContact2D::P_NODEA].GetPtr());
+    Node* hitNode = contact.nodeA_;
     if (hitNode->GetName() == "Imp")
-        hitNode = static_cast<Node*>(eventData[PhysicsEndContact2D::P_NODEB].GetPtr());
+        hitNode = contact.nodeB_;
     String nodeName = hitNode->GetName();
     Node* character2DNode = scene_->GetChild("Imp", true);
 
@@ -6,6 +6,8 @@
 #include "Sample.h"
 #include "Utilities2D/Sample2D.h"
 
+#include <Urho3D/Physics2D/PhysicsEvents2D.h>
+
 class Character2D;
 class Sample2D;
 
@@ -46,9 +48,9 @@ private:
     /// Handle the end rendering event.
     void HandleSceneRendered(StringHash eventType, VariantMap& eventData);
     /// Handle the contact begin event (Box2D contact listener).
-    void HandleCollisionBegin(StringHash eventType, VariantMap& eventData);
+    void HandleCollisionBegin(StringHash eventType, const PhysicsContact2DPayload& contact);
     /// Handle the contact end event (Box2D contact listener).
-    void HandleCollisionEnd(StringHash eventType, VariantMap& eventData);
+    void HandleCollisionEnd(StringHash eventType, const PhysicsContact2DPayload& contact);
     /// Handle reloading the scene.
     void ReloadScene(bool reInit);
     /// Handle 'PLAY' button released event.
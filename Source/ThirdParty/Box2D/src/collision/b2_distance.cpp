@@ -27,7 +27,10 @@
 #include "box2d/b2_polygon_shape.h"
 
 // GJK using Voronoi regions (Christer Ericson) and Barycentric coordinates.
+// Urho3D: the statistics counters are a data race when queries run on worker threads, so they are compiled out by default.
+#ifdef B2_GJK_COUNTERS
 B2_API int32 b2_gjkCalls, b2_gjkIters, b2_gjkMaxIters;
+#endif
 
 void b2DistanceProxy::Set(const b2Shape* shape, int32 index)
 {
@@ -455,7 +458,9 @@ void b2Distance(b2DistanceOutput* output,
 				b2SimplexCache* cache,
 				const b2DistanceInput* input)
 {
+#ifdef B2_GJK_COUNTERS
 	++b2_gjkCalls;
+#endif
 
 	const b2DistanceProxy* proxyA = &input->proxyA;
 	const b2DistanceProxy* proxyB = &input->proxyB;
@@ -536,7 +541,9 @@ void b2Distance(b2DistanceOutput* output,
 
 		// Iteration count is equated to the number of support point calls.
 		++iter;
+#ifdef B2_GJK_COUNTERS
 		++b2_gjkIters;
+#endif
 
 		// Check for duplicate support points. This is the main termination criteria.
 		bool duplicate = false;
@@ -559,7 +566,9 @@ void b2Distance(b2DistanceOutput* output,
 		++simplex.m_count;
 	}
 
+#ifdef B2_GJK_COUNTERS
 	b2_gjkMaxIters = b2Max(b2_gjkMaxIters, iter);
+#endif
 
 	// Prepare output.
 	simplex.GetWitnessPoints(&output->pointA, &output->pointB);
@@ -4,6 +4,7 @@
 #include "../Precompiled.h"
 
 #include "../Audio/Audio.h"
+#include "../Audio/AudioMixer.h"
 #include "../Audio/Sound.h"
 #include "../Audio/SoundListener.h"
 #include "../Audio/SoundSource.h" // 使用 SoundSource 成员与静态注册需要完整类型
@@ -11,6 +12,7 @@
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
 #include "../IO/Log.h"
 
 #include <EASTL/algorithm.h>
@@ -28,6 +30,8 @@ static const i32 MIN_BUFFERLENGTH = 20;
 static const i32 MIN_MIXRATE = 11025;
 static const i32 MAX_MIXRATE = 48000;
 static const StringHash SOUND_MASTER_HASH("Master");
+// 推入 SDL 音频流的分块大小（16 位采样数）
+static const u32 STREAM_CHUNK_SAMPLES = 4096;
 
 static void SDLAudioCallback(void* userdata, Uint8* stream, i32 len);
 static void SDLAudioStreamGetCallback(void* userdata, SDL_AudioStream* stream, int additional_amount, int /*total_amount*/);
@@ -50,6 +54,10 @@ Audio::~Audio()
 {
     Release();
     context_->ReleaseSDL();
+
+    delete mixSources_.exchange(nullptr);
+    for (Vector<SoundSource*>* sources : retiredSources_)
+        delete sources;
 }
 
 bool Audio::SetMode(i32 bufferLengthMSec, i32 mixRate, bool stereo, bool interpolation)
@@ -88,7 +96,8 @@ bool Audio::SetMode(i32 bufferLengthMSec, i32 mixRate, bool stereo, bool interpo
     fragmentSize_ = NextPowerOfTwo((u32)mixRate >> 6u);
     mixRate_ = mixRate;
     interpolation_ = interpolation;
-    clipBuffer_ = new i32[stereo ? fragmentSize_ << 1u : fragmentSize_];
+    mixBuffer_ = new float[stereo ? fragmentSize_ << 1u : fragmentSize_];
+    sourceBuffer_ = new float[fragmentSize_ << 1u];
 
     URHO3D_LOGINFO("Set audio mode " + String(mixRate_) + " Hz " + (stereo_ ? "stereo" : "mono") + (interpolation_ ? " interpolated" : ""));
 
@@ -142,12 +151,14 @@ void Audio::PauseSoundType(const String& type)
 {
     MutexLock lock(audioMutex_);
     pausedSoundTypes_.insert(type);
+    SetSoundTypePaused(type, true);
 }
 
 void Audio::ResumeSoundType(const String& type)
 {
     MutexLock lock(audioMutex_);
     pausedSoundTypes_.erase(type);
+    SetSoundTypePaused(type, false);
     // Update sound sources before resuming playback to make sure 3D positions are up to date
     // Done under mutex to ensure no mixing happens before we are ready
     UpdateInternal(0.0f);
@@ -157,6 +168,8 @@ void Audio::ResumeAll()
 {
     MutexLock lock(audioMutex_);
     pausedSoundTypes_.clear();
+    for (SoundSource* source : soundSources_)
+        source->SetSoundTypePaused(false);
     UpdateInternal(0.0f);
 }
 
@@ -196,8 +209,8 @@ SoundListener* Audio::GetListener() const
 
 void Audio::AddSoundSource(SoundSource* soundSource)
 {
-    MutexLock lock(audioMutex_);
     soundSources_.push_back(soundSource);
+    PublishSoundSources(false);
 }
 
 void Audio::RemoveSoundSource(SoundSource* soundSource)
@@ -205,8 +218,9 @@ void Audio::RemoveSoundSource(SoundSource* soundSource)
     auto i = eastl::find(soundSources_.begin(), soundSources_.end(), soundSource);
     if (i != soundSources_.end())
     {
-        MutexLock lock(audioMutex_);
         soundSources_.erase(i);
+        // 音源即将析构，必须等音频线程不再混音含有它的旧列表
+        PublishSoundSources(true);
     }
 }
 
@@ -225,6 +239,49 @@ float Audio::GetSoundSourceMasterGain(StringHash typeHash) const
     return masterIt->second.GetFloat() * typeIt->second.GetFloat();
 }
 
+void Audio::SetSoundTypePaused(StringHash type, bool paused)
+{
+    for (SoundSource* source : soundSources_)
+    {
+        if (source->GetSoundTypeHash() == type)
+            source->SetSoundTypePaused(paused);
+    }
+}
+
+void Audio::PublishSoundSources(bool waitForMixer)
+{
+    Vector<SoundSource*>* sources = new Vector<SoundSource*>(soundSources_);
+    Vector<SoundSource*>* old = mixSources_.exchange(sources);
+    if (old)
+        retiredSources_.push_back(old);
+
+    if (waitForMixer)
+    {
+        for (;;)
+        {
+            Vector<SoundSource*>* mixing = mixingSources_.load();
+            if (!mixing || mixing == sources)
+                break;
+            Time::Sleep(0);
+        }
+    }
+
+    ReclaimSoundSources();
+}
+
+void Audio::ReclaimSoundSources()
+{
+    Vector<SoundSource*>* mixing = mixingSources_.load();
+    for (i32 i = (i32)retiredSources_.size() - 1; i >= 0; --i)
+    {
+        if (retiredSources_[i] != mixing)
+        {
+            delete retiredSources_[i];
+            retiredSources_.erase(retiredSources_.begin() + i);
+        }
+    }
+}
+
 void SDLAudioCallback(void* userdata, Uint8* stream, i32 len)
 {
     auto* audio = static_cast<Audio*>(userdata);
@@ -242,57 +299,67 @@ void SDLAudioStreamGetCallback(void* userdata, SDL_AudioStream* stream, int addi
         return;
 
     MutexLock Lock(audio->GetMutex());
-    const int samples = additional_amount / (int)audio->GetSampleSize();
-    if (samples <= 0)
-        return;
+    auto samples = (u32)(additional_amount / (int)audio->GetSampleSize());
 
-    // 生成所需的 PCM 数据并推入流
-    SharedArrayPtr<u8> tmp(new u8[(size_t)additional_amount]);
-    audio->MixOutput(tmp.Get(), (u32)samples);
-    SDL_PutAudioStreamData(stream, tmp.Get(), additional_amount);
+    // 分块生成所需的 PCM 数据并推入流，音频线程上不分配内存
+    i16 buffer[STREAM_CHUNK_SAMPLES];
+    const u32 chunkSamples = STREAM_CHUNK_SAMPLES * sizeof(i16) / audio->GetSampleSize();
+    while (samples)
+    {
+        u32 workSamples = Min(samples, chunkSamples);
+        audio->MixOutput(buffer, workSamples);
+        SDL_PutAudioStreamData(stream, buffer, (int)(workSamples * audio->GetSampleSize()));
+        samples -= workSamples;
+    }
 }
 
 void Audio::MixOutput(void* dest, u32 samples)
 {
-    if (!playing_ || !clipBuffer_)
+    if (!playing_ || !mixBuffer_)
     {
         memset(dest, 0, samples * (size_t)sampleSize_);
         return;
     }
 
+    // 登记正在混音的列表后再确认它仍是最新发布的，主线程据此判断旧列表何时可以释放
+    Vector<SoundSource*>* sources;
+    do
+    {
+        sources = mixSources_.load();
+        mixingSources_.store(sources);
+    } while (sources != mixSources_.load());
+
     while (samples)
     {
-        // If sample count exceeds the fragment (clip buffer) size, split the work
+        // If sample count exceeds the fragment (mixing buffer) size, split the work
         u32 workSamples = Min(samples, fragmentSize_);
-        u32 clipSamples = workSamples;
+        u32 mixSamples = workSamples;
         if (stereo_)
-            clipSamples <<= 1;
+            mixSamples <<= 1;
 
-        // Clear clip buffer
-        i32* clipPtr = clipBuffer_.Get();
-        memset(clipPtr, 0, clipSamples * sizeof(i32));
+        // Clear mixing buffer
+        float* mixPtr = mixBuffer_.Get();
+        memset(mixPtr, 0, mixSamples * sizeof(float));
 
-        // Mix samples to clip buffer
-        for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
+        // Mix samples to mixing buffer
+        if (sources)
         {
-            SoundSource* source = *i;
-
-            // Check for pause if necessary
-            if (!pausedSoundTypes_.empty())
+            for (SoundSource* source : *sources)
             {
-                if (pausedSoundTypes_.contains(source->GetSoundType()))
+                if (source->IsSoundTypePaused())
                     continue;
-            }
 
-            source->Mix(clipPtr, workSamples, mixRate_, stereo_, interpolation_);
+                source->Mix(mixPtr, sourceBuffer_.Get(), workSamples, mixRate_, stereo_, interpolation_);
+            }
         }
-        // Copy output from clip buffer to destination
-        auto* destPtr = (short*)dest;
-        while (clipSamples--)
-            *destPtr++ = (short)Clamp(*clipPtr++, -32768, 32767);
+
+        // Convert output from mixing buffer to destination
+        ConvertToS16((i16*)dest, mixPtr, mixSamples);
         samples -= workSamples;
         ((u8*&)dest) += sampleSize_ * workSamples;
     }
+
+    mixingSources_.store(nullptr);
 }
 
 void Audio::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
@@ -316,7 +383,8 @@ void Audio::Release()
         SDL_CloseAudioDevice(deviceID_);
         deviceID_ = 0;
     }
-    clipBuffer_.Reset();
+    mixBuffer_.Reset();
+    sourceBuffer_.Reset();
 }
 
 void Audio::UpdateInternal(float timeStep)
@@ -328,15 +396,14 @@ void Audio::UpdateInternal(float timeStep)
     {
         SoundSource* source = soundSources_[i];
 
-        // Check for pause if necessary; do not update paused sound sources
-        if (!pausedSoundTypes_.empty())
-        {
-            if (pausedSoundTypes_.contains(source->GetSoundType()))
-                continue;
-        }
+        // Do not update paused sound sources
+        if (source->IsSoundTypePaused())
+            continue;
 
         source->Update(timeStep);
     }
+
+    ReclaimSoundSources();
 }
 
 void RegisterAudioLibrary(Context* context)
@@ -9,6 +9,8 @@
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -86,7 +88,7 @@ public:
     /// @property
     SoundListener* GetListener() const;
 
-    /// Return all sound sources.
+    /// Return all sound sources. Main thread only; the audio thread mixes a published copy of the list.
     const Vector<SoundSource*>& GetSoundSources() const { return soundSources_; }
 
     /// Return whether the specified master gain has been defined.
@@ -97,13 +99,13 @@ public:
     /// Remove a sound source. Called by SoundSource.
     void RemoveSoundSource(SoundSource* soundSource);
 
-    /// Return audio thread mutex.
+    /// Return audio thread mutex. Held while mixing and while changing the playback state of sound sources.
     Mutex& GetMutex() { return audioMutex_; }
 
     /// Return sound type specific gain multiplied by master gain.
     float GetSoundSourceMasterGain(StringHash typeHash) const;
 
-    /// Mix sound sources into the buffer.
+    /// Mix sound sources into the buffer. Call with the audio mutex held.
     void MixOutput(void* dest, u32 samples);
 
 private:
@@ -113,9 +115,17 @@ private:
     void Release();
     /// Actually update sound sources with the specific timestep. Called internally.
     void UpdateInternal(float timeStep);
-
-    /// Clipping buffer for mixing.
-    SharedArrayPtr<i32> clipBuffer_;
+    /// Set the paused flag of sound sources of a type.
+    void SetSoundTypePaused(StringHash type, bool paused);
+    /// Publish a copy of the sound source list to the audio thread. Optionally wait until the audio thread no longer mixes an older copy.
+    void PublishSoundSources(bool waitForMixer);
+    /// Free replaced sound source lists the audio thread no longer mixes.
+    void ReclaimSoundSources();
+
+    /// Float mixing buffer.
+    SharedArrayPtr<float> mixBuffer_;
+    /// Resampling scratch buffer for one sound source, in the source's channel layout.
+    SharedArrayPtr<float> sourceBuffer_;
     /// Audio thread mutex.
     Mutex audioMutex_;
     /// SDL audio device ID.
@@ -124,7 +134,7 @@ private:
     void* audioStream_{};
     /// Sample size.
     u32 sampleSize_{};
-    /// Clip buffer size in samples.
+    /// Mixing buffer size in samples.
     u32 fragmentSize_{};
     /// Mixing rate.
     i32 mixRate_{};
@@ -138,12 +148,34 @@ private:
     HashMap<StringHash, Variant> masterGain_;
     /// Paused sound types.
     HashSet<StringHash> pausedSoundTypes_;
-    /// Sound sources.
+    /// Sound sources. Main thread only.
     Vector<SoundSource*> soundSources_;
+    /// Sound source list published to the audio thread.
+    std::atomic<Vector<SoundSource*>*> mixSources_{};
+    /// Sound source list the audio thread is mixing, or null when not mixing.
+    std::atomic<Vector<SoundSource*>*> mixingSources_{};
+    /// Replaced sound source lists waiting to be freed.
+    Vector<Vector<SoundSource*>*> retiredSources_;
     /// Sound listener.
     WeakPtr<SoundListener> listener_;
 };
 
+/// Software mixer benchmark results.
+struct URHO3D_API AudioMixBenchmarkResult
+{
+    /// Number of mixed sound sources.
+    unsigned numSources_{};
+    /// Microseconds to mix one second of output without sound sources.
+    float baseUSec_{};
+    /// Microseconds to mix one second of output per sound source.
+    float perSourceUSec_{};
+    /// Fraction of real time spent mixing all the sound sources. The output can not keep up above 1.
+    float load_{};
+};
+
+/// Mix looping sound sources offline and return the mixing cost. Sets the audio mode if not set yet; for headless runs set the SDL_AUDIO_DRIVER environment variable to "dummy". Results are also logged. The EngineBenchmark extra runs it from the command line.
+URHO3D_API AudioMixBenchmarkResult RunAudioMixBenchmark(Context* context, unsigned numSources = 128, float seconds = 2.0f);
+
 /// Register Audio library objects.
 /// @nobind
 void URHO3D_API RegisterAudioLibrary(Context* context);
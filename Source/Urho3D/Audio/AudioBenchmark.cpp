@@ -0,0 +1,125 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+// 混音性能测试：离线混合大量循环音源，测量每个音源的混音开销与占实时的比例
+
+#include "../Precompiled.h"
+
+#include "../Audio/Audio.h"
+#include "../Audio/Sound.h"
+#include "../Audio/SoundSource.h"
+#include "../Core/Context.h"
+#include "../Core/Timer.h"
+#include "../IO/Log.h"
+#include "../Scene/Node.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// 每次混音调用的采样数，与典型的设备回调大小相当
+static const u32 BENCHMARK_CHUNK_SAMPLES = 1024;
+// 测试音的长度
+static const unsigned BENCHMARK_SOUND_FRAMES = 22050;
+
+namespace
+{
+
+/// Create a looping sine tone.
+SharedPtr<Sound> CreateBenchmarkSound(Context* context, unsigned frequency, bool sixteenBit, bool stereo)
+{
+    unsigned channels = stereo ? 2 : 1;
+    unsigned numSamples = BENCHMARK_SOUND_FRAMES * channels;
+    Vector<i16> samples(numSamples);
+    for (unsigned i = 0; i < numSamples; ++i)
+        samples[i] = (i16)(Sin((float)(i / channels) * 440.0f * 360.0f / (float)frequency) * 8000.0f);
+
+    SharedPtr<Sound> sound(new Sound(context));
+    if (sixteenBit)
+        sound->SetData(samples.data(), numSamples * sizeof(i16));
+    else
+    {
+        Vector<i8> bytes(numSamples);
+        for (unsigned i = 0; i < numSamples; ++i)
+            bytes[i] = (i8)(samples[i] >> 8);
+        sound->SetData(bytes.data(), numSamples);
+    }
+    sound->SetFormat(frequency, sixteenBit, stereo);
+    sound->SetLooped(true);
+    return sound;
+}
+
+/// Mix a number of seconds of output with the audio mutex held. Return elapsed microseconds.
+long long MixBenchmarkOutput(Audio* audio, u32 numSamples)
+{
+    Vector<i16> buffer(BENCHMARK_CHUNK_SAMPLES * 2);
+    HiresTimer timer;
+    MutexLock lock(audio->GetMutex());
+    while (numSamples)
+    {
+        u32 workSamples = Min(numSamples, BENCHMARK_CHUNK_SAMPLES);
+        audio->MixOutput(buffer.data(), workSamples);
+        numSamples -= workSamples;
+    }
+    return timer.GetUSec(false);
+}
+
+}
+
+AudioMixBenchmarkResult RunAudioMixBenchmark(Context* context, unsigned numSources, float seconds)
+{
+    AudioMixBenchmarkResult result;
+    auto* audio = context->GetSubsystem<Audio>();
+    if (!audio)
+        return result;
+
+    if (!audio->IsInitialized() && !audio->SetMode(100, 44100, true))
+    {
+        URHO3D_LOGERROR("Audio mix benchmark: could not open audio output, set SDL_AUDIO_DRIVER=dummy for headless runs");
+        return result;
+    }
+    if (!audio->Play())
+        return result;
+
+    numSources = Max(numSources, 1u);
+    seconds = Max(seconds, 0.1f);
+    i32 mixRate = audio->GetMixRate();
+    auto numSamples = (u32)(seconds * (float)mixRate);
+
+    // 混音前的固定开销：清空混音缓冲与转换输出
+    long long baseUSec = MixBenchmarkOutput(audio, numSamples);
+
+    // 原速 16 位单声道（直接转换路径）、变调 16 位立体声与 8 位单声道（重采样内核）各占一部分
+    SharedPtr<Sound> sounds[] = {
+        CreateBenchmarkSound(context, (unsigned)mixRate, true, false),
+        CreateBenchmarkSound(context, 22050, true, true),
+        CreateBenchmarkSound(context, 11025, false, false)
+    };
+    const float frequencies[] = { (float)mixRate, 22050.0f * 1.25f, 11025.0f };
+
+    SharedPtr<Node> root(new Node(context));
+    for (unsigned i = 0; i < numSources; ++i)
+    {
+        auto* source = root->CreateChild()->CreateComponent<SoundSource>();
+        unsigned type = i % 3;
+        source->Play(sounds[type], frequencies[type], 0.25f, (float)(i % 9) / 4.0f - 1.0f);
+    }
+
+    long long mixUSec = MixBenchmarkOutput(audio, numSamples);
+    root.Reset();
+
+    result.numSources_ = numSources;
+    result.baseUSec_ = (float)baseUSec / seconds;
+    result.perSourceUSec_ = (float)Max(mixUSec - baseUSec, 0LL) / seconds / (float)numSources;
+    result.load_ = (float)mixUSec / (seconds * 1000000.0f);
+
+    URHO3D_LOGINFOF("Audio mix benchmark: %u sources, %d Hz %s%s", numSources, mixRate, audio->IsStereo() ? "stereo" : "mono",
+        audio->GetInterpolation() ? " interpolated" : "");
+    URHO3D_LOGINFOF("  %.1f us per second of output without sources, %.2f us per source, %.2f%% of real time",
+        result.baseUSec_, result.perSourceUSec_, result.load_ * 100.0f);
+
+    return result;
+}
+
+}
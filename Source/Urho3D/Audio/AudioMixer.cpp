@@ -0,0 +1,132 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#include "../Precompiled.h"
+
+#include "../Audio/AudioMixer.h"
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// 没有 SSE 时剩余部分使用无分支的简单循环，编译器可自动向量化（例如 NEON）
+
+void ConvertSamples(float* dest, const i16* src, unsigned count, float scale)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    __m128 vScale = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // 与自身交错后算术右移，得到符号扩展的 32 位整数
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vScale));
+        _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vScale));
+    }
+#endif
+    for (; i < count; ++i)
+        dest[i] = (float)src[i] * scale;
+}
+
+void ConvertSamples(float* dest, const i8* src, unsigned count, float scale)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    __m128 vScale = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        __m128i v16 = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v16, v16), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v16, v16), 16);
+        _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vScale));
+        _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vScale));
+    }
+#endif
+    for (; i < count; ++i)
+        dest[i] = (float)src[i] * scale;
+}
+
+void MixSamples(float* dest, const float* src, unsigned count, float gain)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    __m128 vGain = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(src + i), vGain)));
+#endif
+    for (; i < count; ++i)
+        dest[i] += src[i] * gain;
+}
+
+void MixSamplesMonoToStereo(float* dest, const float* src, unsigned frames, float leftGain, float rightGain)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    __m128 vGain = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+    for (; i + 4 <= frames; i += 4)
+    {
+        __m128 s = _mm_loadu_ps(src + i);
+        float* d = dest + i * 2;
+        _mm_storeu_ps(d, _mm_add_ps(_mm_loadu_ps(d), _mm_mul_ps(_mm_unpacklo_ps(s, s), vGain)));
+        _mm_storeu_ps(d + 4, _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), vGain)));
+    }
+#endif
+    for (; i < frames; ++i)
+    {
+        dest[i * 2] += src[i] * leftGain;
+        dest[i * 2 + 1] += src[i] * rightGain;
+    }
+}
+
+void MixSamplesStereoToMono(float* dest, const float* src, unsigned frames, float gain)
+{
+    gain *= 0.5f;
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    __m128 vGain = _mm_set1_ps(gain);
+    for (; i + 4 <= frames; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(src + i * 2);
+        __m128 b = _mm_loadu_ps(src + i * 2 + 4);
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_add_ps(left, right), vGain)));
+    }
+#endif
+    for (; i < frames; ++i)
+        dest[i] += (src[i * 2] + src[i * 2 + 1]) * gain;
+}
+
+void ConvertToS16(i16* dest, const float* src, unsigned count)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    // 先钳制再截断：超出 int32 范围的值转换结果未定义
+    __m128 vMin = _mm_set1_ps(-32768.0f);
+    __m128 vMax = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), vMin), vMax);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), vMin), vMax);
+        __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float value = src[i];
+        value = value < -32768.0f ? -32768.0f : value;
+        value = value > 32767.0f ? 32767.0f : value;
+        dest[i] = (i16)value;
+    }
+}
+
+}
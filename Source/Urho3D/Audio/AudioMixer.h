@@ -0,0 +1,28 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+/// \file
+
+#pragma once
+
+#include "../Base/PrimitiveTypes.h"
+
+namespace Urho3D
+{
+
+// 软件混音的向量化内核。混音缓冲为 float，幅度与 16 位采样相同，最后一次性饱和转换为 16 位输出
+
+/// Convert 16-bit samples to float, multiplied by scale.
+void ConvertSamples(float* dest, const i16* src, unsigned count, float scale);
+/// Convert 8-bit samples to float, multiplied by scale.
+void ConvertSamples(float* dest, const i8* src, unsigned count, float scale);
+/// Add samples multiplied by gain. Also mixes interleaved stereo to stereo.
+void MixSamples(float* dest, const float* src, unsigned count, float gain);
+/// Add mono samples to an interleaved stereo buffer with separate left and right gains.
+void MixSamplesMonoToStereo(float* dest, const float* src, unsigned frames, float leftGain, float rightGain);
+/// Add interleaved stereo samples to a mono buffer, averaging the channels.
+void MixSamplesStereoToMono(float* dest, const float* src, unsigned frames, float gain);
+/// Convert float samples to 16-bit, saturating out of range values.
+void ConvertToS16(i16* dest, const float* src, unsigned count);
+
+}
@@ -6,6 +6,8 @@
 #include "../Audio/AudioDefs.h"
 #include "../Scene/Component.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -75,6 +77,9 @@ public:
     /// @property
     String GetSoundType() const { return soundType_; }
 
+    /// Return sound type hash.
+    StringHash GetSoundTypeHash() const { return soundTypeHash_; }
+
     /// Return playback time position.
     /// @property
     float GetTimePosition() const { return timePosition_; }
@@ -105,10 +110,14 @@ public:
 
     /// Update the sound source. Perform subclass specific operations. Called by Audio.
     virtual void Update(float timeStep);
-    /// Mix sound source output to a 32-bit clipping buffer. Called by Audio.
-    void Mix(int* dest, unsigned samples, int mixRate, bool stereo, bool interpolation);
+    /// Mix sound source output to a float mixing buffer, using a scratch buffer of at least two floats per sample. Called by Audio.
+    void Mix(float* dest, float* scratch, unsigned samples, int mixRate, bool stereo, bool interpolation);
     /// Update the effective master gain. Called internally and by Audio when the master gain changes.
     void UpdateMasterGain();
+    /// Set whether the sound type is paused. Called by Audio.
+    void SetSoundTypePaused(bool paused) { soundTypePaused_.store(paused, std::memory_order_relaxed); }
+    /// Return whether the sound type is paused. Read by the audio thread instead of looking up the paused types.
+    bool IsSoundTypePaused() const { return soundTypePaused_.load(std::memory_order_relaxed); }
 
     /// Set sound attribute.
     void SetSoundAttr(const ResourceRef& value);
@@ -152,22 +161,8 @@ private:
     void StopLockless();
     /// Set new playback position without locking the audio mutex. Called internally.
     void SetPlayPositionLockless(signed char* pos);
-    /// Mix mono sample to mono buffer.
-    void MixMonoToMono(Sound* sound, int* dest, unsigned samples, int mixRate);
-    /// Mix mono sample to stereo buffer.
-    void MixMonoToStereo(Sound* sound, int* dest, unsigned samples, int mixRate);
-    /// Mix mono sample to mono buffer interpolated.
-    void MixMonoToMonoIP(Sound* sound, int* dest, unsigned samples, int mixRate);
-    /// Mix mono sample to stereo buffer interpolated.
-    void MixMonoToStereoIP(Sound* sound, int* dest, unsigned samples, int mixRate);
-    /// Mix stereo sample to mono buffer.
-    void MixStereoToMono(Sound* sound, int* dest, unsigned samples, int mixRate);
-    /// Mix stereo sample to stereo buffer.
-    void MixStereoToStereo(Sound* sound, int* dest, unsigned samples, int mixRate);
-    /// Mix stereo sample to mono buffer interpolated.
-    void MixStereoToMonoIP(Sound* sound, int* dest, unsigned samples, int mixRate);
-    /// Mix stereo sample to stereo buffer interpolated.
-    void MixStereoToStereoIP(Sound* sound, int* dest, unsigned samples, int mixRate);
+    /// Resample the sound from the playback position to float frames in the sound's channel layout and advance the position. Return number of frames produced, fewer than requested if a one-shot sound ended.
+    unsigned Resample(Sound* sound, float* dest, unsigned frames, int mixRate, bool interpolation);
     /// Advance playback pointer without producing audible output.
     void MixZeroVolume(Sound* sound, unsigned samples, int mixRate);
     /// Advance playback pointer to simulate audio playback in headless mode.
@@ -187,6 +182,8 @@ private:
     SharedPtr<Sound> streamBuffer_;
     /// Unused stream bytes from previous frame.
     int unusedStreamSize_;
+    /// Whether the sound type is paused.
+    std::atomic<bool> soundTypePaused_{};
 };
 
 }
@@ -214,6 +214,8 @@ private:
     Vector<Object*> eventSenders_;
     /// Event data stack.
     Vector<VariantMap*> eventDataMaps_;
+    /// Specific receivers already reached by the sends in progress, stacked per nesting level. Reused to avoid allocating per send.
+    Vector<Object*> processedReceivers_;
     /// Active event handler. Not stored in a stack for performance reasons; is needed only in esoteric cases.
     EventHandler* eventHandler_;
     /// Object categories.
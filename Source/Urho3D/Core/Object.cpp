@@ -77,7 +77,32 @@ void Object::OnEvent(Object* sender, StringHash eventType, VariantMap& eventData
 
     // Make a copy of the context pointer in case the object is destroyed during event handler invocation
     Context* context = context_;
-    EventHandler* specific = nullptr;
+    EventHandler* handler = FindReceiverHandler(sender, eventType);
+    if (handler)
+    {
+        context->SetEventHandler(handler);
+        handler->Invoke(eventData);
+        context->SetEventHandler(nullptr);
+    }
+}
+
+void Object::OnEvent(Object* sender, StringHash eventType, EventPayload& payload)
+{
+    if (blockEvents_)
+        return;
+
+    Context* context = context_;
+    EventHandler* handler = FindReceiverHandler(sender, eventType);
+    if (handler)
+    {
+        context->SetEventHandler(handler);
+        handler->InvokeTyped(payload);
+        context->SetEventHandler(nullptr);
+    }
+}
+
+EventHandler* Object::FindReceiverHandler(Object* sender, StringHash eventType) const
+{
     EventHandler* nonSpecific = nullptr;
 
     EventHandler* handler = eventHandlers_.First();
@@ -85,32 +110,16 @@ void Object::OnEvent(Object* sender, StringHash eventType, VariantMap& eventData
     {
         if (handler->GetEventType() == eventType)
         {
+            // Specific event handlers have priority
             if (!handler->GetSender())
                 nonSpecific = handler;
             else if (handler->GetSender() == sender)
-            {
-                specific = handler;
-                break;
-            }
+                return handler;
         }
         handler = eventHandlers_.Next(handler);
     }
 
-    // Specific event handlers have priority, so if found, invoke first
-    if (specific)
-    {
-        context->SetEventHandler(specific);
-        specific->Invoke(eventData);
-        context->SetEventHandler(nullptr);
-        return;
-    }
-
-    if (nonSpecific)
-    {
-        context->SetEventHandler(nonSpecific);
-        nonSpecific->Invoke(eventData);
-        context->SetEventHandler(nullptr);
-    }
+    return nonSpecific;
 }
 
 bool Object::IsInstanceOf(StringHash type) const
@@ -276,12 +285,20 @@ void Object::UnsubscribeFromAllEventsExcept(const Vector<StringHash>& exceptions
 
 void Object::SendEvent(StringHash eventType)
 {
-    VariantMap noEventData;
-
-    SendEvent(eventType, noEventData);
+    SendEvent(eventType, GetEventDataMap());
 }
 
 void Object::SendEvent(StringHash eventType, VariantMap& eventData)
+{
+    SendEventImpl(eventType, eventData);
+}
+
+void Object::SendEvent(StringHash eventType, EventPayload& payload)
+{
+    SendEventImpl(eventType, payload);
+}
+
+template <class T> void Object::SendEventImpl(StringHash eventType, T& eventData)
 {
     if (!Thread::IsMainThread())
     {
@@ -302,7 +319,11 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     // Make a weak pointer to self to check for destruction during event handling
     WeakPtr<Object> self(this);
     Context* context = context_;
-    HashSet<Object*> processed;
+
+    // Specific receivers reached by this send are recorded on the context's shared stack above those of outer sends,
+    // so no set has to be allocated per send
+    Vector<Object*>& processed = context->processedReceivers_;
+    const unsigned processedBegin = processed.Size();
 
     context->BeginSendEvent(this, eventType);
 
@@ -328,10 +349,11 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
             {
                 group->EndSendEvent();
                 context->EndSendEvent();
+                processed.Resize(processedBegin);
                 return;
             }
 
-            processed.insert(receiver);
+            processed.Push(receiver);
         }
 
         group->EndSendEvent();
@@ -343,43 +365,40 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     {
         group->BeginSendEvent();
 
-        if (processed.empty())
-        {
-            const unsigned numReceivers = group->receivers_.Size();
-            for (unsigned i = 0; i < numReceivers; ++i)
-            {
-                Object* receiver = group->receivers_[i];
-                if (!receiver)
-                    continue;
+        // If there were specific receivers, check that the event is not sent doubly to them. Usually only a few,
+        // so search linearly unless there are many
+        const unsigned processedEnd = processed.Size();
+        Object** processedFirst = processed.Buffer() + processedBegin;
+        Object** processedLast = processed.Buffer() + processedEnd;
+        const bool sorted = processedEnd - processedBegin > 16;
+        if (sorted)
+            eastl::sort(processedFirst, processedLast);
 
-                receiver->OnEvent(this, eventType, eventData);
-
-                if (self.Expired())
-                {
-                    group->EndSendEvent();
-                    context->EndSendEvent();
-                    return;
-                }
-            }
-        }
-        else
+        const unsigned numReceivers = group->receivers_.Size();
+        for (unsigned i = 0; i < numReceivers; ++i)
         {
-            // If there were specific receivers, check that the event is not sent doubly to them
-            const unsigned numReceivers = group->receivers_.Size();
-            for (unsigned i = 0; i < numReceivers; ++i)
+            Object* receiver = group->receivers_[i];
+            if (!receiver)
+                continue;
+
+            if (processedBegin != processedEnd)
             {
-                Object* receiver = group->receivers_[i];
-                if (!receiver || processed.find(receiver) != processed.end())
+                // Nested sends only append past processedEnd and truncate back, so the range stays valid
+                processedFirst = processed.Buffer() + processedBegin;
+                processedLast = processed.Buffer() + processedEnd;
+                if (sorted ? eastl::binary_search(processedFirst, processedLast, receiver) :
+                    eastl::find(processedFirst, processedLast, receiver) != processedLast)
                     continue;
+            }
 
-                receiver->OnEvent(this, eventType, eventData);
+            receiver->OnEvent(this, eventType, eventData);
 
-                if (self.Expired())
-                {
-                    group->EndSendEvent();
-                    context->EndSendEvent();
-                    return;
-                }
+            if (self.Expired())
+            {
+                group->EndSendEvent();
+                context->EndSendEvent();
+                processed.Resize(processedBegin);
+                return;
             }
         }
 
@@ -387,6 +406,7 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     }
 
     context->EndSendEvent();
+    processed.Resize(processedBegin);
 }
 
 VariantMap& Object::GetEventDataMap() const
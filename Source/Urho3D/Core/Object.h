@@ -59,6 +59,55 @@ private:
         static const Urho3D::String& GetTypeNameStatic() { return GetTypeInfoStatic()->GetTypeName(); } \
         static const Urho3D::TypeInfo* GetTypeInfoStatic() { static const Urho3D::TypeInfo typeInfoStatic(#typeName, BaseClassName::GetTypeInfoStatic()); return &typeInfoStatic; }
 
+/// Return a unique identifier for an event payload type.
+template <class T> const void* GetEventPayloadTypeId()
+{
+    static const char id = 0;
+    return &id;
+}
+
+/// Typed event payload sent with Object::SendTypedEvent(). The payload type must provide ToVariantMap(VariantMap&) const and FromVariantMap(const VariantMap&), which convert it for handlers of the other kind.
+/// @nobind
+class URHO3D_API EventPayload
+{
+public:
+    /// Construct with payload and the event data map to fill for VariantMap handlers on first use.
+    template <class T> EventPayload(const T& payload, VariantMap& eventData) :
+        data_(&payload),
+        typeId_(GetEventPayloadTypeId<T>()),
+        toVariantMap_([](const void* data, VariantMap& eventData) { static_cast<const T*>(data)->ToVariantMap(eventData); }),
+        eventData_(eventData),
+        converted_(false)
+    {
+    }
+
+    /// Return the payload if it is of the specified type, or null otherwise.
+    template <class T> const T* Get() const { return typeId_ == GetEventPayloadTypeId<T>() ? static_cast<const T*>(data_) : nullptr; }
+
+    /// Return the payload converted to event data. Converted only once per send.
+    VariantMap& GetEventData()
+    {
+        if (!converted_)
+        {
+            toVariantMap_(data_, eventData_);
+            converted_ = true;
+        }
+        return eventData_;
+    }
+
+private:
+    /// Payload.
+    const void* data_;
+    /// Payload type identifier.
+    const void* typeId_;
+    /// Payload to event data conversion function.
+    void (* toVariantMap_)(const void*, VariantMap&);
+    /// Event data map.
+    VariantMap& eventData_;
+    /// Whether event data has been filled.
+    bool converted_;
+};
+
 /// Base class for objects with type identification, subsystem access and event sending/receiving capability.
 /// @templateversion
 class URHO3D_API Object : public RefCounted
@@ -81,6 +130,8 @@ public:
     virtual const TypeInfo* GetTypeInfo() const = 0;
     /// Handle event.
     virtual void OnEvent(Object* sender, StringHash eventType, VariantMap& eventData);
+    /// Handle event with a typed payload.
+    void OnEvent(Object* sender, StringHash eventType, EventPayload& payload);
 
     /// Return type info static.
     static const TypeInfo* GetTypeInfoStatic() { return nullptr; }
@@ -124,6 +175,20 @@ public:
     {
         SendEvent(eventType, GetEventDataMap().Populate(args...));
     }
+    /// Send event with a typed payload to all subscribers. Handlers subscribed with URHO3D_TYPED_HANDLER receive the payload directly, others receive event data converted from it on first use.
+    template <class T> void SendTypedEvent(StringHash eventType, const T& payload)
+    {
+        EventPayload eventPayload(payload, GetEventDataMap());
+        SendEvent(eventType, eventPayload);
+    }
+    /// Send event with a typed payload to all subscribers, converting it into the specified event data map for VariantMap handlers. The sender may keep the map between sends, so that buffer values reuse their storage. Must not be used for nested sends of the same map.
+    template <class T> void SendTypedEvent(StringHash eventType, const T& payload, VariantMap& eventData)
+    {
+        EventPayload eventPayload(payload, eventData);
+        SendEvent(eventType, eventPayload);
+    }
+    /// Send event with a typed payload to all subscribers.
+    void SendEvent(StringHash eventType, EventPayload& payload);
 
     /// Return execution context.
     Context* GetContext() const { return context_; }
@@ -166,6 +231,10 @@ protected:
     Context* context_;
 
 private:
+    /// Send event to specific receivers first, then to non-specific receivers not reached yet.
+    template <class T> void SendEventImpl(StringHash eventType, T& eventData);
+    /// Find the handler for an event from a sender, preferring a specific handler.
+    EventHandler* FindReceiverHandler(Object* sender, StringHash eventType) const;
     /// Find the first event handler with no specific sender.
     EventHandler* FindEventHandler(StringHash eventType, EventHandler** previous = nullptr) const;
     /// Find the first event handler with specific sender.
@@ -256,6 +325,8 @@ public:
 
     /// Invoke event handler function.
     virtual void Invoke(VariantMap& eventData) = 0;
+    /// Invoke event handler function with a typed payload. By default invokes with the payload converted to event data.
+    virtual void InvokeTyped(EventPayload& payload) { Invoke(payload.GetEventData()); }
     /// Return a unique copy of the event handler.
     virtual EventHandler* Clone() const = 0;
 
@@ -315,6 +386,61 @@ private:
     HandlerFunctionPtr function_;
 };
 
+/// Template implementation of the event handler invoke helper for typed payloads (stores a function pointer of specific class).
+template <class T, class P> class TypedEventHandlerImpl : public EventHandler
+{
+public:
+    using HandlerFunctionPtr = void (T::*)(StringHash, const P&);
+
+    /// Construct with receiver and function pointers and userdata.
+    TypedEventHandlerImpl(T* receiver, HandlerFunctionPtr function, void* userData = nullptr) :
+        EventHandler(receiver, userData),
+        function_(function)
+    {
+        assert(receiver_);
+        assert(function_);
+    }
+
+    /// Invoke event handler function. Converts the event data to the payload type.
+    void Invoke(VariantMap& eventData) override
+    {
+        P payload;
+        payload.FromVariantMap(eventData);
+        auto* receiver = static_cast<T*>(receiver_);
+        (receiver->*function_)(eventType_, payload);
+    }
+
+    /// Invoke event handler function with a typed payload.
+    void InvokeTyped(EventPayload& payload) override
+    {
+        const P* data = payload.Get<P>();
+        if (!data)
+        {
+            Invoke(payload.GetEventData());
+            return;
+        }
+
+        auto* receiver = static_cast<T*>(receiver_);
+        (receiver->*function_)(eventType_, *data);
+    }
+
+    /// Return a unique copy of the event handler.
+    EventHandler* Clone() const override
+    {
+        return new TypedEventHandlerImpl(static_cast<T*>(receiver_), function_, userData_);
+    }
+
+private:
+    /// Class-specific pointer to handler function.
+    HandlerFunctionPtr function_;
+};
+
+/// Construct a typed event handler, deducing the payload type from the handler function.
+template <class T, class P> TypedEventHandlerImpl<T, P>* MakeTypedEventHandler(T* receiver, void (T::* function)(StringHash, const P&))
+{
+    return new TypedEventHandlerImpl<T, P>(receiver, function);
+}
+
 /// Template implementation of the event handler invoke helper (std::function instance).
 /// @nobind
 class EventHandler11Impl : public EventHandler
@@ -356,5 +482,7 @@ URHO3D_API StringHashRegister& GetEventNameRegister();
 #define URHO3D_HANDLER(className, function) (new Urho3D::EventHandlerImpl<className>(this, &className::function))
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function, and also defines a userdata pointer.
 #define URHO3D_HANDLER_USERDATA(className, function, userData) (new Urho3D::EventHandlerImpl<className>(this, &className::function, userData))
+/// Convenience macro to construct an EventHandler for a member function taking a typed payload.
+#define URHO3D_TYPED_HANDLER(className, function) (Urho3D::MakeTypedEventHandler<className>(this, &className::function))
 
 }
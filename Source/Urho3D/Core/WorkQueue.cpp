@@ -12,6 +12,138 @@
 namespace Urho3D
 {
 
+/// Scheduling states of a work item.
+enum WorkItemState : u8
+{
+    WIS_IDLE = 0,
+    WIS_QUEUED,
+    WIS_RUNNING,
+    WIS_REMOVED,
+    /// Removed and dropped from its queue by a thread, which publishes it to the completed list right after.
+    WIS_RETIRED
+};
+
+/// Chase-Lev work-stealing deque of work item pointers. Only the owner pushes and pops at the bottom, any thread may steal from the top.
+class WorkStealingDeque : public RefCounted
+{
+public:
+    /// Construct.
+    WorkStealingDeque() :
+        top_(0),
+        bottom_(0),
+        buffer_(new Buffer(64))
+    {
+    }
+
+    /// Destruct.
+    ~WorkStealingDeque() override
+    {
+        delete buffer_.load(std::memory_order_relaxed);
+        for (Buffer* buffer : retired_)
+            delete buffer;
+    }
+
+    /// Push an item to the bottom. Owner only.
+    void Push(WorkItem* item)
+    {
+        i64 b = bottom_.load(std::memory_order_relaxed);
+        i64 t = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        if (b - t > buffer->mask_)
+            buffer = Grow(buffer, t, b);
+
+        buffer->Put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /// Pop an item from the bottom. Owner only. Return null if empty or lost the race for the last item.
+    WorkItem* Pop()
+    {
+        i64 b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 t = top_.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        WorkItem* item = buffer->Get(b);
+        if (t == b)
+        {
+            // Last item: race against thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    /// Steal an item from the top. Any thread. Return null if empty or lost the race.
+    WorkItem* Steal()
+    {
+        i64 t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+
+        WorkItem* item = buffer_.load(std::memory_order_acquire)->Get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+
+        return item;
+    }
+
+    /// Return whether the deque looks empty. May be stale when read from another thread.
+    bool IsEmpty() const { return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed); }
+
+private:
+    /// Circular item buffer with a power of two capacity.
+    struct Buffer
+    {
+        explicit Buffer(i64 capacity) :
+            mask_(capacity - 1),
+            items_(new std::atomic<WorkItem*>[capacity])
+        {
+        }
+
+        ~Buffer() { delete[] items_; }
+
+        WorkItem* Get(i64 index) const { return items_[index & mask_].load(std::memory_order_relaxed); }
+        void Put(i64 index, WorkItem* item) { items_[index & mask_].store(item, std::memory_order_relaxed); }
+
+        i64 mask_;
+        std::atomic<WorkItem*>* items_;
+    };
+
+    /// Double the buffer capacity. The old buffer is retired, not freed, as thieves may still read from it.
+    Buffer* Grow(Buffer* buffer, i64 t, i64 b)
+    {
+        auto* newBuffer = new Buffer((buffer->mask_ + 1) * 2);
+        for (i64 i = t; i < b; ++i)
+            newBuffer->Put(i, buffer->Get(i));
+
+        retired_.Push(buffer);
+        buffer_.store(newBuffer, std::memory_order_release);
+        return newBuffer;
+    }
+
+    /// Index of the next item to steal.
+    std::atomic<i64> top_;
+    /// Index of the next item to push.
+    std::atomic<i64> bottom_;
+    /// Current buffer.
+    std::atomic<Buffer*> buffer_;
+    /// Buffers replaced by growth, freed on destruction.
+    Vector<Buffer*> retired_;
+};
+
 /// Worker thread managed by the work queue.
 class WorkerThread : public Thread, public RefCounted
 {
@@ -49,14 +181,22 @@ private:
 
 WorkQueue::WorkQueue(Context* context) :
     Object(context),
+    nextDeque_(0),
     shutDown_(false),
-    pausing_(false),
     paused_(false),
     completing_(false),
     tolerance_(10),
     lastSize_(0),
     maxNonThreadedWorkMs_(5)
 {
+    for (i32 band = 0; band < MAX_WORK_PRIORITY_BANDS; ++band)
+    {
+        deques_[band].Push(SharedPtr<WorkStealingDeque>(new WorkStealingDeque()));
+        numPending_[band] = 0;
+        completedItems_[band] = nullptr;
+    }
+    numPublishing_ = 0;
+
     SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(WorkQueue, HandleBeginFrame));
 }
 
@@ -68,6 +208,23 @@ WorkQueue::~WorkQueue()
 
     for (const SharedPtr<WorkerThread>& thread : threads_)
         thread->Stop();
+
+    // Release the references held for items which were never purged
+    for (i32 band = 0; band < MAX_WORK_PRIORITY_BANDS; ++band)
+    {
+        for (const SharedPtr<WorkStealingDeque>& deque : deques_[band])
+        {
+            while (WorkItem* item = deque->Pop())
+                item->ReleaseRef();
+        }
+
+        for (WorkItem* item = completedItems_[band].exchange(nullptr); item;)
+        {
+            WorkItem* next = item->nextCompleted_;
+            item->ReleaseRef();
+            item = next;
+        }
+    }
 }
 
 void WorkQueue::CreateThreads(i32 numThreads)
@@ -83,6 +240,13 @@ void WorkQueue::CreateThreads(i32 numThreads)
     // Start threads in paused mode
     Pause();
 
+    // One deque per worker thread in addition to the main thread's deque. Must exist before the threads run
+    for (i32 band = 0; band < MAX_WORK_PRIORITY_BANDS; ++band)
+    {
+        for (i32 i = 0; i < numThreads; ++i)
+            deques_[band].Push(SharedPtr<WorkStealingDeque>(new WorkStealingDeque()));
+    }
+
     for (i32 i = 0; i < numThreads; ++i)
     {
         SharedPtr<WorkerThread> thread(new WorkerThread(this, i + 1));
@@ -119,44 +283,49 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
         return;
     }
 
-    // Check for duplicate items.
-    assert(!workItems_.Contains(item));
+    // A removed item stays in its deque until a thread drops it. Revive it in place if that has not happened yet
+    u8 expected = WIS_REMOVED;
+    if (item->state_.compare_exchange_strong(expected, WIS_QUEUED))
+    {
+        item->completed_ = false;
+        numPending_[item->band_].fetch_add(1, std::memory_order_relaxed);
+        if (threads_.Size())
+            Resume();
+        return;
+    }
+    if (expected == WIS_RETIRED)
+    {
+        // The retiring thread may not have published the item yet. Wait until it does, otherwise the item would be
+        // pushed to the completed list while queued again
+        while (!ReclaimRemoved(item.Get()))
+            Time::Sleep(0);
+    }
+
+    // Check for duplicate items
+    if (item->state_ != WIS_IDLE)
+    {
+        URHO3D_LOGERROR("Work item submitted to the work queue while still queued");
+        return;
+    }
 
-    // Push to the main thread list to keep item alive
+    // Keep item alive until purged
     // Clear completed flag in case item is reused
-    workItems_.Push(item);
+    item->AddRef();
     item->completed_ = false;
+    item->state_ = WIS_QUEUED;
 
-    // Make sure worker threads' list is safe to modify
-    if (threads_.Size() && !paused_)
-        queueMutex_.Acquire();
+    i32 band = item->priority_ == WI_MAX_PRIORITY ? WPB_HIGH : (item->priority_ > 0 ? WPB_NORMAL :
+        (item->priority_ == 0 ? WPB_LOW : WPB_BACKGROUND));
+    item->band_ = (u8)band;
+    numPending_[band].fetch_add(1, std::memory_order_relaxed);
 
-    // Find position for new item
-    if (queue_.Empty())
-        queue_.Push(item);
-    else
-    {
-        bool inserted = false;
-
-        for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
-        {
-            if ((*i)->priority_ <= item->priority_)
-            {
-                queue_.Insert(i, item);
-                inserted = true;
-                break;
-            }
-        }
-
-        if (!inserted)
-            queue_.Push(item);
-    }
+    // Distribute items round-robin so that each worker thread mostly steals from its own deque
+    i32 numDeques = deques_[band].Size();
+    deques_[band][nextDeque_ % numDeques]->Push(item.Get());
+    nextDeque_ = (nextDeque_ + 1) % numDeques;
 
     if (threads_.Size())
-    {
-        queueMutex_.Release();
-        paused_ = false;
-    }
+        Resume();
 }
 
 bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
@@ -164,44 +333,24 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
     if (!item)
         return false;
 
-    MutexLock lock(queueMutex_);
-
-    // Can only remove successfully if the item was not yet taken by threads for execution
-    List<WorkItem*>::Iterator i = queue_.Find(item.Get());
-    if (i != queue_.End())
-    {
-        List<SharedPtr<WorkItem>>::Iterator j = workItems_.Find(item);
-        if (j != workItems_.End())
-        {
-            queue_.Erase(i);
-            ReturnToPool(item);
-            workItems_.Erase(j);
-            return true;
-        }
-    }
+    // Can only remove successfully if the item was not yet taken by threads for execution.
+    // The item is recycled once its stale deque entry has been dropped
+    u8 expected = WIS_QUEUED;
+    if (!item->state_.compare_exchange_strong(expected, WIS_REMOVED))
+        return false;
 
-    return false;
+    numPending_[item->band_].fetch_sub(1, std::memory_order_release);
+    return true;
 }
 
 i32 WorkQueue::RemoveWorkItems(const Vector<SharedPtr<WorkItem>>& items)
 {
-    MutexLock lock(queueMutex_);
     i32 removed = 0;
 
     for (Vector<SharedPtr<WorkItem>>::ConstIterator i = items.Begin(); i != items.End(); ++i)
     {
-        List<WorkItem*>::Iterator j = queue_.Find(i->Get());
-        if (j != queue_.End())
-        {
-            List<SharedPtr<WorkItem>>::Iterator k = workItems_.Find(*i);
-            if (k != workItems_.End())
-            {
-                queue_.Erase(j);
-                ReturnToPool(*k);
-                workItems_.Erase(k);
-                ++removed;
-            }
-        }
+        if (RemoveWorkItem(*i))
+            ++removed;
     }
 
     return removed;
@@ -211,12 +360,8 @@ void WorkQueue::Pause()
 {
     if (!paused_)
     {
-        pausing_ = true;
-
-        queueMutex_.Acquire();
+        pauseMutex_.Acquire();
         paused_ = true;
-
-        pausing_ = false;
     }
 }
 
@@ -224,8 +369,8 @@ void WorkQueue::Resume()
 {
     if (paused_)
     {
-        queueMutex_.Release();
         paused_ = false;
+        pauseMutex_.Release();
     }
 }
 
@@ -235,100 +380,190 @@ void WorkQueue::Complete(i32 priority)
     assert(priority >= 0);
     completing_ = true;
 
+    i32 lastBand = GetLastBand(priority);
+
     if (threads_.Size())
     {
         Resume();
 
-        // Take work items also in the main thread until queue empty or no high-priority items anymore
-        while (!queue_.Empty())
-        {
-            queueMutex_.Acquire();
-            if (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-            {
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
-            }
-            else
-            {
-                queueMutex_.Release();
-                break;
-            }
-        }
-
-        // Wait for threaded work to complete
+        // Take work items also in the main thread until no high-priority items are left, then wait for threaded work to complete
         while (!IsCompleted(priority))
         {
+            if (WorkItem* item = TakeItem(0, lastBand))
+                ExecuteItem(item, 0);
         }
 
         // If no work at all remaining, pause worker threads by leaving the mutex locked
-        if (queue_.Empty())
+        if (!HasPendingItems())
             Pause();
     }
     else
     {
         // No worker threads: ensure all high-priority items are completed in the main thread
-        while (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-        {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
-        }
+        while (WorkItem* item = TakeItem(0, lastBand))
+            ExecuteItem(item, 0);
     }
 
     PurgeCompleted(priority);
     completing_ = false;
 }
 
+void WorkQueue::ParallelFor(void* begin, i32 count, i32 stride, void (* workFunction)(const WorkItem*, i32), void* aux, i32 minItems)
+{
+    assert(stride > 0);
+    if (count <= 0)
+        return;
+
+    // A few items per thread lets faster threads steal the remainder of a slower one
+    i32 numItems = Min(count / Max(minItems, 1), (GetNumThreads() + 1) * 4);
+    numItems = Max(numItems, 1);
+    i32 itemsPerWorkItem = count / numItems;
+    i32 remainder = count % numItems;
+
+    auto* start = static_cast<u8*>(begin);
+    for (i32 i = 0; i < numItems; ++i)
+    {
+        u8* end = start + (itemsPerWorkItem + (i < remainder ? 1 : 0)) * stride;
+
+        SharedPtr<WorkItem> item = GetFreeItem();
+        item->priority_ = WI_MAX_PRIORITY;
+        item->workFunction_ = workFunction;
+        item->aux_ = aux;
+        item->start_ = start;
+        item->end_ = end;
+        AddWorkItem(item);
+
+        start = end;
+    }
+
+    Complete(WI_MAX_PRIORITY);
+}
+
 bool WorkQueue::IsCompleted(i32 priority) const
 {
     assert(priority >= 0);
-    for (List<SharedPtr<WorkItem>>::ConstIterator i = workItems_.Begin(); i != workItems_.End(); ++i)
+
+    // Bands are tracked with counters, so completion of a priority between the band limits also waits for the rest of its band
+    i32 lastBand = GetLastBand(priority);
+    for (i32 band = 0; band <= lastBand; ++band)
     {
-        if ((*i)->priority_ >= priority && !(*i)->completed_)
+        if (numPending_[band].load(std::memory_order_acquire) > 0)
             return false;
     }
 
-    return true;
+    return numPublishing_.load(std::memory_order_acquire) == 0;
 }
 
-void WorkQueue::ProcessItems(i32 threadIndex)
+i32 WorkQueue::GetLastBand(i32 priority)
 {
-    assert(threadIndex >= 0);
+    if (priority == WI_MAX_PRIORITY)
+        return WPB_HIGH;
+    else if (priority > 0)
+        return WPB_NORMAL;
+    else
+        return WPB_LOW;
+}
+
+bool WorkQueue::HasPendingItems() const
+{
+    for (i32 band = 0; band < MAX_WORK_PRIORITY_BANDS; ++band)
+    {
+        if (numPending_[band].load(std::memory_order_acquire) > 0)
+            return true;
+    }
+
+    return numPublishing_.load(std::memory_order_acquire) > 0;
+}
+
+WorkItem* WorkQueue::TakeItem(i32 threadIndex, i32 lastBand)
+{
+    for (i32 band = 0; band <= lastBand; ++band)
+    {
+        const Vector<SharedPtr<WorkStealingDeque>>& deques = deques_[band];
+        i32 numDeques = deques.Size();
+
+        for (i32 i = 0; i < numDeques; ++i)
+        {
+            WorkStealingDeque* deque = deques[(threadIndex + i) % numDeques];
+            if (deque->IsEmpty())
+                continue;
 
-    bool wasActive = false;
+            WorkItem* item = threadIndex == 0 ? deque->Pop() : deque->Steal();
+            if (item)
+                return item;
+        }
+    }
+
+    return nullptr;
+}
 
+void WorkQueue::ExecuteItem(WorkItem* item, i32 threadIndex)
+{
+    // The band is cached, as the item must not be touched once published to the completed list
+    i32 band = item->band_;
+
+    // Claim the item. If it was removed after being queued, retire it instead, unless the main thread revives it concurrently
     for (;;)
     {
-        if (shutDown_)
+        u8 expected = WIS_QUEUED;
+        if (item->state_.compare_exchange_strong(expected, WIS_RUNNING, std::memory_order_acq_rel))
+            break;
+
+        if (expected != WIS_REMOVED)
+        {
+            // Stale entry of an item that is not queued. Should not happen, drop it rather than spin
             return;
+        }
 
-        if (pausing_ && !wasActive)
-            Time::Sleep(0);
-        else
+        numPublishing_.fetch_add(1, std::memory_order_acq_rel);
+        if (item->state_.compare_exchange_strong(expected, WIS_RETIRED, std::memory_order_acq_rel))
         {
-            queueMutex_.Acquire();
-            if (!queue_.Empty())
-            {
-                wasActive = true;
+            // Hand over to the main thread for purging. AddWorkItem() waits for the push before adding it again
+            PushCompleted(item, band);
+            numPublishing_.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        numPublishing_.fetch_sub(1, std::memory_order_release);
+    }
 
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
-            }
-            else
-            {
-                wasActive = false;
+    item->workFunction_(item, threadIndex);
+    item->completed_ = true;
 
-                queueMutex_.Release();
-                Time::Sleep(0);
-            }
+    // Count the item as publishing while it is neither pending nor on the completed list, so that Complete() still purges it
+    numPublishing_.fetch_add(1, std::memory_order_acq_rel);
+    numPending_[band].fetch_sub(1, std::memory_order_release);
+    PushCompleted(item, band);
+    numPublishing_.fetch_sub(1, std::memory_order_release);
+}
+
+void WorkQueue::PushCompleted(WorkItem* item, i32 band)
+{
+    std::atomic<WorkItem*>& completed = completedItems_[band];
+    item->nextCompleted_ = completed.load(std::memory_order_relaxed);
+    while (!completed.compare_exchange_weak(item->nextCompleted_, item, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+void WorkQueue::ProcessItems(i32 threadIndex)
+{
+    assert(threadIndex >= 0);
+
+    for (;;)
+    {
+        if (shutDown_)
+            return;
+
+        if (WorkItem* item = TakeItem(threadIndex, MAX_WORK_PRIORITY_BANDS - 1))
+            ExecuteItem(item, threadIndex);
+        else if (paused_)
+        {
+            // Block until resumed
+            pauseMutex_.Acquire();
+            pauseMutex_.Release();
         }
+        else
+            Time::Sleep(0);
     }
 }
 
@@ -338,26 +573,85 @@ void WorkQueue::PurgeCompleted(i32 priority)
 
     // Purge completed work items and send completion events. Do not signal items lower than priority threshold,
     // as those may be user submitted and lead to eg. scene manipulation that could happen in the middle of the
-    // render update, which is not allowed
-    for (List<SharedPtr<WorkItem>>::Iterator i = workItems_.Begin(); i != workItems_.End();)
+    // render update, which is not allowed. Negative priority items are signaled together with zero priority items
+    i32 lastBand = priority ? GetLastBand(priority) : MAX_WORK_PRIORITY_BANDS - 1;
+    for (i32 band = 0; band <= lastBand; ++band)
     {
-        if ((*i)->completed_ && (*i)->priority_ >= priority)
+        WorkItem* item = completedItems_[band].exchange(nullptr, std::memory_order_acquire);
+        WorkItem* keep = nullptr;
+
+        while (item)
         {
-            if ((*i)->sendEvent_)
-            {
-                using namespace WorkItemCompleted;
+            WorkItem* next = item->nextCompleted_;
 
-                VariantMap& eventData = GetEventDataMap();
-                eventData[P_ITEM] = i->Get();
-                SendEvent(E_WORKITEMCOMPLETED, eventData);
+            if (Max(item->priority_, 0) >= priority || item->state_ == WIS_RETIRED)
+            {
+                if (item->sendEvent_ && item->state_ == WIS_RUNNING)
+                {
+                    using namespace WorkItemCompleted;
+
+                    VariantMap& eventData = GetEventDataMap();
+                    eventData[P_ITEM] = item;
+                    SendEvent(E_WORKITEMCOMPLETED, eventData);
+                }
+
+                item->state_ = WIS_IDLE;
+                SharedPtr<WorkItem> ptr(item);
+                item->ReleaseRef();
+                ReturnToPool(ptr);
+            }
+            else
+            {
+                item->nextCompleted_ = keep;
+                keep = item;
             }
 
-            ReturnToPool(*i);
-            i = workItems_.Erase(i);
+            item = next;
+        }
+
+        // Put back items below the priority threshold, they are signaled on a later purge
+        while (keep)
+        {
+            WorkItem* next = keep->nextCompleted_;
+            PushCompleted(keep, keep->band_);
+            keep = next;
+        }
+    }
+}
+
+bool WorkQueue::ReclaimRemoved(WorkItem* item)
+{
+    // Take the item out of the completed list of its band without returning it to the pool, as it is being added again
+    WorkItem* current = completedItems_[item->band_].exchange(nullptr, std::memory_order_acquire);
+    WorkItem* keep = nullptr;
+    bool found = false;
+
+    while (current)
+    {
+        WorkItem* next = current->nextCompleted_;
+        if (current != item)
+        {
+            current->nextCompleted_ = keep;
+            keep = current;
         }
         else
-            ++i;
+            found = true;
+        current = next;
+    }
+
+    while (keep)
+    {
+        WorkItem* next = keep->nextCompleted_;
+        PushCompleted(keep, keep->band_);
+        keep = next;
     }
+
+    if (!found)
+        return false;
+
+    item->state_ = WIS_IDLE;
+    item->ReleaseRef();
+    return true;
 }
 
 void WorkQueue::PurgePool()
@@ -396,18 +690,18 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
 void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
     // If no worker threads, complete low-priority work here
-    if (threads_.Empty() && !queue_.Empty())
+    if (threads_.Empty() && HasPendingItems())
     {
         URHO3D_PROFILE(CompleteWorkNonthreaded);
 
         HiresTimer timer;
 
-        while (!queue_.Empty() && timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
+        while (timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
         {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            WorkItem* item = TakeItem(0, MAX_WORK_PRIORITY_BANDS - 1);
+            if (!item)
+                break;
+            ExecuteItem(item, 0);
         }
     }
 
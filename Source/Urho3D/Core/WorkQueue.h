@@ -20,7 +20,22 @@ URHO3D_EVENT(E_WORKITEMCOMPLETED, WorkItemCompleted)
 
 inline constexpr i32 WI_MAX_PRIORITY = M_MAX_INT;
 
+/// Priority bands of the work queue. Items are scheduled band by band; order inside a band is not guaranteed.
+enum WorkPriorityBand
+{
+    /// Items with WI_MAX_PRIORITY, usually rendering work completed within the same frame.
+    WPB_HIGH = 0,
+    /// Items with a positive priority below WI_MAX_PRIORITY.
+    WPB_NORMAL,
+    /// Items with zero priority.
+    WPB_LOW,
+    /// Items with negative priority. Not waited for by Complete() or IsCompleted(), which require a non-negative priority.
+    WPB_BACKGROUND,
+    MAX_WORK_PRIORITY_BANDS
+};
+
 class WorkerThread;
+class WorkStealingDeque;
 
 /// Work queue item.
 /// @nobind
@@ -45,7 +60,13 @@ public:
     std::atomic<bool> completed_{};
 
 private:
+    /// Scheduling state, claimed atomically by either the executing thread or RemoveWorkItem().
+    std::atomic<u8> state_{};
+    /// Priority band the item was queued in.
+    u8 band_{};
     bool pooled_{};
+    /// Next item in the lock-free completed list of the work queue.
+    WorkItem* nextCompleted_{};
 };
 
 /// Work queue subsystem for multithreading.
@@ -65,7 +86,7 @@ public:
     void CreateThreads(i32 numThreads);
     /// Get pointer to an usable WorkItem from the item pool. Allocate one if no more free items.
     SharedPtr<WorkItem> GetFreeItem();
-    /// Add a work item and resume worker threads.
+    /// Add a work item and resume worker threads. A removed item may be added again right away; if it had not yet been dropped from its queue, it keeps its original queue position and priority band.
     void AddWorkItem(const SharedPtr<WorkItem>& item);
     /// Remove a work item before it has started executing. Return true if successfully removed.
     bool RemoveWorkItem(SharedPtr<WorkItem> item);
@@ -77,6 +98,14 @@ public:
     void Resume();
     /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
     void Complete(i32 priority);
+    /// Split an array into work items of at least minItems elements and complete them with WI_MAX_PRIORITY on worker threads and the main thread. Each item receives its sub-range in start_ and end_, and the aux pointer in aux_.
+    /// Must only be called from the main thread, like AddWorkItem() and Complete(), and not from inside a work function.
+    template <class T> void ParallelFor(T* begin, T* end, void (* workFunction)(const WorkItem*, i32), void* aux = nullptr, i32 minItems = 1)
+    {
+        ParallelFor(begin, (i32)(end - begin), (i32)sizeof(T), workFunction, aux, minItems);
+    }
+    /// Split a raw array of count elements of stride bytes into work items and complete them. See the typed overload.
+    void ParallelFor(void* begin, i32 count, i32 stride, void (* workFunction)(const WorkItem*, i32), void* aux, i32 minItems);
 
     /// Set the pool telerance before it starts deleting pool items.
     void SetTolerance(int tolerance) { tolerance_ = tolerance; }
@@ -87,7 +116,7 @@ public:
     /// Return number of worker threads.
     i32 GetNumThreads() const { return threads_.Size(); }
 
-    /// Return whether all work with at least the specified priority is finished.
+    /// Return whether all work with at least the specified priority is finished. The priority must not be negative.
     bool IsCompleted(i32 priority) const;
     /// Return whether the queue is currently completing work in the main thread.
     bool IsCompleting() const { return completing_; }
@@ -101,6 +130,18 @@ public:
 private:
     /// Process work items until shut down. Called by the worker threads.
     void ProcessItems(i32 threadIndex);
+    /// Take the next item of the highest non-empty band up to lastBand. The main thread pops from the bottom of any deque, worker threads steal from their own deque first and then from the others.
+    WorkItem* TakeItem(i32 threadIndex, i32 lastBand);
+    /// Execute a taken item unless it was removed, then hand it over to PurgeCompleted().
+    void ExecuteItem(WorkItem* item, i32 threadIndex);
+    /// Push an item to the completed list of the specified band. Lock-free, called from any thread.
+    void PushCompleted(WorkItem* item, i32 band);
+    /// Return the last band that may hold items with at least the specified priority.
+    static i32 GetLastBand(i32 priority);
+    /// Return whether any band, including negative priority items, has queued or executing items.
+    bool HasPendingItems() const;
+    /// Reclaim a removed item which has already been dropped from its queue, so that it can be added again. Return false if the dropping thread has not published it to the completed list yet.
+    bool ReclaimRemoved(WorkItem* item);
     /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
     void PurgeCompleted(i32 priority);
     /// Purge the pool to reduce allocation where its unneeded.
@@ -114,18 +155,22 @@ private:
     Vector<SharedPtr<WorkerThread>> threads_;
     /// Work item pool for reuse to cut down on allocation. The bool is a flag for item pooling and whether it is available or not.
     List<SharedPtr<WorkItem>> poolItems_;
-    /// Work item collection. Accessed only by the main thread.
-    List<SharedPtr<WorkItem>> workItems_;
-    /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems).
-    List<WorkItem*> queue_;
-    /// Worker queue mutex.
-    Mutex queueMutex_;
+    /// Work-stealing deques per priority band, one for the main thread and one for each worker thread. Only the main thread pushes and pops at the bottom; worker threads steal from the top.
+    Vector<SharedPtr<WorkStealingDeque>> deques_[MAX_WORK_PRIORITY_BANDS];
+    /// Number of queued or executing items per band. Items are kept alive by an added reference until purged.
+    std::atomic<i32> numPending_[MAX_WORK_PRIORITY_BANDS];
+    /// Lock-free lists of executed or removed items per band, waiting to be purged by the main thread.
+    std::atomic<WorkItem*> completedItems_[MAX_WORK_PRIORITY_BANDS];
+    /// Number of items being published to the completed lists. Such items are no longer counted as pending.
+    std::atomic<i32> numPublishing_;
+    /// Deque that receives the next added item.
+    i32 nextDeque_;
+    /// Pause mutex. Kept locked while paused so that idle worker threads block on it.
+    Mutex pauseMutex_;
     /// Shutting down flag.
     std::atomic<bool> shutDown_;
-    /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
-    std::atomic<bool> pausing_;
-    /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-    bool paused_;
+    /// Paused flag. Indicates the pause mutex being locked to prevent worker threads using up CPU time.
+    std::atomic<bool> paused_;
     /// Completing work in the main thread flag.
     bool completing_;
     /// Tolerance for the shared pool before it begins to deallocate.
@@ -1346,6 +1346,42 @@ bool Graphics::BgfxDrawQuads(const void* qvertices, int numVertices, Texture2D*
     return bgfx_->DrawQuads(qvertices, numVertices, texture, cache, mvp);
 }
 
+bool Graphics::BgfxDrawQuadBatches(const BgfxQuadBatch* batches, unsigned numBatches, const Matrix4& mvp)
+{
+    if (!bgfx_)
+        return false;
+    auto* cache = GetSubsystem<ResourceCache>();
+    return bgfx_->DrawQuadBatches(batches, numBatches, cache, mvp);
+}
+
+unsigned short Graphics::BgfxCreateQuadVertexPool(unsigned numVertices)
+{
+    if (!bgfx_)
+        return 0xFFFF;
+    return bgfx_->CreateQuadVertexPool(numVertices);
+}
+
+void Graphics::BgfxDestroyQuadVertexPool(unsigned short pool)
+{
+    if (bgfx_)
+        bgfx_->DestroyQuadVertexPool(pool);
+}
+
+bool Graphics::BgfxUpdateQuadVertexPool(unsigned short pool, unsigned startVertex, const void* vertices, unsigned numVertices)
+{
+    if (!bgfx_)
+        return false;
+    return bgfx_->UpdateQuadVertexPool(pool, startVertex, vertices, numVertices);
+}
+
+bool Graphics::BgfxDrawQuadPoolBatches(unsigned short pool, const BgfxQuadBatch* batches, unsigned numBatches, const Matrix4& mvp)
+{
+    if (!bgfx_)
+        return false;
+    auto* cache = GetSubsystem<ResourceCache>();
+    return bgfx_->DrawQuadPoolBatches(pool, batches, numBatches, cache, mvp);
+}
+
 bool Graphics::BgfxDrawTriangles(const void* tvertices, int numVertices, const Matrix4& mvp)
 {
     if (!bgfx_)
@@ -1380,6 +1416,14 @@ bool Graphics::BgfxDrawUIWithMaterial(const float* vertices, int numVertices, Ma
     return bgfx_->DrawUIWithMaterial(vertices, numVertices, material, cache, mvp);
 }
 
+bool Graphics::BgfxDrawUIBatches(const BgfxUIBatch* batches, unsigned numBatches, const Matrix4& mvp)
+{
+    if (!bgfx_)
+        return false;
+    auto* cache = GetSubsystem<ResourceCache>();
+    return bgfx_->DrawUIBatches(batches, numBatches, cache, mvp);
+}
+
 void Graphics::BgfxSet2DLights(const Vector<Vector4>& posRange, const Vector<Vector4>& colorInt, int count, float ambient)
 {
     if (!bgfx_)
@@ -1433,6 +1477,13 @@ bool Graphics::BeginUIDraw(RenderSurface* surface, int targetWidth, int targetHe
     return false;
 }
 
+bool Graphics::BgfxQueueTextureUpload(Texture2D* texture, Image* image, bool useAlpha)
+{
+    if (!bgfx_)
+        return false;
+    return bgfx_->QueueTextureUpload(texture, image, useAlpha);
+}
+
 void Graphics::BgfxReleaseTexture(Texture2D* texture)
 {
     if (!bgfx_)
@@ -1440,6 +1491,32 @@ void Graphics::BgfxReleaseTexture(Texture2D* texture)
     bgfx_->ReleaseTexture(texture);
 }
 
+void Graphics::SetTextureUploadBudget(unsigned bytesPerFrame)
+{
+    if (bgfx_)
+        bgfx_->SetTextureUploadBudget(bytesPerFrame);
+}
+
+unsigned Graphics::GetTextureUploadBudget() const
+{
+    return bgfx_ ? bgfx_->GetTextureUploadBudget() : 0;
+}
+
+unsigned Graphics::GetNumPendingTextureUploads() const
+{
+    return bgfx_ ? bgfx_->GetNumPendingTextureUploads() : 0;
+}
+
+unsigned long long Graphics::GetPendingTextureUploadBytes() const
+{
+    return bgfx_ ? bgfx_->GetPendingTextureUploadBytes() : 0;
+}
+
+unsigned long long Graphics::GetUploadedTextureBytes() const
+{
+    return bgfx_ ? bgfx_->GetUploadedTextureBytes() : 0;
+}
+
 bool Graphics::BgfxUpdateTextureRegion(Texture2D* texture, int x, int y, int width, int height, const void* data, unsigned level)
 {
     if (!bgfx_)
@@ -26,6 +26,7 @@ class File;
 class Image;
 class IndexBuffer;
 class GPUObject;
+class Material;
 class RenderSurface;
 class Shader;
 class ShaderPrecache;
@@ -107,6 +108,38 @@ struct ScreenModeParams
     bool operator !=(const ScreenModeParams& rhs) const { return !(*this == rhs); }
 };
 
+/// One source range for merged BGFX quad submission (Vertex2D / SpriteBatch QVertex layout, 4 vertices per quad).
+struct BgfxQuadBatch
+{
+    /// Vertex data.
+    const void* vertices_{};
+    /// Number of vertices, a multiple of 4.
+    unsigned numVertices_{};
+    /// Texture. Null uses the white texture.
+    Texture2D* texture_{};
+    /// Blend mode.
+    BlendMode blendMode_{BLEND_ALPHA};
+    /// Start vertex in a persistent quad vertex pool. Only used by BgfxDrawQuadPoolBatches().
+    unsigned poolStart_{};
+};
+
+/// One source range for merged BGFX UI submission (UI_VERTEX_SIZE triangle list layout).
+struct BgfxUIBatch
+{
+    /// Vertex data.
+    const float* vertices_{};
+    /// Number of vertices, a multiple of 3.
+    unsigned numVertices_{};
+    /// Texture. Null uses the white texture.
+    Texture2D* texture_{};
+    /// Custom material. Batches with a material are never merged.
+    Material* material_{};
+    /// Blend mode.
+    BlendMode blendMode_{BLEND_ALPHA};
+    /// Scissor rectangle in pixels.
+    IntRect scissor_;
+};
+
 /// Window mode parameters.
 struct WindowModeParams
 {
@@ -332,6 +365,16 @@ public:
     void DebugDrawBgfxHello();
     /// 使用 bgfx 提交四边形批次（SpriteBatch 用）。
     bool BgfxDrawQuads(const void* qvertices, int numVertices, Texture2D* texture, const Matrix4& mvp);
+    /// 使用 bgfx 合并提交一组四边形批次：整组共用一个 transient 顶点缓冲，仅在纹理/混合模式变化时产生 drawcall（Urho2D 用）。
+    bool BgfxDrawQuadBatches(const BgfxQuadBatch* batches, unsigned numBatches, const Matrix4& mvp);
+    /// 创建常驻四边形顶点池（Vertex2D 布局），返回句柄；不支持时返回 0xFFFF，调用方应回落到 BgfxDrawQuadBatches。
+    unsigned short BgfxCreateQuadVertexPool(unsigned numVertices);
+    /// 销毁常驻四边形顶点池。
+    void BgfxDestroyQuadVertexPool(unsigned short pool);
+    /// 局部更新常驻四边形顶点池中的一段顶点。
+    bool BgfxUpdateQuadVertexPool(unsigned short pool, unsigned startVertex, const void* vertices, unsigned numVertices);
+    /// 使用常驻顶点池合并提交一组四边形批次：批次以 poolStart_ 引用池内顶点，每帧仅生成索引（Urho2D 用）。
+    bool BgfxDrawQuadPoolBatches(unsigned short pool, const BgfxQuadBatch* batches, unsigned numBatches, const Matrix4& mvp);
     /// 使用 bgfx 提交三角形批次（SpriteBatch 用）。
     bool BgfxDrawTriangles(const void* tvertices, int numVertices, const Matrix4& mvp);
     /// 使用 bgfx 提交 UI 顶点（按 UI_VERTEX_SIZE 布局的三角形列表）。
@@ -339,10 +382,25 @@ public:
     bool BgfxDrawColored(PrimitiveType prim, const float* vertices, int numVertices, const Matrix4& mvp);
     /// 使用 bgfx 提交 UI 顶点并应用自定义材质（绑定贴图与 uniform）。
     bool BgfxDrawUIWithMaterial(const float* vertices, int numVertices, class Material* material, const Matrix4& mvp);
+    /// 使用 bgfx 合并提交一组 UI 批次：整组共用一个 transient 顶点缓冲，仅在纹理/混合模式/裁剪变化时产生 drawcall。
+    /// transient 空间不足时返回 false 且不提交任何批次，调用方应回落到逐批次提交。
+    bool BgfxDrawUIBatches(const BgfxUIBatch* batches, unsigned numBatches, const Matrix4& mvp);
     /// 从 Image 直接创建 BGFX 纹理（用于字体/临时纹理），并缓存句柄到内部映射。
     bool BgfxCreateTextureFromImage(Texture2D* texture, Image* image, bool useAlpha);
+    /// 排队上传 Image 到 BGFX 纹理：未设置上传预算时立即创建，否则在之后的帧按预算上传。
+    bool BgfxQueueTextureUpload(Texture2D* texture, Image* image, bool useAlpha);
     /// 释放由 BGFX 创建的纹理（若存在）。
     void BgfxReleaseTexture(Texture2D* texture);
+    /// 设置每帧纹理上传预算（字节，0 = 不限制）。启用后纹理在工作线程解码、分帧上传，就绪前以透明占位纹理绘制。
+    void SetTextureUploadBudget(unsigned bytesPerFrame);
+    /// 返回每帧纹理上传预算。
+    unsigned GetTextureUploadBudget() const;
+    /// 返回正在解码或等待上传的纹理数量。
+    unsigned GetNumPendingTextureUploads() const;
+    /// 返回等待上传的纹理字节数。
+    unsigned long long GetPendingTextureUploadBytes() const;
+    /// 返回累计上传的纹理字节数。
+    unsigned long long GetUploadedTextureBytes() const;
     /// BGFX：更新纹理子矩形（数据应为 RGBA8；若纹理为 A8 将自动扩展）。
     bool BgfxUpdateTextureRegion(Texture2D* texture, int x, int y, int width, int height, const void* data, unsigned level = 0);
     /// 运行时切换“默认离屏渲染 + backbuffer 呈现”方案（默认 false）。
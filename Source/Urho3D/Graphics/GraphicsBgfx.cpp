@@ -6,13 +6,11 @@
 #include "GraphicsBgfx.h"
 #include "BgfxSDLPlatform.h"
 #include "BgfxMiAllocator.h"
-#include "BgfxCustomAllocator.h"
 
 #include <bgfx/bgfx.h>
 #include <bgfx/platform.h>
 #include <algorithm>
 #include <vector>
-#include <bimg/decode.h>
 #include <bx/allocator.h>
 #include <cstdio>
 
@@ -22,7 +20,9 @@
 #include "../Resource/Image.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Material.h"
+#include "../Core/Timer.h"
 #include "../Core/Variant.h"
+#include "../Core/WorkQueue.h"
 #include "../Container/Vector.h"
 #include "../IO/Log.h"
 // bgfx 头在上方已包含
@@ -30,6 +30,23 @@
 namespace Urho3D
 {
 
+// 常用顶点布局：pos(3f) + color0(ub4n) [+ texcoord0(2f)]，在 Initialize 中构建一次，避免每次提交重复构建
+static bgfx::VertexLayout posColorTexLayout;
+static bgfx::VertexLayout posColorLayout;
+
+static void InitVertexLayouts()
+{
+    posColorTexLayout.begin()
+        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
+        .add(bgfx::Attrib::TexCoord0,2, bgfx::AttribType::Float)
+        .end();
+    posColorLayout.begin()
+        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
+        .end();
+}
+
 GraphicsBgfx::GraphicsBgfx() = default;
 
 GraphicsBgfx::~GraphicsBgfx()
@@ -62,6 +79,8 @@ bool GraphicsBgfx::Initialize(void* nativeWindowHandle, unsigned width, unsigned
     if (!bgfx::init(init))
         return false;
 
+    InitVertexLayouts();
+
     // 设定默认视图（id=0），清屏并设置视口。
     bgfx::setViewClear(0, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x000000ffu, 1.0f, 0);
     bgfx::setViewRect(0, 0, 0, static_cast<uint16_t>(width_), static_cast<uint16_t>(height_));
@@ -87,6 +106,26 @@ void GraphicsBgfx::Shutdown()
         if (bgfx::isValid(fh)) bgfx::destroy(fh);
     }
     fbCache_.clear();
+    if (quadIndexBuffer_ != bgfx::kInvalidHandle)
+    {
+        bgfx::IndexBufferHandle ih; ih.idx = quadIndexBuffer_;
+        if (bgfx::isValid(ih)) bgfx::destroy(ih);
+        quadIndexBuffer_ = bgfx::kInvalidHandle;
+        quadIndexBufferQuads_ = 0;
+    }
+    if (linearIndexBuffer_ != bgfx::kInvalidHandle)
+    {
+        bgfx::IndexBufferHandle ih; ih.idx = linearIndexBuffer_;
+        if (bgfx::isValid(ih)) bgfx::destroy(ih);
+        linearIndexBuffer_ = bgfx::kInvalidHandle;
+        linearIndexBufferSize_ = 0;
+    }
+    for (unsigned short pool : quadVertexPools_)
+    {
+        bgfx::DynamicVertexBufferHandle vh; vh.idx = pool;
+        if (bgfx::isValid(vh)) bgfx::destroy(vh);
+    }
+    quadVertexPools_.clear();
     if (ui_.whiteTex != bgfx::kInvalidHandle)
     {
         bgfx::TextureHandle wh; wh.idx = ui_.whiteTex;
@@ -142,7 +181,31 @@ void GraphicsBgfx::Shutdown()
     for (auto& kv : samplerCache_){ bgfx::UniformHandle u{kv.second}; if (bgfx::isValid(u)) bgfx::destroy(u);} samplerCache_.clear();
     for (auto& kv : vec4Cache_){ bgfx::UniformHandle u{kv.second}; if (bgfx::isValid(u)) bgfx::destroy(u);} vec4Cache_.clear();
     for (auto& kv : mat4Cache_){ bgfx::UniformHandle u{kv.second}; if (bgfx::isValid(u)) bgfx::destroy(u);} mat4Cache_.clear();
+    alphaTextures_.clear();
+    // 等待后台解码结束（解码数据由工作函数引用），丢弃未上传的纹理
+    for (auto& decode : textureDecodes_)
+    {
+        WorkQueue* queue = decode->queue_;
+        if (queue && !queue->RemoveWorkItem(decode->item_))
+        {
+            while (!decode->item_->completed_)
+                Time::Sleep(0);
+        }
+    }
+    textureDecodes_.clear();
+    textureUploads_.clear();
+    streamingTextures_.clear();
+    failedTextures_.clear();
+    pendingUploadBytes_ = 0;
+    if (placeholderTex_ != bgfx::kInvalidHandle)
+    {
+        bgfx::TextureHandle ph; ph.idx = placeholderTex_;
+        if (bgfx::isValid(ph)) bgfx::destroy(ph);
+        placeholderTex_ = bgfx::kInvalidHandle;
+    }
     bgfx::shutdown();
+    // shutdown 会释放所有尚未上传的 makeRef 内存
+    ReleasePendingImages();
     initialized_ = false;
     width_ = height_ = 0;
 }
@@ -162,6 +225,7 @@ void GraphicsBgfx::BeginFrame()
 {
     if (!initialized_)
         return;
+    ProcessTextureStreaming();
     // 确保默认视图与 UI 视图（31）在本帧有效，并设置 UI 视图到 backbuffer
     bgfx::touch(0);
     const uint16_t uiView = 31;
@@ -190,6 +254,7 @@ void GraphicsBgfx::EndFrame()
     if (!initialized_)
         return;
     bgfx::frame();
+    ReleasePendingImages();
 }
  
 bool GraphicsBgfx::InitializeFromSDL(void* sdlWindow, unsigned width, unsigned height)
@@ -247,6 +312,27 @@ void GraphicsBgfx::ApplyState()
     bgfx::setState(state_);
 }
 
+static uint64_t GetBgfxBlendState(BlendMode mode)
+{
+    switch (mode)
+    {
+    case BLEND_REPLACE: return 0; // 不设置混合位
+    case BLEND_ALPHA: return BGFX_STATE_BLEND_ALPHA;
+    case BLEND_ADD: return BGFX_STATE_BLEND_ADD;
+    case BLEND_MULTIPLY: return BGFX_STATE_BLEND_MULTIPLY;
+    case BLEND_PREMULALPHA:
+        return BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_ONE, BGFX_STATE_BLEND_INV_SRC_ALPHA);
+    case BLEND_ADDALPHA: return BGFX_STATE_BLEND_ADD; // 近似
+    case BLEND_INVDESTALPHA: return BGFX_STATE_BLEND_ALPHA; // 近似
+    case BLEND_SUBTRACT:
+        return BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_ONE, BGFX_STATE_BLEND_ONE) | BGFX_STATE_BLEND_EQUATION_SUB;
+    case BLEND_SUBTRACTALPHA:
+        // 近似：以 srcAlpha 权重相减
+        return BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_SRC_ALPHA, BGFX_STATE_BLEND_ONE) | BGFX_STATE_BLEND_EQUATION_SUB;
+    default: return 0;
+    }
+}
+
 void GraphicsBgfx::SetBlendMode(BlendMode mode, bool alphaToCoverage)
 {
     lastBlendMode_ = mode;
@@ -259,27 +345,7 @@ void GraphicsBgfx::SetBlendMode(BlendMode mode, bool alphaToCoverage)
     else
         state_ &= ~BGFX_STATE_BLEND_ALPHA_TO_COVERAGE;
 
-    switch (mode)
-    {
-    case BLEND_REPLACE: break; // 不设置混合位
-    case BLEND_ALPHA: state_ |= BGFX_STATE_BLEND_ALPHA; break;
-    case BLEND_ADD: state_ |= BGFX_STATE_BLEND_ADD; break;
-    case BLEND_MULTIPLY: state_ |= BGFX_STATE_BLEND_MULTIPLY; break;
-    case BLEND_PREMULALPHA:
-        state_ |= BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_ONE, BGFX_STATE_BLEND_INV_SRC_ALPHA);
-        break;
-    case BLEND_ADDALPHA: state_ |= BGFX_STATE_BLEND_ADD; break; // 近似
-    case BLEND_INVDESTALPHA: state_ |= BGFX_STATE_BLEND_ALPHA; break; // 近似
-    case BLEND_SUBTRACT:
-        state_ |= BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_ONE, BGFX_STATE_BLEND_ONE);
-        state_ |= BGFX_STATE_BLEND_EQUATION_SUB;
-        break;
-    case BLEND_SUBTRACTALPHA:
-        state_ |= BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_SRC_ALPHA, BGFX_STATE_BLEND_ONE);
-        state_ |= BGFX_STATE_BLEND_EQUATION_SUB;
-        break; // 近似：以 srcAlpha 权重相减
-    default: break;
-    }
+    state_ |= GetBgfxBlendState(mode);
 }
 
 void GraphicsBgfx::SetColorWrite(bool enable)
@@ -649,12 +715,7 @@ void GraphicsBgfx::DebugDrawHello()
         return;
 
     // 顶点声明：pos(3f), color0(ub4n), texcoord0(2f)
-    bgfx::VertexLayout layout;
-    layout.begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
-        .add(bgfx::Attrib::TexCoord0,2, bgfx::AttribType::Float)
-        .end();
+    const bgfx::VertexLayout& layout = posColorTexLayout;
 
     struct Vtx { float x,y,z; uint32_t abgr; float u,v; };
     const Vtx verts[4] = {
@@ -745,6 +806,28 @@ static uint64_t GetBgfxSamplerFlagsFromTexture(const Texture2D* tex)
     return flags;
 }
 
+uint64_t GraphicsBgfx::GetSamplerFlags(Texture2D* texture) const
+{
+    if (!texture)
+        return 0;
+
+    uint64_t flags = GetBgfxSamplerFlagsFromTexture(texture);
+    if (texture->GetFilterMode() == FILTER_TRILINEAR)
+    {
+        if (defaultFilter_ == FILTER_NEAREST)
+            flags |= (BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT | BGFX_SAMPLER_MIP_POINT);
+        else if (defaultFilter_ == FILTER_BILINEAR)
+            flags |= BGFX_SAMPLER_MIP_POINT;
+    }
+    if (texture->GetAnisotropy() <= 1 && defaultAniso_ > 1)
+    {
+#ifdef BGFX_SAMPLER_ANISOTROPIC
+        flags |= BGFX_SAMPLER_ANISOTROPIC;
+#endif
+    }
+    return flags;
+}
+
 unsigned short GraphicsBgfx::GetOrCreateTexture(Texture2D* tex, ResourceCache* cache)
 {
     if (!tex)
@@ -784,147 +867,37 @@ unsigned short GraphicsBgfx::GetOrCreateTexture(Texture2D* tex, ResourceCache* c
         return th.idx;
     }
 
-    // 采样纹理：优先根据纹理格式决定获取像素的方式，避免对非 RGBA/RGB 纹理调用 GetImage() 触发错误日志
-    const unsigned fmt = tex->GetFormat();
-    const unsigned alphaFmt = Graphics::GetAlphaFormat();
-    const unsigned rgbaFmt = Graphics::GetRGBAFormat();
-    const unsigned rgbFmt  = Graphics::GetRGBFormat();
-
-    uint32_t w = 0, h = 0;
-    const bgfx::Memory* mem = nullptr;
-
-    const uint64_t samplerFlags = GetBgfxSamplerFlagsFromTexture(tex);
-
-    if (fmt == alphaFmt)
+    // 采样纹理：正常情况下 Texture2D::EndLoad() 已用加载时解码的 Image 直接创建 bgfx 纹理。
+    // 只有在 bgfx 初始化之前加载的纹理会走到这里，此时从资源系统临时取得 Image（不常驻缓存）。
+    if (resName.Empty())
     {
-        // 单通道 Alpha 纹理：读取 A8 数据并扩展为 RGBA8(FFFFFF,A)
-        w = (uint32_t)tex->GetWidth();
-        h = (uint32_t)tex->GetHeight();
-        const uint32_t aSize = w * h; // A8
-        std::vector<unsigned char> a8(aSize);
-        if (!tex->GetData(0, a8.data()))
-        {
-            URHO3D_LOGERRORF("GetOrCreateTexture: Failed to get A8 data from texture %s", tex->GetName().CString());
-            return ui_.whiteTex;
-        }
-        std::vector<unsigned char> bgra; bgra.resize(w * h * 4u);
-        unsigned char* dst = bgra.data();
-        for (uint32_t i = 0; i < aSize; ++i)
-        {
-            const unsigned char a = a8[i];
-            // BGRA 排列：B,G,R = 255，A = alpha
-            dst[i*4 + 0] = 0xFF;
-            dst[i*4 + 1] = 0xFF;
-            dst[i*4 + 2] = 0xFF;
-            dst[i*4 + 3] = a;
-        }
-        mem = bgfx::copy(bgra.data(), (uint32_t)bgra.size());
+        // 未命名的运行时纹理（例如默认材质用的占位纹理），无可靠的源图像；返回白纹理，避免错误日志刷屏。
+        URHO3D_LOGDEBUG("GetOrCreateTexture: Unnamed runtime texture, fallback to whiteTex");
+        return ui_.whiteTex;
     }
-    else if (fmt == rgbaFmt || fmt == rgbFmt)
-    {
-        URHO3D_LOGDEBUGF("GetOrCreateTexture: Processing RGBA/RGB texture %s", resName.CString());
-        SharedPtr<Image> rgba;
-        // 优先从资源系统重新解码原始图片（避免依赖 GPU 回读）。仅当资源名非空才尝试。
-        if (cache && !resName.Empty())
-        {
-            SharedPtr<Image> src(cache->GetResource<Image>(resName));
-            if (src)
-            {
-                rgba = src->IsCompressed() ? src->GetDecompressedImage() : src;
-                if (rgba && rgba->GetComponents() != 4)
-                    rgba = rgba->ConvertToRGBA();
-            }
-        }
-        // 回退：尝试通过 Texture2D::GetImage（BGFX 下通常不可用），失败则用白纹理替代。
-        if (!rgba)
-        {
-            if (resName.Empty())
-            {
-                // 未命名的运行时纹理（例如默认材质用的占位纹理），无可靠的源图像；返回白纹理，避免错误日志刷屏。
-                URHO3D_LOGDEBUG("GetOrCreateTexture: Unnamed runtime texture, fallback to whiteTex");
-                return ui_.whiteTex;
-            }
-            else
-            {
-                SharedPtr<Image> img = tex->GetImage();
-                if (img)
-                {
-                    rgba = img->IsCompressed() ? img->GetDecompressedImage() : img;
-                    if (rgba && rgba->GetComponents() != 4)
-                        rgba = rgba->ConvertToRGBA();
-                }
-            }
-        }
-
-        if (!rgba)
-        {
-            URHO3D_LOGERRORF("GetOrCreateTexture: Failed to acquire RGBA image for %s", resName.CString());
-            return ui_.whiteTex;
-        }
+    if (failedTextures_.count(tex))
+        return ui_.whiteTex;
 
-        w = (uint32_t)rgba->GetWidth();
-        h = (uint32_t)rgba->GetHeight();
-        const uint32_t size = w * h * 4u;
-        mem = bgfx::copy(rgba->GetData(), size);
-    }
-    else
+    // 启用上传预算时不在绘制路径上同步解码：交给 WorkQueue 解码，就绪前使用占位纹理
+    if (textureUploadBudget_ && cache)
     {
-        // 其它格式（压缩/容器等）：尝试用 bimg 解码（支持 DDS/KTX/PVR），失败则回退白纹理
-        if (cache)
-        {
-            const String& resName = tex->GetName();
-            SharedPtr<File> f(cache->GetFile(resName));
-            if (f && f->IsOpen())
-            {
-                const unsigned fsize = (unsigned)f->GetSize();
-                if (fsize > 0)
-                {
-                    SharedArrayPtr<unsigned char> fbuf(new unsigned char[fsize]);
-                    f->Read(fbuf.Get(), fsize);
-
-                    BgfxCustomAllocator alloc;
-                    bimg::ImageContainer* ic = bimg::imageParse(&alloc, fbuf.Get(), fsize);
-                    if (ic)
-                    {
-                        const bool hasMips = ic->m_numMips > 1;
-                        const uint16_t numLayers = (uint16_t)ic->m_numLayers;
-                        const bgfx::TextureFormat::Enum bfmt = (bgfx::TextureFormat::Enum)ic->m_format;
-                        uint64_t tflags = 0;
-#ifdef BGFX_TEXTURE_SRGB
-                        if (tex->GetSRGB()) tflags |= BGFX_TEXTURE_SRGB;
-#endif
-                        const bgfx::Memory* tmem = bgfx::copy(ic->m_data, (uint32_t)ic->m_size);
-                        bgfx::TextureHandle th = bgfx::createTexture2D((uint16_t)ic->m_width, (uint16_t)ic->m_height, hasMips, numLayers, bfmt, tflags, tmem);
-                        bimg::imageFree(ic);
-                        if (bgfx::isValid(th))
-                        {
-                            textureCache_[tex] = th.idx;
-                            return th.idx;
-                        }
-                    }
-                }
-            }
-        }
-        return ui_.whiteTex;
+        if (!streamingTextures_.count(tex))
+            StartTextureDecode(tex, cache);
+        return failedTextures_.count(tex) ? ui_.whiteTex : GetStreamingPlaceholder();
     }
 
-    uint64_t tflags = 0;
-#ifdef BGFX_TEXTURE_SRGB
-    if (tex->GetSRGB()) tflags |= BGFX_TEXTURE_SRGB;
-#endif
-    bgfx::TextureHandle th = bgfx::createTexture2D(
-        (uint16_t)w, (uint16_t)h, false, 1,
-        bgfx::TextureFormat::RGBA8,
-        tflags,
-        mem);
-    if (!bgfx::isValid(th))
+    SharedPtr<Image> image;
+    if (cache)
+        image = cache->GetTempResource<Image>(resName, false);
+    if (!image || !CreateTextureFromImage(tex, image, false))
     {
-        URHO3D_LOGERRORF("GetOrCreateTexture: Failed to create bgfx texture for %s", tex->GetName().CString());
+        URHO3D_LOGERRORF("GetOrCreateTexture: Failed to create bgfx texture for %s", resName.CString());
+        failedTextures_.insert(tex);
         return ui_.whiteTex;
     }
-    URHO3D_LOGDEBUGF("GetOrCreateTexture: Successfully created bgfx texture for %s (handle=%u)", tex->GetName().CString(), th.idx);
-    textureCache_[tex] = th.idx;
-    return th.idx;
+
+    URHO3D_LOGDEBUGF("GetOrCreateTexture: Successfully created bgfx texture for %s (handle=%u)", resName.CString(), textureCache_[tex]);
+    return textureCache_[tex];
 }
 
 bool GraphicsBgfx::LoadUrho2DPrograms(ResourceCache* cache)
@@ -1156,6 +1129,8 @@ void GraphicsBgfx::ReleaseTexture(Texture2D* tex)
         }
         textureCache_.erase(it);
     }
+    alphaTextures_.erase(tex);
+    CancelTextureStreaming(tex);
     // 同步清理引用该纹理的帧缓冲缓存
     for (auto fbIt = fbCache_.begin(); fbIt != fbCache_.end(); )
     {
@@ -1177,53 +1152,256 @@ void GraphicsBgfx::ReleaseTexture(Texture2D* tex)
 }
 
 bool GraphicsBgfx::DrawQuads(const void* qvertices, int numVertices, Texture2D* texture, ResourceCache* cache, const Matrix4& mvp)
+{
+    if (numVertices <= 0)
+        return initialized_;
+
+    // QVertex（Vector3 position_, u32 color_, Vector2 uv_）与四边形合批布局一致：
+    // 作为单段合批提交，复用缓存布局与静态四边形索引缓冲，混合模式沿用当前状态
+    BgfxQuadBatch batch;
+    batch.vertices_ = qvertices;
+    batch.numVertices_ = (unsigned)numVertices;
+    batch.texture_ = texture;
+    batch.blendMode_ = lastBlendMode_;
+    return DrawQuadBatches(&batch, 1, cache, mvp);
+}
+
+unsigned short GraphicsBgfx::PrepareQuadProgram()
+{
+    const bool hasLit = (u2d_.programLit != bgfx::kInvalidHandle);
+    const bool hasUnlit = (u2d_.programUnlit != bgfx::kInvalidHandle);
+    if (u2d_count_ > 0 && hasLit)
+    {
+        if (u2d_.u_lightCountAmbient != bgfx::kInvalidHandle)
+        {
+            const float cntAmb[4] = { (float)u2d_count_, u2d_ambient_, 0.0f, 0.0f };
+            bgfx::setUniform(bgfx::UniformHandle{u2d_.u_lightCountAmbient}, cntAmb);
+        }
+        if (u2d_.u_lightsPosRange != bgfx::kInvalidHandle)
+            bgfx::setUniform(bgfx::UniformHandle{u2d_.u_lightsPosRange}, &u2d_posRange_[0].x_, (uint16_t)u2d_count_);
+        if (u2d_.u_lightsColorInt != bgfx::kInvalidHandle)
+            bgfx::setUniform(bgfx::UniformHandle{u2d_.u_lightsColorInt}, &u2d_colorInt_[0].x_, (uint16_t)u2d_count_);
+        return u2d_.programLit;
+    }
+    if (hasUnlit)
+        return u2d_.programUnlit;
+    return ui_.programDiff;
+}
+
+bool GraphicsBgfx::EnsureQuadIndexBuffer(unsigned numQuads)
+{
+    numQuads = Min(numQuads, MAX_QUADS_PER_DRAW);
+    if (quadIndexBuffer_ != bgfx::kInvalidHandle && quadIndexBufferQuads_ >= numQuads)
+        return true;
+
+    // 按 2 的幂增长，避免批次规模小幅波动时反复重建
+    unsigned quads = Max(quadIndexBufferQuads_, 256u);
+    while (quads < numQuads)
+        quads <<= 1u;
+    quads = Min(quads, MAX_QUADS_PER_DRAW);
+
+    const bgfx::Memory* mem = bgfx::alloc(quads * 6u * (uint32_t)sizeof(uint16_t));
+    auto* dest = reinterpret_cast<uint16_t*>(mem->data);
+    for (unsigned q = 0; q < quads; ++q)
+    {
+        const auto base = (uint16_t)(q * 4u);
+        dest[0] = base; dest[1] = base + 1; dest[2] = base + 2;
+        dest[3] = base; dest[4] = base + 2; dest[5] = base + 3;
+        dest += 6;
+    }
+
+    bgfx::IndexBufferHandle ih = bgfx::createIndexBuffer(mem);
+    if (!bgfx::isValid(ih))
+    {
+        URHO3D_LOGERROR("BGFX: Failed to create static quad index buffer");
+        return false;
+    }
+    // 销毁为延迟执行，本帧已提交的 drawcall 仍可安全引用旧缓冲
+    if (quadIndexBuffer_ != bgfx::kInvalidHandle)
+        bgfx::destroy(bgfx::IndexBufferHandle{quadIndexBuffer_});
+    quadIndexBuffer_ = ih.idx;
+    quadIndexBufferQuads_ = quads;
+    return true;
+}
+
+bool GraphicsBgfx::EnsureLinearIndexBuffer(unsigned numIndices)
+{
+    numIndices = Min(numIndices, 0x10000u);
+    if (linearIndexBuffer_ != bgfx::kInvalidHandle && linearIndexBufferSize_ >= numIndices)
+        return true;
+
+    unsigned size = Max(linearIndexBufferSize_, 1024u);
+    while (size < numIndices)
+        size <<= 1u;
+    size = Min(size, 0x10000u);
+
+    const bgfx::Memory* mem = bgfx::alloc(size * (uint32_t)sizeof(uint16_t));
+    auto* dest = reinterpret_cast<uint16_t*>(mem->data);
+    for (unsigned i = 0; i < size; ++i)
+        dest[i] = (uint16_t)i;
+
+    bgfx::IndexBufferHandle ih = bgfx::createIndexBuffer(mem);
+    if (!bgfx::isValid(ih))
+    {
+        URHO3D_LOGERROR("BGFX: Failed to create static linear index buffer");
+        return false;
+    }
+    if (linearIndexBuffer_ != bgfx::kInvalidHandle)
+        bgfx::destroy(bgfx::IndexBufferHandle{linearIndexBuffer_});
+    linearIndexBuffer_ = ih.idx;
+    linearIndexBufferSize_ = size;
+    return true;
+}
+
+bool GraphicsBgfx::DrawQuadBatches(const BgfxQuadBatch* batches, unsigned numBatches, ResourceCache* cache, const Matrix4& mvp)
 {
     if (!initialized_)
         return false;
     if (!LoadUIPrograms(cache))
         return false;
-    if (numVertices <= 0)
+    if (!batches || !numBatches)
         return true;
 
-    // 顶点布局
-    bgfx::VertexLayout layout;
-    layout.begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
-        .add(bgfx::Attrib::TexCoord0,2, bgfx::AttribType::Float)
-        .end();
-
-    struct Vtx { float x,y,z; uint32_t abgr; float u,v; };
-    const int vcount = numVertices;
-    const int qcount = vcount / 4;
-    const int icount = qcount * 6;
+    const bgfx::VertexLayout& layout = posColorTexLayout;
+    const uint32_t stride = layout.getStride();
 
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer tib;
-    if (!bgfx::allocTransientBuffers(&tvb, layout, (uint32_t)vcount, &tib, (uint32_t)icount))
+    unsigned totalVertices = 0;
+    for (unsigned i = 0; i < numBatches; ++i)
+        totalVertices += batches[i].numVertices_;
+    if (!EnsureQuadIndexBuffer(Min(totalVertices, MAX_QUADS_PER_DRAW * 4u) / 4u))
         return false;
 
-    // 转拷数据
-    const auto* src = reinterpret_cast<const unsigned char*>(qvertices);
-    // QVertex: Vector3 position_, u32 color_, Vector2 uv_
-    struct QV { float px,py,pz; uint32_t color; float u,v; };
-    auto* vdst = reinterpret_cast<Vtx*>(tvb.data);
-    for (int i=0;i<vcount;i++)
-    {
-        const QV& s = *reinterpret_cast<const QV*>(src + i*sizeof(QV));
-        vdst[i] = {s.px,s.py,s.pz, s.color, s.u,s.v};
+    const float mvpArr[16] = {
+        mvp.m00_, mvp.m10_, mvp.m20_, mvp.m30_,
+        mvp.m01_, mvp.m11_, mvp.m21_, mvp.m31_,
+        mvp.m02_, mvp.m12_, mvp.m22_, mvp.m32_,
+        mvp.m03_, mvp.m13_, mvp.m23_, mvp.m33_,
+    };
+    bgfx::UniformHandle umvp; umvp.idx = ui_.u_mvp;
+    bgfx::UniformHandle stex1; stex1.idx = ui_.s_tex;
+    bgfx::UniformHandle stex2; stex2.idx = ui_.s_texAlt;
+    bgfx::IndexBufferHandle ibh; ibh.idx = quadIndexBuffer_;
+    const uint64_t baseState = (state_ & ~(BGFX_STATE_BLEND_MASK | BGFX_STATE_BLEND_EQUATION_MASK))
+        | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A;
+
+    unsigned b = 0;
+    while (b < numBatches)
+    {
+        // 本段：在剩余 transient 空间内尽量容纳更多完整批次
+        const uint32_t avail = bgfx::getAvailTransientVertexBuffer(totalVertices, layout);
+        unsigned end = b;
+        unsigned segmentVertices = 0;
+        while (end < numBatches && segmentVertices + batches[end].numVertices_ <= avail)
+            segmentVertices += batches[end++].numVertices_;
+        if (end == b)
+        {
+            URHO3D_LOGWARNINGF("BGFX: Transient vertex buffer exhausted, dropped %u Urho2D batches", numBatches - b);
+            return false;
+        }
+
+        bgfx::TransientVertexBuffer tvb;
+        bgfx::allocTransientVertexBuffer(&tvb, segmentVertices, layout);
+        // Vertex2D/QVertex 与布局逐字节一致（pos 3f, color u32, uv 2f），直接整段拷贝
+        uint8_t* vdst = tvb.data;
+        for (unsigned i = b; i < end; ++i)
+        {
+            memcpy(vdst, batches[i].vertices_, batches[i].numVertices_ * stride);
+            vdst += batches[i].numVertices_ * stride;
+        }
+
+        unsigned runStart = 0;
+        unsigned i = b;
+        while (i < end)
+        {
+            // 收集相同 (纹理, 混合模式) 的相邻批次
+            Texture2D* texture = batches[i].texture_;
+            const BlendMode blendMode = batches[i].blendMode_;
+            unsigned runVertices = 0;
+            while (i < end && batches[i].texture_ == texture && batches[i].blendMode_ == blendMode)
+                runVertices += batches[i++].numVertices_;
+
+            bgfx::TextureHandle texh; texh.idx = GetOrCreateTexture(texture, cache);
+            const uint32_t sflags = (uint32_t)GetSamplerFlags(texture);
+            const uint64_t state = baseState | GetBgfxBlendState(blendMode);
+
+            // 16 位静态索引缓冲：超过 MAX_QUADS_PER_DRAW 的段拆分为多次提交
+            for (unsigned offset = 0; offset < runVertices; offset += MAX_QUADS_PER_DRAW * 4u)
+            {
+                const unsigned count = Min(runVertices - offset, MAX_QUADS_PER_DRAW * 4u);
+                bgfx::ProgramHandle ph; ph.idx = PrepareQuadProgram();
+                bgfx::setUniform(umvp, mvpArr);
+                bgfx::setTexture(0, stex1, texh, sflags);
+                bgfx::setTexture(1, stex2, texh, sflags);
+                bgfx::setState(state);
+                bgfx::setVertexBuffer(0, &tvb, runStart + offset, count);
+                bgfx::setIndexBuffer(ibh, 0, count / 4u * 6u);
+                bgfx::submit(0, ph);
+            }
+            runStart += runVertices;
+        }
+
+        totalVertices -= segmentVertices;
+        b = end;
     }
-    // 索引
-    auto* idst = reinterpret_cast<uint16_t*>(tib.data);
-    for (int q=0;q<qcount;q++)
+    return true;
+}
+
+unsigned short GraphicsBgfx::CreateQuadVertexPool(unsigned numVertices)
+{
+    if (!initialized_ || !numVertices)
+        return bgfx::kInvalidHandle;
+    // 池内顶点可能超过 65535 个，需要 32 位索引
+    if (!(bgfx::getCaps()->supported & BGFX_CAPS_INDEX32))
+        return bgfx::kInvalidHandle;
+
+    bgfx::DynamicVertexBufferHandle vh = bgfx::createDynamicVertexBuffer(numVertices, posColorTexLayout);
+    if (!bgfx::isValid(vh))
     {
-        uint16_t base = (uint16_t)(q*4);
-        idst[q*6+0]=base+0; idst[q*6+1]=base+1; idst[q*6+2]=base+2;
-        idst[q*6+3]=base+0; idst[q*6+4]=base+2; idst[q*6+5]=base+3;
+        URHO3D_LOGERROR("BGFX: Failed to create quad vertex pool");
+        return bgfx::kInvalidHandle;
     }
+    quadVertexPools_.push_back(vh.idx);
+    return vh.idx;
+}
 
-    // 设定 MVP=I 与纹理
-    float mvpArr[16] = {
+void GraphicsBgfx::DestroyQuadVertexPool(unsigned short pool)
+{
+    auto it = std::find(quadVertexPools_.begin(), quadVertexPools_.end(), pool);
+    if (!initialized_ || it == quadVertexPools_.end())
+        return;
+
+    // 销毁为延迟执行，本帧已提交的 drawcall 仍可安全引用
+    bgfx::destroy(bgfx::DynamicVertexBufferHandle{pool});
+    quadVertexPools_.erase(it);
+}
+
+bool GraphicsBgfx::UpdateQuadVertexPool(unsigned short pool, unsigned startVertex, const void* vertices, unsigned numVertices)
+{
+    if (!initialized_ || pool == bgfx::kInvalidHandle)
+        return false;
+    if (!vertices || !numVertices)
+        return true;
+
+    const uint32_t stride = posColorTexLayout.getStride();
+    bgfx::update(bgfx::DynamicVertexBufferHandle{pool}, startVertex, bgfx::copy(vertices, numVertices * stride));
+    return true;
+}
+
+bool GraphicsBgfx::DrawQuadPoolBatches(unsigned short pool, const BgfxQuadBatch* batches, unsigned numBatches,
+    ResourceCache* cache, const Matrix4& mvp)
+{
+    if (!initialized_ || pool == bgfx::kInvalidHandle)
+        return false;
+    if (!LoadUIPrograms(cache))
+        return false;
+    if (!batches || !numBatches)
+        return true;
+
+    unsigned totalIndices = 0;
+    for (unsigned i = 0; i < numBatches; ++i)
+        totalIndices += batches[i].numVertices_ / 4u * 6u;
+
+    const float mvpArr[16] = {
         mvp.m00_, mvp.m10_, mvp.m20_, mvp.m30_,
         mvp.m01_, mvp.m11_, mvp.m21_, mvp.m31_,
         mvp.m02_, mvp.m12_, mvp.m22_, mvp.m32_,
@@ -1232,53 +1410,67 @@ bool GraphicsBgfx::DrawQuads(const void* qvertices, int numVertices, Texture2D*
     bgfx::UniformHandle umvp; umvp.idx = ui_.u_mvp;
     bgfx::UniformHandle stex1; stex1.idx = ui_.s_tex;
     bgfx::UniformHandle stex2; stex2.idx = ui_.s_texAlt;
-    bgfx::TextureHandle texh; texh.idx = GetOrCreateTexture(texture, cache);
-    bgfx::setUniform(umvp, mvpArr);
-    uint64_t sflags = texture ? GetBgfxSamplerFlagsFromTexture(texture) : 0;
-    if (texture)
-    {
-        if (texture->GetFilterMode() == FILTER_TRILINEAR)
+    bgfx::DynamicVertexBufferHandle vh; vh.idx = pool;
+    const uint64_t baseState = (state_ & ~(BGFX_STATE_BLEND_MASK | BGFX_STATE_BLEND_EQUATION_MASK))
+        | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A;
+
+    unsigned b = 0;
+    while (b < numBatches)
+    {
+        // 本段：在剩余 transient 索引空间内尽量容纳更多完整批次
+        const uint32_t avail = bgfx::getAvailTransientIndexBuffer(totalIndices, true);
+        unsigned end = b;
+        unsigned segmentIndices = 0;
+        while (end < numBatches && segmentIndices + batches[end].numVertices_ / 4u * 6u <= avail)
+            segmentIndices += batches[end++].numVertices_ / 4u * 6u;
+        if (end == b)
         {
-            if (defaultFilter_ == FILTER_NEAREST)
-                sflags |= (BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT | BGFX_SAMPLER_MIP_POINT);
-            else if (defaultFilter_ == FILTER_BILINEAR)
-                sflags |= BGFX_SAMPLER_MIP_POINT;
+            URHO3D_LOGWARNINGF("BGFX: Transient index buffer exhausted, dropped %u Urho2D batches", numBatches - b);
+            return false;
         }
-        if (texture->GetAnisotropy() <= 1 && defaultAniso_ > 1)
+
+        bgfx::TransientIndexBuffer tib;
+        bgfx::allocTransientIndexBuffer(&tib, segmentIndices, true);
+        auto* idst = reinterpret_cast<uint32_t*>(tib.data);
+        for (unsigned i = b; i < end; ++i)
         {
-#ifdef BGFX_SAMPLER_ANISOTROPIC
-            sflags |= BGFX_SAMPLER_ANISOTROPIC;
-#endif
+            const unsigned quads = batches[i].numVertices_ / 4u;
+            for (unsigned q = 0; q < quads; ++q)
+            {
+                const uint32_t base = batches[i].poolStart_ + q * 4u;
+                idst[0] = base; idst[1] = base + 1; idst[2] = base + 2;
+                idst[3] = base; idst[4] = base + 2; idst[5] = base + 3;
+                idst += 6;
+            }
         }
-    }
-    bgfx::setTexture(0, stex1, texh, (uint32_t)sflags);
-    bgfx::setTexture(1, stex2, texh, (uint32_t)sflags);
 
-    // 提交：根据灯光开关选择 2D 程序并设置灯光 uniforms（如可用）
-    bgfx::ProgramHandle ph;
-    bool hasLit = (u2d_.programLit != bgfx::kInvalidHandle);
-    bool hasUnlit = (u2d_.programUnlit != bgfx::kInvalidHandle);
-    if (u2d_count_ > 0 && hasLit)
-    {
-        if (u2d_.u_lightCountAmbient != bgfx::kInvalidHandle)
+        unsigned runStart = 0;
+        unsigned i = b;
+        while (i < end)
         {
-            const float cntAmb[4] = { (float)u2d_count_, u2d_ambient_, 0.0f, 0.0f };
-            bgfx::setUniform(bgfx::UniformHandle{u2d_.u_lightCountAmbient}, cntAmb);
+            // 收集相同 (纹理, 混合模式) 的相邻批次
+            Texture2D* texture = batches[i].texture_;
+            const BlendMode blendMode = batches[i].blendMode_;
+            unsigned runIndices = 0;
+            while (i < end && batches[i].texture_ == texture && batches[i].blendMode_ == blendMode)
+                runIndices += batches[i++].numVertices_ / 4u * 6u;
+
+            bgfx::TextureHandle texh; texh.idx = GetOrCreateTexture(texture, cache);
+            const uint32_t sflags = (uint32_t)GetSamplerFlags(texture);
+            bgfx::ProgramHandle ph; ph.idx = PrepareQuadProgram();
+            bgfx::setUniform(umvp, mvpArr);
+            bgfx::setTexture(0, stex1, texh, sflags);
+            bgfx::setTexture(1, stex2, texh, sflags);
+            bgfx::setState(baseState | GetBgfxBlendState(blendMode));
+            bgfx::setVertexBuffer(0, vh);
+            bgfx::setIndexBuffer(&tib, runStart, runIndices);
+            bgfx::submit(0, ph);
+            runStart += runIndices;
         }
-        if (u2d_.u_lightsPosRange != bgfx::kInvalidHandle && u2d_count_ > 0)
-            bgfx::setUniform(bgfx::UniformHandle{u2d_.u_lightsPosRange}, &u2d_posRange_[0].x_, (uint16_t)u2d_count_);
-        if (u2d_.u_lightsColorInt != bgfx::kInvalidHandle && u2d_count_ > 0)
-            bgfx::setUniform(bgfx::UniformHandle{u2d_.u_lightsColorInt}, &u2d_colorInt_[0].x_, (uint16_t)u2d_count_);
-        ph.idx = u2d_.programLit;
+
+        totalIndices -= segmentIndices;
+        b = end;
     }
-    else if (hasUnlit)
-        ph.idx = u2d_.programUnlit;
-    else
-        ph.idx = ui_.programDiff;
-    bgfx::setState((state_ | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A));
-    bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
-    bgfx::submit(0, ph);
     return true;
 }
 
@@ -1291,13 +1483,12 @@ bool GraphicsBgfx::DrawTriangles(const void* tvertices, int numVertices, Resourc
     if (numVertices <= 0)
         return true;
 
+    // 顺序索引复用静态缓冲，避免每次提交重写 transient 索引（16 位，单次最多 65535 顶点）
+    if (numVertices > 0xFFFF || !EnsureLinearIndexBuffer((unsigned)numVertices))
+        return false;
+
     // 布局同上：补 0 UV
-    bgfx::VertexLayout layout;
-    layout.begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
-        .add(bgfx::Attrib::TexCoord0,2, bgfx::AttribType::Float)
-        .end();
+    const bgfx::VertexLayout& layout = posColorTexLayout;
 
     struct Vtx { float x,y,z; uint32_t abgr; float u,v; };
     const int vcount = numVertices;
@@ -1329,23 +1520,10 @@ bool GraphicsBgfx::DrawTriangles(const void* tvertices, int numVertices, Resourc
     bgfx::setTexture(0, stex1, texh);
     bgfx::setTexture(1, stex2, texh);
 
-    // 使用顺序索引而非 setVertexCount，避免因 API 约束导致的 fatal
-    if (numVertices > 0xFFFF)
-        return false; // 防御：UI 批次异常大时避免 16-bit 索引溢出
-    bgfx::TransientIndexBuffer tib;
-    if (bgfx::getAvailTransientIndexBuffer((uint32_t)numVertices) < (uint32_t)numVertices)
-        return false;
-    bgfx::allocTransientIndexBuffer(&tib, (uint32_t)numVertices);
-    {
-        auto* idst = reinterpret_cast<uint16_t*>(tib.data);
-        for (int i = 0; i < numVertices; ++i)
-            idst[i] = (uint16_t)i;
-    }
-
     bgfx::ProgramHandle ph; ph.idx = ui_.programDiff;
     bgfx::setState((state_ | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A));
     bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
+    bgfx::setIndexBuffer(bgfx::IndexBufferHandle{linearIndexBuffer_}, 0, (uint32_t)numVertices);
     bgfx::submit(0, ph);
     return true;
 }
@@ -1359,25 +1537,18 @@ bool GraphicsBgfx::DrawUITriangles(const float* vertices, int numVertices, Textu
     if (numVertices <= 0 || vertices == nullptr)
         return true;
 
-    bgfx::VertexLayout layout;
-    layout.begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
-        .add(bgfx::Attrib::TexCoord0,2, bgfx::AttribType::Float)
-        .end();
+    // 顺序索引复用静态缓冲，避免每次提交重写 transient 索引（16 位，单次最多 65535 顶点）
+    if (numVertices > 0xFFFF || !EnsureLinearIndexBuffer((unsigned)numVertices))
+        return false;
+
+    const bgfx::VertexLayout& layout = posColorTexLayout;
 
     bgfx::TransientVertexBuffer tvb;
     if (bgfx::getAvailTransientVertexBuffer((uint32_t)numVertices, layout) < (uint32_t)numVertices)
         return false;
     bgfx::allocTransientVertexBuffer(&tvb, (uint32_t)numVertices, layout);
-    struct Vtx { float x,y,z; uint32_t abgr; float u,v; };
-    auto* vdst = reinterpret_cast<Vtx*>(tvb.data);
-    for (int i = 0; i < numVertices; ++i)
-    {
-        const float* src = vertices + i * 6;
-        uint32_t color; memcpy(&color, &src[3], sizeof(uint32_t));
-        vdst[i] = {src[0], src[1], src[2], color, src[4], src[5]};
-    }
+    // UI 顶点（x,y,z,colorBits,u,v）与 posColorTexLayout 逐字节一致，整段拷贝
+    memcpy(tvb.data, vertices, (size_t)numVertices * layout.getStride());
 
     float mvpArr[16] = {
         mvp.m00_, mvp.m10_, mvp.m20_, mvp.m30_,
@@ -1430,99 +1601,457 @@ bool GraphicsBgfx::DrawUITriangles(const float* vertices, int numVertices, Textu
         }
     }
 
-    // 使用顺序索引而非 setVertexCount
-    if (numVertices > 0xFFFF)
-        return false; // 防御：UI 批次异常大时避免 16-bit 索引溢出
-    bgfx::TransientIndexBuffer tib;
-    if (bgfx::getAvailTransientIndexBuffer((uint32_t)numVertices) < (uint32_t)numVertices)
-        return false;
-    bgfx::allocTransientIndexBuffer(&tib, (uint32_t)numVertices);
-    {
-        auto* idst = reinterpret_cast<uint16_t*>(tib.data);
-        for (int i = 0; i < numVertices; ++i)
-            idst[i] = (uint16_t)i;
-    }
-
     bgfx::ProgramHandle ph; ph.idx = programIdx;
     bgfx::setState((state_ | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A));
     bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
+    bgfx::setIndexBuffer(bgfx::IndexBufferHandle{linearIndexBuffer_}, 0, (uint32_t)numVertices);
     bgfx::submit(0, ph);
     return true;
 }
 
-bool GraphicsBgfx::CreateTextureFromImage(Texture2D* tex, Image* image, bool useAlpha)
+bool GraphicsBgfx::DrawUIBatches(const BgfxUIBatch* batches, unsigned numBatches, ResourceCache* cache, const Matrix4& mvp)
 {
-    if (!tex || !image)
+    if (!initialized_)
         return false;
+    if (!LoadUIPrograms(cache))
+        return false;
+    if (!batches || !numBatches)
+        return true;
 
-    const uint64_t samplerFlags = GetBgfxSamplerFlagsFromTexture(tex);
+    const bgfx::VertexLayout& layout = posColorTexLayout;
+    const uint32_t stride = layout.getStride();
 
-    // 处理组件数：1(A8)/3(RGB)/4(RGBA)
-    SharedPtr<Image> rgba(image);
-    if (image->IsCompressed())
-        rgba = image->GetDecompressedImage();
-    if (!rgba)
+    unsigned totalVertices = 0;
+    for (unsigned i = 0; i < numBatches; ++i)
+    {
+        if (!batches[i].material_)
+            totalVertices += batches[i].numVertices_;
+    }
+
+    // 单次提交使用 16 位顺序索引，超过的部分拆分为多次提交（65535 为 3 的倍数，不会拆开三角形）
+    const unsigned maxVerticesPerDraw = 0xFFFFu;
+    if (totalVertices && !EnsureLinearIndexBuffer(Min(totalVertices, maxVerticesPerDraw)))
         return false;
 
-    const unsigned comps = rgba->GetComponents();
-    std::vector<unsigned char> data;
-    const unsigned w = rgba->GetWidth();
-    const unsigned h = rgba->GetHeight();
-    const unsigned pixels = w * h;
+    // 整帧的 UI 顶点只分配一次 transient 缓冲；空间不足时整体放弃，由调用方逐批次提交
+    bgfx::TransientVertexBuffer tvb;
+    if (totalVertices)
+    {
+        if (bgfx::getAvailTransientVertexBuffer(totalVertices, layout) < totalVertices)
+            return false;
+        bgfx::allocTransientVertexBuffer(&tvb, totalVertices, layout);
 
-    if (comps == 1)
+        // UI 顶点（x,y,z,colorBits,u,v）与 posColorTexLayout 逐字节一致，按提交顺序整段拷贝
+        uint8_t* vdst = tvb.data;
+        for (unsigned i = 0; i < numBatches; ++i)
+        {
+            if (batches[i].material_)
+                continue;
+            memcpy(vdst, batches[i].vertices_, batches[i].numVertices_ * stride);
+            vdst += batches[i].numVertices_ * stride;
+        }
+    }
+
+    const float mvpArr[16] = {
+        mvp.m00_, mvp.m10_, mvp.m20_, mvp.m30_,
+        mvp.m01_, mvp.m11_, mvp.m21_, mvp.m31_,
+        mvp.m02_, mvp.m12_, mvp.m22_, mvp.m32_,
+        mvp.m03_, mvp.m13_, mvp.m23_, mvp.m33_,
+    };
+    bgfx::UniformHandle umvp; umvp.idx = ui_.u_mvp;
+    bgfx::UniformHandle stex1; stex1.idx = ui_.s_tex;
+    bgfx::UniformHandle stex2; stex2.idx = ui_.s_texAlt;
+    bgfx::IndexBufferHandle ibh; ibh.idx = linearIndexBuffer_;
+    const uint64_t baseState = (state_ & ~(BGFX_STATE_BLEND_MASK | BGFX_STATE_BLEND_EQUATION_MASK))
+        | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A;
+    const unsigned alphaFormat = Graphics::GetAlphaFormat();
+
+    unsigned runStart = 0;
+    unsigned i = 0;
+    while (i < numBatches)
     {
-        const unsigned char* a8 = rgba->GetData();
-        data.resize(pixels * 4u);
-        for (unsigned i = 0; i < pixels; ++i)
+        const BgfxUIBatch& first = batches[i];
+        if (first.material_)
+        {
+            SetBlendMode(first.blendMode_, false);
+            SetScissor(true, first.scissor_);
+            DrawUIWithMaterial(first.vertices_, (int)first.numVertices_, first.material_, cache, mvp);
+            ++i;
+            continue;
+        }
+
+        // 收集相同 (纹理, 混合模式, 裁剪) 的相邻批次
+        unsigned runVertices = 0;
+        while (i < numBatches && !batches[i].material_ && batches[i].texture_ == first.texture_ &&
+            batches[i].blendMode_ == first.blendMode_ && batches[i].scissor_ == first.scissor_)
+            runVertices += batches[i++].numVertices_;
+
+        // 按纹理格式与混合模式选择像素程序
+        Texture2D* texture = first.texture_;
+        unsigned short programIdx = ui_.programDiff;
+        if (texture)
+        {
+            const bool isAlphaTex = texture->GetFormat() == alphaFormat;
+            const bool useMask = first.blendMode_ != BLEND_ALPHA && first.blendMode_ != BLEND_ADDALPHA &&
+                first.blendMode_ != BLEND_PREMULALPHA;
+            if (isAlphaTex && ui_.programAlpha != bgfx::kInvalidHandle)
+                programIdx = ui_.programAlpha;
+            else if (!isAlphaTex && useMask && ui_.programMask != bgfx::kInvalidHandle)
+                programIdx = ui_.programMask;
+        }
+
+        bgfx::TextureHandle texh; texh.idx = GetOrCreateTexture(texture, cache);
+        const uint32_t sflags = (uint32_t)GetSamplerFlags(texture);
+        const uint64_t state = baseState | GetBgfxBlendState(first.blendMode_);
+        const uint16_t sx = (uint16_t)Max(0, first.scissor_.left_);
+        const uint16_t sy = (uint16_t)Max(0, first.scissor_.top_);
+        const uint16_t sw = (uint16_t)Max(0, first.scissor_.Width());
+        const uint16_t sh = (uint16_t)Max(0, first.scissor_.Height());
+
+        for (unsigned offset = 0; offset < runVertices; offset += maxVerticesPerDraw)
         {
-            unsigned char a = a8[i];
-            data[i*4+0] = 0xFF; // R
-            data[i*4+1] = 0xFF; // G
-            data[i*4+2] = 0xFF; // B
-            data[i*4+3] = a;    // A
+            const unsigned count = Min(runVertices - offset, maxVerticesPerDraw);
+            bgfx::ProgramHandle ph; ph.idx = programIdx;
+            bgfx::setUniform(umvp, mvpArr);
+            bgfx::setTexture(0, stex1, texh, sflags);
+            bgfx::setTexture(1, stex2, texh, sflags);
+            bgfx::setState(state);
+            bgfx::setScissor(sx, sy, sw, sh);
+            bgfx::setVertexBuffer(0, &tvb, runStart + offset, count);
+            bgfx::setIndexBuffer(ibh, 0, count);
+            bgfx::submit(0, ph);
         }
+        runStart += runVertices;
+    }
+
+    return true;
+}
+
+// 将 Urho3D 的压缩格式映射为 bgfx 纹理格式
+static bgfx::TextureFormat::Enum GetBgfxCompressedFormat(CompressedFormat format)
+{
+    switch (format)
+    {
+    case CF_RGBA:            return bgfx::TextureFormat::RGBA8;
+    case CF_DXT1:            return bgfx::TextureFormat::BC1;
+    case CF_DXT3:            return bgfx::TextureFormat::BC2;
+    case CF_DXT5:            return bgfx::TextureFormat::BC3;
+    case CF_ETC1:            return bgfx::TextureFormat::ETC1;
+    case CF_ETC2_RGB:        return bgfx::TextureFormat::ETC2;
+    case CF_ETC2_RGBA:       return bgfx::TextureFormat::ETC2A;
+    case CF_PVRTC_RGB_2BPP:  return bgfx::TextureFormat::PTC12;
+    case CF_PVRTC_RGBA_2BPP: return bgfx::TextureFormat::PTC12A;
+    case CF_PVRTC_RGB_4BPP:  return bgfx::TextureFormat::PTC14;
+    case CF_PVRTC_RGBA_4BPP: return bgfx::TextureFormat::PTC14A;
+    default:                 return bgfx::TextureFormat::Unknown;
     }
-    else if (comps == 3)
+}
+
+// 后端可直接采样（或由 bgfx 内部模拟）该格式的 2D 纹理
+static bool IsBgfxTextureFormatSupported(bgfx::TextureFormat::Enum format)
+{
+    if (format == bgfx::TextureFormat::Unknown)
+        return false;
+    const bgfx::Caps* caps = bgfx::getCaps();
+    return (caps->formats[format] & (BGFX_CAPS_FORMAT_TEXTURE_2D | BGFX_CAPS_FORMAT_TEXTURE_2D_EMULATED)) != 0;
+}
+
+void GraphicsBgfx::ReleaseImageRef(void* /*ptr*/, void* userData)
+{
+    // 可能在渲染线程回调：Image 引用计数非原子，只登记，回到主线程再释放
+    auto* ref = static_cast<ImageRef*>(userData);
+    MutexLock lock(ref->owner_->imageRefMutex_);
+    ref->owner_->releasedImageRefs_.push_back(ref);
+}
+
+void GraphicsBgfx::ReleasePendingImages()
+{
+    std::vector<ImageRef*> released;
+    {
+        MutexLock lock(imageRefMutex_);
+        released.swap(releasedImageRefs_);
+    }
+    for (ImageRef* ref : released)
+    {
+        ref->image_->ReleaseRef();
+        delete ref;
+    }
+}
+
+const bgfx::Memory* GraphicsBgfx::MakeImageRef(Image* image, const void* data, unsigned size)
+{
+    auto* ref = new ImageRef{this, image};
+    image->AddRef();
+    return bgfx::makeRef(data, size, &GraphicsBgfx::ReleaseImageRef, ref);
+}
+
+// 返回 Image 上传到 GPU 的数据量（压缩图像按全部 mip 级别计算）
+static unsigned GetImageUploadSize(const Image* image)
+{
+    if (image->IsCompressed())
     {
-        const unsigned char* src = rgba->GetData();
-        data.resize(pixels * 4u);
-        for (unsigned i = 0; i < pixels; ++i)
+        unsigned size = 0;
+        for (unsigned i = 0; i < image->GetNumCompressedLevels(); ++i)
+            size += image->GetCompressedLevel(i).dataSize_;
+        return size;
+    }
+    return (unsigned)image->GetWidth() * (unsigned)image->GetHeight() * image->GetComponents();
+}
+
+void GraphicsBgfx::DecodeTextureWork(const WorkItem* item, i32 /*threadIndex*/)
+{
+    auto* decode = static_cast<TextureDecode*>(item->aux_);
+    decode->success_ = decode->image_->Load(*decode->file_);
+}
+
+void GraphicsBgfx::StartTextureDecode(Texture2D* tex, ResourceCache* cache)
+{
+    // 文件在主线程打开（资源包与路径查找不是线程安全的），只把解码放到工作线程
+    auto* queue = cache->GetSubsystem<WorkQueue>();
+    SharedPtr<File> file = cache->GetFile(tex->GetName(), false);
+    if (!queue || !file)
+    {
+        URHO3D_LOGERRORF("GetOrCreateTexture: Failed to open %s for streaming", tex->GetName().CString());
+        failedTextures_.insert(tex);
+        return;
+    }
+
+    auto decode = std::make_unique<TextureDecode>();
+    decode->tex_ = tex;
+    decode->image_ = new Image(cache->GetContext());
+    decode->file_ = file;
+    decode->queue_ = queue;
+    decode->success_ = false;
+    // 不使用池化工作项：池化项回收时会重置完成标志，这里需要逐帧轮询
+    decode->item_ = new WorkItem();
+    decode->item_->workFunction_ = &GraphicsBgfx::DecodeTextureWork;
+    decode->item_->aux_ = decode.get();
+    decode->item_->priority_ = 0;
+
+    streamingTextures_.insert(tex);
+    queue->AddWorkItem(decode->item_);
+    textureDecodes_.push_back(std::move(decode));
+}
+
+void GraphicsBgfx::CancelTextureStreaming(const Texture2D* tex)
+{
+    failedTextures_.erase(tex);
+    if (!streamingTextures_.erase(tex))
+        return;
+
+    for (auto it = textureUploads_.begin(); it != textureUploads_.end();)
+    {
+        if (it->tex_ == tex)
         {
-            data[i*4+0] = src[i*3+0];
-            data[i*4+1] = src[i*3+1];
-            data[i*4+2] = src[i*3+2];
-            data[i*4+3] = 0xFF;
+            pendingUploadBytes_ -= it->size_;
+            it = textureUploads_.erase(it);
         }
+        else
+            ++it;
     }
-    else if (comps == 4)
+    // 解码中的项无法安全中断，完成后丢弃结果
+    for (auto& decode : textureDecodes_)
     {
-        // 直接复制 RGBA8
-        const unsigned char* src = rgba->GetData();
-        data.assign(src, src + pixels*4u);
+        if (decode->tex_ == tex)
+            decode->tex_ = nullptr;
     }
-    else
+}
+
+unsigned short GraphicsBgfx::GetStreamingPlaceholder()
+{
+    if (placeholderTex_ == bgfx::kInvalidHandle)
     {
-        // 转成 RGBA 再试
-        rgba = rgba->ConvertToRGBA();
-        if (!rgba)
-            return false;
-        const unsigned char* src = rgba->GetData();
-        data.assign(src, src + rgba->GetWidth()*rgba->GetHeight()*4u);
+        const uint32_t transparent = 0u;
+        placeholderTex_ = bgfx::createTexture2D(1, 1, false, 1, bgfx::TextureFormat::RGBA8,
+            (BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_W_CLAMP | BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT),
+            bgfx::copy(&transparent, sizeof(transparent))).idx;
+    }
+    return placeholderTex_;
+}
+
+bool GraphicsBgfx::QueueTextureUpload(Texture2D* tex, Image* image, bool useAlpha)
+{
+    if (!initialized_ || !tex || !image)
+        return false;
+    if (!textureUploadBudget_)
+        return CreateTextureFromImage(tex, image, useAlpha);
+
+    CancelTextureStreaming(tex);
+    unsigned size = GetImageUploadSize(image);
+    textureUploads_.push_back(TextureUpload{tex, SharedPtr<Image>(image), useAlpha, size});
+    streamingTextures_.insert(tex);
+    pendingUploadBytes_ += size;
+    return true;
+}
+
+void GraphicsBgfx::ProcessTextureStreaming()
+{
+    // 收取已完成的解码
+    for (auto it = textureDecodes_.begin(); it != textureDecodes_.end();)
+    {
+        TextureDecode* decode = it->get();
+        if (!decode->item_->completed_)
+        {
+            ++it;
+            continue;
+        }
+
+        Texture2D* tex = decode->tex_;
+        SharedPtr<Image> image = decode->image_;
+        bool success = decode->success_;
+        it = textureDecodes_.erase(it);
+        if (!tex)
+            continue;
+
+        streamingTextures_.erase(tex);
+        if (success)
+            QueueTextureUpload(tex, image, false);
+        else
+        {
+            URHO3D_LOGERRORF("GetOrCreateTexture: Failed to decode %s", tex->GetName().CString());
+            failedTextures_.insert(tex);
+        }
+    }
+
+    // 按预算上传；每帧至少上传一张，超过预算的大纹理不会永远排不上
+    unsigned long long uploaded = 0;
+    while (!textureUploads_.empty())
+    {
+        TextureUpload& front = textureUploads_.front();
+        if (uploaded && uploaded + front.size_ > textureUploadBudget_)
+            break;
+
+        TextureUpload upload = front;
+        textureUploads_.pop_front();
+        streamingTextures_.erase(upload.tex_);
+        pendingUploadBytes_ -= upload.size_;
+        uploaded += upload.size_;
+        if (!CreateTextureFromImage(upload.tex_, upload.image_, upload.useAlpha_))
+        {
+            URHO3D_LOGERRORF("Failed to upload texture %s", upload.tex_->GetName().CString());
+            failedTextures_.insert(upload.tex_);
+        }
+    }
+}
+
+bool GraphicsBgfx::CreateTextureFromImage(Texture2D* tex, Image* image, bool useAlpha)
+{
+    if (!initialized_ || !tex || !image)
+        return false;
+
+    // 直接设置数据的纹理不再等待排队的上传
+    CancelTextureStreaming(tex);
+
+    // 尽量保持加载器已解码的原生格式，用 makeRef 直接引用 Image 的数据（含压缩 mip 链），
+    // 上传完成后由 bgfx 回调释放；只有后端不支持的格式才在 CPU 上转换为 RGBA8
+    SharedPtr<Image> source(image);
+    bgfx::TextureFormat::Enum format = bgfx::TextureFormat::Unknown;
+    const bgfx::Memory* mem = nullptr;
+    unsigned w = image->GetWidth();
+    unsigned h = image->GetHeight();
+    bool hasMips = false;
+    bool nativeAlpha = false;
+
+    if (image->IsCompressed())
+    {
+        format = GetBgfxCompressedFormat(image->GetCompressedFormat());
+        if (IsBgfxTextureFormatSupported(format) && image->GetNumCompressedLevels())
+        {
+            // 各级 mip 在 Image 中连续存放；只有完整 mip 链才能整体上传，否则只上传第 0 级
+            CompressedLevel first = image->GetCompressedLevel(0);
+            CompressedLevel last = image->GetCompressedLevel(image->GetNumCompressedLevels() - 1);
+            auto chainSize = (unsigned)(last.data_ + last.dataSize_ - first.data_);
+
+            bgfx::TextureInfo info;
+            bgfx::calcTextureSize(info, (uint16_t)w, (uint16_t)h, 1, false, true, 1, format);
+            hasMips = info.storageSize == chainSize && info.numMips == image->GetNumCompressedLevels();
+            mem = MakeImageRef(image, first.data_, hasMips ? chainSize : first.dataSize_);
+        }
+        else
+        {
+            source = image->GetDecompressedImage();
+            if (!source)
+                return false;
+        }
+    }
+
+    if (!mem)
+    {
+        const unsigned comps = source->GetComponents();
+        const unsigned char* src = source->GetData();
+        const unsigned pixels = w * h;
+
+        if (comps == 1 && useAlpha && IsBgfxTextureFormatSupported(bgfx::TextureFormat::A8))
+        {
+            // 字体等 Alpha 纹理：着色器只采样 .a，直接以 A8 上传
+            format = bgfx::TextureFormat::A8;
+            nativeAlpha = true;
+            mem = MakeImageRef(source, src, pixels);
+        }
+        else if (comps == 3 && IsBgfxTextureFormatSupported(bgfx::TextureFormat::RGB8))
+        {
+            format = bgfx::TextureFormat::RGB8;
+            mem = MakeImageRef(source, src, pixels * 3u);
+        }
+        else if (comps == 4)
+        {
+            format = bgfx::TextureFormat::RGBA8;
+            mem = MakeImageRef(source, src, pixels * 4u);
+        }
+        else
+        {
+            // 其余情况直接转换进 bgfx 分配的内存，不再经过临时缓冲
+            format = bgfx::TextureFormat::RGBA8;
+            mem = bgfx::alloc(pixels * 4u);
+            unsigned char* dst = mem->data;
+            for (unsigned i = 0; i < pixels; ++i, dst += 4)
+            {
+                switch (comps)
+                {
+                case 1:
+                    // A8 扩展为 (FF,FF,FF,A)
+                    dst[0] = dst[1] = dst[2] = 0xFF;
+                    dst[3] = src[i];
+                    break;
+                case 2:
+                    dst[0] = dst[1] = dst[2] = src[i * 2];
+                    dst[3] = src[i * 2 + 1];
+                    break;
+                default:
+                    dst[0] = src[i * 3];
+                    dst[1] = src[i * 3 + 1];
+                    dst[2] = src[i * 3 + 2];
+                    dst[3] = 0xFF;
+                    break;
+                }
+            }
+        }
     }
 
-    const bgfx::Memory* mem = bgfx::copy(data.data(), (uint32_t)data.size());
     uint64_t tflags = 0;
 #ifdef BGFX_TEXTURE_SRGB
     if (tex->GetSRGB()) tflags |= BGFX_TEXTURE_SRGB;
 #endif
-    bgfx::TextureHandle th = bgfx::createTexture2D((uint16_t)w, (uint16_t)h, false, 1,
-        bgfx::TextureFormat::RGBA8, tflags, mem);
+    const uint32_t memSize = mem->size;
+    bgfx::TextureHandle th = bgfx::createTexture2D((uint16_t)w, (uint16_t)h, hasMips, 1, format, tflags, mem);
     if (!bgfx::isValid(th))
         return false;
+    uploadedTextureBytes_ += memSize;
+
+    // 重新设置数据时先销毁旧纹理
+    auto it = textureCache_.find(tex);
+    if (it != textureCache_.end() && it->second != bgfx::kInvalidHandle)
+    {
+        bgfx::TextureHandle old; old.idx = it->second;
+        if (bgfx::isValid(old))
+            bgfx::destroy(old);
+    }
 
     textureCache_[tex] = th.idx;
+    if (nativeAlpha)
+        alphaTextures_.insert(tex);
+    else
+        alphaTextures_.erase(tex);
     return true;
 }
 
@@ -1536,11 +2065,7 @@ bool GraphicsBgfx::DrawColored(PrimitiveType prim, const float* vertices, int nu
         return false;
 
     // 顶点声明：pos(3f) + color0(ub4n)
-    bgfx::VertexLayout layout;
-    layout.begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
-        .end();
+    const bgfx::VertexLayout& layout = posColorLayout;
 
     struct Vtx { float x,y,z; uint32_t abgr; };
 
@@ -1654,12 +2179,7 @@ bool GraphicsBgfx::DrawFullscreenTexture(Texture2D* texture, ResourceCache* cach
 
     Matrix4 id(Matrix4::IDENTITY);
     // 准备提交
-    bgfx::VertexLayout layout;
-    layout.begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
-        .add(bgfx::Attrib::TexCoord0,2, bgfx::AttribType::Float)
-        .end();
+    const bgfx::VertexLayout& layout = posColorTexLayout;
 
     bgfx::TransientVertexBuffer tvb;
     if (bgfx::getAvailTransientVertexBuffer(6, layout) < 6)
@@ -1667,12 +2187,8 @@ bool GraphicsBgfx::DrawFullscreenTexture(Texture2D* texture, ResourceCache* cach
     bgfx::allocTransientVertexBuffer(&tvb, 6, layout);
     memcpy(tvb.data, verts, sizeof(verts));
 
-    bgfx::TransientIndexBuffer tib;
-    if (bgfx::getAvailTransientIndexBuffer(6) < 6)
+    if (!EnsureLinearIndexBuffer(6))
         return false;
-    bgfx::allocTransientIndexBuffer(&tib, 6);
-    uint16_t* idst = reinterpret_cast<uint16_t*>(tib.data);
-    for (int i = 0; i < 6; ++i) idst[i] = (uint16_t)i;
 
     float mvpArr[16] = {
         id.m00_, id.m10_, id.m20_, id.m30_,
@@ -1693,7 +2209,7 @@ bool GraphicsBgfx::DrawFullscreenTexture(Texture2D* texture, ResourceCache* cach
     ph.idx = (ui_.programCopy != bgfx::kInvalidHandle) ? ui_.programCopy : ui_.programDiff;
     bgfx::setState((state_ | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A));
     bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
+    bgfx::setIndexBuffer(bgfx::IndexBufferHandle{linearIndexBuffer_}, 0, 6);
     bgfx::submit(0, ph);
     return true;
 }
@@ -1709,25 +2225,18 @@ bool GraphicsBgfx::DrawUIWithMaterial(const float* vertices, int numVertices, Ma
     if (numVertices <= 0 || vertices == nullptr)
         return true;
 
-    bgfx::VertexLayout layout;
-    layout.begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::Color0,   4, bgfx::AttribType::Uint8, true)
-        .add(bgfx::Attrib::TexCoord0,2, bgfx::AttribType::Float)
-        .end();
+    // 顺序索引复用静态缓冲，避免每次提交重写 transient 索引（16 位，单次最多 65535 顶点）
+    if (numVertices > 0xFFFF || !EnsureLinearIndexBuffer((unsigned)numVertices))
+        return false;
+
+    const bgfx::VertexLayout& layout = posColorTexLayout;
 
     bgfx::TransientVertexBuffer tvb;
     if (bgfx::getAvailTransientVertexBuffer((uint32_t)numVertices, layout) < (uint32_t)numVertices)
         return false;
     bgfx::allocTransientVertexBuffer(&tvb, (uint32_t)numVertices, layout);
-    struct Vtx { float x,y,z; uint32_t abgr; float u,v; };
-    auto* vdst = reinterpret_cast<Vtx*>(tvb.data);
-    for (int i = 0; i < numVertices; ++i)
-    {
-        const float* src = vertices + i * 6;
-        uint32_t color; memcpy(&color, &src[3], sizeof(uint32_t));
-        vdst[i] = {src[0], src[1], src[2], color, src[4], src[5]};
-    }
+    // UI 顶点（x,y,z,colorBits,u,v）与 posColorTexLayout 逐字节一致，整段拷贝
+    memcpy(tvb.data, vertices, (size_t)numVertices * layout.getStride());
 
     float mvpArr[16] = {
         mvp.m00_, mvp.m10_, mvp.m20_, mvp.m30_,
@@ -1849,22 +2358,10 @@ bool GraphicsBgfx::DrawUIWithMaterial(const float* vertices, int numVertices, Ma
         }
     }
 
-    if (numVertices > 0xFFFF)
-        return false;
-    bgfx::TransientIndexBuffer tib;
-    if (bgfx::getAvailTransientIndexBuffer((uint32_t)numVertices) < (uint32_t)numVertices)
-        return false;
-    bgfx::allocTransientIndexBuffer(&tib, (uint32_t)numVertices);
-    {
-        auto* idst = reinterpret_cast<uint16_t*>(tib.data);
-        for (int i = 0; i < numVertices; ++i)
-            idst[i] = (uint16_t)i;
-    }
-
     bgfx::ProgramHandle ph; ph.idx = programIdx;
     bgfx::setState((state_ | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A));
     bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
+    bgfx::setIndexBuffer(bgfx::IndexBufferHandle{linearIndexBuffer_}, 0, (uint32_t)numVertices);
     bgfx::submit(0, ph);
     return true;
 }
@@ -1898,31 +2395,34 @@ bool GraphicsBgfx::UpdateTextureRegion(Texture2D* tex, int x, int y, int width,
     if (!bgfx::isValid(th))
         return false;
 
-    // 若原纹理是 A8，需要将 A8 扩展为 RGBA8 再上传
+    // 原纹理是 A8 时：以 A8 存储的纹理直接上传，否则扩展为 RGBA8 写入 bgfx 分配的内存
     const bool isAlphaOnly = (tex->GetFormat() == Graphics::GetAlphaFormat());
-    uint32_t pitch = (uint32_t)width * 4u;
-    std::vector<unsigned char> rgbaBuf;
-    const void* src = data;
-    if (isAlphaOnly)
+    const bgfx::Memory* mem;
+    uint32_t pitch;
+    if (isAlphaOnly && alphaTextures_.find(tex) != alphaTextures_.end())
     {
+        pitch = (uint32_t)width;
+        mem = bgfx::copy(data, (uint32_t)height * pitch);
+    }
+    else if (isAlphaOnly)
+    {
+        pitch = (uint32_t)width * 4u;
+        mem = bgfx::alloc((uint32_t)height * pitch);
         const unsigned char* a8 = reinterpret_cast<const unsigned char*>(data);
-        rgbaBuf.resize((size_t)width * (size_t)height * 4u);
-        for (int i = 0; i < height; ++i)
+        unsigned char* dst = mem->data;
+        const unsigned pixels = (unsigned)width * (unsigned)height;
+        for (unsigned i = 0; i < pixels; ++i, dst += 4)
         {
-            for (int j = 0; j < width; ++j)
-            {
-                const int idx = i * width + j;
-                const unsigned char a = a8[idx];
-                rgbaBuf[idx*4 + 0] = 0xFF;
-                rgbaBuf[idx*4 + 1] = 0xFF;
-                rgbaBuf[idx*4 + 2] = 0xFF;
-                rgbaBuf[idx*4 + 3] = a;
-            }
+            dst[0] = dst[1] = dst[2] = 0xFF;
+            dst[3] = a8[i];
         }
-        src = rgbaBuf.data();
+    }
+    else
+    {
+        pitch = (uint32_t)width * 4u;
+        mem = bgfx::copy(data, (uint32_t)height * pitch);
     }
 
-    const bgfx::Memory* mem = bgfx::copy(src, (uint32_t)height * pitch);
     bgfx::updateTexture2D(th, 0 /*layer*/, (uint8_t)level, (uint16_t)x, (uint16_t)y, (uint16_t)width, (uint16_t)height, mem, pitch);
     return true;
 }
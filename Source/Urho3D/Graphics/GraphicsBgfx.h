@@ -11,16 +11,32 @@
 #include "../Math/Color.h"
 #include "../Math/Matrix4.h"
 #include "../Math/Vector4.h"
+#include "../Container/Ptr.h"
 #include "../Container/STLAdapter.h"
+#include "../Core/Mutex.h"
+#include <deque>
+#include <memory>
 #include <string>
+#include <vector>
+
+namespace bgfx
+{
+struct Memory;
+}
 
 namespace Urho3D
 {
 
+class File;
+class Image;
 class Texture2D;
 class ResourceCache;
 class Material;
 class Variant;
+class WorkQueue;
+struct BgfxQuadBatch;
+struct BgfxUIBatch;
+struct WorkItem;
 
 /// bgfx 渲染器薄封装（最小骨架）。
 /// 说明：仅提供初始化/帧提交等基础能力，具体渲染管线、资源管理与 Urho3D 类型映射将在后续阶段逐步完善。
@@ -80,6 +96,16 @@ public:
 
     // 批量绘制（供 SpriteBatch 调用）
     bool DrawQuads(const void* qvertices /*SpriteBatchBase::QVertex[]*/, int numVertices, Texture2D* texture, ResourceCache* cache, const Matrix4& mvp);
+    // 合批绘制（供 Renderer2D 调用）：所有批次拷入同一个 transient VB，按相邻的 (纹理, 混合模式) 分段提交，复用静态四边形索引缓冲
+    bool DrawQuadBatches(const BgfxQuadBatch* batches, unsigned numBatches, ResourceCache* cache, const Matrix4& mvp);
+    // 常驻四边形顶点池（供 Renderer2D 调用）：静态精灵只上传一次，之后仅对变化的区间做局部更新
+    // 创建可容纳 numVertices 个 Vertex2D 的顶点池，返回句柄；不支持 32 位索引时返回 0xFFFF，调用方应回落到 DrawQuadBatches
+    unsigned short CreateQuadVertexPool(unsigned numVertices);
+    void DestroyQuadVertexPool(unsigned short pool);
+    // 局部更新顶点池 [startVertex, startVertex + numVertices) 区间
+    bool UpdateQuadVertexPool(unsigned short pool, unsigned startVertex, const void* vertices, unsigned numVertices);
+    // 按 BgfxQuadBatch::poolStart_ 引用池内顶点，每帧只生成 transient 32 位索引，按相邻的 (纹理, 混合模式) 分段提交
+    bool DrawQuadPoolBatches(unsigned short pool, const BgfxQuadBatch* batches, unsigned numBatches, ResourceCache* cache, const Matrix4& mvp);
     bool DrawTriangles(const void* tvertices /*SpriteBatchBase::TVertex[]*/, int numVertices, ResourceCache* cache, const Matrix4& mvp);
     // UI: 直接从 UI 顶点浮点数组绘制三角形（pos, color, uv，按 UI_VERTEX_SIZE=6 排列）
     bool DrawUITriangles(const float* vertices, int numVertices, Texture2D* texture, ResourceCache* cache, const Matrix4& mvp);
@@ -87,19 +113,35 @@ public:
     bool DrawColored(PrimitiveType prim, const float* vertices, int numVertices, const Matrix4& mvp);
     // UI: 使用自定义材质（贴图+uniform），仍然复用 UI 顶点布局与通用 UI 程序集
     bool DrawUIWithMaterial(const float* vertices, int numVertices, Material* material, ResourceCache* cache, const Matrix4& mvp);
+    // UI 合批：所有批次拷入同一个 transient VB，相邻且 (纹理, 混合模式, 裁剪) 相同的批次合并为一次提交；带材质的批次单独提交
+    bool DrawUIBatches(const BgfxUIBatch* batches, unsigned numBatches, ResourceCache* cache, const Matrix4& mvp);
     // 使用 CopyFramebuffer 程序将纹理绘制为全屏三角形（若不可用则回退到 Basic_Diff_VC）
     bool DrawFullscreenTexture(Texture2D* texture, ResourceCache* cache);
 
-    // 从 Image 创建 BGFX 纹理并保存到映射（供 UI 字体等路径使用）
-    bool CreateTextureFromImage(Texture2D* tex, class Image* image, bool useAlpha);
+    // 从 Image 创建 BGFX 纹理并保存到映射：保持原生格式（A8/RGB8/压缩 mip 链），以 makeRef 引用 Image 数据上传
+    // useAlpha 时单通道图像以 A8 上传，仅供采样 .a 的着色器（字体）使用
+    bool CreateTextureFromImage(Texture2D* tex, Image* image, bool useAlpha);
     /// 释放并移除由 GetOrCreateTexture/CreateTextureFromImage 创建的 BGFX 纹理。
     void ReleaseTexture(Texture2D* tex);
 
+    // 纹理流式上传：每帧最多上传 bytesPerFrame 字节（0 = 不限制，立即创建）。
+    // 启用后加载完成的纹理排队分帧上传；首次绘制时尚未创建的纹理在 WorkQueue 线程解码；就绪前以透明占位纹理绘制
+    void SetTextureUploadBudget(unsigned bytesPerFrame) { textureUploadBudget_ = bytesPerFrame; }
+    unsigned GetTextureUploadBudget() const { return textureUploadBudget_; }
+    // 排队上传已解码的 Image；预算为 0 时立即创建
+    bool QueueTextureUpload(Texture2D* tex, Image* image, bool useAlpha);
+    // 等待解码或上传的纹理数量
+    unsigned GetNumPendingTextureUploads() const { return (unsigned)streamingTextures_.size(); }
+    // 等待上传的字节数（解码中的纹理尚不计入）
+    unsigned long long GetPendingTextureUploadBytes() const { return pendingUploadBytes_; }
+    // 累计上传的纹理字节数
+    unsigned long long GetUploadedTextureBytes() const { return uploadedTextureBytes_; }
+
     // 渲染目标与帧缓冲
     bool SetFrameBuffer(Texture2D* color, Texture2D* depth);
     bool ResetFrameBuffer();
 
-    // 纹理局部更新（level=0 默认），数据应为 RGBA8；若纹理为 A8 则自动扩展为 RGBA8。
+    // 纹理局部更新（level=0 默认），数据应为 RGBA8；若纹理为 A8 则按原生 A8 上传或自动扩展为 RGBA8。
     bool UpdateTextureRegion(Texture2D* tex, int x, int y, int width, int height, const void* data, unsigned level = 0);
 
     // SRGB 与默认采样参数（全局）
@@ -120,6 +162,30 @@ public:
 
 private:
     void ApplyState();
+    /// 确保静态四边形索引缓冲至少容纳 numQuads 个四边形（16 位索引，上限 MAX_QUADS_PER_DRAW）。
+    bool EnsureQuadIndexBuffer(unsigned numQuads);
+    /// 确保静态顺序索引缓冲（0..N-1，16 位）至少容纳 numIndices 个索引。
+    bool EnsureLinearIndexBuffer(unsigned numIndices);
+    /// 选择四边形使用的程序（有灯光时优先 Urho2D lit），并设置 2D 灯光 uniforms。
+    unsigned short PrepareQuadProgram();
+    /// 计算纹理采样标志（叠加全局默认过滤/各向异性设置）。
+    uint64_t GetSamplerFlags(Texture2D* texture) const;
+    /// 以 makeRef 引用 Image 的数据，上传完成前保持 Image 存活。
+    const bgfx::Memory* MakeImageRef(Image* image, const void* data, unsigned size);
+    /// bgfx 的 makeRef 释放回调（可能在渲染线程调用）。
+    static void ReleaseImageRef(void* ptr, void* userData);
+    /// 在主线程释放 bgfx 已上传完毕的 Image。
+    void ReleasePendingImages();
+    /// 收取后台解码结果，并按预算上传排队的纹理。每帧开始时调用。
+    void ProcessTextureStreaming();
+    /// 在 WorkQueue 线程解码纹理的源图像。
+    void StartTextureDecode(Texture2D* tex, ResourceCache* cache);
+    /// 取消纹理尚未完成的解码与上传。
+    void CancelTextureStreaming(const Texture2D* tex);
+    /// 返回流式纹理就绪前使用的透明占位纹理。
+    unsigned short GetStreamingPlaceholder();
+    /// 后台解码工作函数。
+    static void DecodeTextureWork(const WorkItem* item, i32 threadIndex);
 
 private:
     bool initialized_{};
@@ -147,9 +213,59 @@ private:
         bool ready{};
     } ui_;
 
+    // 静态四边形索引缓冲（0,1,2,0,2,3 模式，16 位），按见过的最大批次增长
+    static const unsigned MAX_QUADS_PER_DRAW = 16384;
+    unsigned short quadIndexBuffer_{0xFFFF};
+    unsigned quadIndexBufferQuads_{};
+    // 静态顺序索引缓冲（0..N-1，16 位），供三角形列表类提交（SpriteBatch 三角形、UI）复用
+    unsigned short linearIndexBuffer_{0xFFFF};
+    unsigned linearIndexBufferSize_{};
+    // 已创建的常驻四边形顶点池（动态顶点缓冲句柄），Shutdown 时统一销毁
+    std::vector<unsigned short> quadVertexPools_;
+
     // 纹理缓存：Urho3D Texture2D* -> bgfx::TextureHandle.idx
     Urho3D::stl::unordered_map<const Texture2D*, unsigned short> textureCache_;
-    unsigned short GetOrCreateTexture(Texture2D* tex, class ResourceCache* cache);
+    unsigned short GetOrCreateTexture(Texture2D* tex, ResourceCache* cache);
+    // 以原生 A8 格式存储的纹理，局部更新时不需要扩展为 RGBA8
+    Urho3D::stl::unordered_set<const Texture2D*> alphaTextures_;
+
+    // makeRef 上传期间被引用的 Image
+    struct ImageRef
+    {
+        GraphicsBgfx* owner_;
+        Image* image_;
+    };
+    Mutex imageRefMutex_;
+    std::vector<ImageRef*> releasedImageRefs_;
+
+    // 排队等待上传的纹理
+    struct TextureUpload
+    {
+        Texture2D* tex_;
+        SharedPtr<Image> image_;
+        bool useAlpha_;
+        unsigned size_;
+    };
+    // 后台解码中的纹理，tex_ 为空表示已取消
+    struct TextureDecode
+    {
+        Texture2D* tex_;
+        SharedPtr<Image> image_;
+        SharedPtr<File> file_;
+        SharedPtr<WorkItem> item_;
+        WeakPtr<WorkQueue> queue_;
+        bool success_;
+    };
+    std::deque<TextureUpload> textureUploads_;
+    std::vector<std::unique_ptr<TextureDecode>> textureDecodes_;
+    // 正在解码或排队上传的纹理
+    Urho3D::stl::unordered_set<const Texture2D*> streamingTextures_;
+    // 源图像解码失败的纹理，不再重试直到纹理被释放
+    Urho3D::stl::unordered_set<const Texture2D*> failedTextures_;
+    unsigned textureUploadBudget_{};
+    unsigned long long pendingUploadBytes_{};
+    unsigned long long uploadedTextureBytes_{};
+    unsigned short placeholderTex_{0xFFFF};
     // 动态 uniform/sampler 缓存
     unsigned short GetOrCreateSampler(const char* name);
     unsigned short GetOrCreateVec4(const char* name);
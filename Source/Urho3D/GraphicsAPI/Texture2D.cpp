@@ -61,8 +61,8 @@ bool Texture2D::BeginLoad(Deserializer& source)
         return false;
     }
 
-    // Precalculate mip levels if async loading
-    if (GetAsyncLoadState() == ASYNC_LOADING)
+    // Precalculate mip levels if async loading. BGFX uploads only the loaded levels, so the extra levels would only use memory
+    if (GetAsyncLoadState() == ASYNC_LOADING && Graphics::GetGAPI() != GAPI_BGFX)
         loadImage_->PrecalculateLevels();
 
     // Load the optional parameters file
@@ -85,7 +85,8 @@ bool Texture2D::EndLoad()
     SetParameters(loadParameters_);
     bool success = true;
 
-    // BGFX 后端：不在 Urho 的 GL/D3D 设备上创建纹理，记录元数据供 BGFX 路径使用。
+    // BGFX 后端：直接用加载时解码的 Image 创建 bgfx 纹理，避免首次绘制时再从 ResourceCache 重新解码。
+    // 设置了上传预算时排队分帧上传；bgfx 尚未初始化时只记录元数据，由 GraphicsBgfx 在首次使用时创建。
     if (Graphics::GetGAPI() == GAPI_BGFX)
     {
         if (loadImage_)
@@ -102,7 +103,8 @@ bool Texture2D::EndLoad()
                 fmt = Graphics::GetRGBAFormat();
 
             SetSizeForBgfx_NoCreate(w, h, fmt);
-            success = true;
+            if (graphics_->IsBgfxActive())
+                success = graphics_->BgfxQueueTextureUpload(this, loadImage_, false);
         }
         else
             success = false;
@@ -303,6 +305,8 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
                 const unsigned comps = image->GetComponents();
                 if (comps == 1 || useAlpha)
                     fmt = Graphics::GetAlphaFormat();
+                else if (comps == 3)
+                    fmt = Graphics::GetRGBFormat();
                 else
                     fmt = Graphics::GetRGBAFormat();
                 SetSizeForBgfx_NoCreate(image->GetWidth(), image->GetHeight(), fmt);
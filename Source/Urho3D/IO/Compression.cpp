@@ -11,6 +11,7 @@
 
 #include <LZ4/lz4.h>
 #include <LZ4/lz4hc.h>
+#include <STB/stb_image.h>
 
 namespace Urho3D
 {
@@ -103,4 +104,56 @@ VectorBuffer DecompressVectorBuffer(VectorBuffer& src)
     return ret;
 }
 
+unsigned DecompressZlib(void* dest, unsigned destSize, const void* src, unsigned srcSize)
+{
+    if (!dest || !src || !destSize || !srcSize)
+        return 0;
+
+    // 解压实现来自 Image 中编译的 stb_image
+    int written = stbi_zlib_decode_buffer((char*)dest, (int)destSize, (const char*)src, (int)srcSize);
+    return written > 0 ? (unsigned)written : 0;
+}
+
+unsigned DecompressGzip(void* dest, unsigned destSize, const void* src, unsigned srcSize)
+{
+    if (!dest || !src || !destSize)
+        return 0;
+
+    // 10 字节头：魔数 1F 8B、压缩方式 8 (deflate)、标志位，之后是可选字段
+    const auto* data = (const unsigned char*)src;
+    if (srcSize < 18 || data[0] != 0x1f || data[1] != 0x8b || data[2] != 8)
+        return 0;
+
+    const unsigned char flags = data[3];
+    unsigned offset = 10;
+
+    // FEXTRA
+    if (flags & 0x04u)
+    {
+        if (offset + 2 > srcSize)
+            return 0;
+        offset += 2 + (data[offset] | (unsigned)data[offset + 1] << 8u);
+    }
+    // FNAME, FCOMMENT：以零结尾的字符串
+    for (unsigned flag = 0x08u; flag <= 0x10u; flag <<= 1u)
+    {
+        if (!(flags & flag))
+            continue;
+        while (offset < srcSize && data[offset])
+            ++offset;
+        ++offset;
+    }
+    // FHCRC
+    if (flags & 0x02u)
+        offset += 2;
+
+    // 结尾有 8 字节的 CRC32 和原始长度
+    if (offset + 8 > srcSize)
+        return 0;
+
+    int written = stbi_zlib_decode_noheader_buffer((char*)dest, (int)destSize, (const char*)data + offset,
+        (int)(srcSize - offset - 8));
+    return written > 0 ? (unsigned)written : 0;
+}
+
 }
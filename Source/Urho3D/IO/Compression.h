@@ -30,5 +30,9 @@ URHO3D_API bool DecompressStream(Serializer& dest, Deserializer& src);
 URHO3D_API VectorBuffer CompressVectorBuffer(VectorBuffer& src);
 /// Decompress a VectorBuffer produced using CompressVectorBuffer().
 URHO3D_API VectorBuffer DecompressVectorBuffer(VectorBuffer& src);
+/// Inflate zlib (RFC 1950) compressed data into a destination buffer. Return the number of bytes written, or 0 on error.
+URHO3D_API unsigned DecompressZlib(void* dest, unsigned destSize, const void* src, unsigned srcSize);
+/// Inflate gzip (RFC 1952) compressed data into a destination buffer. Return the number of bytes written, or 0 on error.
+URHO3D_API unsigned DecompressGzip(void* dest, unsigned destSize, const void* src, unsigned srcSize);
 
 }
@@ -18,6 +18,10 @@
 #include <limits>
 #include <type_traits>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace Urho3D
 {
 
@@ -319,6 +323,20 @@ inline i32 CountSetBits(u32 value)
     return count;
 }
 
+/// Return the number of trailing zero bits, i.e. the position of the lowest set bit. The value must not be zero.
+inline unsigned CountTrailingZeros(u64 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)value))
+        return index;
+    _BitScanForward(&index, (unsigned long)(value >> 32u));
+    return index + 32;
+#else
+    return (unsigned)__builtin_ctzll(value);
+#endif
+}
+
 /// Update a hash with the given 8-bit value using the SDBM algorithm.
 inline constexpr hash32 SDBMHash(hash32 hash, u8 c) { return c + (hash << 6u) + (hash << 16u) - hash; }
 
@@ -58,6 +58,7 @@ Connection::Connection(Context* context, bool isClient, const SLNet::AddressOrGU
     connectPending_(false),
     sceneLoaded_(false),
     logStatistics_(false),
+    quantizedUpdate_(false),
     address_(nullptr),
     packedMessageLimit_(1024)
 {
@@ -168,6 +169,8 @@ void Connection::SetScene(Scene* newScene)
     scene_ = newScene;
     sceneLoaded_ = false;
     UnsubscribeFromEvent(E_ASYNCLOADFINISHED);
+    snapshotWriter_.Clear();
+    snapshotReader_.Clear();
 
     if (!scene_)
         return;
@@ -249,6 +252,15 @@ void Connection::SendServerUpdate()
     nodesToProcess_.insert(sceneID);
     ProcessNode(sceneID);
 
+    // 量化复制模式下，节点变换从逐节点的 latest data 消息中剥离，改由每次更新一条的快照发送
+    auto* network = GetSubsystem<Network>();
+    bool quantized = network->GetReplicationMode() == REPLICATION_QUANTIZED;
+    if (quantized)
+        snapshotWriter_.SetQuantization(network->GetTransformQuantization(), sceneState_);
+    else if (quantizedUpdate_)
+        snapshotWriter_.Clear();
+    quantizedUpdate_ = quantized;
+
     // Then go through all dirtied nodes
     // 原始实现依赖 HashSet::Insert(另一个集合) 接口；在 EASTL 包装下改为逐个插入
     for (auto it = sceneState_.dirtyNodes_.begin(); it != sceneState_.dirtyNodes_.end(); ++it)
@@ -261,6 +273,13 @@ void Connection::SendServerUpdate()
         unsigned nodeID = *nodesToProcess_.begin();
         ProcessNode(nodeID);
     }
+
+    if (quantizedUpdate_)
+    {
+        msg_.Clear();
+        if (snapshotWriter_.WriteSnapshot(msg_))
+            SendMessage(MSG_TRANSFORMSNAPSHOT, false, false, msg_);
+    }
 }
 
 void Connection::SendClientUpdate()
@@ -280,6 +299,10 @@ void Connection::SendClientUpdate()
         msg_.WritePackedQuaternion(rotation_);
     SendMessage(MSG_CONTROLS, false, false, msg_, CONTROLS_CONTENT_ID);
 
+    msg_.Clear();
+    if (snapshotReader_.WriteAck(msg_))
+        SendMessage(MSG_SNAPSHOTACK, false, false, msg_);
+
     ++timeStamp_;
 }
 
@@ -494,6 +517,15 @@ bool Connection::ProcessMessage(int msgID, MemoryBuffer& buffer)
             case MSG_PACKAGEINFO:
                 ProcessPackageInfo(msgID, msg);
                 break;
+
+            case MSG_TRANSFORMSNAPSHOT:
+                ProcessTransformSnapshot(msgID, msg);
+                break;
+
+            case MSG_SNAPSHOTACK:
+                ProcessSnapshotAck(msgID, msg);
+                break;
+
             default:
                 ProcessUnknownMessage(msgID, msg);
                 break;
@@ -524,6 +556,9 @@ void Connection::ProcessLoadScene(int msgID, MemoryBuffer& msg)
         return;
     }
 
+    // Transform snapshots of the previous scene are no longer valid
+    snapshotReader_.Clear();
+
     // Store the scene file name we need to eventually load
     sceneFileName_ = msg.ReadString();
 
@@ -600,6 +635,8 @@ void Connection::ProcessSceneUpdate(int msgID, MemoryBuffer& msg)
 
             // Read initial attributes, then snap the motion smoothing immediately to the end
             node->ReadDeltaUpdate(msg);
+            // Transform snapshots may have arrived before the node was created
+            snapshotReader_.ApplyLatest(node);
             auto* transform = node->GetComponent<SmoothedTransform>();
             if (transform)
                 transform->Update(1.0f, 0.0f);
@@ -694,6 +731,7 @@ void Connection::ProcessSceneUpdate(int msgID, MemoryBuffer& msg)
             if (node)
                 node->Remove();
             nodeLatestData_.erase(nodeID);
+            snapshotReader_.RemoveNode(nodeID);
         }
         break;
 
@@ -1045,6 +1083,33 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
     }
 }
 
+void Connection::ProcessTransformSnapshot(int msgID, MemoryBuffer& msg)
+{
+    if (IsClient())
+    {
+        URHO3D_LOGWARNING("Received unexpected TransformSnapshot message from client " + ToString());
+        return;
+    }
+
+    if (!scene_ || !sceneLoaded_)
+        return;
+
+    snapshotReader_.ReadSnapshot(msg, scene_);
+}
+
+void Connection::ProcessSnapshotAck(int msgID, MemoryBuffer& msg)
+{
+    if (!IsClient())
+    {
+        URHO3D_LOGWARNING("Received unexpected SnapshotAck message from server");
+        return;
+    }
+
+    u16 sequence = msg.ReadU16();
+    u32 receivedMask = msg.ReadU32();
+    snapshotWriter_.Acknowledge(sequence, receivedMask);
+}
+
 Scene* Connection::GetScene() const
 {
     return scene_;
@@ -1202,6 +1267,7 @@ void Connection::ProcessNode(unsigned nodeID)
             // would be enough. However, this may be better due to the client not possibly having updated parenting
             // information at the time of receiving this message
             SendMessage(MSG_REMOVENODE, true, true, msg_);
+            snapshotWriter_.RemoveNode(i->second);
             sceneState_.nodeStates_.erase(nodeID);
         }
         else
@@ -1308,6 +1374,9 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
         unsigned numAttributes = attributes->Size();
         bool hasLatestData = false;
 
+        if (quantizedUpdate_)
+            snapshotWriter_.TakeTransformChanges(attributes, nodeState);
+
         for (unsigned i = 0; i < numAttributes; ++i)
         {
             if (nodeState.dirtyAttributes_.IsSet(i) && (attributes->At(i).mode_ & AM_LATESTDATA))
@@ -10,6 +10,7 @@
 #include "../Core/Timer.h"
 #include "../Input/Controls.h"
 #include "../IO/VectorBuffer.h"
+#include "../Network/QuantizedReplication.h"
 #include "../Scene/ReplicationState.h"
 
 namespace SLNet
@@ -276,6 +277,10 @@ private:
     void ProcessSceneLoaded(int msgID, MemoryBuffer& msg);
     /// Process a remote event message from the client or server. Called by Network.
     void ProcessRemoteEvent(int msgID, MemoryBuffer& msg);
+    /// Process a TransformSnapshot message from the server. Called by Network.
+    void ProcessTransformSnapshot(int msgID, MemoryBuffer& msg);
+    /// Process a SnapshotAck message from the client. Called by Network.
+    void ProcessSnapshotAck(int msgID, MemoryBuffer& msg);
     /// Process a node for sending a network update. Recurses to process depended on node(s) first.
     void ProcessNode(unsigned nodeID);
     /// Process a node that the client has not yet received.
@@ -313,6 +318,10 @@ private:
     HashMap<unsigned, Vector<byte>> componentLatestData_;
     /// Node ID's to process during a replication update.
     HashSet<unsigned> nodesToProcess_;
+    /// Transform snapshot stream to the client in quantized replication mode. Used on the server only.
+    TransformSnapshotWriter snapshotWriter_;
+    /// Transform snapshot stream from the server. Used on the client only.
+    TransformSnapshotReader snapshotReader_;
     /// Reusable message buffer.
     VectorBuffer msg_;
     /// Queued remote events.
@@ -337,6 +346,8 @@ private:
     bool sceneLoaded_;
     /// Show statistics flag.
     bool logStatistics_;
+    /// Whether the current server update uses quantized replication.
+    bool quantizedUpdate_;
     /// Address of this connection.
     SLNet::AddressOrGUID* address_;
     /// Raknet peer object.
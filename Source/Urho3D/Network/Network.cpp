@@ -182,6 +182,7 @@ static const int SERVER_TIMEOUT_TIME = 10000;
 Network::Network(Context* context) :
     Object(context),
     updateFps_(DEFAULT_UPDATE_FPS),
+    replicationMode_(REPLICATION_DEFAULT),
     simulatedLatency_(0),
     simulatedPacketLoss_(0.0f),
     updateInterval_(1.0f / (float)DEFAULT_UPDATE_FPS),
@@ -561,6 +562,16 @@ void Network::SetUpdateFps(int fps)
     updateAcc_ = 0.0f;
 }
 
+void Network::SetReplicationMode(ReplicationMode mode)
+{
+    replicationMode_ = mode;
+}
+
+void Network::SetTransformQuantization(const TransformQuantization& settings)
+{
+    transformQuantization_ = settings;
+}
+
 void Network::SetSimulatedLatency(int ms)
 {
     simulatedLatency_ = Max(ms, 0);
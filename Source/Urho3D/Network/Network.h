@@ -74,6 +74,11 @@ public:
     /// Set network update FPS.
     /// @property
     void SetUpdateFps(int fps);
+    /// Set scene replication mode. Quantized mode sends node transforms as delta compressed snapshots.
+    /// @property
+    void SetReplicationMode(ReplicationMode mode);
+    /// Set transform quantization of the quantized replication mode.
+    void SetTransformQuantization(const TransformQuantization& settings);
     /// Set simulated latency in milliseconds. This adds a fixed delay before sending each packet.
     /// @property
     void SetSimulatedLatency(int ms);
@@ -99,6 +104,13 @@ public:
     /// @property
     int GetUpdateFps() const { return updateFps_; }
 
+    /// Return scene replication mode.
+    /// @property
+    ReplicationMode GetReplicationMode() const { return replicationMode_; }
+
+    /// Return transform quantization of the quantized replication mode.
+    const TransformQuantization& GetTransformQuantization() const { return transformQuantization_; }
+
     /// Return simulated latency in milliseconds.
     /// @property
     int GetSimulatedLatency() const { return simulatedLatency_; }
@@ -167,6 +179,10 @@ private:
     Urho3D::stl::unordered_set<Scene*> networkScenes_;
     /// Update FPS.
     int updateFps_;
+    /// Scene replication mode.
+    ReplicationMode replicationMode_;
+    /// Transform quantization of the quantized replication mode.
+    TransformQuantization transformQuantization_;
     /// Simulated latency (send delay) in milliseconds.
     int simulatedLatency_;
     /// Simulated packet loss probability between 0.0 - 1.0.
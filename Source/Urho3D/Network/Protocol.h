@@ -47,6 +47,10 @@ static const int MSG_PACKAGEINFO = 0x98;
 
 /// Packet that includes all the above messages
 static const int MSG_PACKED_MESSAGE = 0x99;
+/// Server->client: quantized and delta compressed node transforms (quantized replication mode.)
+static const int MSG_TRANSFORMSNAPSHOT = 0x9A;
+/// Client->server: acknowledgement of received transform snapshots.
+static const int MSG_SNAPSHOTACK = 0x9B;
 
 /// Used to define custom messages, usually of the form MSG_USER + x, where x is an integer value.
 static const int MSG_USER = 0x200;
@@ -0,0 +1,621 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#include "../Precompiled.h"
+
+#include "../Container/Sort.h"
+#include "../Network/QuantizedReplication.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SmoothedTransform.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// 快照中每个节点的最坏编码长度（字节）：ID、基线、3 个位置分量与旋转
+static const unsigned MAX_NODE_SNAPSHOT_BYTES = 28;
+// 快照头：序号 u16 + 标志 u8 + 位置精度 u8 + 旋转精度 u8
+static const unsigned SNAPSHOT_HEADER_BYTES = 5;
+// 2D 模式标志位
+static const unsigned SNAPSHOT_FLAG_2D = 1;
+// Smallest three 编码中非最大分量的取值上限为 1/sqrt(2)
+static const float SQRT_TWO = 1.41421356f;
+
+static TransformQuantization ClampQuantization(const TransformQuantization& settings)
+{
+    TransformQuantization ret = settings;
+    ret.positionBits_ = Min(ret.positionBits_, 16u);
+    // 3D 模式下旋转为 2 位索引 + 3 个分量，需装入 32 位
+    ret.rotationBits_ = Clamp(ret.rotationBits_, 4u, ret.twoDimensional_ ? 16u : 10u);
+    ret.maxSnapshotBytes_ = Max(ret.maxSnapshotBytes_, SNAPSHOT_HEADER_BYTES + MAX_NODE_SNAPSHOT_BYTES);
+    return ret;
+}
+
+static bool SameQuantization(const TransformQuantization& lhs, const TransformQuantization& rhs)
+{
+    return lhs.twoDimensional_ == rhs.twoDimensional_ && lhs.positionBits_ == rhs.positionBits_ &&
+        lhs.rotationBits_ == rhs.rotationBits_;
+}
+
+static unsigned GetRotationBits(const TransformQuantization& settings)
+{
+    return settings.twoDimensional_ ? settings.rotationBits_ : 2 + 3 * settings.rotationBits_;
+}
+
+// 判断序号 a 是否比 b 新（处理 16 位回绕）
+static bool IsNewerSequence(u16 a, u16 b)
+{
+    return (short)(a - b) > 0;
+}
+
+BitWriter::BitWriter(VectorBuffer& dest) :
+    dest_(dest),
+    scratch_(0),
+    scratchBits_(0),
+    bitsWritten_(0)
+{
+}
+
+void BitWriter::Write(u32 value, unsigned bits)
+{
+    if (!bits)
+        return;
+
+    if (bits < 32)
+        value &= (1u << bits) - 1;
+
+    scratch_ |= (u64)value << scratchBits_;
+    scratchBits_ += bits;
+    bitsWritten_ += bits;
+
+    // 攒够 32 位后整体写出
+    if (scratchBits_ >= 32)
+    {
+        dest_.WriteU32((u32)scratch_);
+        scratch_ >>= 32u;
+        scratchBits_ -= 32;
+    }
+}
+
+void BitWriter::WriteVarBits(u32 value)
+{
+    // 长度前缀为有效位数减 1，值 0 按 1 位写出
+    unsigned bits = 1;
+    while (bits < 32 && (value >> bits))
+        ++bits;
+
+    Write(bits - 1, 5);
+    Write(value, bits);
+}
+
+void BitWriter::Flush()
+{
+    while (scratchBits_ > 0)
+    {
+        dest_.WriteU8((u8)scratch_);
+        scratch_ >>= 8u;
+        scratchBits_ = scratchBits_ > 8 ? scratchBits_ - 8 : 0;
+    }
+    scratch_ = 0;
+}
+
+BitReader::BitReader(MemoryBuffer& source) :
+    data_(source.GetData() + source.GetPosition()),
+    size_((unsigned)(source.GetSize() - source.GetPosition())),
+    position_(0),
+    error_(false)
+{
+}
+
+u32 BitReader::Read(unsigned bits)
+{
+    if (!bits)
+        return 0;
+
+    if (position_ + bits > size_ * 8)
+    {
+        error_ = true;
+        position_ = size_ * 8;
+        return 0;
+    }
+
+    // 最多跨越 5 个字节
+    u64 value = 0;
+    unsigned byteIndex = position_ >> 3u;
+    unsigned bitOffset = position_ & 7u;
+    unsigned numBytes = Min((bitOffset + bits + 7) >> 3u, size_ - byteIndex);
+    for (unsigned i = 0; i < numBytes; ++i)
+        value |= (u64)data_[byteIndex + i] << (i * 8);
+
+    position_ += bits;
+    value >>= bitOffset;
+    return bits < 32 ? (u32)value & ((1u << bits) - 1) : (u32)value;
+}
+
+u32 BitReader::ReadVarBits()
+{
+    unsigned bits = Read(5) + 1;
+    return Read(bits);
+}
+
+QuantizedTransform QuantizeTransform(Node* node, const TransformQuantization& settings)
+{
+    QuantizedTransform ret;
+
+    const Vector3& position = node->GetPosition();
+    const Quaternion& rotation = node->GetRotation();
+    auto scale = (float)(1u << settings.positionBits_);
+    ret.position_[0] = RoundToInt(position.x_ * scale);
+    ret.position_[1] = RoundToInt(position.y_ * scale);
+
+    if (settings.twoDimensional_)
+    {
+        // 2D 节点只绕 Z 轴旋转，直接由四元数求角度
+        float angle = 2.0f * Atan2(rotation.z_, rotation.w_);
+        if (angle >= 180.0f)
+            angle -= 360.0f;
+        else if (angle < -180.0f)
+            angle += 360.0f;
+
+        u32 steps = 1u << settings.rotationBits_;
+        ret.rotation_ = (u32)RoundToInt((angle + 180.0f) * (1.0f / 360.0f) * (float)steps) & (steps - 1);
+    }
+    else
+    {
+        ret.position_[2] = RoundToInt(position.z_ * scale);
+
+        // Smallest three：省略绝对值最大的分量，由单位长度约束还原
+        float components[4] = { rotation.w_, rotation.x_, rotation.y_, rotation.z_ };
+        unsigned largest = 0;
+        for (unsigned i = 1; i < 4; ++i)
+        {
+            if (Abs(components[i]) > Abs(components[largest]))
+                largest = i;
+        }
+
+        float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+        u32 maxValue = (1u << settings.rotationBits_) - 1;
+        ret.rotation_ = largest;
+        unsigned shift = 2;
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+
+            // 其余分量位于 [-1/sqrt(2), 1/sqrt(2)]
+            float normalized = Clamp((components[i] * sign * SQRT_TWO + 1.0f) * 0.5f, 0.0f, 1.0f);
+            ret.rotation_ |= (u32)RoundToInt(normalized * (float)maxValue) << shift;
+            shift += settings.rotationBits_;
+        }
+    }
+
+    return ret;
+}
+
+void ApplyQuantizedTransform(Node* node, const QuantizedTransform& transform, const TransformQuantization& settings)
+{
+    float invScale = 1.0f / (float)(1u << settings.positionBits_);
+    Vector3 position((float)transform.position_[0] * invScale, (float)transform.position_[1] * invScale,
+        settings.twoDimensional_ ? node->GetPosition().z_ : (float)transform.position_[2] * invScale);
+
+    Quaternion rotation;
+    if (settings.twoDimensional_)
+    {
+        u32 steps = 1u << settings.rotationBits_;
+        rotation = Quaternion((float)transform.rotation_ * (360.0f / (float)steps) - 180.0f);
+    }
+    else
+    {
+        float components[4];
+        unsigned largest = transform.rotation_ & 3u;
+        u32 maxValue = (1u << settings.rotationBits_) - 1;
+        unsigned shift = 2;
+        float sumSquares = 0.0f;
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+
+            float normalized = (float)((transform.rotation_ >> shift) & maxValue) / (float)maxValue;
+            components[i] = (normalized * 2.0f - 1.0f) * (1.0f / SQRT_TWO);
+            sumSquares += components[i] * components[i];
+            shift += settings.rotationBits_;
+        }
+        components[largest] = sqrtf(Max(1.0f - sumSquares, 0.0f));
+        rotation = Quaternion(components[0], components[1], components[2], components[3]);
+        rotation.Normalize();
+    }
+
+    auto* smoothed = node->GetComponent<SmoothedTransform>();
+    if (smoothed)
+    {
+        smoothed->SetTargetPosition(position);
+        smoothed->SetTargetRotation(rotation);
+    }
+    else
+        node->SetTransform(position, rotation);
+}
+
+TransformSnapshotWriter::TransformSnapshotWriter() :
+    settings_(ClampQuantization(TransformQuantization())),
+    cachedAttributes_(nullptr),
+    positionIndex_(M_MAX_UNSIGNED),
+    rotationIndex_(M_MAX_UNSIGNED),
+    sequence_(0),
+    cursor_(0)
+{
+}
+
+void TransformSnapshotWriter::SetQuantization(const TransformQuantization& settings, SceneReplicationState& sceneState)
+{
+    TransformQuantization clamped = ClampQuantization(settings);
+    settings_.maxSnapshotBytes_ = clamped.maxSnapshotBytes_;
+    if (SameQuantization(clamped, settings_))
+        return;
+
+    settings_ = clamped;
+
+    // 旧精度下确认过的基线在客户端已不可用
+    for (auto i = sceneState.nodeStates_.begin(); i != sceneState.nodeStates_.end(); ++i)
+    {
+        NodeReplicationState& nodeState = i->second;
+        nodeState.hasAckedTransform_ = false;
+        nodeState.sentTransforms_.Clear();
+        if (nodeState.node_)
+            AddNode(nodeState);
+    }
+}
+
+bool TransformSnapshotWriter::TakeTransformChanges(const Vector<AttributeInfo>* attributes, NodeReplicationState& nodeState)
+{
+    if (attributes != cachedAttributes_)
+    {
+        cachedAttributes_ = attributes;
+        positionIndex_ = rotationIndex_ = M_MAX_UNSIGNED;
+        for (i32 i = 0; i < attributes->Size(); ++i)
+        {
+            const String& name = attributes->At(i).name_;
+            if (name == "Network Position")
+                positionIndex_ = i;
+            else if (name == "Network Rotation")
+                rotationIndex_ = i;
+        }
+    }
+
+    bool changed = false;
+    if (nodeState.dirtyAttributes_.IsSet(positionIndex_))
+    {
+        nodeState.dirtyAttributes_.Clear(positionIndex_);
+        changed = true;
+    }
+    if (nodeState.dirtyAttributes_.IsSet(rotationIndex_))
+    {
+        nodeState.dirtyAttributes_.Clear(rotationIndex_);
+        changed = true;
+    }
+
+    if (changed)
+        AddNode(nodeState);
+
+    return changed;
+}
+
+void TransformSnapshotWriter::AddNode(NodeReplicationState& nodeState)
+{
+    if (!nodeState.snapshotActive_)
+    {
+        nodeState.snapshotActive_ = true;
+        activeNodes_.Push(&nodeState);
+    }
+}
+
+void TransformSnapshotWriter::RemoveNode(NodeReplicationState& nodeState)
+{
+    if (nodeState.snapshotActive_)
+    {
+        nodeState.snapshotActive_ = false;
+        activeNodes_.Remove(&nodeState);
+    }
+}
+
+void TransformSnapshotWriter::Clear()
+{
+    for (NodeReplicationState* nodeState : activeNodes_)
+        nodeState->snapshotActive_ = false;
+
+    activeNodes_.Clear();
+    cursor_ = 0;
+}
+
+bool TransformSnapshotWriter::WriteSnapshot(VectorBuffer& dest)
+{
+    if (activeNodes_.Empty())
+        return false;
+
+    // 按节点 ID 排序，使 ID 差值编码更短；从游标处开始，截断的快照不会一直漏掉同一批节点
+    Sort(activeNodes_.Begin(), activeNodes_.End(), [](NodeReplicationState* lhs, NodeReplicationState* rhs)
+    {
+        return (lhs->node_ ? lhs->node_->GetID() : 0) < (rhs->node_ ? rhs->node_->GetID() : 0);
+    });
+
+    unsigned startSize = dest.GetSize();
+    dest.WriteU16(sequence_);
+    dest.WriteU8(settings_.twoDimensional_ ? SNAPSHOT_FLAG_2D : 0);
+    dest.WriteU8((u8)settings_.positionBits_);
+    dest.WriteU8((u8)settings_.rotationBits_);
+
+    BitWriter writer(dest);
+    unsigned numPositions = settings_.twoDimensional_ ? 2 : 3;
+    unsigned rotationBits = GetRotationBits(settings_);
+    unsigned numActive = activeNodes_.Size();
+    unsigned start = cursor_ < numActive ? cursor_ : 0;
+    unsigned numWritten = 0;
+    unsigned numVisited = 0;
+    NodeId previousID = 0;
+
+    for (; numVisited < numActive; ++numVisited)
+    {
+        if (SNAPSHOT_HEADER_BYTES + writer.GetNumBytes() + MAX_NODE_SNAPSHOT_BYTES > settings_.maxSnapshotBytes_)
+            break;
+
+        NodeReplicationState& nodeState = *activeNodes_[(start + numVisited) % numActive];
+        Node* node = nodeState.node_;
+        if (!node)
+            continue;
+
+        QuantizedTransform current = QuantizeTransform(node, settings_);
+
+        // 客户端已确认当前状态且没有在途的其他状态：无需再发送
+        if (nodeState.hasAckedTransform_ && current == nodeState.ackedTransform_ && nodeState.sentTransforms_.Empty())
+        {
+            nodeState.snapshotActive_ = false;
+            continue;
+        }
+
+        bool useBaseline = nodeState.hasAckedTransform_ &&
+            (u16)(sequence_ - nodeState.ackedSequence_) <= MAX_SNAPSHOT_BASELINE_AGE;
+        QuantizedTransform baseline;
+        if (useBaseline)
+            baseline = nodeState.ackedTransform_;
+
+        NodeId nodeID = node->GetID();
+        writer.WriteBit(true);
+        writer.WriteSignedVarBits((i32)(nodeID - previousID));
+        previousID = nodeID;
+
+        writer.WriteBit(useBaseline);
+        if (useBaseline)
+            writer.Write((u16)(sequence_ - nodeState.ackedSequence_) - 1, 4);
+
+        for (unsigned i = 0; i < numPositions; ++i)
+        {
+            i32 delta = current.position_[i] - baseline.position_[i];
+            writer.WriteBit(delta != 0);
+            if (delta)
+                writer.WriteSignedVarBits(delta);
+        }
+
+        bool rotationChanged = !useBaseline || current.rotation_ != baseline.rotation_;
+        writer.WriteBit(rotationChanged);
+        if (rotationChanged)
+            writer.Write(current.rotation_, rotationBits);
+
+        if ((unsigned)nodeState.sentTransforms_.Size() >= MAX_SNAPSHOT_BASELINE_AGE)
+            nodeState.sentTransforms_.Erase(0);
+        nodeState.sentTransforms_.Push(SentTransform{sequence_, current});
+        ++numWritten;
+    }
+
+    writer.WriteBit(false);
+    writer.Flush();
+
+    cursor_ = numVisited < numActive ? (start + numVisited) % numActive : 0;
+
+    // 移除已不需要发送的节点
+    for (i32 i = activeNodes_.Size() - 1; i >= 0; --i)
+    {
+        if (!activeNodes_[i]->snapshotActive_)
+        {
+            activeNodes_.Erase(i);
+            if (cursor_ > (unsigned)i)
+                --cursor_;
+        }
+    }
+
+    if (!numWritten)
+    {
+        // 回退已写入的头部，不发送空快照
+        dest.Resize(startSize);
+        return false;
+    }
+
+    ++sequence_;
+    return true;
+}
+
+void TransformSnapshotWriter::Acknowledge(u16 sequence, u32 receivedMask)
+{
+    for (NodeReplicationState* nodeState : activeNodes_)
+    {
+        Vector<SentTransform>& sent = nodeState->sentTransforms_;
+
+        // 找到客户端收到的最新状态作为新的基线
+        for (i32 i = sent.Size() - 1; i >= 0; --i)
+        {
+            auto age = (u16)(sequence - sent[i].sequence_);
+            if (age == 0 || (age <= 32 && (receivedMask & (1u << (age - 1)))))
+            {
+                if (!nodeState->hasAckedTransform_ || IsNewerSequence(sent[i].sequence_, nodeState->ackedSequence_))
+                {
+                    nodeState->ackedTransform_ = sent[i].transform_;
+                    nodeState->ackedSequence_ = sent[i].sequence_;
+                    nodeState->hasAckedTransform_ = true;
+                }
+                sent.Erase(0, i + 1);
+                break;
+            }
+        }
+    }
+}
+
+TransformSnapshotReader::TransformSnapshotReader() :
+    latestSequence_(0),
+    receivedMask_(0),
+    hasReceived_(false),
+    ackPending_(false)
+{
+}
+
+bool TransformSnapshotReader::ReadSnapshot(MemoryBuffer& source, Scene* scene)
+{
+    u16 sequence = source.ReadU16();
+    TransformQuantization settings;
+    settings.twoDimensional_ = (source.ReadU8() & SNAPSHOT_FLAG_2D) != 0;
+    settings.positionBits_ = source.ReadU8();
+    settings.rotationBits_ = source.ReadU8();
+    settings = ClampQuantization(settings);
+
+    // 服务器更换了量化精度：旧的历史状态不能再作为基线
+    if (!SameQuantization(settings, settings_))
+    {
+        settings_ = settings;
+        nodes_.clear();
+    }
+
+    BitReader reader(source);
+    unsigned numPositions = settings_.twoDimensional_ ? 2 : 3;
+    unsigned rotationBits = GetRotationBits(settings_);
+    bool missingBaseline = false;
+    NodeId nodeID = 0;
+
+    while (reader.ReadBit())
+    {
+        nodeID += (NodeId)reader.ReadSignedVarBits();
+        NodeHistory& history = nodes_[nodeID];
+
+        QuantizedTransform transform;
+        bool baselineFound = true;
+        if (reader.ReadBit())
+        {
+            auto baselineSequence = (u16)(sequence - (reader.Read(4) + 1));
+            baselineFound = false;
+            for (unsigned i = 0; i < history.count_; ++i)
+            {
+                if (history.entries_[i].sequence_ == baselineSequence)
+                {
+                    transform = history.entries_[i].transform_;
+                    baselineFound = true;
+                    break;
+                }
+            }
+        }
+
+        for (unsigned i = 0; i < numPositions; ++i)
+        {
+            if (reader.ReadBit())
+                transform.position_[i] += reader.ReadSignedVarBits();
+        }
+        if (reader.ReadBit())
+            transform.rotation_ = reader.Read(rotationBits);
+
+        if (reader.HasError())
+            return false;
+
+        // 缺少基线时无法还原该节点，整个快照不确认，服务器会在基线过期后改发绝对值
+        if (!baselineFound)
+        {
+            missingBaseline = true;
+            continue;
+        }
+
+        history.entries_[history.next_] = SentTransform{sequence, transform};
+        history.next_ = (history.next_ + 1) % MAX_SNAPSHOT_BASELINE_AGE;
+        history.count_ = Min(history.count_ + 1, MAX_SNAPSHOT_BASELINE_AGE);
+
+        // 乱序到达的旧快照只作为基线保存，不回退节点状态
+        if (history.hasApplied_ && !IsNewerSequence(sequence, history.appliedSequence_))
+            continue;
+
+        Node* node = scene ? scene->GetNode(nodeID) : nullptr;
+        if (node)
+        {
+            ApplyQuantizedTransform(node, transform, settings_);
+            history.appliedSequence_ = sequence;
+            history.hasApplied_ = true;
+        }
+    }
+
+    if (reader.HasError() || missingBaseline)
+        return false;
+
+    if (!hasReceived_)
+    {
+        latestSequence_ = sequence;
+        receivedMask_ = 0;
+        hasReceived_ = true;
+    }
+    else
+    {
+        auto age = (short)(sequence - latestSequence_);
+        if (age > 0)
+        {
+            receivedMask_ = age < 32 ? receivedMask_ << (unsigned)age : 0;
+            if (age <= 32)
+                receivedMask_ |= 1u << (unsigned)(age - 1);
+            latestSequence_ = sequence;
+        }
+        else if (age < 0 && age >= -32)
+            receivedMask_ |= 1u << (unsigned)(-age - 1);
+    }
+
+    ackPending_ = true;
+    return true;
+}
+
+bool TransformSnapshotReader::WriteAck(VectorBuffer& dest)
+{
+    if (!ackPending_)
+        return false;
+
+    dest.WriteU16(latestSequence_);
+    dest.WriteU32(receivedMask_);
+    ackPending_ = false;
+    return true;
+}
+
+void TransformSnapshotReader::RemoveNode(id32 nodeID)
+{
+    nodes_.erase(nodeID);
+}
+
+void TransformSnapshotReader::ApplyLatest(Node* node)
+{
+    auto i = nodes_.find(node->GetID());
+    if (i == nodes_.end() || !i->second.count_)
+        return;
+
+    NodeHistory& history = i->second;
+    unsigned newest = (history.next_ + MAX_SNAPSHOT_BASELINE_AGE - 1) % MAX_SNAPSHOT_BASELINE_AGE;
+    for (unsigned j = 0; j < history.count_; ++j)
+    {
+        if (IsNewerSequence(history.entries_[j].sequence_, history.entries_[newest].sequence_))
+            newest = j;
+    }
+
+    ApplyQuantizedTransform(node, history.entries_[newest].transform_, settings_);
+    history.appliedSequence_ = history.entries_[newest].sequence_;
+    history.hasApplied_ = true;
+}
+
+void TransformSnapshotReader::Clear()
+{
+    nodes_.clear();
+    latestSequence_ = 0;
+    receivedMask_ = 0;
+    hasReceived_ = false;
+    ackPending_ = false;
+}
+
+}
@@ -0,0 +1,226 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+/// \file
+
+#pragma once
+
+#include "../Container/HashMap.h"
+#include "../IO/MemoryBuffer.h"
+#include "../IO/VectorBuffer.h"
+#include "../Scene/ReplicationState.h"
+
+namespace Urho3D
+{
+
+class Context;
+class Node;
+class Scene;
+
+/// Scene replication mode of the server.
+enum ReplicationMode
+{
+    /// Node transforms are sent as full precision latest data messages.
+    REPLICATION_DEFAULT = 0,
+    /// Node transforms are quantized, bit-packed and delta compressed against the last acknowledged state per client.
+    REPLICATION_QUANTIZED
+};
+
+/// Quantization settings of the transform snapshot stream.
+struct URHO3D_API TransformQuantization
+{
+    /// 2D mode: send only x, y and the roll angle. Z is replicated only when the node is created.
+    bool twoDimensional_{};
+    /// Fractional bits of the fixed point positions, i.e. position precision is 1 / 2^bits.
+    unsigned positionBits_{8};
+    /// Bits of the roll angle in 2D mode, or of each smallest-three quaternion component in 3D mode.
+    unsigned rotationBits_{12};
+    /// Snapshot size limit in bytes. Nodes that do not fit are sent on the next update.
+    unsigned maxSnapshotBytes_{1200};
+};
+
+/// Writes bits into a byte buffer, least significant bit first.
+class URHO3D_API BitWriter
+{
+public:
+    /// Construct writing to the end of a buffer.
+    explicit BitWriter(VectorBuffer& dest);
+
+    /// Write the lowest bits of a value. Bit count must be 0-32.
+    void Write(u32 value, unsigned bits);
+    /// Write a bool as a single bit.
+    void WriteBit(bool value) { Write(value ? 1u : 0u, 1); }
+    /// Write an unsigned value with a 5-bit length prefix.
+    void WriteVarBits(u32 value);
+    /// Write a signed value with zigzag encoding and a 5-bit length prefix.
+    void WriteSignedVarBits(i32 value) { WriteVarBits(((u32)value << 1u) ^ (u32)(value >> 31)); }
+    /// Write remaining bits to the buffer.
+    void Flush();
+
+    /// Return number of bytes written including unflushed bits.
+    unsigned GetNumBytes() const { return (bitsWritten_ + 7) >> 3u; }
+
+private:
+    /// Destination buffer.
+    VectorBuffer& dest_;
+    /// Pending bits.
+    u64 scratch_;
+    /// Number of pending bits.
+    unsigned scratchBits_;
+    /// Total number of bits written.
+    unsigned bitsWritten_;
+};
+
+/// Reads bits written by BitWriter.
+class URHO3D_API BitReader
+{
+public:
+    /// Construct reading from the current position of a buffer.
+    explicit BitReader(MemoryBuffer& source);
+
+    /// Read a value. Bit count must be 0-32. Returns zero and sets the error flag past the end of data.
+    u32 Read(unsigned bits);
+    /// Read a single bit as a bool.
+    bool ReadBit() { return Read(1) != 0; }
+    /// Read an unsigned value with a 5-bit length prefix.
+    u32 ReadVarBits();
+    /// Read a signed value with zigzag encoding and a 5-bit length prefix.
+    i32 ReadSignedVarBits()
+    {
+        u32 value = ReadVarBits();
+        return (i32)(value >> 1u) ^ -(i32)(value & 1u);
+    }
+
+    /// Return whether tried to read past the end of data.
+    bool HasError() const { return error_; }
+
+private:
+    /// Source data.
+    const byte* data_;
+    /// Source data size in bytes.
+    unsigned size_;
+    /// Read position in bits.
+    unsigned position_;
+    /// Error flag.
+    bool error_;
+};
+
+/// Quantize a node's transform.
+URHO3D_API QuantizedTransform QuantizeTransform(Node* node, const TransformQuantization& settings);
+/// Apply a quantized transform to a node, through the SmoothedTransform component if it exists.
+URHO3D_API void ApplyQuantizedTransform(Node* node, const QuantizedTransform& transform, const TransformQuantization& settings);
+
+/// Server side writer of the transform snapshot stream for one client.
+class URHO3D_API TransformSnapshotWriter
+{
+public:
+    /// Construct.
+    TransformSnapshotWriter();
+
+    /// Set quantization settings. Resets all baselines of the scene replication state if they change.
+    void SetQuantization(const TransformQuantization& settings, SceneReplicationState& sceneState);
+    /// Clear the dirty network position and rotation bits of a node and queue it for the next snapshot instead. Return true if the node had transform changes.
+    bool TakeTransformChanges(const Vector<AttributeInfo>* attributes, NodeReplicationState& nodeState);
+    /// Queue a node for the next snapshot.
+    void AddNode(NodeReplicationState& nodeState);
+    /// Remove a node, for example when its replication state is about to be erased.
+    void RemoveNode(NodeReplicationState& nodeState);
+    /// Remove all nodes.
+    void Clear();
+    /// Write a snapshot. Return false if there was nothing to send.
+    bool WriteSnapshot(VectorBuffer& dest);
+    /// Process an acknowledgement: latest received sequence and a bitmask of the 32 sequences before it.
+    void Acknowledge(u16 sequence, u32 receivedMask);
+
+    /// Return quantization settings.
+    const TransformQuantization& GetQuantization() const { return settings_; }
+    /// Return number of nodes with unacknowledged transform changes.
+    unsigned GetNumActiveNodes() const { return activeNodes_.Size(); }
+
+private:
+    /// Quantization settings.
+    TransformQuantization settings_;
+    /// Nodes with transform changes the client has not acknowledged yet.
+    Vector<NodeReplicationState*> activeNodes_;
+    /// Network attributes the indices were resolved from.
+    const Vector<AttributeInfo>* cachedAttributes_;
+    /// Network position attribute index.
+    unsigned positionIndex_;
+    /// Network rotation attribute index.
+    unsigned rotationIndex_;
+    /// Next snapshot sequence number.
+    u16 sequence_;
+    /// Index of the active node to start the next snapshot from, so that truncated snapshots do not starve any node.
+    unsigned cursor_;
+};
+
+/// Client side reader of the transform snapshot stream.
+class URHO3D_API TransformSnapshotReader
+{
+public:
+    /// Construct.
+    TransformSnapshotReader();
+
+    /// Read a snapshot and apply it to the scene's nodes. Return false if it was malformed or referenced a missing baseline.
+    bool ReadSnapshot(MemoryBuffer& source, Scene* scene);
+    /// Write an acknowledgement of the received snapshots. Return false if nothing was received since the last one.
+    bool WriteAck(VectorBuffer& dest);
+    /// Forget a removed node.
+    void RemoveNode(id32 nodeID);
+    /// Apply the newest received transform to a node created after its snapshots arrived.
+    void ApplyLatest(Node* node);
+    /// Forget all nodes and received snapshots.
+    void Clear();
+
+private:
+    /// Received transforms of one node.
+    struct NodeHistory
+    {
+        /// Ring buffer of received transforms.
+        SentTransform entries_[MAX_SNAPSHOT_BASELINE_AGE];
+        /// Next ring buffer index.
+        unsigned next_{};
+        /// Number of valid entries.
+        unsigned count_{};
+        /// Sequence of the newest transform applied to the node.
+        u16 appliedSequence_{};
+        /// Whether a transform has been applied to the node.
+        bool hasApplied_{};
+    };
+
+    /// Received transforms by node ID.
+    HashMap<id32, NodeHistory> nodes_;
+    /// Quantization settings of the latest snapshot.
+    TransformQuantization settings_;
+    /// Latest successfully read sequence.
+    u16 latestSequence_;
+    /// Bitmask of successfully read sequences before the latest.
+    u32 receivedMask_;
+    /// Whether any snapshot has been read.
+    bool hasReceived_;
+    /// Whether an acknowledgement should be sent.
+    bool ackPending_;
+};
+
+/// Loopback benchmark results, averaged per update tick.
+struct URHO3D_API ReplicationBenchmarkResult
+{
+    /// Bytes sent to all clients in default replication mode.
+    float defaultBytes_{};
+    /// Server CPU microseconds in default replication mode.
+    float defaultUSec_{};
+    /// Bytes sent to all clients in quantized replication mode.
+    float quantizedBytes_{};
+    /// Server CPU microseconds in quantized replication mode, including acknowledgement processing.
+    float quantizedUSec_{};
+    /// Client CPU microseconds to decode and apply the quantized snapshots of all clients.
+    float quantizedClientUSec_{};
+    /// Largest position error on the client after the last tick.
+    float maxPositionError_{};
+};
+
+/// Run a loopback replication benchmark of moving nodes for a number of clients, comparing default and quantized replication. Results are also logged. The EngineBenchmark extra runs it from the command line.
+URHO3D_API ReplicationBenchmarkResult RunReplicationBenchmark(Context* context, unsigned numClients, unsigned numNodes,
+    unsigned numTicks, float packetLoss = 0.0f, const TransformQuantization& settings = TransformQuantization());
+
+}
@@ -0,0 +1,285 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+// 复制性能测试：在内存回环中比较默认复制与量化快照复制的每次更新字节数和 CPU 开销
+
+#include "../Precompiled.h"
+
+#include "../Core/Timer.h"
+#include "../IO/Log.h"
+#include "../Network/QuantizedReplication.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// 打包消息中每条消息的 ID 与长度头
+static const unsigned PACKED_MESSAGE_HEADER_BYTES = 8;
+// 确认消息回到服务器所需的更新次数，模拟往返延迟
+static const unsigned ACK_DELAY_TICKS = 2;
+// 模拟的网络更新间隔
+static const float BENCHMARK_TIME_STEP = 1.0f / 30.0f;
+
+namespace
+{
+
+/// Acknowledgement in flight from a client to the server.
+struct PendingAck
+{
+    /// Tick at which the server receives it.
+    unsigned deliverTick_;
+    /// Latest received sequence.
+    u16 sequence_;
+    /// Bitmask of received sequences before the latest.
+    u32 receivedMask_;
+};
+
+/// Simulated client of the benchmark.
+struct BenchmarkClient
+{
+    /// Replication state of the default mode.
+    SceneReplicationState defaultState_;
+    /// Replication state of the quantized mode.
+    SceneReplicationState quantizedState_;
+    /// Snapshot writer on the server.
+    TransformSnapshotWriter writer_;
+    /// Snapshot reader on the client.
+    TransformSnapshotReader reader_;
+    /// Acknowledgements in flight.
+    Vector<PendingAck> pendingAcks_;
+};
+
+/// Xorshift random number generator, so that runs are repeatable.
+struct BenchmarkRandom
+{
+    /// Return a random number in the range 0-1.
+    float Next()
+    {
+        state_ ^= state_ << 13u;
+        state_ ^= state_ >> 17u;
+        state_ ^= state_ << 5u;
+        return (float)(state_ & 0xffffffu) / (float)0x1000000;
+    }
+
+    /// Return a random number in the given range.
+    float Next(float min, float max) { return min + (max - min) * Next(); }
+
+    /// Generator state.
+    u32 state_{0x9e3779b9u};
+};
+
+void AddReplicationStates(SceneReplicationState& sceneState, const Vector<Node*>& nodes)
+{
+    for (Node* node : nodes)
+    {
+        NodeReplicationState& nodeState = sceneState.nodeStates_[node->GetID()];
+        nodeState.connection_ = nullptr;
+        nodeState.sceneState_ = &sceneState;
+        nodeState.node_ = node;
+        node->AddReplicationState(&nodeState);
+    }
+}
+
+}
+
+ReplicationBenchmarkResult RunReplicationBenchmark(Context* context, unsigned numClients, unsigned numNodes,
+    unsigned numTicks, float packetLoss, const TransformQuantization& settings)
+{
+    numClients = Max(numClients, 1u);
+    numNodes = Max(numNodes, 1u);
+    numTicks = Max(numTicks, 1u);
+
+    // 客户端状态需要比场景活得久：场景中的节点持有指向复制状态的指针
+    Vector<BenchmarkClient> clients(numClients);
+
+    // 所有客户端共用一个镜像场景，只用于检验解码结果
+    SharedPtr<Scene> serverScene(new Scene(context));
+    SharedPtr<Scene> clientScene(new Scene(context));
+
+    BenchmarkRandom random;
+    Vector<Node*> nodes;
+    Vector<Vector3> velocities;
+    Vector<float> angularVelocities;
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* node = serverScene->CreateChild(String::EMPTY, REPLICATED);
+        node->SetPosition(Vector3(random.Next(-50.0f, 50.0f), random.Next(-50.0f, 50.0f), settings.twoDimensional_ ? 0.0f :
+            random.Next(-50.0f, 50.0f)));
+        node->SetRotation(Quaternion(random.Next(-180.0f, 180.0f)));
+        nodes.Push(node);
+
+        // 只有一半节点在运动，静止节点在量化模式下不应产生任何流量
+        bool moving = (i & 1u) == 0;
+        velocities.Push(moving ? Vector3(random.Next(-2.0f, 2.0f), random.Next(-2.0f, 2.0f), settings.twoDimensional_ ? 0.0f :
+            random.Next(-2.0f, 2.0f)) : Vector3::ZERO);
+        angularVelocities.Push(moving ? random.Next(-90.0f, 90.0f) : 0.0f);
+
+        Node* clientNode = clientScene->CreateChild(String::EMPTY, REPLICATED, node->GetID());
+        clientNode->SetTransform(node->GetPosition(), node->GetRotation());
+    }
+
+    for (BenchmarkClient& client : clients)
+    {
+        AddReplicationStates(client.defaultState_, nodes);
+        AddReplicationStates(client.quantizedState_, nodes);
+        client.writer_.SetQuantization(settings, client.quantizedState_);
+    }
+
+    // 初始状态视为已随节点创建发送
+    serverScene->PrepareNetworkUpdate();
+    for (BenchmarkClient& client : clients)
+    {
+        for (auto i = client.defaultState_.nodeStates_.begin(); i != client.defaultState_.nodeStates_.end(); ++i)
+        {
+            i->second.dirtyAttributes_.ClearAll();
+            i->second.markedDirty_ = false;
+        }
+        for (auto i = client.quantizedState_.nodeStates_.begin(); i != client.quantizedState_.nodeStates_.end(); ++i)
+        {
+            i->second.dirtyAttributes_.ClearAll();
+            i->second.markedDirty_ = false;
+        }
+        client.defaultState_.dirtyNodes_.clear();
+        client.quantizedState_.dirtyNodes_.clear();
+    }
+
+    ReplicationBenchmarkResult result;
+    HiresTimer timer;
+    VectorBuffer msg;
+    VectorBuffer ack;
+    long long defaultUSec = 0;
+    long long quantizedUSec = 0;
+    long long clientUSec = 0;
+    unsigned long long defaultBytes = 0;
+    unsigned long long quantizedBytes = 0;
+
+    for (unsigned tick = 0; tick < numTicks; ++tick)
+    {
+        for (unsigned i = 0; i < numNodes; ++i)
+        {
+            if (angularVelocities[i] == 0.0f)
+                continue;
+
+            Node* node = nodes[i];
+            node->SetTransform(node->GetPosition() + velocities[i] * BENCHMARK_TIME_STEP,
+                Quaternion(angularVelocities[i] * BENCHMARK_TIME_STEP) * node->GetRotation());
+        }
+
+        // 属性变化检测由两种模式共享，不计入对比
+        serverScene->PrepareNetworkUpdate();
+
+        // 默认模式：每个客户端、每个变化节点一条 latest data 消息
+        timer.Reset();
+        for (BenchmarkClient& client : clients)
+        {
+            SceneReplicationState& sceneState = client.defaultState_;
+            for (auto i = sceneState.dirtyNodes_.begin(); i != sceneState.dirtyNodes_.end(); ++i)
+            {
+                NodeReplicationState& nodeState = sceneState.nodeStates_[*i];
+                Node* node = nodeState.node_;
+                const Vector<AttributeInfo>* attributes = node->GetNetworkAttributes();
+                bool hasLatestData = false;
+                for (i32 j = 0; j < attributes->Size(); ++j)
+                {
+                    if (nodeState.dirtyAttributes_.IsSet(j) && (attributes->At(j).mode_ & AM_LATESTDATA))
+                        hasLatestData = true;
+                }
+
+                if (hasLatestData)
+                {
+                    msg.Clear();
+                    msg.WriteNetID(node->GetID());
+                    node->WriteLatestDataUpdate(msg, (unsigned char)tick);
+                    defaultBytes += msg.GetSize() + PACKED_MESSAGE_HEADER_BYTES;
+                }
+
+                nodeState.dirtyAttributes_.ClearAll();
+                nodeState.markedDirty_ = false;
+            }
+            sceneState.dirtyNodes_.clear();
+        }
+        defaultUSec += timer.GetUSec(false);
+
+        // 量化模式：处理到期的确认，收集变换变化，每个客户端写一条快照
+        for (BenchmarkClient& client : clients)
+        {
+            timer.Reset();
+            for (i32 i = 0; i < client.pendingAcks_.Size();)
+            {
+                const PendingAck& pending = client.pendingAcks_[i];
+                if (pending.deliverTick_ <= tick)
+                {
+                    client.writer_.Acknowledge(pending.sequence_, pending.receivedMask_);
+                    client.pendingAcks_.Erase(i);
+                }
+                else
+                    ++i;
+            }
+
+            SceneReplicationState& sceneState = client.quantizedState_;
+            for (auto i = sceneState.dirtyNodes_.begin(); i != sceneState.dirtyNodes_.end(); ++i)
+            {
+                NodeReplicationState& nodeState = sceneState.nodeStates_[*i];
+                client.writer_.TakeTransformChanges(nodeState.node_->GetNetworkAttributes(), nodeState);
+                nodeState.dirtyAttributes_.ClearAll();
+                nodeState.markedDirty_ = false;
+            }
+            sceneState.dirtyNodes_.clear();
+
+            msg.Clear();
+            bool hasSnapshot = client.writer_.WriteSnapshot(msg);
+            quantizedUSec += timer.GetUSec(false);
+
+            if (!hasSnapshot)
+                continue;
+
+            quantizedBytes += msg.GetSize() + PACKED_MESSAGE_HEADER_BYTES;
+            if (random.Next() < packetLoss)
+                continue;
+
+            timer.Reset();
+            MemoryBuffer source(msg.GetData(), msg.GetSize());
+            client.reader_.ReadSnapshot(source, clientScene);
+            ack.Clear();
+            bool hasAck = client.reader_.WriteAck(ack);
+            clientUSec += timer.GetUSec(false);
+
+            if (hasAck && random.Next() >= packetLoss)
+            {
+                MemoryBuffer ackSource(ack.GetData(), ack.GetSize());
+                PendingAck pending;
+                pending.deliverTick_ = tick + ACK_DELAY_TICKS;
+                pending.sequence_ = ackSource.ReadU16();
+                pending.receivedMask_ = ackSource.ReadU32();
+                client.pendingAcks_.Push(pending);
+            }
+        }
+    }
+
+    for (Node* node : nodes)
+    {
+        Node* clientNode = clientScene->GetNode(node->GetID());
+        if (clientNode)
+            result.maxPositionError_ = Max(result.maxPositionError_, (clientNode->GetPosition() - node->GetPosition()).Length());
+    }
+
+    auto ticks = (float)numTicks;
+    result.defaultBytes_ = (float)defaultBytes / ticks;
+    result.defaultUSec_ = (float)defaultUSec / ticks;
+    result.quantizedBytes_ = (float)quantizedBytes / ticks;
+    result.quantizedUSec_ = (float)quantizedUSec / ticks;
+    result.quantizedClientUSec_ = (float)clientUSec / ticks;
+
+    URHO3D_LOGINFOF("Replication benchmark: %u clients, %u nodes (half moving), %u ticks, %.1f%% packet loss", numClients,
+        numNodes, numTicks, packetLoss * 100.0f);
+    URHO3D_LOGINFOF("  Default:   %.0f bytes/tick, %.1f us/tick server", result.defaultBytes_, result.defaultUSec_);
+    URHO3D_LOGINFOF("  Quantized: %.0f bytes/tick, %.1f us/tick server, %.1f us/tick clients, max position error %f",
+        result.quantizedBytes_, result.quantizedUSec_, result.quantizedClientUSec_, result.maxPositionError_);
+
+    return result;
+}
+
+}
@@ -67,7 +67,12 @@ void CollisionShape2D::SetTrigger(bool trigger)
     fixtureDef_.isSensor = trigger;
 
     if (fixture_)
+    {
+        // Box2D wakes the body when the sensor flag changes
         fixture_->SetSensor(trigger);
+        if (rigidBody_)
+            rigidBody_->MarkAwake();
+    }
 
     MarkNetworkUpdate();
 }
@@ -80,7 +85,11 @@ void CollisionShape2D::SetCategoryBits(int categoryBits)
     fixtureDef_.filter.categoryBits = (uint16)categoryBits;
 
     if (fixture_)
+    {
+        // Contacts that no longer pass the filter are destroyed on the next step, which wakes the touching bodies
+        rigidBody_->MarkContactsAwake(fixture_);
         fixture_->SetFilterData(fixtureDef_.filter);
+    }
 
     MarkNetworkUpdate();
 }
@@ -93,7 +102,10 @@ void CollisionShape2D::SetMaskBits(int maskBits)
     fixtureDef_.filter.maskBits = (uint16)maskBits;
 
     if (fixture_)
+    {
+        rigidBody_->MarkContactsAwake(fixture_);
         fixture_->SetFilterData(fixtureDef_.filter);
+    }
 
     MarkNetworkUpdate();
 }
@@ -106,7 +118,10 @@ void CollisionShape2D::SetGroupIndex(int groupIndex)
     fixtureDef_.filter.groupIndex = (int16)groupIndex;
 
     if (fixture_)
+    {
+        rigidBody_->MarkContactsAwake(fixture_);
         fixture_->SetFilterData(fixtureDef_.filter);
+    }
 
     MarkNetworkUpdate();
 }
@@ -224,6 +239,9 @@ void CollisionShape2D::ReleaseFixture()
     if (!body)
         return;
 
+    // Destroying the contacts wakes the touching bodies
+    rigidBody_->MarkContactsAwake(fixture_);
+
     b2MassData massData = body->GetMassData();
     body->DestroyFixture(fixture_);
     if (!rigidBody_->GetUseFixtureMass()) // Workaround for resetting mass in DestroyFixture().
@@ -89,7 +89,11 @@ void Constraint2D::ReleaseJoint()
         otherBody_->RemoveConstraint2D(this);
 
     if (physicsWorld_)
+    {
+        // Box2D wakes both bodies when a joint is destroyed
         physicsWorld_->GetWorld()->DestroyJoint(joint_);
+        MarkBodiesAwake();
+    }
 
     joint_ = nullptr;
 }
@@ -156,6 +160,14 @@ void Constraint2D::InitializeJointDef(b2JointDef* jointDef)
     jointDef->collideConnected = collideConnected_;
 }
 
+void Constraint2D::MarkBodiesAwake()
+{
+    if (ownerBody_)
+        ownerBody_->MarkAwake();
+    if (otherBody_)
+        otherBody_->MarkAwake();
+}
+
 void Constraint2D::RecreateJoint()
 {
     if (attachedConstraint_)
@@ -74,6 +74,8 @@ protected:
     void RecreateJoint();
     /// Initialize joint def.
     void InitializeJointDef(b2JointDef* jointDef);
+    /// Keep both bodies in the physics world's awake list after a joint change that wakes them in Box2D.
+    void MarkBodiesAwake();
     /// Mark other body node ID dirty.
     void MarkOtherBodyNodeIDDirty() { otherBodyNodeIDDirty_ = true; }
 
@@ -45,7 +45,10 @@ void ConstraintMotor2D::SetLinearOffset(const Vector2& linearOffset)
     linearOffset_ = linearOffset;
 
     if (joint_)
+    {
         static_cast<b2MotorJoint*>(joint_)->SetLinearOffset(ToB2Vec2(linearOffset));
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -60,7 +63,10 @@ void ConstraintMotor2D::SetAngularOffset(float angularOffset)
     jointDef_.angularOffset = angularOffset;
 
     if (joint_)
+    {
         static_cast<b2MotorJoint*>(joint_)->SetAngularOffset(angularOffset);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
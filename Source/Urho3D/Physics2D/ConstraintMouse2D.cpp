@@ -43,7 +43,12 @@ void ConstraintMouse2D::SetTarget(const Vector2& target)
     target_ = target;
 
     if (joint_)
+    {
+        // Moving the target wakes the dragged body
         static_cast<b2MouseJoint*>(joint_)->SetTarget(ToB2Vec2(target));
+        if (ownerBody_)
+            ownerBody_->MarkAwake();
+    }
     else
         RecreateJoint();
 
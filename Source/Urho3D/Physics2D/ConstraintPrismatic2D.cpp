@@ -70,7 +70,10 @@ void ConstraintPrismatic2D::SetEnableLimit(bool enableLimit)
     jointDef_.enableLimit = enableLimit;
 
     if (joint_)
+    {
         static_cast<b2PrismaticJoint*>(joint_)->EnableLimit(enableLimit);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -85,7 +88,10 @@ void ConstraintPrismatic2D::SetLowerTranslation(float lowerTranslation)
     jointDef_.lowerTranslation = lowerTranslation;
 
     if (joint_)
+    {
         static_cast<b2PrismaticJoint*>(joint_)->SetLimits(lowerTranslation, jointDef_.upperTranslation);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -100,7 +106,10 @@ void ConstraintPrismatic2D::SetUpperTranslation(float upperTranslation)
     jointDef_.upperTranslation = upperTranslation;
 
     if (joint_)
+    {
         static_cast<b2PrismaticJoint*>(joint_)->SetLimits(jointDef_.lowerTranslation, upperTranslation);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -115,7 +124,10 @@ void ConstraintPrismatic2D::SetEnableMotor(bool enableMotor)
     jointDef_.enableMotor = enableMotor;
 
     if (joint_)
+    {
         static_cast<b2PrismaticJoint*>(joint_)->EnableMotor(enableMotor);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -130,7 +142,10 @@ void ConstraintPrismatic2D::SetMaxMotorForce(float maxMotorForce)
     jointDef_.maxMotorForce = maxMotorForce;
 
     if (joint_)
+    {
         static_cast<b2PrismaticJoint*>(joint_)->SetMaxMotorForce(maxMotorForce);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -145,7 +160,10 @@ void ConstraintPrismatic2D::SetMotorSpeed(float motorSpeed)
     jointDef_.motorSpeed = motorSpeed;
 
     if (joint_)
+    {
         static_cast<b2PrismaticJoint*>(joint_)->SetMotorSpeed(motorSpeed);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -57,7 +57,10 @@ void ConstraintRevolute2D::SetEnableLimit(bool enableLimit)
     jointDef_.enableLimit = enableLimit;
 
     if (joint_)
+    {
         static_cast<b2RevoluteJoint*>(joint_)->EnableLimit(enableLimit);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -72,7 +75,10 @@ void ConstraintRevolute2D::SetLowerAngle(float lowerAngle)
     jointDef_.lowerAngle = lowerAngle;
 
     if (joint_)
+    {
         static_cast<b2RevoluteJoint*>(joint_)->SetLimits(lowerAngle, jointDef_.upperAngle);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -87,7 +93,10 @@ void ConstraintRevolute2D::SetUpperAngle(float upperAngle)
     jointDef_.upperAngle = upperAngle;
 
     if (joint_)
+    {
         static_cast<b2RevoluteJoint*>(joint_)->SetLimits(jointDef_.lowerAngle, upperAngle);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -102,7 +111,10 @@ void ConstraintRevolute2D::SetEnableMotor(bool enableMotor)
     jointDef_.enableMotor = enableMotor;
 
     if (joint_)
+    {
         static_cast<b2RevoluteJoint*>(joint_)->EnableMotor(enableMotor);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -117,7 +129,10 @@ void ConstraintRevolute2D::SetMotorSpeed(float motorSpeed)
     jointDef_.motorSpeed = motorSpeed;
 
     if (joint_)
+    {
         static_cast<b2RevoluteJoint*>(joint_)->SetMotorSpeed(motorSpeed);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -132,7 +147,10 @@ void ConstraintRevolute2D::SetMaxMotorTorque(float maxMotorTorque)
     jointDef_.maxMotorTorque = maxMotorTorque;
 
     if (joint_)
+    {
         static_cast<b2RevoluteJoint*>(joint_)->SetMaxMotorTorque(maxMotorTorque);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -73,7 +73,10 @@ void ConstraintWheel2D::SetEnableMotor(bool enableMotor)
     jointDef_.enableMotor = enableMotor;
 
     if (joint_)
+    {
         static_cast<b2WheelJoint*>(joint_)->EnableMotor(enableMotor);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -88,7 +91,10 @@ void ConstraintWheel2D::SetMaxMotorTorque(float maxMotorTorque)
     jointDef_.maxMotorTorque = maxMotorTorque;
 
     if (joint_)
+    {
         static_cast<b2WheelJoint*>(joint_)->SetMaxMotorTorque(maxMotorTorque);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -103,7 +109,10 @@ void ConstraintWheel2D::SetMotorSpeed(float motorSpeed)
     jointDef_.motorSpeed = motorSpeed;
 
     if (joint_)
+    {
         static_cast<b2WheelJoint*>(joint_)->SetMotorSpeed(motorSpeed);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -192,7 +201,10 @@ void ConstraintWheel2D::SetLowerTranslation(float lowerTranslation)
     jointDef_.lowerTranslation = lowerTranslation;
 
     if (joint_)
+    {
         static_cast<b2WheelJoint*>(joint_)->SetLimits(lowerTranslation, jointDef_.upperTranslation);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -207,7 +219,10 @@ void ConstraintWheel2D::SetUpperTranslation(float upperTranslation)
     jointDef_.upperTranslation = upperTranslation;
 
     if (joint_)
+    {
         static_cast<b2WheelJoint*>(joint_)->SetLimits(jointDef_.lowerTranslation, upperTranslation);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -222,7 +237,10 @@ void ConstraintWheel2D::SetEnableLimit(bool enableLimit)
     jointDef_.enableLimit = enableLimit;
 
     if (joint_)
+    {
         static_cast<b2WheelJoint*>(joint_)->EnableLimit(enableLimit);
+        MarkBodiesAwake();
+    }
     else
         RecreateJoint();
 
@@ -21,6 +21,83 @@ URHO3D_EVENT(E_PHYSICSPOSTSTEP, PhysicsPostStep)
 namespace Urho3D
 {
 
+class CollisionShape2D;
+class Node;
+class PhysicsWorld2D;
+class RigidBody2D;
+class VectorBuffer;
+
+/// Maximum number of points in a 2D contact manifold.
+inline constexpr i32 MAX_CONTACT_POINTS_2D = 2;
+
+/// Contact points carried by the typed 2D contact event payloads. Serialized to the P_CONTACTS buffer for VariantMap handlers.
+struct URHO3D_API ContactPoints2D
+{
+    /// Write to a contact buffer: position (Vector2), normal (Vector2), negative overlap distance (float) per point.
+    const Vector<byte>& Serialize(VectorBuffer& buffer) const;
+    /// Write to a byte vector in the same format, reusing its capacity.
+    void Serialize(Vector<byte>& dest) const;
+    /// Read from a contact buffer.
+    void Deserialize(const Vector<byte>& buffer);
+
+    /// Number of contact points.
+    i32 numPoints_{};
+    /// Contact normal in world space.
+    Vector2 normal_;
+    /// Contact positions in world space.
+    Vector2 positions_[MAX_CONTACT_POINTS_2D];
+    /// Contact overlap values.
+    float separations_[MAX_CONTACT_POINTS_2D]{};
+};
+
+/// Typed payload of E_PHYSICSBEGINCONTACT2D and E_PHYSICSENDCONTACT2D for Object::SendTypedEvent().
+struct URHO3D_API PhysicsContact2DPayload
+{
+    /// Fill event data.
+    void ToVariantMap(VariantMap& eventData) const;
+    /// Read from event data.
+    void FromVariantMap(const VariantMap& eventData);
+
+    /// Physics world.
+    PhysicsWorld2D* world_{};
+    /// Rigid body A.
+    RigidBody2D* bodyA_{};
+    /// Rigid body B.
+    RigidBody2D* bodyB_{};
+    /// Node A.
+    Node* nodeA_{};
+    /// Node B.
+    Node* nodeB_{};
+    /// Shape A.
+    CollisionShape2D* shapeA_{};
+    /// Shape B.
+    CollisionShape2D* shapeB_{};
+    /// Contact points.
+    ContactPoints2D contacts_;
+};
+
+/// Typed payload of E_NODEBEGINCONTACT2D and E_NODEENDCONTACT2D for Object::SendTypedEvent().
+struct URHO3D_API NodeContact2DPayload
+{
+    /// Fill event data.
+    void ToVariantMap(VariantMap& eventData) const;
+    /// Read from event data.
+    void FromVariantMap(const VariantMap& eventData);
+
+    /// Rigid body of the receiving node.
+    RigidBody2D* body_{};
+    /// Other node.
+    Node* otherNode_{};
+    /// Other rigid body.
+    RigidBody2D* otherBody_{};
+    /// Shape of the receiving node.
+    CollisionShape2D* shape_{};
+    /// Other shape.
+    CollisionShape2D* otherShape_{};
+    /// Contact points.
+    ContactPoints2D contacts_;
+};
+
 /// Physics update contact. Global event sent by PhysicsWorld2D.
 URHO3D_EVENT(E_PHYSICSUPDATECONTACT2D, PhysicsUpdateContact2D)
 {
@@ -5,10 +5,12 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../Physics2D/CollisionShape2D.h"
 #include "../Physics2D/PhysicsEvents2D.h"
 #include "../Physics2D/PhysicsUtils2D.h"
@@ -17,6 +19,10 @@
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
+#include <box2d/b2_distance.h>
+
+#include <EASTL/sort.h>
+
 #include "../DebugNew.h"
 
 using namespace std;
@@ -28,12 +34,16 @@ extern const char* SUBSYSTEM_CATEGORY;
 static const Vector2 DEFAULT_GRAVITY(0.0f, -9.81f);
 static const int DEFAULT_VELOCITY_ITERATIONS = 8;
 static const int DEFAULT_POSITION_ITERATIONS = 3;
+static const int DEFAULT_MAX_SUBSTEPS = 8;
+// 批量查询时每个工作项至少处理的查询数，单条射线的开销很小，避免工作项调度开销占主导
+static const i32 MIN_QUERIES_PER_WORK_ITEM = 32;
 
 PhysicsWorld2D::PhysicsWorld2D(Context* context) :
     Component(context),
     gravity_(DEFAULT_GRAVITY),
     velocityIterations_(DEFAULT_VELOCITY_ITERATIONS),
-    positionIterations_(DEFAULT_POSITION_ITERATIONS)
+    positionIterations_(DEFAULT_POSITION_ITERATIONS),
+    maxSubSteps_(DEFAULT_MAX_SUBSTEPS)
 {
     // Set default debug draw flags
     m_drawFlags = e_shapeBit;
@@ -74,6 +84,9 @@ void PhysicsWorld2D::RegisterObject(Context* context)
         AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Position Iterations", GetPositionIterations, SetPositionIterations, DEFAULT_POSITION_ITERATIONS,
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Physics FPS", GetFps, SetFps, 0, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Substeps", GetMaxSubSteps, SetMaxSubSteps, DEFAULT_MAX_SUBSTEPS, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Interpolation", GetInterpolation, SetInterpolation, true, AM_DEFAULT);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -265,6 +278,44 @@ void PhysicsWorld2D::Update(float timeStep)
 {
     URHO3D_PROFILE(UpdatePhysics2D);
 
+    if (fps_ <= 0)
+    {
+        StepSimulation(timeStep);
+        return;
+    }
+
+    float internalTimeStep = 1.0f / (float)fps_;
+    timeAcc_ += timeStep;
+
+    int numSteps = 0;
+    while (timeAcc_ >= internalTimeStep && numSteps < maxSubSteps_)
+    {
+        // 睡眠物体的变换不会改变，只需保存可能移动的物体
+        if (interpolation_)
+        {
+            UpdateParentedRigidBodies();
+            for (RigidBody2D* rigidBody : awakeRigidBodies_)
+                rigidBody->SavePreviousTransform();
+            for (RigidBody2D* rigidBody : parentedRigidBodies_)
+                rigidBody->SavePreviousTransform();
+        }
+
+        StepSimulation(internalTimeStep);
+        timeAcc_ -= internalTimeStep;
+        ++numSteps;
+    }
+
+    // 超过子步上限时丢弃整步的积压时间，只保留不足一步的部分用于插值
+    if (timeAcc_ >= internalTimeStep)
+        timeAcc_ = Mod(timeAcc_, internalTimeStep);
+
+    // 插值只改变节点变换，不写回 Box2D 物体
+    if (interpolation_)
+        ApplyWorldTransforms(timeAcc_ / internalTimeStep);
+}
+
+void PhysicsWorld2D::StepSimulation(float timeStep)
+{
     using namespace PhysicsPreStep;
 
     VariantMap& eventData = GetEventDataMap();
@@ -276,22 +327,46 @@ void PhysicsWorld2D::Update(float timeStep)
     world_->Step(timeStep, velocityIterations_, positionIterations_);
     physicsStepping_ = false;
 
-    // Apply world transforms. Unparented transforms first
-    for (i32 i = 0; i < (i32)rigidBodies_.Size();)
+    ApplyWorldTransforms(1.0f);
+
+    SendBeginContactEvents();
+    SendEndContactEvents();
+
+    using namespace PhysicsPostStep;
+    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+}
+
+void PhysicsWorld2D::ApplyWorldTransforms(float interpolation)
+{
+    if (interpolation >= 1.0f)
+        AddConnectedAwakeRigidBodies();
+    UpdateParentedRigidBodies();
+
+    // Apply world transforms. Unparented transforms first, only for bodies that may have moved
+    for (i32 i = 0; i < awakeRigidBodies_.Size();)
     {
-        if (rigidBodies_[i])
+        RigidBody2D* rigidBody = awakeRigidBodies_[i];
+        if (!rigidBody->parentRigidBody_)
+            rigidBody->ApplyWorldTransform(interpolation);
+
+        // 已睡眠且不再处于插值中的物体移出列表，由唤醒挂钩或接触传播重新加入
+        b2Body* body = rigidBody->body_;
+        if (!body || rigidBody->parentRigidBody_ || (!rigidBody->interpolated_ && (!body->IsEnabled() ||
+            body->GetType() == b2_staticBody || !body->IsAwake())))
         {
-            rigidBodies_[i]->ApplyWorldTransform();
-            ++i;
+            // 睡眠期间变换不变，从当前变换开始插值
+            rigidBody->SavePreviousTransform();
+            RemoveAwakeRigidBody(rigidBody);
         }
         else
-        {
-            // Erase possible stale weak pointer
-            rigidBodies_.Erase(i);
-        }
+            ++i;
     }
 
-    // Apply delayed (parented) world transforms now, if any
+    // Parented transforms in parent chain depth order, so the parent's node is already in place
+    for (RigidBody2D* rigidBody : parentedRigidBodies_)
+        rigidBody->ApplyWorldTransform(interpolation);
+
+    // Apply delayed world transforms added from outside, if any
     while (!delayedWorldTransforms_.empty())
     {
         for (auto i = delayedWorldTransforms_.begin();
@@ -309,12 +384,61 @@ void PhysicsWorld2D::Update(float timeStep)
                 ++i;
         }
     }
+}
 
-    SendBeginContactEvents();
-    SendEndContactEvents();
+void PhysicsWorld2D::AddConnectedAwakeRigidBodies()
+{
+    // 列表在遍历中增长，新加入的物体也会继续向外传播
+    for (i32 i = 0; i < awakeRigidBodies_.Size(); ++i)
+    {
+        b2Body* body = awakeRigidBodies_[i]->body_;
+        if (!body || !body->IsAwake())
+            continue;
 
-    using namespace PhysicsPostStep;
-    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+        for (b2ContactEdge* edge = body->GetContactList(); edge; edge = edge->next)
+        {
+            b2Body* other = edge->other;
+            if (edge->contact->IsTouching() && other->IsAwake() && other->GetType() != b2_staticBody)
+                AddAwakeRigidBody((RigidBody2D*)other->GetUserData().pointer);
+        }
+
+        for (b2JointEdge* edge = body->GetJointList(); edge; edge = edge->next)
+        {
+            b2Body* other = edge->other;
+            if (other->IsAwake() && other->GetType() != b2_staticBody)
+                AddAwakeRigidBody((RigidBody2D*)other->GetUserData().pointer);
+        }
+    }
+}
+
+void PhysicsWorld2D::UpdateParentedRigidBodies()
+{
+    if (!parentedRigidBodiesDirty_)
+        return;
+
+    // 按父刚体链深度排序，链只在父子关系变化时才改变
+    Vector<Pair<unsigned, RigidBody2D*>> sorted;
+    for (const WeakPtr<RigidBody2D>& rigidBody : rigidBodies_)
+    {
+        if (!rigidBody || !rigidBody->parentRigidBody_)
+            continue;
+
+        unsigned depth = 0;
+        for (RigidBody2D* parent = rigidBody->parentRigidBody_; parent && depth < (unsigned)rigidBodies_.Size(); parent = parent->parentRigidBody_)
+            ++depth;
+        sorted.Push(MakePair(depth, rigidBody.Get()));
+    }
+
+    eastl::stable_sort(sorted.Begin(), sorted.End(), [](const Pair<unsigned, RigidBody2D*>& lhs, const Pair<unsigned, RigidBody2D*>& rhs)
+    {
+        return lhs.first_ < rhs.first_;
+    });
+
+    parentedRigidBodies_.Clear();
+    for (const Pair<unsigned, RigidBody2D*>& entry : sorted)
+        parentedRigidBodies_.Push(entry.second_);
+
+    parentedRigidBodiesDirty_ = false;
 }
 
 void PhysicsWorld2D::DrawDebugGeometry()
@@ -412,6 +536,22 @@ void PhysicsWorld2D::SetPositionIterations(int positionIterations)
     positionIterations_ = positionIterations;
 }
 
+void PhysicsWorld2D::SetFps(int fps)
+{
+    fps_ = Max(fps, 0);
+    timeAcc_ = 0.0f;
+}
+
+void PhysicsWorld2D::SetMaxSubSteps(int num)
+{
+    maxSubSteps_ = Max(num, 1);
+}
+
+void PhysicsWorld2D::SetInterpolation(bool enable)
+{
+    interpolation_ = enable;
+}
+
 void PhysicsWorld2D::AddRigidBody(RigidBody2D* rigidBody)
 {
     if (!rigidBody)
@@ -431,6 +571,9 @@ void PhysicsWorld2D::RemoveRigidBody(RigidBody2D* rigidBody)
 
     WeakPtr<RigidBody2D> rigidBodyPtr(rigidBody);
     rigidBodies_.Remove(rigidBodyPtr);
+    RemoveAwakeRigidBody(rigidBody);
+    parentedRigidBodies_.Remove(rigidBody);
+    delayedWorldTransforms_.erase(rigidBody);
 }
 
 void PhysicsWorld2D::AddDelayedWorldTransform(const DelayedWorldTransform2D& transform)
@@ -438,6 +581,29 @@ void PhysicsWorld2D::AddDelayedWorldTransform(const DelayedWorldTransform2D& tra
     delayedWorldTransforms_[transform.rigidBody_] = transform;
 }
 
+void PhysicsWorld2D::AddAwakeRigidBody(RigidBody2D* rigidBody)
+{
+    if (!rigidBody || rigidBody->awakeIndex_ != M_MAX_UNSIGNED)
+        return;
+
+    rigidBody->awakeIndex_ = awakeRigidBodies_.Size();
+    awakeRigidBodies_.Push(rigidBody);
+}
+
+void PhysicsWorld2D::RemoveAwakeRigidBody(RigidBody2D* rigidBody)
+{
+    unsigned index = rigidBody->awakeIndex_;
+    if (index == M_MAX_UNSIGNED)
+        return;
+
+    RigidBody2D* last = awakeRigidBodies_.Back();
+    awakeRigidBodies_[index] = last;
+    last->awakeIndex_ = index;
+    awakeRigidBodies_.Pop();
+
+    rigidBody->awakeIndex_ = M_MAX_UNSIGNED;
+}
+
 // Ray cast call back class.
 class RayCastCallback : public b2RayCastCallback
 {
@@ -504,12 +670,12 @@ public:
     // Called for each fixture found in the query.
     float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
     {
-        // Ignore sensor
+        // Ignore sensor. Returning 1 would reset the clipped ray to full length, -1 filters the fixture out
         if (fixture->IsSensor())
-            return true;
+            return -1.0f;
 
         if ((fixture->GetFilterData().maskBits & collisionMask_) == 0)
-            return true;
+            return -1.0f;
 
         float distance = (ToVector2(point) - startPoint_).Length();
         if (distance < minDistance_)
@@ -522,7 +688,8 @@ public:
             result_.body_ = (RigidBody2D*)(fixture->GetBody()->GetUserData().pointer);
         }
 
-        return true;
+        // 裁剪射线到当前命中点，之后只会报告更近的夹具
+        return fraction;
     }
 
 private:
@@ -662,6 +829,396 @@ void PhysicsWorld2D::GetRigidBodies(Vector<RigidBody2D*>& results, const Rect& a
     world_->QueryAABB(&callback, b2Aabb);
 }
 
+namespace
+{
+
+/// Shared state of a query batch, passed to the work items.
+struct QueryBatch2D
+{
+    /// Box2D world. Only read during the batch.
+    const b2World* world_;
+    /// First query.
+    const void* queries_;
+    /// Closest hit results.
+    PhysicsRaycastResult2D* hits_;
+    /// Rigid body results.
+    RigidBody2D** bodies_;
+    /// Number of rigid body results per query.
+    unsigned* numBodies_;
+    /// Maximum number of rigid body results per query.
+    unsigned maxBodies_;
+};
+
+/// Return Box2D transform of a shape query.
+b2Transform GetQueryTransform(const PhysicsShapeQuery2D& query)
+{
+    return b2Transform(ToB2Vec2(query.position_), b2Rot(query.rotation_ * M_DEGTORAD));
+}
+
+/// Return Box2D AABB of a shape query's shape, optionally swept along the translation.
+b2AABB GetQueryAABB(const PhysicsShapeQuery2D& query, const b2Transform& transform, bool swept)
+{
+    b2AABB aabb;
+    query.shape_->ComputeAABB(&aabb, transform, 0);
+    for (i32 i = 1; i < query.shape_->GetChildCount(); ++i)
+    {
+        b2AABB childAabb;
+        query.shape_->ComputeAABB(&childAabb, transform, i);
+        aabb.Combine(childAabb);
+    }
+
+    if (swept)
+    {
+        b2AABB endAabb = aabb;
+        endAabb.lowerBound += ToB2Vec2(query.translation_);
+        endAabb.upperBound += ToB2Vec2(query.translation_);
+        aabb.Combine(endAabb);
+    }
+
+    return aabb;
+}
+
+}
+
+// Batched overlap query call back class. Writes distinct rigid bodies to a caller-provided array.
+class BatchOverlapQueryCallback : public b2QueryCallback
+{
+public:
+    // Construct for a box query.
+    BatchOverlapQueryCallback(RigidBody2D** results, unsigned maxResults, u16 collisionMask, const b2AABB& aabb) :
+        results_(results),
+        maxResults_(maxResults),
+        numResults_(0),
+        collisionMask_(collisionMask),
+        aabb_(aabb),
+        shape_(nullptr)
+    {
+    }
+
+    // Construct for a shape query.
+    BatchOverlapQueryCallback(RigidBody2D** results, unsigned maxResults, u16 collisionMask, const b2Shape* shape,
+        const b2Transform& transform) :
+        results_(results),
+        maxResults_(maxResults),
+        numResults_(0),
+        collisionMask_(collisionMask),
+        shape_(shape),
+        transform_(transform)
+    {
+    }
+
+    // Called for each fixture found in the query AABB.
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+        // Ignore sensor
+        if (fixture->IsSensor())
+            return true;
+
+        if ((fixture->GetFilterData().maskBits & collisionMask_) == 0)
+            return true;
+
+        // A body with several fixtures is reported once
+        auto* rigidBody = (RigidBody2D*)(fixture->GetBody()->GetUserData().pointer);
+        for (unsigned i = 0; i < numResults_; ++i)
+        {
+            if (results_[i] == rigidBody)
+                return true;
+        }
+
+        if (!Overlaps(fixture))
+            return true;
+
+        results_[numResults_++] = rigidBody;
+        return numResults_ < maxResults_;
+    }
+
+    // Return number of results.
+    unsigned GetNumResults() const { return numResults_; }
+
+private:
+    // Test the fixture's children against the query box or shape. The broadphase only tests the fattened AABBs.
+    bool Overlaps(b2Fixture* fixture) const
+    {
+        const b2Shape* fixtureShape = fixture->GetShape();
+        const b2Transform& fixtureTransform = fixture->GetBody()->GetTransform();
+        for (i32 i = 0; i < fixtureShape->GetChildCount(); ++i)
+        {
+            if (!shape_)
+            {
+                if (b2TestOverlap(fixture->GetAABB(i), aabb_))
+                    return true;
+                continue;
+            }
+
+            for (i32 j = 0; j < shape_->GetChildCount(); ++j)
+            {
+                if (b2TestOverlap(fixtureShape, i, shape_, j, fixtureTransform, transform_))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Results.
+    RigidBody2D** results_;
+    // Maximum number of results.
+    unsigned maxResults_;
+    // Number of results.
+    unsigned numResults_;
+    // Collision mask.
+    u16 collisionMask_;
+    // Query box.
+    b2AABB aabb_;
+    // Query shape, null for a box query.
+    const b2Shape* shape_;
+    // Query shape transform.
+    b2Transform transform_;
+};
+
+// Batched shape cast call back class. Keeps the closest hit.
+class BatchShapeCastCallback : public b2QueryCallback
+{
+public:
+    // Construct.
+    BatchShapeCastCallback(PhysicsRaycastResult2D& result, const PhysicsShapeQuery2D& query, const b2Transform& transform) :
+        result_(result),
+        query_(query),
+        transform_(transform),
+        translation_(ToB2Vec2(query.translation_)),
+        minLambda_(M_INFINITY)
+    {
+    }
+
+    // Called for each fixture found in the swept query AABB.
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+        // Ignore sensor
+        if (fixture->IsSensor())
+            return true;
+
+        if ((fixture->GetFilterData().maskBits & query_.collisionMask_) == 0)
+            return true;
+
+        b2ShapeCastInput input;
+        input.transformA = fixture->GetBody()->GetTransform();
+        input.transformB = transform_;
+        input.translationB = translation_;
+
+        const b2Shape* fixtureShape = fixture->GetShape();
+        for (i32 i = 0; i < fixtureShape->GetChildCount(); ++i)
+        {
+            input.proxyA.Set(fixtureShape, i);
+            for (i32 j = 0; j < query_.shape_->GetChildCount(); ++j)
+            {
+                input.proxyB.Set(query_.shape_, j);
+
+                b2ShapeCastOutput output;
+                if (b2ShapeCast(&output, &input) && output.lambda < minLambda_)
+                {
+                    minLambda_ = output.lambda;
+
+                    result_.position_ = ToVector2(output.point);
+                    result_.normal_ = ToVector2(output.normal);
+                    result_.distance_ = output.lambda * query_.translation_.Length();
+                    result_.body_ = (RigidBody2D*)(fixture->GetBody()->GetUserData().pointer);
+                }
+            }
+        }
+
+        return true;
+    }
+
+private:
+    // Physics raycast result.
+    PhysicsRaycastResult2D& result_;
+    // Query.
+    const PhysicsShapeQuery2D& query_;
+    // Query shape start transform.
+    b2Transform transform_;
+    // Query shape translation.
+    b2Vec2 translation_;
+    // Minimum translation fraction.
+    float minLambda_;
+};
+
+static void RaycastSingleWork(const WorkItem* item, i32 /*threadIndex*/)
+{
+    auto* batch = reinterpret_cast<QueryBatch2D*>(item->aux_);
+    auto* start = reinterpret_cast<const PhysicsRaycastQuery2D*>(item->start_);
+    auto* end = reinterpret_cast<const PhysicsRaycastQuery2D*>(item->end_);
+    auto* queries = reinterpret_cast<const PhysicsRaycastQuery2D*>(batch->queries_);
+
+    for (const PhysicsRaycastQuery2D* query = start; query != end; ++query)
+    {
+        PhysicsRaycastResult2D& result = batch->hits_[query - queries];
+        result.body_ = nullptr;
+
+        // Box2D asserts on zero length rays
+        b2Vec2 startPoint = ToB2Vec2(query->startPoint_);
+        b2Vec2 endPoint = ToB2Vec2(query->endPoint_);
+        if ((endPoint - startPoint).LengthSquared() <= 0.0f)
+            continue;
+
+        SingleRayCastCallback callback(result, query->startPoint_, query->collisionMask_);
+        batch->world_->RayCast(&callback, startPoint, endPoint);
+    }
+}
+
+static void GetRigidBodiesAabbWork(const WorkItem* item, i32 /*threadIndex*/)
+{
+    auto* batch = reinterpret_cast<QueryBatch2D*>(item->aux_);
+    auto* start = reinterpret_cast<const PhysicsAabbQuery2D*>(item->start_);
+    auto* end = reinterpret_cast<const PhysicsAabbQuery2D*>(item->end_);
+    auto* queries = reinterpret_cast<const PhysicsAabbQuery2D*>(batch->queries_);
+
+    for (const PhysicsAabbQuery2D* query = start; query != end; ++query)
+    {
+        unsigned index = (unsigned)(query - queries);
+
+        b2AABB b2Aabb;
+        Vector2 delta(M_EPSILON, M_EPSILON);
+        b2Aabb.lowerBound = ToB2Vec2(query->aabb_.min_ - delta);
+        b2Aabb.upperBound = ToB2Vec2(query->aabb_.max_ + delta);
+
+        BatchOverlapQueryCallback callback(batch->bodies_ + index * batch->maxBodies_, batch->maxBodies_, query->collisionMask_, b2Aabb);
+        batch->world_->QueryAABB(&callback, b2Aabb);
+        batch->numBodies_[index] = callback.GetNumResults();
+    }
+}
+
+static void GetRigidBodiesShapeWork(const WorkItem* item, i32 /*threadIndex*/)
+{
+    auto* batch = reinterpret_cast<QueryBatch2D*>(item->aux_);
+    auto* start = reinterpret_cast<const PhysicsShapeQuery2D*>(item->start_);
+    auto* end = reinterpret_cast<const PhysicsShapeQuery2D*>(item->end_);
+    auto* queries = reinterpret_cast<const PhysicsShapeQuery2D*>(batch->queries_);
+
+    for (const PhysicsShapeQuery2D* query = start; query != end; ++query)
+    {
+        unsigned index = (unsigned)(query - queries);
+        batch->numBodies_[index] = 0;
+        if (!query->shape_)
+            continue;
+
+        b2Transform transform = GetQueryTransform(*query);
+        BatchOverlapQueryCallback callback(batch->bodies_ + index * batch->maxBodies_, batch->maxBodies_, query->collisionMask_,
+            query->shape_, transform);
+        batch->world_->QueryAABB(&callback, GetQueryAABB(*query, transform, false));
+        batch->numBodies_[index] = callback.GetNumResults();
+    }
+}
+
+static void ShapeCastSingleWork(const WorkItem* item, i32 /*threadIndex*/)
+{
+    auto* batch = reinterpret_cast<QueryBatch2D*>(item->aux_);
+    auto* start = reinterpret_cast<const PhysicsShapeQuery2D*>(item->start_);
+    auto* end = reinterpret_cast<const PhysicsShapeQuery2D*>(item->end_);
+    auto* queries = reinterpret_cast<const PhysicsShapeQuery2D*>(batch->queries_);
+
+    for (const PhysicsShapeQuery2D* query = start; query != end; ++query)
+    {
+        PhysicsRaycastResult2D& result = batch->hits_[query - queries];
+        result.body_ = nullptr;
+        if (!query->shape_)
+            continue;
+
+        b2Transform transform = GetQueryTransform(*query);
+        BatchShapeCastCallback callback(result, *query, transform);
+        batch->world_->QueryAABB(&callback, GetQueryAABB(*query, transform, true));
+    }
+}
+
+void PhysicsWorld2D::RaycastSingle(const PhysicsRaycastQuery2D* queries, PhysicsRaycastResult2D* results, unsigned count)
+{
+    if (!count)
+        return;
+
+    if (physicsStepping_)
+    {
+        URHO3D_LOGERROR("Can not perform batched physics queries while the world is stepping");
+        return;
+    }
+
+    URHO3D_PROFILE(RaycastBatch2D);
+
+    // Box2D 的查询只读取世界，步进之间可以在多个线程上同时执行
+    QueryBatch2D batch{world_.get(), queries, results, nullptr, nullptr, 0};
+    // 工作项只读取查询数组
+    auto* begin = const_cast<PhysicsRaycastQuery2D*>(queries);
+    GetSubsystem<WorkQueue>()->ParallelFor(begin, begin + count, RaycastSingleWork, &batch, MIN_QUERIES_PER_WORK_ITEM);
+}
+
+void PhysicsWorld2D::GetRigidBodies(const PhysicsAabbQuery2D* queries, RigidBody2D** results, unsigned* numResults, unsigned count,
+    unsigned maxResults)
+{
+    if (!count)
+        return;
+
+    if (physicsStepping_)
+    {
+        URHO3D_LOGERROR("Can not perform batched physics queries while the world is stepping");
+        return;
+    }
+
+    if (!maxResults)
+    {
+        for (unsigned i = 0; i < count; ++i)
+            numResults[i] = 0;
+        return;
+    }
+
+    URHO3D_PROFILE(AabbQueryBatch2D);
+
+    QueryBatch2D batch{world_.get(), queries, nullptr, results, numResults, maxResults};
+    auto* begin = const_cast<PhysicsAabbQuery2D*>(queries);
+    GetSubsystem<WorkQueue>()->ParallelFor(begin, begin + count, GetRigidBodiesAabbWork, &batch, MIN_QUERIES_PER_WORK_ITEM);
+}
+
+void PhysicsWorld2D::GetRigidBodies(const PhysicsShapeQuery2D* queries, RigidBody2D** results, unsigned* numResults, unsigned count,
+    unsigned maxResults)
+{
+    if (!count)
+        return;
+
+    if (physicsStepping_)
+    {
+        URHO3D_LOGERROR("Can not perform batched physics queries while the world is stepping");
+        return;
+    }
+
+    if (!maxResults)
+    {
+        for (unsigned i = 0; i < count; ++i)
+            numResults[i] = 0;
+        return;
+    }
+
+    URHO3D_PROFILE(ShapeQueryBatch2D);
+
+    QueryBatch2D batch{world_.get(), queries, nullptr, results, numResults, maxResults};
+    auto* begin = const_cast<PhysicsShapeQuery2D*>(queries);
+    GetSubsystem<WorkQueue>()->ParallelFor(begin, begin + count, GetRigidBodiesShapeWork, &batch, MIN_QUERIES_PER_WORK_ITEM);
+}
+
+void PhysicsWorld2D::ShapeCastSingle(const PhysicsShapeQuery2D* queries, PhysicsRaycastResult2D* results, unsigned count)
+{
+    if (!count)
+        return;
+
+    if (physicsStepping_)
+    {
+        URHO3D_LOGERROR("Can not perform batched physics queries while the world is stepping");
+        return;
+    }
+
+    URHO3D_PROFILE(ShapeCastBatch2D);
+
+    QueryBatch2D batch{world_.get(), queries, results, nullptr, nullptr, 0};
+    auto* begin = const_cast<PhysicsShapeQuery2D*>(queries);
+    GetSubsystem<WorkQueue>()->ParallelFor(begin, begin + count, ShapeCastSingleWork, &batch, MIN_QUERIES_PER_WORK_ITEM);
+}
+
 bool PhysicsWorld2D::GetAllowSleeping() const
 {
     return world_->GetAllowSleeping();
@@ -691,9 +1248,27 @@ void PhysicsWorld2D::OnSceneSet(Scene* scene)
 {
     // Subscribe to the scene subsystem update, which will trigger the physics simulation step
     if (scene)
+    {
         SubscribeToEvent(scene, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(PhysicsWorld2D, HandleSceneSubsystemUpdate));
+        SubscribeToEvent(scene, E_NODEADDED, URHO3D_HANDLER(PhysicsWorld2D, HandleNodeAdded));
+    }
     else
+    {
         UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
+        UnsubscribeFromEvent(E_NODEADDED);
+    }
+}
+
+void PhysicsWorld2D::HandleNodeAdded(StringHash eventType, VariantMap& eventData)
+{
+    using namespace NodeAdded;
+
+    // Reparenting within the scene sends the node added event. The node's dirtying is not reliable for this, as it is
+    // not signaled again while the transform is already dirty
+    auto* node = static_cast<Node*>(eventData[P_NODE].GetPtr());
+    auto* rigidBody = node->GetComponent<RigidBody2D>();
+    if (rigidBody && rigidBody->physicsWorld_ == this)
+        rigidBody->UpdateParentRigidBody();
 }
 
 void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
@@ -710,45 +1285,39 @@ void PhysicsWorld2D::SendBeginContactEvents()
     if (beginContactInfos_.Empty())
         return;
 
-    using namespace PhysicsBeginContact2D;
-    VariantMap& eventData = GetEventDataMap();
-    VariantMap nodeEventData;
-    eventData[P_WORLD] = this;
+    // Typed payloads: VariantMap event data is only built if a handler subscribed without URHO3D_TYPED_HANDLER.
+    // It is built into maps kept by the world, as the pooled event data map is cleared on every send
+    PhysicsContact2DPayload payload;
+    NodeContact2DPayload nodePayload;
+    payload.world_ = this;
 
     for (const ContactInfo& contactInfo : beginContactInfos_)
     {
-        eventData[P_BODYA] = contactInfo.bodyA_.Get();
-        eventData[P_BODYB] = contactInfo.bodyB_.Get();
-        eventData[P_NODEA] = contactInfo.nodeA_.Get();
-        eventData[P_NODEB] = contactInfo.nodeB_.Get();
-        eventData[P_CONTACTS] = contactInfo.Serialize(contacts_);
-        eventData[P_SHAPEA] = contactInfo.shapeA_.Get();
-        eventData[P_SHAPEB] = contactInfo.shapeB_.Get();
-
-        SendEvent(E_PHYSICSBEGINCONTACT2D, eventData);
+        contactInfo.FillPayload(payload);
+        SendTypedEvent(E_PHYSICSBEGINCONTACT2D, payload, contactEventData_);
 
-        nodeEventData[NodeBeginContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
+        nodePayload.contacts_ = contactInfo.points_;
 
         if (contactInfo.nodeA_)
         {
-            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeB_.Get();
+            nodePayload.body_ = contactInfo.bodyA_;
+            nodePayload.otherNode_ = contactInfo.nodeB_;
+            nodePayload.otherBody_ = contactInfo.bodyB_;
+            nodePayload.shape_ = contactInfo.shapeA_;
+            nodePayload.otherShape_ = contactInfo.shapeB_;
 
-            contactInfo.nodeA_->SendEvent(E_NODEBEGINCONTACT2D, nodeEventData);
+            contactInfo.nodeA_->SendTypedEvent(E_NODEBEGINCONTACT2D, nodePayload, nodeContactEventData_);
         }
 
         if (contactInfo.nodeB_)
         {
-            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeA_.Get();
+            nodePayload.body_ = contactInfo.bodyB_;
+            nodePayload.otherNode_ = contactInfo.nodeA_;
+            nodePayload.otherBody_ = contactInfo.bodyA_;
+            nodePayload.shape_ = contactInfo.shapeB_;
+            nodePayload.otherShape_ = contactInfo.shapeA_;
 
-            contactInfo.nodeB_->SendEvent(E_NODEBEGINCONTACT2D, nodeEventData);
+            contactInfo.nodeB_->SendTypedEvent(E_NODEBEGINCONTACT2D, nodePayload, nodeContactEventData_);
         }
     }
 
@@ -760,45 +1329,39 @@ void PhysicsWorld2D::SendEndContactEvents()
     if (endContactInfos_.Empty())
         return;
 
-    using namespace PhysicsEndContact2D;
-    VariantMap& eventData = GetEventDataMap();
-    VariantMap nodeEventData;
-    eventData[P_WORLD] = this;
+    // Typed payloads: VariantMap event data is only built if a handler subscribed without URHO3D_TYPED_HANDLER.
+    // It is built into maps kept by the world, as the pooled event data map is cleared on every send
+    PhysicsContact2DPayload payload;
+    NodeContact2DPayload nodePayload;
+    payload.world_ = this;
 
     for (const ContactInfo& contactInfo : endContactInfos_)
     {
-        eventData[P_BODYA] = contactInfo.bodyA_.Get();
-        eventData[P_BODYB] = contactInfo.bodyB_.Get();
-        eventData[P_NODEA] = contactInfo.nodeA_.Get();
-        eventData[P_NODEB] = contactInfo.nodeB_.Get();
-        eventData[P_CONTACTS] = contactInfo.Serialize(contacts_);
-        eventData[P_SHAPEA] = contactInfo.shapeA_.Get();
-        eventData[P_SHAPEB] = contactInfo.shapeB_.Get();
+        contactInfo.FillPayload(payload);
+        SendTypedEvent(E_PHYSICSENDCONTACT2D, payload, contactEventData_);
 
-        SendEvent(E_PHYSICSENDCONTACT2D, eventData);
-
-        nodeEventData[NodeEndContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
+        nodePayload.contacts_ = contactInfo.points_;
 
         if (contactInfo.nodeA_)
         {
-            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeB_.Get();
+            nodePayload.body_ = contactInfo.bodyA_;
+            nodePayload.otherNode_ = contactInfo.nodeB_;
+            nodePayload.otherBody_ = contactInfo.bodyB_;
+            nodePayload.shape_ = contactInfo.shapeA_;
+            nodePayload.otherShape_ = contactInfo.shapeB_;
 
-            contactInfo.nodeA_->SendEvent(E_NODEENDCONTACT2D, nodeEventData);
+            contactInfo.nodeA_->SendTypedEvent(E_NODEENDCONTACT2D, nodePayload, nodeContactEventData_);
         }
 
         if (contactInfo.nodeB_)
         {
-            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeA_.Get();
+            nodePayload.body_ = contactInfo.bodyB_;
+            nodePayload.otherNode_ = contactInfo.nodeA_;
+            nodePayload.otherBody_ = contactInfo.bodyA_;
+            nodePayload.shape_ = contactInfo.shapeB_;
+            nodePayload.otherShape_ = contactInfo.shapeA_;
 
-            contactInfo.nodeB_->SendEvent(E_NODEENDCONTACT2D, nodeEventData);
+            contactInfo.nodeB_->SendTypedEvent(E_NODEENDCONTACT2D, nodePayload, nodeContactEventData_);
         }
     }
 
@@ -820,25 +1383,138 @@ PhysicsWorld2D::ContactInfo::ContactInfo(b2Contact* contact)
 
     b2WorldManifold worldManifold;
     contact->GetWorldManifold(&worldManifold);
-    numPoints_ = contact->GetManifold()->pointCount;
-    worldNormal_ = Vector2(worldManifold.normal.x, worldManifold.normal.y);
-    for (int i = 0; i < numPoints_; ++i)
+    points_.numPoints_ = contact->GetManifold()->pointCount;
+    points_.normal_ = Vector2(worldManifold.normal.x, worldManifold.normal.y);
+    for (int i = 0; i < points_.numPoints_; ++i)
     {
-        worldPositions_[i] = Vector2(worldManifold.points[i].x, worldManifold.points[i].y);
-        separations_[i] = worldManifold.separations[i];
+        points_.positions_[i] = Vector2(worldManifold.points[i].x, worldManifold.points[i].y);
+        points_.separations_[i] = worldManifold.separations[i];
     }
 }
 
 const Urho3D::Vector<byte>& PhysicsWorld2D::ContactInfo::Serialize(VectorBuffer& buffer) const
+{
+    return points_.Serialize(buffer);
+}
+
+void PhysicsWorld2D::ContactInfo::FillPayload(PhysicsContact2DPayload& payload) const
+{
+    payload.bodyA_ = bodyA_;
+    payload.bodyB_ = bodyB_;
+    payload.nodeA_ = nodeA_;
+    payload.nodeB_ = nodeB_;
+    payload.shapeA_ = shapeA_;
+    payload.shapeB_ = shapeB_;
+    payload.contacts_ = points_;
+}
+
+static_assert(MAX_CONTACT_POINTS_2D == b2_maxManifoldPoints, "Contact point count mismatch");
+
+/// Return an event parameter, or empty if missing.
+static const Variant& GetEventParam(const VariantMap& eventData, StringHash key)
+{
+    auto i = eventData.find(key);
+    return i != eventData.end() ? i->second : Variant::EMPTY;
+}
+
+const Urho3D::Vector<byte>& ContactPoints2D::Serialize(VectorBuffer& buffer) const
 {
     buffer.Clear();
     for (int i = 0; i < numPoints_; ++i)
     {
-        buffer.WriteVector2(worldPositions_[i]);
-        buffer.WriteVector2(worldNormal_);
+        buffer.WriteVector2(positions_[i]);
+        buffer.WriteVector2(normal_);
         buffer.WriteFloat(separations_[i]);
     }
     return buffer.GetBuffer();
 }
 
+void ContactPoints2D::Serialize(Vector<byte>& dest) const
+{
+    const i32 pointSize = 2 * sizeof(Vector2) + sizeof(float);
+    dest.Resize(numPoints_ * pointSize);
+    byte* data = dest.data();
+    for (int i = 0; i < numPoints_; ++i)
+    {
+        memcpy(data, &positions_[i], sizeof(Vector2));
+        memcpy(data + sizeof(Vector2), &normal_, sizeof(Vector2));
+        memcpy(data + 2 * sizeof(Vector2), &separations_[i], sizeof(float));
+        data += pointSize;
+    }
+}
+
+void ContactPoints2D::Deserialize(const Vector<byte>& buffer)
+{
+    MemoryBuffer source(buffer);
+    numPoints_ = 0;
+    while (!source.IsEof() && numPoints_ < MAX_CONTACT_POINTS_2D)
+    {
+        positions_[numPoints_] = source.ReadVector2();
+        normal_ = source.ReadVector2();
+        separations_[numPoints_] = source.ReadFloat();
+        ++numPoints_;
+    }
+}
+
+// PhysicsWorld2D 在发送之间保留事件数据映射，直接写入已有的缓冲变量即可避免分配
+static void WriteContactPoints(const ContactPoints2D& contacts, VariantMap& eventData, StringHash key)
+{
+    Variant& value = eventData[key];
+    if (value.GetType() != VAR_BUFFER)
+        value = Vector<byte>();
+    contacts.Serialize(*value.GetBufferPtr());
+}
+
+void PhysicsContact2DPayload::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace PhysicsBeginContact2D;
+
+    eventData[P_WORLD] = world_;
+    eventData[P_BODYA] = bodyA_;
+    eventData[P_BODYB] = bodyB_;
+    eventData[P_NODEA] = nodeA_;
+    eventData[P_NODEB] = nodeB_;
+    WriteContactPoints(contacts_, eventData, P_CONTACTS);
+    eventData[P_SHAPEA] = shapeA_;
+    eventData[P_SHAPEB] = shapeB_;
+}
+
+void PhysicsContact2DPayload::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace PhysicsBeginContact2D;
+
+    world_ = static_cast<PhysicsWorld2D*>(GetEventParam(eventData, P_WORLD).GetPtr());
+    bodyA_ = static_cast<RigidBody2D*>(GetEventParam(eventData, P_BODYA).GetPtr());
+    bodyB_ = static_cast<RigidBody2D*>(GetEventParam(eventData, P_BODYB).GetPtr());
+    nodeA_ = static_cast<Node*>(GetEventParam(eventData, P_NODEA).GetPtr());
+    nodeB_ = static_cast<Node*>(GetEventParam(eventData, P_NODEB).GetPtr());
+    shapeA_ = static_cast<CollisionShape2D*>(GetEventParam(eventData, P_SHAPEA).GetPtr());
+    shapeB_ = static_cast<CollisionShape2D*>(GetEventParam(eventData, P_SHAPEB).GetPtr());
+    contacts_.Deserialize(GetEventParam(eventData, P_CONTACTS).GetBuffer());
+}
+
+void NodeContact2DPayload::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace NodeBeginContact2D;
+
+    eventData[P_BODY] = body_;
+    eventData[P_OTHERNODE] = otherNode_;
+    eventData[P_OTHERBODY] = otherBody_;
+    WriteContactPoints(contacts_, eventData, P_CONTACTS);
+    eventData[P_SHAPE] = shape_;
+    eventData[P_OTHERSHAPE] = otherShape_;
+}
+
+void NodeContact2DPayload::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace NodeBeginContact2D;
+
+    body_ = static_cast<RigidBody2D*>(GetEventParam(eventData, P_BODY).GetPtr());
+    otherNode_ = static_cast<Node*>(GetEventParam(eventData, P_OTHERNODE).GetPtr());
+    otherBody_ = static_cast<RigidBody2D*>(GetEventParam(eventData, P_OTHERBODY).GetPtr());
+    shape_ = static_cast<CollisionShape2D*>(GetEventParam(eventData, P_SHAPE).GetPtr());
+    otherShape_ = static_cast<CollisionShape2D*>(GetEventParam(eventData, P_OTHERSHAPE).GetPtr());
+    contacts_.Deserialize(GetEventParam(eventData, P_CONTACTS).GetBuffer());
+}
+
 }
@@ -5,6 +5,7 @@
 
 #include "../Scene/Component.h"
 #include "../IO/VectorBuffer.h"
+#include "../Physics2D/PhysicsEvents2D.h"
 
 #include <box2d/box2d.h>
 
@@ -36,6 +37,41 @@ struct URHO3D_API PhysicsRaycastResult2D
     RigidBody2D* body_{};
 };
 
+/// Ray of a batched 2D physics raycast.
+struct URHO3D_API PhysicsRaycastQuery2D
+{
+    /// Ray start point.
+    Vector2 startPoint_;
+    /// Ray end point.
+    Vector2 endPoint_;
+    /// Collision mask.
+    u16 collisionMask_{M_U16_MASK_ALL_BITS};
+};
+
+/// Box of a batched 2D physics box query.
+struct URHO3D_API PhysicsAabbQuery2D
+{
+    /// Query box.
+    Rect aabb_;
+    /// Collision mask.
+    u16 collisionMask_{M_U16_MASK_ALL_BITS};
+};
+
+/// Shape of a batched 2D physics overlap query or shape cast.
+struct URHO3D_API PhysicsShapeQuery2D
+{
+    /// Box2D shape. Not owned, must stay alive until the batch returns.
+    const b2Shape* shape_{};
+    /// Worldspace position of the shape.
+    Vector2 position_;
+    /// Rotation of the shape in degrees.
+    float rotation_{};
+    /// Movement of the shape for shape casts. Ignored by overlap queries.
+    Vector2 translation_;
+    /// Collision mask.
+    u16 collisionMask_{M_U16_MASK_ALL_BITS};
+};
+
 /// Delayed world transform assignment for parented 2D rigidbodies.
 struct DelayedWorldTransform2D
 {
@@ -90,7 +126,7 @@ public:
     /// Draw a point.
     void DrawPoint(const b2Vec2& p, float size, const b2Color& color) override;
 
-    /// Step the simulation forward.
+    /// Step the simulation forward. In fixed rate mode, the time step is accumulated and the simulation is stepped by whole fixed steps.
     void Update(float timeStep);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
@@ -136,12 +172,27 @@ public:
     /// Set position iterations.
     /// @property
     void SetPositionIterations(int positionIterations);
+    /// Set simulation steps per second. Zero (default) steps once per update with the variable update time step.
+    /// @property
+    void SetFps(int fps);
+    /// Set maximum number of fixed steps per update. Time beyond that is dropped, which slows the simulation down instead of making long frames longer.
+    /// @property
+    void SetMaxSubSteps(int num);
+    /// Set whether node transforms are interpolated between the last two fixed steps. Only used in fixed rate mode.
+    /// @property
+    void SetInterpolation(bool enable);
     /// Add rigid body.
     void AddRigidBody(RigidBody2D* rigidBody);
     /// Remove rigid body.
     void RemoveRigidBody(RigidBody2D* rigidBody);
-    /// Add a delayed world transform assignment. Called by RigidBody2D.
+    /// Add a delayed world transform assignment, applied after the parent rigid body's own delayed assignment.
     void AddDelayedWorldTransform(const DelayedWorldTransform2D& transform);
+    /// Add a rigid body to the awake list, whose node transforms are synced after each step. Called by RigidBody2D.
+    void AddAwakeRigidBody(RigidBody2D* rigidBody);
+    /// Remove a rigid body from the awake list. Called by RigidBody2D.
+    void RemoveAwakeRigidBody(RigidBody2D* rigidBody);
+    /// Mark the parented rigid body list to be rebuilt after a parent rigid body link changed. Called by RigidBody2D.
+    void MarkParentedRigidBodiesDirty() { parentedRigidBodiesDirty_ = true; }
 
     /// Perform a physics world raycast and return all hits.
     void Raycast(Vector<PhysicsRaycastResult2D>& results, const Vector2& startPoint, const Vector2& endPoint,
@@ -156,6 +207,22 @@ public:
     /// Return rigid bodies by a box query.
     void GetRigidBodies(Vector<RigidBody2D*>& results, const Rect& aabb, u16 collisionMask = M_U16_MASK_ALL_BITS);
 
+    /// Perform a batch of raycasts in parallel and write the closest hit of each ray to the result at the same index. Rays that hit nothing get a null body.
+    /// Must not be called while the world is stepping.
+    /// @nobind
+    void RaycastSingle(const PhysicsRaycastQuery2D* queries, PhysicsRaycastResult2D* results, unsigned count);
+    /// Perform a batch of box queries in parallel. Query i writes up to maxResults distinct rigid bodies whose fixtures overlap the box to results + i * maxResults,
+    /// and their number to numResults[i]. Must not be called while the world is stepping.
+    /// @nobind
+    void GetRigidBodies(const PhysicsAabbQuery2D* queries, RigidBody2D** results, unsigned* numResults, unsigned count, unsigned maxResults);
+    /// Perform a batch of shape overlap queries in parallel. Results are written like in the box query batch. Must not be called while the world is stepping.
+    /// @nobind
+    void GetRigidBodies(const PhysicsShapeQuery2D* queries, RigidBody2D** results, unsigned* numResults, unsigned count, unsigned maxResults);
+    /// Perform a batch of shape casts along the query translations in parallel and write the closest hit to the result at the same index.
+    /// The hit distance is measured along the translation. Fixtures the shape overlaps at its start position are not reported. Must not be called while the world is stepping.
+    /// @nobind
+    void ShapeCastSingle(const PhysicsShapeQuery2D* queries, PhysicsRaycastResult2D* results, unsigned count);
+
     /// Return whether physics world will automatically simulate during scene update.
     /// @property
     bool IsUpdateEnabled() const { return updateEnabled_; }
@@ -208,6 +275,18 @@ public:
     /// @property
     int GetPositionIterations() const { return positionIterations_; }
 
+    /// Return simulation steps per second, zero if stepping with the update time step.
+    /// @property
+    int GetFps() const { return fps_; }
+
+    /// Return maximum number of fixed steps per update.
+    /// @property
+    int GetMaxSubSteps() const { return maxSubSteps_; }
+
+    /// Return whether node transforms are interpolated in fixed rate mode.
+    /// @property
+    bool GetInterpolation() const { return interpolation_; }
+
     /// Return the Box2D physics world.
     b2World* GetWorld() { return world_.get(); }
 
@@ -223,6 +302,16 @@ protected:
 
     /// Handle the scene subsystem update event, step simulation here.
     void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle a node being added or reparented in the scene. Update the parent rigid body of its rigid body.
+    void HandleNodeAdded(StringHash eventType, VariantMap& eventData);
+    /// Step the Box2D world once, apply world transforms and send step and contact events.
+    void StepSimulation(float timeStep);
+    /// Apply world transforms of rigid bodies to their nodes, interpolated between the previous and current step by a factor.
+    void ApplyWorldTransforms(float interpolation);
+    /// Add bodies woken by the simulation to the awake list. Box2D wakes bodies through touching contacts and joints of awake bodies.
+    void AddConnectedAwakeRigidBodies();
+    /// Rebuild the parented rigid body list sorted by parent chain depth, if dirty.
+    void UpdateParentedRigidBodies();
     /// Send begin contact events.
     void SendBeginContactEvents();
     /// Send end contact events.
@@ -237,6 +326,14 @@ protected:
     int velocityIterations_{};
     /// Position iterations.
     int positionIterations_{};
+    /// Simulation steps per second, zero for variable time step.
+    int fps_{};
+    /// Maximum number of fixed steps per update.
+    int maxSubSteps_{};
+    /// Whether to interpolate node transforms in fixed rate mode.
+    bool interpolation_{true};
+    /// Accumulated time not yet simulated in fixed rate mode.
+    float timeAcc_{};
 
     /// Extra weak pointer to scene to allow for cleanup in case the world is destroyed before other components.
     WeakPtr<Scene> scene_;
@@ -255,6 +352,12 @@ protected:
     Vector<WeakPtr<RigidBody2D>> rigidBodies_;
     /// Delayed (parented) world transform assignments.
     HashMap<RigidBody2D*, DelayedWorldTransform2D> delayedWorldTransforms_;
+    /// Unparented rigid bodies which may be moving. Bodies are removed once they have been synced asleep.
+    Vector<RigidBody2D*> awakeRigidBodies_;
+    /// Rigid bodies parented to another rigid body, parents before children.
+    Vector<RigidBody2D*> parentedRigidBodies_;
+    /// Parented rigid body list needs to be rebuilt flag.
+    bool parentedRigidBodiesDirty_{};
 
     /// Contact info.
     struct ContactInfo
@@ -265,6 +368,8 @@ protected:
         explicit ContactInfo(b2Contact* contact);
         /// Write contact info to buffer.
         const Vector<byte>& Serialize(VectorBuffer& buffer) const;
+        /// Fill the bodies, nodes, shapes and points of a typed contact event payload.
+        void FillPayload(PhysicsContact2DPayload& payload) const;
 
         /// Rigid body A.
         SharedPtr<RigidBody2D> bodyA_;
@@ -278,14 +383,8 @@ protected:
         SharedPtr<CollisionShape2D> shapeA_;
         /// Shape B.
         SharedPtr<CollisionShape2D> shapeB_;
-        /// Number of contact points.
-        int numPoints_{};
-        /// Contact normal in world space.
-        Vector2 worldNormal_;
-        /// Contact positions in world space.
-        Vector2 worldPositions_[b2_maxManifoldPoints];
-        /// Contact overlap values.
-        float separations_[b2_maxManifoldPoints]{};
+        /// Contact points in world space.
+        ContactPoints2D points_;
     };
     /// Begin contact infos.
     Vector<ContactInfo> beginContactInfos_;
@@ -293,6 +392,10 @@ protected:
     Vector<ContactInfo> endContactInfos_;
     /// Temporary buffer with contact data.
     VectorBuffer contacts_;
+    /// Event data of the physics contact events for VariantMap handlers. Kept between sends to reuse the contacts buffer.
+    VariantMap contactEventData_;
+    /// Event data of the node contact events for VariantMap handlers. Kept between sends to reuse the contacts buffer.
+    VariantMap nodeContactEventData_;
 };
 
 }
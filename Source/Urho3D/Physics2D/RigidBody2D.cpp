@@ -31,12 +31,17 @@ static const char* bodyTypeNames[] =
 RigidBody2D::RigidBody2D(Context* context) :
     Component(context),
     useFixtureMass_(true),
-    body_(nullptr)
+    body_(nullptr),
+    interpolatedAngle_(0.0f),
+    interpolated_(false),
+    awakeIndex_(M_MAX_UNSIGNED)
 {
     // Make sure the massData members are zero-initialized.
     massData_.mass = 0.0f;
     massData_.I = 0.0f;
     massData_.center.SetZero();
+    previousTransform_.SetIdentity();
+    interpolatedPosition_.SetZero();
 }
 
 RigidBody2D::~RigidBody2D()
@@ -78,7 +83,14 @@ void RigidBody2D::OnSetEnabled()
     bodyDef_.enabled = enabled;
 
     if (body_)
+    {
+        // Disabling destroys the contacts, which wakes the touching bodies
+        if (!enabled)
+            MarkContactsAwake();
         body_->SetEnabled(enabled);
+        if (enabled)
+            MarkAwake();
+    }
 
     MarkNetworkUpdate();
 }
@@ -89,6 +101,7 @@ void RigidBody2D::SetBodyType(BodyType2D type)
     if (body_)
     {
         body_->SetType(bodyType);
+        MarkAwake();
         // Mass data was reset to keep it legal (e.g. static body should have mass 0).
         // If not using fixture mass, reassign our mass data now
         if (!useFixtureMass_)
@@ -264,7 +277,11 @@ void RigidBody2D::SetGravityScale(float gravityScale)
 void RigidBody2D::SetAwake(bool awake)
 {
     if (body_)
+    {
         body_->SetAwake(awake);
+        if (awake)
+            MarkAwake();
+    }
     else
     {
         if (bodyDef_.awake == awake)
@@ -280,7 +297,10 @@ void RigidBody2D::SetLinearVelocity(const Vector2& linearVelocity)
 {
     b2Vec2 b2linearVelocity = ToB2Vec2(linearVelocity);
     if (body_)
+    {
         body_->SetLinearVelocity(b2linearVelocity);
+        MarkAwake();
+    }
     else
     {
         if (bodyDef_.linearVelocity == b2linearVelocity)
@@ -295,7 +315,10 @@ void RigidBody2D::SetLinearVelocity(const Vector2& linearVelocity)
 void RigidBody2D::SetAngularVelocity(float angularVelocity)
 {
     if (body_)
+    {
         body_->SetAngularVelocity(angularVelocity);
+        MarkAwake();
+    }
     else
     {
         if (bodyDef_.angularVelocity == angularVelocity)
@@ -310,37 +333,61 @@ void RigidBody2D::SetAngularVelocity(float angularVelocity)
 void RigidBody2D::ApplyForce(const Vector2& force, const Vector2& point, bool wake)
 {
     if (body_ && force != Vector2::ZERO)
+    {
         body_->ApplyForce(ToB2Vec2(force), ToB2Vec2(point), wake);
+        if (wake)
+            MarkAwake();
+    }
 }
 
 void RigidBody2D::ApplyForceToCenter(const Vector2& force, bool wake)
 {
     if (body_ && force != Vector2::ZERO)
+    {
         body_->ApplyForceToCenter(ToB2Vec2(force), wake);
+        if (wake)
+            MarkAwake();
+    }
 }
 
 void RigidBody2D::ApplyTorque(float torque, bool wake)
 {
     if (body_ && torque != 0)
+    {
         body_->ApplyTorque(torque, wake);
+        if (wake)
+            MarkAwake();
+    }
 }
 
 void RigidBody2D::ApplyLinearImpulse(const Vector2& impulse, const Vector2& point, bool wake)
 {
     if (body_ && impulse != Vector2::ZERO)
+    {
         body_->ApplyLinearImpulse(ToB2Vec2(impulse), ToB2Vec2(point), wake);
+        if (wake)
+            MarkAwake();
+    }
 }
 
 void RigidBody2D::ApplyLinearImpulseToCenter(const Vector2& impulse, bool wake)
 {
     if (body_ && impulse != Vector2::ZERO)
+    {
         body_->ApplyLinearImpulseToCenter(ToB2Vec2(impulse), wake);
+        if (wake)
+            MarkAwake();
+    }
 }
 
 void RigidBody2D::ApplyAngularImpulse(float impulse, bool wake)
 {
     if (body_)
+    {
         body_->ApplyAngularImpulse(impulse, wake);
+        if (wake)
+            MarkAwake();
+    }
 }
 
 void RigidBody2D::CreateBody()
@@ -356,6 +403,7 @@ void RigidBody2D::CreateBody()
 
     body_ = physicsWorld_->GetWorld()->CreateBody(&bodyDef_);
     body_->GetUserData().pointer = (uintptr_t)this;
+    previousTransform_ = body_->GetTransform();
 
     for (const WeakPtr<CollisionShape2D>& collisionShape : collisionShapes_)
     {
@@ -371,6 +419,8 @@ void RigidBody2D::CreateBody()
         if (constraint)
             constraint->CreateJoint();
     }
+
+    MarkAwake();
 }
 
 void RigidBody2D::ReleaseBody()
@@ -390,6 +440,9 @@ void RigidBody2D::ReleaseBody()
             constraint->ReleaseJoint();
     }
 
+    // Destroying the contacts wakes the touching bodies
+    MarkContactsAwake();
+
     for (const WeakPtr<CollisionShape2D>& collisionShape : collisionShapes_)
     {
         if (collisionShape)
@@ -398,41 +451,45 @@ void RigidBody2D::ReleaseBody()
 
     physicsWorld_->GetWorld()->DestroyBody(body_);
     body_ = nullptr;
+    physicsWorld_->RemoveAwakeRigidBody(this);
 }
 
-void RigidBody2D::ApplyWorldTransform()
+void RigidBody2D::ApplyWorldTransform(float interpolation)
 {
     if (!body_ || !node_)
         return;
 
-    // If the rigid body is parented to another rigid body, can not set the transform immediately.
-    // In that case store it to PhysicsWorld2D for delayed assignment
-    RigidBody2D* parentRigidBody = nullptr;
-    Node* parent = node_->GetParent();
-    if (parent != GetScene() && parent)
-        parentRigidBody = parent->GetComponent<RigidBody2D>();
-
-    // If body is not parented and is static or sleeping, no need to update
-    if (!parentRigidBody && (!body_->IsEnabled() || body_->GetType() == b2_staticBody || !body_->IsAwake()))
+    // If body is not parented and is static or sleeping, no need to update, unless it fell asleep while interpolated.
+    // Parented bodies are applied by PhysicsWorld2D after their parents, as the parent's movement changes their local transform
+    bool moving = body_->IsEnabled() && body_->GetType() != b2_staticBody && body_->IsAwake();
+    if (!parentRigidBody_ && !moving && !interpolated_)
         return;
 
     const b2Transform& transform = body_->GetTransform();
-    Vector3 newWorldPosition = node_->GetWorldPosition();
-    newWorldPosition.x_ = transform.p.x;
-    newWorldPosition.y_ = transform.p.y;
-    Quaternion newWorldRotation(transform.q.GetAngle() * M_RADTODEG, Vector3::FORWARD);
+    b2Vec2 position = transform.p;
+    float angle = transform.q.GetAngle();
 
-    if (parentRigidBody)
+    interpolated_ = moving && interpolation < 1.0f;
+    if (interpolated_)
     {
-        DelayedWorldTransform2D delayed;
-        delayed.rigidBody_ = this;
-        delayed.parentRigidBody_ = parentRigidBody;
-        delayed.worldPosition_ = newWorldPosition;
-        delayed.worldRotation_ = newWorldRotation;
-        physicsWorld_->AddDelayedWorldTransform(delayed);
+        // 沿最短方向插值角度，GetAngle() 的范围是 -pi...pi
+        float previousAngle = previousTransform_.q.GetAngle();
+        float deltaAngle = angle - previousAngle;
+        if (deltaAngle > b2_pi)
+            deltaAngle -= 2.0f * b2_pi;
+        else if (deltaAngle < -b2_pi)
+            deltaAngle += 2.0f * b2_pi;
+
+        position = previousTransform_.p + interpolation * (position - previousTransform_.p);
+        angle = previousAngle + interpolation * deltaAngle;
     }
-    else
-        ApplyWorldTransform(newWorldPosition, newWorldRotation);
+
+    Vector3 newWorldPosition = node_->GetWorldPosition();
+    newWorldPosition.x_ = position.x;
+    newWorldPosition.y_ = position.y;
+    Quaternion newWorldRotation(angle * M_RADTODEG, Vector3::FORWARD);
+
+    ApplyWorldTransform(newWorldPosition, newWorldRotation);
 }
 
 void RigidBody2D::ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation)
@@ -445,6 +502,46 @@ void RigidBody2D::ApplyWorldTransform(const Vector3& newWorldPosition, const Qua
         node_->SetWorldRotation(newWorldRotation);
         physicsWorld_->SetApplyingTransforms(false);
     }
+
+    // Remember the interpolated transform as read back from the node, so that it is not mistaken for a user change
+    if (interpolated_)
+    {
+        interpolatedPosition_ = ToB2Vec2(node_->GetWorldPosition());
+        interpolatedAngle_ = node_->GetWorldRotation().RollAngle() * M_DEGTORAD;
+    }
+}
+
+void RigidBody2D::SavePreviousTransform()
+{
+    if (body_)
+        previousTransform_ = body_->GetTransform();
+}
+
+void RigidBody2D::MarkAwake()
+{
+    if (physicsWorld_ && body_)
+        physicsWorld_->AddAwakeRigidBody(this);
+}
+
+void RigidBody2D::MarkContactsAwake(b2Fixture* fixture)
+{
+    if (!physicsWorld_ || !body_)
+        return;
+
+    bool touching = false;
+    for (b2ContactEdge* edge = body_->GetContactList(); edge; edge = edge->next)
+    {
+        b2Contact* contact = edge->contact;
+        if (!contact->IsTouching() || (fixture && contact->GetFixtureA() != fixture && contact->GetFixtureB() != fixture))
+            continue;
+
+        touching = true;
+        if (edge->other->GetType() != b2_staticBody)
+            physicsWorld_->AddAwakeRigidBody((RigidBody2D*)edge->other->GetUserData().pointer);
+    }
+
+    if (touching)
+        MarkAwake();
 }
 
 void RigidBody2D::AddCollisionShape2D(CollisionShape2D* collisionShape)
@@ -554,15 +651,19 @@ void RigidBody2D::OnSceneSet(Scene* scene)
 
         CreateBody();
         physicsWorld_->AddRigidBody(this);
+        UpdateParentRigidBody();
+        UpdateChildRigidBodies(false);
     }
     else
     {
         if (physicsWorld_)
         {
+            UpdateChildRigidBodies(true);
             ReleaseBody();
             physicsWorld_->RemoveRigidBody(this);
             physicsWorld_.Reset();
         }
+        parentRigidBody_.Reset();
     }
 }
 
@@ -588,8 +689,58 @@ void RigidBody2D::OnMarkedDirty(Node* node)
         bodyDef_.position = newPosition;
         bodyDef_.angle = newAngle;
     }
+    else if (interpolated_ && newPosition == interpolatedPosition_ && newAngle == interpolatedAngle_)
+        return;
     else if (newPosition != body_->GetPosition() || newAngle != body_->GetAngle())
+    {
+        // Moved from outside the simulation, do not interpolate from the old transform
         body_->SetTransform(newPosition, newAngle);
+        previousTransform_ = body_->GetTransform();
+        interpolated_ = false;
+    }
+}
+
+void RigidBody2D::UpdateParentRigidBody()
+{
+    Node* parentNode = node_ ? node_->GetParent() : nullptr;
+
+    RigidBody2D* parentRigidBody = nullptr;
+    if (parentNode && parentNode != GetScene())
+        parentRigidBody = parentNode->GetComponent<RigidBody2D>();
+    if (parentRigidBody == parentRigidBody_)
+        return;
+
+    parentRigidBody_ = parentRigidBody;
+    if (physicsWorld_)
+    {
+        physicsWorld_->MarkParentedRigidBodiesDirty();
+        // Unparented bodies are synced from the awake list
+        if (!parentRigidBody)
+            MarkAwake();
+    }
+}
+
+void RigidBody2D::UpdateChildRigidBodies(bool removed)
+{
+    if (!node_)
+        return;
+
+    for (const SharedPtr<Node>& child : node_->GetChildren())
+    {
+        auto* childRigidBody = child->GetComponent<RigidBody2D>();
+        if (!childRigidBody || !childRigidBody->physicsWorld_)
+            continue;
+
+        if (!removed)
+            childRigidBody->UpdateParentRigidBody();
+        else if (childRigidBody->parentRigidBody_ == this)
+        {
+            // The node still has this component while it is being removed, so unlink explicitly
+            childRigidBody->parentRigidBody_.Reset();
+            childRigidBody->physicsWorld_->MarkParentedRigidBodiesDirty();
+            childRigidBody->MarkAwake();
+        }
+    }
 }
 
 }
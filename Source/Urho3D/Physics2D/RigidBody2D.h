@@ -29,6 +29,8 @@ class URHO3D_API RigidBody2D : public Component
 {
     URHO3D_OBJECT(RigidBody2D, Component);
 
+    friend class PhysicsWorld2D;
+
 public:
     /// Construct.
     explicit RigidBody2D(Context* context);
@@ -100,10 +102,16 @@ public:
     /// Release body.
     void ReleaseBody();
 
-    /// Apply world transform from the Box2D body. Called by PhysicsWorld2D.
-    void ApplyWorldTransform();
+    /// Apply world transform from the Box2D body, interpolated from the previous step's transform by a factor. Does not feed back into the simulation. Called by PhysicsWorld2D.
+    void ApplyWorldTransform(float interpolation = 1.0f);
     /// Apply specified world position & rotation. Called by PhysicsWorld2D.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
+    /// Store the Box2D body transform as the previous step's transform for interpolation. Called by PhysicsWorld2D.
+    void SavePreviousTransform();
+    /// Add to the physics world's list of awake bodies, whose node transforms are synced after each step. Called when the Box2D body may have been woken from outside the simulation.
+    void MarkAwake();
+    /// Add the bodies touching this body, or only the specified fixture of it, to the awake list along with this body. Called before contacts are destroyed or refiltered, as Box2D wakes the touching bodies then.
+    void MarkContactsAwake(b2Fixture* fixture = nullptr);
     /// Add collision shape.
     void AddCollisionShape2D(CollisionShape2D* collisionShape);
     /// Remove collision shape.
@@ -167,6 +175,9 @@ public:
     /// Return Box2D body.
     b2Body* GetBody() const { return body_; }
 
+    /// Return rigid body of the parent node, or null if none.
+    RigidBody2D* GetParentRigidBody() const { return parentRigidBody_; }
+
 private:
     /// Handle node being assigned.
     void OnNodeSet(Node* node) override;
@@ -174,6 +185,10 @@ private:
     void OnSceneSet(Scene* scene) override;
     /// Handle node transform being dirtied.
     void OnMarkedDirty(Node* node) override;
+    /// Update the cached rigid body of the parent node.
+    void UpdateParentRigidBody();
+    /// Update the cached parent rigid body of rigid bodies in child nodes. When removed, unlink them from this body.
+    void UpdateChildRigidBodies(bool removed);
 
     /// Physics world.
     WeakPtr<PhysicsWorld2D> physicsWorld_;
@@ -185,10 +200,22 @@ private:
     bool useFixtureMass_;
     /// Box2D body.
     b2Body* body_;
+    /// Box2D body transform before the last fixed step.
+    b2Transform previousTransform_;
+    /// Node world position last set between two steps, in Box2D form.
+    b2Vec2 interpolatedPosition_;
+    /// Node world angle last set between two steps, in radians.
+    float interpolatedAngle_;
+    /// Whether the node transform was last set between two steps, so it must be snapped to the body once it sleeps.
+    bool interpolated_;
     /// Collision shapes.
     Vector<WeakPtr<CollisionShape2D>> collisionShapes_;
     /// Constraints.
     Vector<WeakPtr<Constraint2D>> constraints_;
+    /// Rigid body of the parent node.
+    WeakPtr<RigidBody2D> parentRigidBody_;
+    /// Index in the physics world's awake list, or M_MAX_UNSIGNED if not in it.
+    unsigned awakeIndex_;
 };
 
 }
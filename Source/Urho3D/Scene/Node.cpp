@@ -38,7 +38,9 @@ Node::Node(Context* context) :
     position_(Vector3::ZERO),
     rotation_(Quaternion::IDENTITY),
     scale_(Vector3::ONE),
-    worldRotation_(Quaternion::IDENTITY)
+    worldRotation_(Quaternion::IDENTITY),
+    transformLevel_(TRANSFORM_NOT_REGISTERED),
+    transformIndex_(0)
 {
     impl_ = make_unique<NodeImpl>();
     impl_->owner_ = nullptr;
@@ -735,6 +737,9 @@ void Node::MarkDirty()
         if (cur->dirty_)
             return;
         cur->dirty_ = true;
+        // Flag for the scene's batched world transform update
+        if (cur->transformLevel_ < TRANSFORM_PENDING)
+            cur->scene_->GetTransformSystem().MarkDirty(cur, cur->scene_->IsThreadedUpdate());
 
         // Notify listener components first, then mark child nodes
         for (size_t idx = 0; idx < cur->listeners_.size();)
@@ -827,10 +832,14 @@ void Node::AddChild(Node* node, i32 index)
         children_.push_back(nodeShared);
     else
         children_.insert(children_.begin() + index, nodeShared);
-    if (scene_ && node->GetScene() != scene_)
+    bool sameScene = scene_ && node->GetScene() == scene_;
+    if (scene_ && !sameScene)
         scene_->NodeAdded(node);
 
     node->parent_ = this;
+    // Depth may change when reparenting within the scene
+    if (sameScene)
+        scene_->GetTransformSystem().ReparentNode(node);
     node->MarkDirty();
     node->MarkNetworkUpdate();
     // If the child node has components, also mark network update on them to ensure they have a valid NetworkState
@@ -63,6 +63,7 @@ class URHO3D_API Node : public Animatable
     URHO3D_OBJECT(Node, Animatable);
 
     friend class Connection;
+    friend class TransformSystem;
 
 public:
     /// Construct.
@@ -738,6 +739,10 @@ private:
     Vector3 scale_;
     /// World-space rotation.
     mutable Quaternion worldRotation_;
+    /// Depth level in the scene's transform system, or TRANSFORM_NOT_REGISTERED / TRANSFORM_PENDING.
+    unsigned transformLevel_;
+    /// Slot index within the transform system depth level, or index in the pending list.
+    unsigned transformIndex_;
     /// Components.
     Vector<SharedPtr<Component>> components_;
     /// Child scene nodes.
@@ -15,6 +15,8 @@ namespace Urho3D
 {
 
 static const unsigned MAX_NETWORK_ATTRIBUTES = 64;
+/// Maximum age in snapshots of a transform baseline usable for delta compression in quantized replication.
+static const unsigned MAX_SNAPSHOT_BASELINE_AGE = 16;
 
 class Component;
 class Connection;
@@ -122,6 +124,34 @@ struct URHO3D_API ReplicationState
     Connection* connection_;
 };
 
+/// Node transform quantized for the snapshot stream of quantized replication.
+struct URHO3D_API QuantizedTransform
+{
+    /// Test for equality.
+    bool operator ==(const QuantizedTransform& rhs) const
+    {
+        return position_[0] == rhs.position_[0] && position_[1] == rhs.position_[1] && position_[2] == rhs.position_[2] &&
+            rotation_ == rhs.rotation_;
+    }
+
+    /// Test for inequality.
+    bool operator !=(const QuantizedTransform& rhs) const { return !(*this == rhs); }
+
+    /// Position in fixed point units.
+    i32 position_[3]{};
+    /// Packed rotation: roll angle in 2D mode, smallest-three quaternion in 3D mode.
+    u32 rotation_{};
+};
+
+/// Quantized transform sent in a snapshot and not yet acknowledged.
+struct URHO3D_API SentTransform
+{
+    /// Snapshot sequence number.
+    u16 sequence_;
+    /// Sent transform.
+    QuantizedTransform transform_;
+};
+
 /// Per-user component network replication state.
 struct URHO3D_API ComponentReplicationState : public ReplicationState
 {
@@ -150,6 +180,16 @@ struct URHO3D_API NodeReplicationState : public ReplicationState
     float priorityAcc_{};
     /// Whether exists in the SceneState's dirty set.
     bool markedDirty_{};
+    /// Last transform acknowledged by the client. Used in quantized replication only.
+    QuantizedTransform ackedTransform_;
+    /// Transforms sent in snapshots but not yet acknowledged, oldest first.
+    Vector<SentTransform> sentTransforms_;
+    /// Snapshot sequence number of the acknowledged transform.
+    u16 ackedSequence_{};
+    /// Whether the acknowledged transform is valid.
+    bool hasAckedTransform_{};
+    /// Whether exists in the connection's snapshot node list.
+    bool snapshotActive_{};
 };
 
 /// Per-user scene network replication state.
@@ -66,6 +66,7 @@ Scene::~Scene()
     // the removal of child nodes' components
     RemoveAllComponents();
     RemoveAllChildren();
+    transforms_.Clear();
 
     // Remove scene reference and owner from all nodes that still exist
     for (auto i = replicatedNodes_.begin(); i != replicatedNodes_.end(); ++i)
@@ -764,6 +765,9 @@ void Scene::Update(float timeStep)
     // Update scene attribute animation.
     SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
 
+    // Bring world transforms up to date before physics reads them
+    UpdateWorldTransforms();
+
     // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
     SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
 
@@ -790,6 +794,13 @@ void Scene::Update(float timeStep)
     elapsedTime_ += timeStep;
 }
 
+void Scene::UpdateWorldTransforms()
+{
+    URHO3D_PROFILE(UpdateWorldTransforms);
+
+    transforms_.Update(GetSubsystem<WorkQueue>());
+}
+
 void Scene::BeginThreadedUpdate()
 {
     // Check the work queue subsystem whether it actually has created worker threads. If not, do not enter threaded mode.
@@ -895,6 +906,8 @@ void Scene::NodeAdded(Node* node)
         oldScene->NodeRemoved(node);
 
     node->SetScene(this);
+    if (node != this)
+        transforms_.AddNode(node);
 
     // If the new node has an ID of zero (default), assign a replicated ID now
     NodeId id = node->GetID();
@@ -971,6 +984,7 @@ void Scene::NodeRemoved(Node* node)
     else
         localNodes_.erase(id);
 
+    transforms_.RemoveNode(node);
     node->ResetScene();
 
     // Remove node from tag cache
@@ -1071,22 +1085,21 @@ String Scene::GetVarNamesAttr() const
 
 void Scene::PrepareNetworkUpdate()
 {
-    for (HashSet<NodeId>::iterator i = networkUpdateNodes_.begin(); i != networkUpdateNodes_.end(); ++i)
+    // 直接持有对象弱引用，避免每个脏节点 / 组件一次 ID 哈希查找
+    for (const WeakPtr<Node>& node : networkUpdateNodes_)
     {
-        Node* node = GetNode(*i);
-        if (node)
+        if (node && node->GetScene() == this)
             node->PrepareNetworkUpdate();
     }
 
-    for (HashSet<ComponentId>::iterator i = networkUpdateComponents_.begin(); i != networkUpdateComponents_.end(); ++i)
+    for (const WeakPtr<Component>& component : networkUpdateComponents_)
     {
-        Component* component = GetComponent(*i);
-        if (component)
+        if (component && component->GetScene() == this)
             component->PrepareNetworkUpdate();
     }
 
-    networkUpdateNodes_.clear();
-    networkUpdateComponents_.clear();
+    networkUpdateNodes_.Clear();
+    networkUpdateComponents_.Clear();
 }
 
 void Scene::CleanupConnection(Connection* connection)
@@ -1105,11 +1118,11 @@ void Scene::MarkNetworkUpdate(Node* node)
     if (node)
     {
         if (!threadedUpdate_)
-            networkUpdateNodes_.insert(node->GetID());
+            networkUpdateNodes_.Push(WeakPtr<Node>(node));
         else
         {
             MutexLock lock(sceneMutex_);
-            networkUpdateNodes_.insert(node->GetID());
+            networkUpdateNodes_.Push(WeakPtr<Node>(node));
         }
     }
 }
@@ -1119,11 +1132,11 @@ void Scene::MarkNetworkUpdate(Component* component)
     if (component)
     {
         if (!threadedUpdate_)
-            networkUpdateComponents_.insert(component->GetID());
+            networkUpdateComponents_.Push(WeakPtr<Component>(component));
         else
         {
             MutexLock lock(sceneMutex_);
-            networkUpdateComponents_.insert(component->GetID());
+            networkUpdateComponents_.Push(WeakPtr<Component>(component));
         }
     }
 }
@@ -11,6 +11,7 @@
 #include "../Resource/JSONFile.h"
 #include "../Scene/Node.h"
 #include "../Scene/SceneResolver.h"
+#include "../Scene/TransformSystem.h"
 
 namespace Urho3D
 {
@@ -227,6 +228,10 @@ public:
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
+    /// Recalculate world transforms of nodes marked dirty in one batched pass. Called before physics sync and rendering.
+    void UpdateWorldTransforms();
+    /// Return the transform system.
+    TransformSystem& GetTransformSystem() { return transforms_; }
 
     /// Get free node ID, either non-local or local.
     NodeId GetFreeNodeID(CreateMode mode);
@@ -304,14 +309,16 @@ private:
     Vector<SharedPtr<PackageFile>> requiredPackageFiles_;
     /// Registered node user variable reverse mappings.
     HashMap<StringHash, String> varNames_;
-    /// Nodes to check for attribute changes on the next network update.
-    HashSet<NodeId> networkUpdateNodes_;
-    /// Components to check for attribute changes on the next network update.
-    HashSet<ComponentId> networkUpdateComponents_;
+    /// Nodes to check for attribute changes on the next network update. Deduplicated by the node's network update flag.
+    Vector<WeakPtr<Node>> networkUpdateNodes_;
+    /// Components to check for attribute changes on the next network update. Deduplicated by the component's network update flag.
+    Vector<WeakPtr<Component>> networkUpdateComponents_;
     /// Delayed dirty notification queue for components.
     Vector<Component*> delayedDirtyComponents_;
     /// Mutex for the delayed dirty notification queue.
     Mutex sceneMutex_;
+    /// Depth-sorted world transform storage.
+    TransformSystem transforms_;
     /// Preallocated event data map for smoothing update events.
     VariantMap smoothingData_;
     /// Next free non-local node ID.
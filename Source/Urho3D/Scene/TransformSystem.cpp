@@ -0,0 +1,270 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#include "../Precompiled.h"
+
+#include "../Core/WorkQueue.h"
+#include "../Scene/Scene.h"
+#include "../Scene/TransformSystem.h"
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// 每个工作项至少处理的脏位字数（每字 64 个节点），层级太小时在调用线程上直接处理
+static const unsigned MIN_WORDS_PER_WORK_ITEM = 32;
+
+TransformSystem::~TransformSystem()
+{
+    Clear();
+}
+
+void TransformSystem::AddNode(Node* node)
+{
+    if (node->transformLevel_ != TRANSFORM_NOT_REGISTERED)
+        RemoveNode(node);
+
+    // 加入时父节点指针可能尚未设置，因此深度在下一次更新时才计算
+    node->transformLevel_ = TRANSFORM_PENDING;
+    node->transformIndex_ = pendingNodes_.Size();
+    pendingNodes_.Push(node);
+}
+
+void TransformSystem::RemoveNode(Node* node)
+{
+    unsigned levelIndex = node->transformLevel_;
+    unsigned index = node->transformIndex_;
+
+    if (levelIndex == TRANSFORM_PENDING)
+    {
+        Node* last = pendingNodes_.Back();
+        pendingNodes_[index] = last;
+        last->transformIndex_ = index;
+        pendingNodes_.Pop();
+    }
+    else if (levelIndex != TRANSFORM_NOT_REGISTERED)
+    {
+        Level& level = levels_[levelIndex];
+        level.nodes_[index] = nullptr;
+        level.dirty_[index >> 6u] &= ~(1ull << (index & 63u));
+        level.freeSlots_.Push(index);
+    }
+
+    node->transformLevel_ = TRANSFORM_NOT_REGISTERED;
+}
+
+void TransformSystem::ReparentNode(Node* node)
+{
+    if (node->transformLevel_ != TRANSFORM_NOT_REGISTERED)
+        RequeueSubtree(node);
+}
+
+void TransformSystem::MarkDirty(Node* node, bool threaded)
+{
+    if (node->transformLevel_ >= TRANSFORM_PENDING)
+        return;
+
+    if (threaded)
+    {
+        MutexLock lock(dirtyMutex_);
+        SetDirtyBit(node->transformLevel_, node->transformIndex_);
+    }
+    else
+        SetDirtyBit(node->transformLevel_, node->transformIndex_);
+}
+
+void TransformSystem::Update(WorkQueue* queue)
+{
+    if (!pendingNodes_.Empty())
+        PlacePendingNodes();
+
+    unsigned numItems = queue ? queue->GetNumThreads() + 1 : 1;
+
+    // 逐层处理：上一层的世界变换全部算完后，本层各段互不依赖，可并行
+    for (unsigned i = 0; i < (unsigned)levels_.Size(); ++i)
+    {
+        unsigned numWords = levels_[i].dirty_.Size();
+        unsigned wordsPerItem = Max((numWords + numItems - 1) / numItems, MIN_WORDS_PER_WORK_ITEM);
+        if (numItems == 1 || numWords <= wordsPerItem)
+        {
+            UpdateLevel(i, 0, numWords);
+            continue;
+        }
+
+        ranges_.Clear();
+        for (unsigned begin = 0; begin < numWords; begin += wordsPerItem)
+            ranges_.Push(UpdateRange{this, i, begin, Min(begin + wordsPerItem, numWords)});
+
+        for (UpdateRange& range : ranges_)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = WI_MAX_PRIORITY;
+            item->workFunction_ = UpdateLevelWork;
+            item->aux_ = &range;
+            queue->AddWorkItem(item);
+        }
+
+        queue->Complete(WI_MAX_PRIORITY);
+    }
+}
+
+void TransformSystem::Clear()
+{
+    for (Level& level : levels_)
+    {
+        for (Node* node : level.nodes_)
+        {
+            if (node)
+                node->transformLevel_ = TRANSFORM_NOT_REGISTERED;
+        }
+    }
+    for (Node* node : pendingNodes_)
+        node->transformLevel_ = TRANSFORM_NOT_REGISTERED;
+
+    levels_.Clear();
+    pendingNodes_.Clear();
+}
+
+unsigned TransformSystem::GetNumNodes() const
+{
+    unsigned numNodes = 0;
+    for (const Level& level : levels_)
+        numNodes += level.nodes_.Size() - level.freeSlots_.Size();
+    return numNodes;
+}
+
+void TransformSystem::PlacePendingNodes()
+{
+    // 待放置列表不再需要索引，借用 transformIndex_ 保存深度，按深度排序后父节点总是先于子节点放置
+    for (Node* node : pendingNodes_)
+    {
+        unsigned depth = 0;
+        Node* parent = node->parent_;
+        while (parent && parent != node->scene_)
+        {
+            ++depth;
+            parent = parent->parent_;
+        }
+        node->transformIndex_ = parent ? depth : TRANSFORM_NOT_REGISTERED;
+    }
+
+    eastl::sort(pendingNodes_.Begin(), pendingNodes_.End(), [](Node* lhs, Node* rhs)
+    {
+        return lhs->transformIndex_ < rhs->transformIndex_;
+    });
+
+    for (Node* node : pendingNodes_)
+    {
+        unsigned depth = node->transformIndex_;
+        i32 parentIndex = -1;
+        if (depth)
+        {
+            Node* parent = node->parent_;
+            // 不在场景层级中的节点保持未注册，仍由 GetWorldTransform() 按需计算
+            if (depth == TRANSFORM_NOT_REGISTERED || parent->transformLevel_ != depth - 1)
+            {
+                node->transformLevel_ = TRANSFORM_NOT_REGISTERED;
+                continue;
+            }
+            parentIndex = (i32)parent->transformIndex_;
+        }
+
+        if ((unsigned)levels_.Size() <= depth)
+            levels_.Resize(depth + 1);
+
+        Level& level = levels_[depth];
+        unsigned index;
+        if (!level.freeSlots_.Empty())
+        {
+            index = level.freeSlots_.Back();
+            level.freeSlots_.Pop();
+            level.nodes_[index] = node;
+            level.parents_[index] = parentIndex;
+        }
+        else
+        {
+            index = level.nodes_.Size();
+            level.nodes_.Push(node);
+            level.parents_.Push(parentIndex);
+            level.worldTransforms_.Push(Matrix3x4::IDENTITY);
+            level.worldRotations_.Push(Quaternion::IDENTITY);
+            if ((unsigned)level.dirty_.Size() * 64 <= index)
+                level.dirty_.Push(0);
+        }
+
+        node->transformLevel_ = depth;
+        node->transformIndex_ = index;
+        // 新放置的槽位没有有效的世界变换，无论节点是否脏都要复制或计算一次
+        SetDirtyBit(depth, index);
+    }
+
+    pendingNodes_.Clear();
+}
+
+void TransformSystem::UpdateLevel(unsigned levelIndex, unsigned beginWord, unsigned endWord)
+{
+    Level& level = levels_[levelIndex];
+    const Level* parentLevel = levelIndex ? &levels_[levelIndex - 1] : nullptr;
+
+    for (unsigned word = beginWord; word < endWord; ++word)
+    {
+        u64 bits = level.dirty_[word];
+        if (!bits)
+            continue;
+        level.dirty_[word] = 0;
+
+        while (bits)
+        {
+            unsigned index = word * 64 + CountTrailingZeros(bits);
+            bits &= bits - 1;
+
+            Node* node = level.nodes_[index];
+            Matrix3x4& worldTransform = level.worldTransforms_[index];
+            Quaternion& worldRotation = level.worldRotations_[index];
+
+            // 节点可能已被 GetWorldTransform() 按需更新，此时只需同步到数组
+            if (!node->dirty_)
+            {
+                worldTransform = node->worldTransform_;
+                worldRotation = node->worldRotation_;
+                continue;
+            }
+
+            // 场景本身视为单位变换
+            if (parentLevel)
+            {
+                i32 parentIndex = level.parents_[index];
+                worldTransform = parentLevel->worldTransforms_[parentIndex] *
+                    Matrix3x4(node->position_, node->rotation_, node->scale_);
+                worldRotation = parentLevel->worldRotations_[parentIndex] * node->rotation_;
+            }
+            else
+            {
+                worldTransform = Matrix3x4(node->position_, node->rotation_, node->scale_);
+                worldRotation = node->rotation_;
+            }
+
+            node->worldTransform_ = worldTransform;
+            node->worldRotation_ = worldRotation;
+            node->dirty_ = false;
+        }
+    }
+}
+
+void TransformSystem::RequeueSubtree(Node* node)
+{
+    AddNode(node);
+    for (const SharedPtr<Node>& child : node->children_)
+        RequeueSubtree(child);
+}
+
+void TransformSystem::UpdateLevelWork(const WorkItem* item, i32 /*threadIndex*/)
+{
+    auto* range = reinterpret_cast<UpdateRange*>(item->aux_);
+    range->system_->UpdateLevel(range->level_, range->beginWord_, range->endWord_);
+}
+
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+/// \file
+
+#pragma once
+
+#include "../Container/Vector.h"
+#include "../Core/Mutex.h"
+#include "../Math/Matrix3x4.h"
+
+namespace Urho3D
+{
+
+class Node;
+class Scene;
+class WorkQueue;
+struct WorkItem;
+
+/// Node transform level value for nodes not registered to a transform system.
+static const unsigned TRANSFORM_NOT_REGISTERED = M_MAX_UNSIGNED;
+/// Node transform level value for nodes waiting to be placed on the next update.
+static const unsigned TRANSFORM_PENDING = M_MAX_UNSIGNED - 1;
+
+/// Scene-wide world transform storage. Nodes are kept in arrays sorted by hierarchy depth, and world transforms of nodes
+/// marked dirty are recalculated level by level in one pass, instead of lazily one node at a time.
+class URHO3D_API TransformSystem
+{
+public:
+    /// Construct.
+    TransformSystem() = default;
+    /// Destruct. Unregister remaining nodes.
+    ~TransformSystem();
+
+    /// Prevent copy construction.
+    TransformSystem(const TransformSystem& rhs) = delete;
+    /// Prevent assignment.
+    TransformSystem& operator =(const TransformSystem& rhs) = delete;
+
+    /// Add a node. It is placed into its depth level on the next update.
+    void AddNode(Node* node);
+    /// Remove a node.
+    void RemoveNode(Node* node);
+    /// Handle node parent change within the same scene. Re-place the node and its children, as their depths may change.
+    void ReparentNode(Node* node);
+    /// Mark a registered node's world transform to be recalculated on the next update. Is thread-safe during threaded update.
+    void MarkDirty(Node* node, bool threaded);
+    /// Recalculate dirty world transforms. The queue may be null, in which case all work is done on the calling thread.
+    void Update(WorkQueue* queue);
+    /// Unregister all nodes.
+    void Clear();
+
+    /// Return number of depth levels.
+    unsigned GetNumLevels() const { return levels_.Size(); }
+    /// Return number of placed nodes.
+    unsigned GetNumNodes() const;
+
+private:
+    /// Nodes of one hierarchy depth and their world transforms.
+    struct Level
+    {
+        /// Nodes. Removed nodes leave a null slot that is reused.
+        Vector<Node*> nodes_;
+        /// Parent slot index in the previous level, or -1 for children of the scene.
+        Vector<i32> parents_;
+        /// World transforms.
+        Vector<Matrix3x4> worldTransforms_;
+        /// World rotations.
+        Vector<Quaternion> worldRotations_;
+        /// Dirty bits, one per slot.
+        Vector<u64> dirty_;
+        /// Free slots.
+        Vector<unsigned> freeSlots_;
+    };
+
+    /// Range of dirty bit words of one level, processed by one work item.
+    struct UpdateRange
+    {
+        /// Transform system.
+        TransformSystem* system_;
+        /// Level index.
+        unsigned level_;
+        /// First dirty bit word.
+        unsigned beginWord_;
+        /// Last dirty bit word, exclusive.
+        unsigned endWord_;
+    };
+
+    /// Set the dirty bit of a slot.
+    void SetDirtyBit(unsigned levelIndex, unsigned index) { levels_[levelIndex].dirty_[index >> 6u] |= 1ull << (index & 63u); }
+    /// Place pending nodes into their depth levels.
+    void PlacePendingNodes();
+    /// Recalculate world transforms of dirty nodes in a range of dirty bit words of a level.
+    void UpdateLevel(unsigned levelIndex, unsigned beginWord, unsigned endWord);
+    /// Remove a node and its children from the levels and add them to the pending list.
+    void RequeueSubtree(Node* node);
+    /// Work function for updating a range of a level.
+    static void UpdateLevelWork(const WorkItem* item, i32 threadIndex);
+
+    /// Depth levels.
+    Vector<Level> levels_;
+    /// Nodes waiting to be placed.
+    Vector<Node*> pendingNodes_;
+    /// Work item ranges, kept to avoid allocation.
+    Vector<UpdateRange> ranges_;
+    /// Mutex for marking dirty during threaded update.
+    Mutex dirtyMutex_;
+};
+
+}
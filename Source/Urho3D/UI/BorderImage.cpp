@@ -61,12 +61,14 @@ void BorderImage::SetTexture(Texture* texture)
     texture_ = texture;
     if (imageRect_ == IntRect::ZERO)
         SetFullImageRect();
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetImageRect(const IntRect& rect)
 {
     if (rect != IntRect::ZERO)
         imageRect_ = rect;
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetFullImageRect()
@@ -81,6 +83,7 @@ void BorderImage::SetBorder(const IntRect& rect)
     border_.top_ = Max(rect.top_, 0);
     border_.right_ = Max(rect.right_, 0);
     border_.bottom_ = Max(rect.bottom_, 0);
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetImageBorder(const IntRect& rect)
@@ -89,36 +92,43 @@ void BorderImage::SetImageBorder(const IntRect& rect)
     imageBorder_.top_ = Max(rect.top_, 0);
     imageBorder_.right_ = Max(rect.right_, 0);
     imageBorder_.bottom_ = Max(rect.bottom_, 0);
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetHoverOffset(const IntVector2& offset)
 {
     hoverOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetHoverOffset(int x, int y)
 {
     hoverOffset_ = IntVector2(x, y);
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetDisabledOffset(const IntVector2& offset)
 {
     disabledOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetDisabledOffset(int x, int y)
 {
     disabledOffset_ = IntVector2(x, y);
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetBlendMode(BlendMode mode)
 {
     blendMode_ = mode;
+    MarkBatchesDirty();
 }
 
 void BorderImage::SetTiled(bool enable)
 {
     tiled_ = enable;
+    MarkBatchesDirty();
 }
 
 void BorderImage::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, const IntRect& currentScissor,
@@ -195,7 +205,7 @@ void BorderImage::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData
     UIBatch::AddOrMerge(batch, batches);
 
     // Reset hovering for next frame
-    hovering_ = false;
+    ResetHovering();
 }
 
 void BorderImage::SetTextureAttr(const ResourceRef& value)
@@ -223,6 +233,7 @@ ResourceRef BorderImage::GetMaterialAttr() const
 void BorderImage::SetMaterial(Material* material)
 {
     material_ = material;
+    MarkBatchesDirty();
 }
 
 Material* BorderImage::GetMaterial() const
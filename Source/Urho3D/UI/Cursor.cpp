@@ -64,6 +64,9 @@ Cursor::Cursor(Context* context) :
     for (unsigned i = 0; i < CS_MAX_SHAPES; i++)
         shapeInfos_[shapeNames[i]] = CursorShapeInfo(i);
 
+    // 光标每帧最后单独生成批次，移动或变换形状不应使根元素的批次缓存失效
+    batchCacheExcluded_ = true;
+
     // Subscribe to OS mouse cursor visibility changes to be able to reapply the cursor shape
     SubscribeToEvent(E_MOUSEVISIBLECHANGED, URHO3D_HANDLER(Cursor, HandleMouseVisibleChanged));
 }
@@ -105,7 +105,7 @@ void Sprite::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, con
     UIBatch::AddOrMerge(batch, batches);
 
     // Reset hovering for next frame
-    hovering_ = false;
+    ResetHovering();
 }
 
 void Sprite::OnPositionSet(const IntVector2& newPosition)
@@ -177,12 +177,14 @@ void Sprite::SetTexture(Texture* texture)
     texture_ = texture;
     if (imageRect_ == IntRect::ZERO)
         SetFullImageRect();
+    MarkBatchesDirty();
 }
 
 void Sprite::SetImageRect(const IntRect& rect)
 {
     if (rect != IntRect::ZERO)
         imageRect_ = rect;
+    MarkBatchesDirty();
 }
 
 void Sprite::SetFullImageRect()
@@ -194,6 +196,7 @@ void Sprite::SetFullImageRect()
 void Sprite::SetBlendMode(BlendMode mode)
 {
     blendMode_ = mode;
+    MarkBatchesDirty();
 }
 
 const Matrix3x4& Sprite::GetTransform() const
@@ -104,7 +104,7 @@ void Text::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, const
     FontFace* face = font_ ? font_->GetFace(fontSize_) : nullptr;
     if (!face)
     {
-        hovering_ = false;
+        ResetHovering();
         return;
     }
 
@@ -327,6 +327,7 @@ void Text::SetTextAlignment(HorizontalAlignment align)
         textAlignment_ = align;
         charLocationsDirty_ = true;
     }
+    MarkBatchesDirty();
 }
 
 void Text::SetRowSpacing(float spacing)
@@ -386,42 +387,50 @@ void Text::SetSelection(i32 start, i32 length)
     selectionStart_ = start;
     selectionLength_ = length;
     ValidateSelection();
+    MarkBatchesDirty();
 }
 
 void Text::ClearSelection()
 {
     selectionStart_ = 0;
     selectionLength_ = 0;
+    MarkBatchesDirty();
 }
 
 void Text::SetTextEffect(TextEffect textEffect)
 {
     textEffect_ = textEffect;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectShadowOffset(const IntVector2& offset)
 {
     shadowOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectStrokeThickness(int thickness)
 {
     strokeThickness_ = Abs(thickness);
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectRoundStroke(bool roundStroke)
 {
     roundStroke_ = roundStroke;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectColor(const Color& effectColor)
 {
     effectColor_ = effectColor;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectDepthBias(float bias)
 {
     effectDepthBias_ = bias;
+    MarkBatchesDirty();
 }
 
 float Text::GetRowWidth(i32 index) const
@@ -502,6 +511,7 @@ bool Text::FilterImplicitAttributes(XMLElement& dest) const
 
 void Text::UpdateText(bool onResize)
 {
+    MarkBatchesDirty();
     rowWidths_.Clear();
     printText_.Clear();
 
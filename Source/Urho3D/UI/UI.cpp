@@ -64,6 +64,8 @@ const float DEFAULT_DRAGBEGIN_INTERVAL = 0.5f;
 const float DEFAULT_TOOLTIP_DELAY = 0.5f;
 const int DEFAULT_DRAGBEGIN_DISTANCE = 5;
 const int DEFAULT_FONT_TEXTURE_MAX_SIZE = 2048;
+// 合并 bgfx UI 批次时向前查找的最大绘制组数，限制最坏情况下的开销
+const unsigned MAX_UI_MERGE_LOOKBACK = 32;
 
 const char* UI_CATEGORY = "UI";
 
@@ -94,6 +96,7 @@ UI::UI(Context* context) :
     useScreenKeyboard_(false),
 #endif
     useMutableGlyphs_(false),
+    retainedBatches_(false),
     forceAutoHint_(false),
     fontHintLevel_(FONT_HINT_LEVEL_NORMAL),
     fontSubpixelThreshold_(12),
@@ -187,6 +190,7 @@ void UI::SetFocusElement(UIElement* element, bool byKey)
     {
         UIElement* oldFocusElement = focusElement_;
         focusElement_.Reset();
+        oldFocusElement->MarkBatchesDirty();
 
         VariantMap& focusEventData = GetEventDataMap();
         focusEventData[Defocused::P_ELEMENT] = oldFocusElement;
@@ -197,6 +201,7 @@ void UI::SetFocusElement(UIElement* element, bool byKey)
     if (element && element->GetFocusMode() >= FM_FOCUSABLE)
     {
         focusElement_ = element;
+        element->MarkBatchesDirty();
 
         VariantMap& focusEventData = GetEventDataMap();
         focusEventData[Focused::P_ELEMENT] = element;
@@ -372,6 +377,10 @@ void UI::Update(float timeStep)
             UIElement* element = i->first;
             if (element)
             {
+                // 悬停标志通常在生成批次时重置，元素的批次被缓存时需要在这里显式结束悬停
+                element->SetHovering(false);
+                element->MarkBatchesDirty();
+
                 using namespace HoverEnd;
 
                 VariantMap& eventData = GetEventDataMap();
@@ -674,6 +683,19 @@ void UI::SetUseMutableGlyphs(bool enable)
     }
 }
 
+void UI::SetRetainedBatches(bool enable)
+{
+    if (enable != retainedBatches_)
+    {
+        retainedBatches_ = enable;
+        if (!enable)
+        {
+            ResetBatchCaches(rootElement_, true);
+            ResetBatchCaches(rootModalElement_, true);
+        }
+    }
+}
+
 void UI::SetForceAutoHint(bool enable)
 {
     if (enable != forceAutoHint_)
@@ -1053,6 +1075,14 @@ void UI::Render(VertexBuffer* buffer, const Vector<UIBatch>& batches, unsigned b
 
         if (vdata)
         {
+            // 整帧顶点共用一个 transient 缓冲，合并后的批次一次提交；空间不足时回落到逐批次提交
+            BuildBgfxBatches(batches, batchStart, batchEnd, *vdata);
+            if (bgfxBatches_.Empty() || graphics_->BgfxDrawUIBatches(&bgfxBatches_[0], bgfxBatches_.Size(), proj2))
+            {
+                graphics_->EndUIDraw(surface);
+                return;
+            }
+
             for (unsigned i = batchStart; i < batchEnd; ++i)
             {
                 const UIBatch& batch = batches[i];
@@ -1209,7 +1239,111 @@ void UI::Render(VertexBuffer* buffer, const Vector<UIBatch>& batches, unsigned b
     }
 }
 
+void UI::BuildBgfxBatches(const Vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd, const Vector<float>& vertexData)
+{
+    bgfxBatches_.Clear();
+    mergeSources_.Clear();
+    mergeNext_.Clear();
+    mergeGroups_.Clear();
+
+    for (unsigned i = batchStart; i < batchEnd; ++i)
+    {
+        const UIBatch& batch = batches[i];
+        if (batch.vertexStart_ == batch.vertexEnd_)
+            continue;
+
+        BgfxUIBatch source;
+        source.vertices_ = &vertexData[batch.vertexStart_];
+        source.numVertices_ = (batch.vertexEnd_ - batch.vertexStart_) / UI_VERTEX_SIZE;
+        source.texture_ = static_cast<Texture2D*>(batch.texture_);
+        source.material_ = batch.customMaterial_;
+        source.blendMode_ = batch.blendMode_;
+        source.scissor_ = IntRect((int)(batch.scissor_.left_ * uiScale_), (int)(batch.scissor_.top_ * uiScale_),
+            (int)(batch.scissor_.right_ * uiScale_), (int)(batch.scissor_.bottom_ * uiScale_));
+
+        // 屏幕包围矩形（未缩放坐标）：顶点范围与裁剪矩形的交集
+        Rect bounds;
+        for (unsigned v = batch.vertexStart_; v < batch.vertexEnd_; v += UI_VERTEX_SIZE)
+            bounds.Merge(Vector2(vertexData[v], vertexData[v + 1]));
+        bounds.Clip(Rect((float)batch.scissor_.left_, (float)batch.scissor_.top_, (float)batch.scissor_.right_,
+            (float)batch.scissor_.bottom_));
+
+        unsigned index = mergeSources_.Size();
+        mergeSources_.Push(source);
+        mergeNext_.Push(M_MAX_UNSIGNED);
+
+        // 向前查找状态相同的绘制组：批次只与其间的绘制组都不重叠时才能提前，否则会改变叠加顺序
+        unsigned target = M_MAX_UNSIGNED;
+        if (!source.material_)
+        {
+            unsigned numGroups = mergeGroups_.Size();
+            unsigned stop = numGroups > MAX_UI_MERGE_LOOKBACK ? numGroups - MAX_UI_MERGE_LOOKBACK : 0;
+            for (unsigned g = numGroups; g-- > stop;)
+            {
+                const UIMergeGroup& group = mergeGroups_[g];
+                const BgfxUIBatch& head = mergeSources_[group.first_];
+                if (!head.material_ && head.texture_ == source.texture_ && head.blendMode_ == source.blendMode_ &&
+                    head.scissor_ == source.scissor_)
+                {
+                    target = g;
+                    break;
+                }
+                if (group.bounds_.min_.x_ < bounds.max_.x_ && group.bounds_.max_.x_ > bounds.min_.x_ &&
+                    group.bounds_.min_.y_ < bounds.max_.y_ && group.bounds_.max_.y_ > bounds.min_.y_)
+                    break;
+            }
+        }
+
+        if (target != M_MAX_UNSIGNED)
+        {
+            UIMergeGroup& group = mergeGroups_[target];
+            mergeNext_[group.last_] = index;
+            group.last_ = index;
+            group.bounds_.Merge(bounds);
+        }
+        else
+            mergeGroups_.Push(UIMergeGroup{index, index, bounds});
+    }
+
+    // 按组输出，同组批次相邻，由后端合并为一次提交
+    for (const UIMergeGroup& group : mergeGroups_)
+    {
+        for (unsigned index = group.first_; index != M_MAX_UNSIGNED; index = mergeNext_[index])
+            bgfxBatches_.Push(mergeSources_[index]);
+    }
+}
+
 void UI::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, UIElement* element, IntRect currentScissor)
+{
+    // 可变字形可能在帧之间被清出字体纹理，此时缓存的纹理坐标会失效，只能每帧重新生成
+    if (retainedBatches_ && !useMutableGlyphs_ && element != cursor_)
+    {
+        UIElement* parent = element->GetParent();
+        bool topLevel = element == rootElement_ || element == rootModalElement_ || parent == rootElement_ ||
+            parent == rootModalElement_;
+
+        if (topLevel || element->GetCacheBatches())
+        {
+            UIBatchCache* cache = element->GetBatchCache(true);
+            if (cache->dirty_ || cache->scissor_ != currentScissor)
+            {
+                cache->batches_.Clear();
+                cache->vertexData_.Clear();
+                GenerateBatches(cache->batches_, cache->vertexData_, element, currentScissor);
+                cache->scissor_ = currentScissor;
+                // 生成过程中的临时状态切换（如 DropDownList 的选中项）也会标记脏，因此生成后才清除
+                cache->dirty_ = false;
+            }
+
+            AppendBatches(batches, vertexData, *cache);
+            return;
+        }
+    }
+
+    GenerateBatches(batches, vertexData, element, currentScissor);
+}
+
+void UI::GenerateBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, UIElement* element, IntRect currentScissor)
 {
     // Set clipping scissor for child elements. No need to draw if zero size
     element->AdjustScissor(currentScissor);
@@ -1262,6 +1396,36 @@ void UI::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, UIEleme
     }
 }
 
+void UI::AppendBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, const UIBatchCache& cache)
+{
+    if (cache.batches_.Empty())
+        return;
+
+    // 顶点数据整块复制，批次只需平移顶点范围并指向目标顶点数组
+    auto vertexOffset = (unsigned)vertexData.Size();
+    vertexData.Insert(vertexData.End(), cache.vertexData_.Begin(), cache.vertexData_.End());
+
+    for (const UIBatch& cachedBatch : cache.batches_)
+    {
+        UIBatch batch = cachedBatch;
+        batch.vertexData_ = &vertexData;
+        batch.vertexStart_ += vertexOffset;
+        batch.vertexEnd_ += vertexOffset;
+        UIBatch::AddOrMerge(batch, batches);
+    }
+}
+
+void UI::ResetBatchCaches(UIElement* element, bool release)
+{
+    if (release)
+        element->ReleaseBatchCache();
+    else if (UIBatchCache* cache = element->GetBatchCache(false))
+        cache->dirty_ = true;
+
+    for (const SharedPtr<UIElement>& child : element->GetChildren())
+        ResetBatchCaches(child, release);
+}
+
 void UI::GetElementAt(UIElement*& result, UIElement* current, const IntVector2& position, bool enabledOnly)
 {
     if (!current)
@@ -1388,6 +1552,10 @@ void UI::ReleaseFontFaces()
 
     for (Font* font : fonts)
         font->ReleaseFaces();
+
+    // 缓存的批次引用了已释放字体的纹理
+    ResetBatchCaches(rootElement_, false);
+    ResetBatchCaches(rootModalElement_, false);
 }
 
 void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags buttons, QualifierFlags qualifiers, Cursor* cursor)
@@ -1424,6 +1592,7 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
                 // Begin hover event
                 if (hoveredElements_.find(element) == hoveredElements_.end())
                 {
+                    element->MarkBatchesDirty();
                     SendDragOrHoverEvent(E_HOVERBEGIN, element, cursorPos, IntVector2::ZERO, nullptr);
                     // Exit if element is destroyed by the event handling
                     if (!element)
@@ -1469,6 +1638,7 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
             // Begin hover event
             if (hoveredElements_.find(element) == hoveredElements_.end())
             {
+                element->MarkBatchesDirty();
                 SendDragOrHoverEvent(E_HOVERBEGIN, element, cursorPos, IntVector2::ZERO, nullptr);
                 // Exit if element is destroyed by the event handling
                 if (!element)
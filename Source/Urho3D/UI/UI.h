@@ -13,6 +13,8 @@
 namespace Urho3D
 {
 
+struct BgfxUIBatch;
+
 /// Font hinting level (only used for FreeType fonts).
 enum FontHintLevel
 {
@@ -104,6 +106,9 @@ public:
     /// Set whether to use mutable (eraseable) glyphs to ensure a font face never expands to more than one texture. Default false.
     /// @property
     void SetUseMutableGlyphs(bool enable);
+    /// Set whether to keep the batches of unchanged element hierarchies between frames instead of regenerating them. Batches of root and top-level elements, and elements that enable it themselves, are cached. Has no effect while mutable glyphs are used. Default false.
+    /// @property
+    void SetRetainedBatches(bool enable);
     /// Set whether to force font autohinting instead of using FreeType's TTF bytecode interpreter.
     /// @property
     void SetForceAutoHint(bool enable);
@@ -215,6 +220,10 @@ public:
     /// @property
     bool GetUseMutableGlyphs() const { return useMutableGlyphs_; }
 
+    /// Return whether batches of unchanged element hierarchies are kept between frames.
+    /// @property
+    bool GetRetainedBatches() const { return retainedBatches_; }
+
     /// Return whether is using forced autohinting.
     /// @property
     bool GetForceAutoHint() const { return forceAutoHint_; }
@@ -287,6 +296,17 @@ private:
         SharedPtr<VertexBuffer> debugVertexBuffer_;
     };
 
+    /// Group of compatible batches drawn with one draw call in merged BGFX submission.
+    struct UIMergeGroup
+    {
+        /// First source batch.
+        unsigned first_;
+        /// Last source batch.
+        unsigned last_;
+        /// Union of the source batches' screen bounds.
+        Rect bounds_;
+    };
+
     /// Initialize when screen mode initially set.
     void Initialize();
     /// Update UI element logic recursively.
@@ -295,8 +315,16 @@ private:
     void SetVertexData(VertexBuffer* dest, const Vector<float>& vertexData);
     /// Render UI batches to the current rendertarget. Geometry must have been uploaded first.
     void Render(VertexBuffer* buffer, const Vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd);
-    /// Generate batches from an UI element recursively. Skip the cursor element.
+    /// Build merged BGFX submission batches, moving batches forward past non-overlapping batches to join a compatible draw.
+    void BuildBgfxBatches(const Vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd, const Vector<float>& vertexData);
+    /// Generate batches from an UI element recursively, or copy them from the element's batch cache if unchanged. Skip the cursor element.
     void GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, UIElement* element, IntRect currentScissor);
+    /// Generate batches from an UI element's children.
+    void GenerateBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, UIElement* element, IntRect currentScissor);
+    /// Append cached batches and vertex data.
+    void AppendBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, const UIBatchCache& cache);
+    /// Mark batch caches of an element hierarchy dirty, or release them.
+    void ResetBatchCaches(UIElement* element, bool release);
     /// Return UI element at global screen coordinates. Return position converted to element's screen coordinates.
     UIElement* GetElementAt(const IntVector2& position, bool enabledOnly, IntVector2* elementScreenPosition);
     /// Return UI element at screen position recursively.
@@ -393,6 +421,14 @@ private:
     SharedPtr<VertexBuffer> debugVertexBuffer_;
     /// UI element query vector.
     Vector<UIElement*> tempElements_;
+    /// Merged BGFX submission batches in draw order.
+    Vector<BgfxUIBatch> bgfxBatches_;
+    /// BGFX submission batches in UI batch order, used while merging.
+    Vector<BgfxUIBatch> mergeSources_;
+    /// Next source batch in the same merge group, or M_MAX_UNSIGNED.
+    Vector<unsigned> mergeNext_;
+    /// Merge groups.
+    Vector<UIMergeGroup> mergeGroups_;
     /// Clipboard text.
     mutable String clipBoard_;
     /// Seconds between clicks to register a double click.
@@ -423,6 +459,8 @@ private:
     bool useScreenKeyboard_;
     /// Flag for using mutable (erasable) font glyphs.
     bool useMutableGlyphs_;
+    /// Flag for keeping batches of unchanged element hierarchies between frames.
+    bool retainedBatches_;
     /// Flag for forcing FreeType auto hinting.
     bool forceAutoHint_;
     /// FreeType hinting level (default is FONT_HINT_LEVEL_NORMAL).
@@ -94,4 +94,17 @@ public:
     Material* customMaterial_{};
 };
 
+/// Batches and vertex data generated from an element's children, kept between frames when %UI retained batching is enabled.
+struct UIBatchCache
+{
+    /// Batches. Vertex data pointers refer to the cache's own vertex data.
+    Vector<UIBatch> batches_;
+    /// Vertex data.
+    Vector<float> vertexData_;
+    /// Scissor the batches were generated with.
+    IntRect scissor_;
+    /// Needs regeneration flag.
+    bool dirty_{true};
+};
+
 }
@@ -130,6 +130,7 @@ void UIElement::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Bring To Back", GetBringToBack, SetBringToBack, true, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Clip Children", GetClipChildren, SetClipChildren, false, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Use Derived Opacity", GetUseDerivedOpacity, SetUseDerivedOpacity, true, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cache Batches", GetCacheBatches, SetCacheBatches, false, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Focus Mode", GetFocusMode, SetFocusMode, focusModes, FM_NOTFOCUSABLE, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Drag And Drop Mode", GetDragDropMode, SetDragDropMode, dragDropModes, DD_DISABLED, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Layout Mode", GetLayoutMode, SetLayoutMode, layoutModes, LM_FREE, AM_FILE);
@@ -152,6 +153,8 @@ void UIElement::ApplyAttributes()
         if (colors_[i] != colors_[0])
             colorGradient_ = true;
     }
+
+    MarkBatchesDirty();
 }
 
 bool UIElement::LoadXML(const XMLElement& source)
@@ -330,7 +333,7 @@ void UIElement::Update(float timeStep)
 void UIElement::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, const IntRect& currentScissor)
 {
     // Reset hovering for next frame
-    hovering_ = false;
+    ResetHovering();
 }
 
 void UIElement::GetDebugDrawBatches(Vector<UIBatch>& batches, Vector<float>& vertexData, const IntRect& currentScissor)
@@ -807,6 +810,7 @@ void UIElement::SetClipBorder(const IntRect& rect)
     clipBorder_.top_ = Max(rect.top_, 0);
     clipBorder_.right_ = Max(rect.right_, 0);
     clipBorder_.bottom_ = Max(rect.bottom_, 0);
+    MarkBatchesDirty();
 }
 
 void UIElement::SetColor(const Color& color)
@@ -815,6 +819,7 @@ void UIElement::SetColor(const Color& color)
         cornerColor = color;
     colorGradient_ = false;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetColor(Corner corner, const Color& color)
@@ -828,6 +833,8 @@ void UIElement::SetColor(Corner corner, const Color& color)
         if (i != corner && colors_[i] != colors_[corner])
             colorGradient_ = true;
     }
+
+    MarkBatchesDirty();
 }
 
 void UIElement::SetPriority(int priority)
@@ -838,6 +845,7 @@ void UIElement::SetPriority(int priority)
     priority_ = priority;
     if (parent_)
         parent_->sortOrderDirty_ = true;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetOpacity(float opacity)
@@ -859,6 +867,7 @@ void UIElement::SetBringToBack(bool enable)
 void UIElement::SetClipChildren(bool enable)
 {
     clipChildren_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetSortChildren(bool enable)
@@ -867,22 +876,26 @@ void UIElement::SetSortChildren(bool enable)
         sortOrderDirty_ = true;
 
     sortChildren_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetUseDerivedOpacity(bool enable)
 {
     useDerivedOpacity_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetEnabled(bool enable)
 {
     enabled_ = enable;
     enabledPrev_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetDeepEnabled(bool enable)
 {
     enabled_ = enable;
+    MarkBatchesDirty();
 
     for (Vector<SharedPtr<UIElement>>::ConstIterator i = children_.Begin(); i != children_.End(); ++i)
         (*i)->SetDeepEnabled(enable);
@@ -891,6 +904,7 @@ void UIElement::SetDeepEnabled(bool enable)
 void UIElement::ResetDeepEnabled()
 {
     enabled_ = enabledPrev_;
+    MarkBatchesDirty();
 
     for (Vector<SharedPtr<UIElement>>::ConstIterator i = children_.Begin(); i != children_.End(); ++i)
         (*i)->ResetDeepEnabled();
@@ -900,6 +914,7 @@ void UIElement::SetEnabledRecursive(bool enable)
 {
     enabled_ = enable;
     enabledPrev_ = enable;
+    MarkBatchesDirty();
 
     for (Vector<SharedPtr<UIElement>>::ConstIterator i = children_.Begin(); i != children_.End(); ++i)
         (*i)->SetEnabledRecursive(enable);
@@ -941,7 +956,11 @@ void UIElement::SetFocus(bool enable)
 
 void UIElement::SetSelected(bool enable)
 {
-    selected_ = enable;
+    if (enable != selected_)
+    {
+        selected_ = enable;
+        MarkBatchesDirty();
+    }
 }
 
 void UIElement::SetVisible(bool enable)
@@ -954,6 +973,7 @@ void UIElement::SetVisible(bool enable)
     if (enable != visible_)
     {
         visible_ = enable;
+        MarkBatchesDirty();
 
         // Parent's layout may change as a result of visibility change
         if (parent_)
@@ -1369,6 +1389,7 @@ void UIElement::RemoveChild(UIElement* element, i32 index/* = 0*/)
 
             element->Detach();
             children_.erase(children_.begin() + i);
+            MarkBatchesDirty();
             UpdateLayout();
             return;
         }
@@ -1398,6 +1419,7 @@ void UIElement::RemoveChildAtIndex(i32 index)
 
     children_[index]->Detach();
     children_.erase(children_.begin() + index);
+    MarkBatchesDirty();
     UpdateLayout();
 }
 
@@ -1424,6 +1446,7 @@ void UIElement::RemoveAllChildren()
         (*i++)->Detach();
     }
     children_.clear();
+    MarkBatchesDirty();
     UpdateLayout();
 }
 
@@ -1458,6 +1481,7 @@ void UIElement::SetInternal(bool enable)
 void UIElement::SetTraversalMode(TraversalMode traversalMode)
 {
     traversalMode_ = traversalMode;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetElementEventSender(bool flag)
@@ -1465,6 +1489,13 @@ void UIElement::SetElementEventSender(bool flag)
     elementEventSender_ = flag;
 }
 
+void UIElement::SetCacheBatches(bool enable)
+{
+    cacheBatches_ = enable;
+    if (!enable)
+        batchCache_.reset();
+}
+
 void UIElement::SetTags(const StringVector& tags)
 {
     RemoveAllTags();
@@ -1827,7 +1858,10 @@ void UIElement::SetChildOffset(const IntVector2& offset)
 
 void UIElement::SetHovering(bool enable)
 {
+    // 悬停标志在每次生成批次后重置，只有与生成批次时的状态不同才需要重新生成
     hovering_ = enable;
+    if (enable != batchesHovering_)
+        MarkBatchesDirty();
 }
 
 void UIElement::AdjustScissor(IntRect& currentScissor)
@@ -1951,13 +1985,52 @@ Animatable* UIElement::FindAttributeAnimationTarget(const String& name, String&
 }
 
 void UIElement::MarkDirty()
+{
+    MarkBatchesDirty();
+    MarkDirtyRecursive();
+}
+
+void UIElement::MarkBatchesDirty()
+{
+    // 外观变化会使自身及所有祖先缓存的子元素批次失效，被排除的元素（如光标）单独渲染，不影响祖先
+    for (UIElement* element = this; element; element = element->parent_)
+    {
+        if (element->batchCacheExcluded_)
+            return;
+        if (element->batchCache_)
+            element->batchCache_->dirty_ = true;
+    }
+}
+
+UIBatchCache* UIElement::GetBatchCache(bool create)
+{
+    if (!batchCache_ && create)
+        batchCache_ = std::make_unique<UIBatchCache>();
+    return batchCache_.get();
+}
+
+void UIElement::ReleaseBatchCache()
+{
+    batchCache_.reset();
+}
+
+void UIElement::OnSetAttribute(const AttributeInfo& attr, const Variant& src)
+{
+    Animatable::OnSetAttribute(attr, src);
+    MarkBatchesDirty();
+}
+
+void UIElement::MarkDirtyRecursive()
 {
     positionDirty_ = true;
     opacityDirty_ = true;
     derivedColorDirty_ = true;
+    // 祖先已由 MarkBatchesDirty() 标记，这里只需标记子树内的缓存
+    if (batchCache_)
+        batchCache_->dirty_ = true;
 
     for (Vector<SharedPtr<UIElement>>::ConstIterator i = children_.Begin(); i != children_.End(); ++i)
-        (*i)->MarkDirty();
+        (*i)->MarkDirtyRecursive();
 }
 
 bool UIElement::RemoveChildXML(XMLElement& parent, const String& name) const
@@ -11,6 +11,8 @@
 #include "../Scene/Animatable.h"
 #include "../UI/UIBatch.h"
 
+#include <memory>
+
 namespace Urho3D
 {
 
@@ -412,6 +414,9 @@ public:
     /// Set element event sender flag. When child element is added or deleted, the event would be sent using UIElement found in the parental chain having this flag set. If not set, the event is sent using UI's root as per normal.
     /// @property
     void SetElementEventSender(bool flag);
+    /// Set whether to keep the batches of child elements between frames when %UI retained batching is enabled. Root and top-level elements are always cached. Default false.
+    /// @property
+    void SetCacheBatches(bool enable);
 
     /// Set tags. Old tags are overwritten.
     void SetTags(const StringVector& tags);
@@ -737,8 +742,10 @@ public:
 
     /// Set child offset.
     void SetChildOffset(const IntVector2& offset);
-    /// Set hovering state.
+    /// Set hovering state. Invalidates the batches only if the state differs from the one they were generated with.
     void SetHovering(bool enable);
+    /// Reset hovering for the next frame. Called at the end of GetBatches(), remembers the state the batches were generated with.
+    void ResetHovering() { batchesHovering_ = hovering_; hovering_ = false; }
     /// Adjust scissor for rendering.
     void AdjustScissor(IntRect& currentScissor);
     /// Get UI rendering batches with a specified offset. Also recurse to child elements.
@@ -755,6 +762,17 @@ public:
     /// @property
     bool IsElementEventSender() const { return elementEventSender_; }
 
+    /// Return whether keeps the batches of child elements between frames when %UI retained batching is enabled.
+    /// @property
+    bool GetCacheBatches() const { return cacheBatches_; }
+
+    /// Mark cached batches of this element and its parents as needing regeneration. Called when the element's appearance changes.
+    void MarkBatchesDirty();
+    /// Return cached batches of child elements, optionally creating them. Used internally by UI.
+    UIBatchCache* GetBatchCache(bool create);
+    /// Release cached batches of child elements. Used internally by UI.
+    void ReleaseBatchCache();
+
     /// Get element which should send child added / removed events.
     UIElement* GetElementEventSender() const;
 
@@ -771,6 +789,8 @@ protected:
     void OnAttributeAnimationRemoved() override;
     /// Find target of an attribute animation from object hierarchy by name.
     Animatable* FindAttributeAnimationTarget(const String& name, String& outName) override;
+    /// Handle attribute write access. Mark cached batches dirty.
+    void OnSetAttribute(const AttributeInfo& attr, const Variant& src) override;
     /// Mark screen position as needing an update.
     void MarkDirty();
     /// Remove child XML element by matching attribute name.
@@ -820,6 +840,8 @@ protected:
     bool visible_{true};
     /// Hovering flag.
     bool hovering_{};
+    /// Hovering flag when batches were last generated.
+    bool batchesHovering_{};
     /// Internally created flag.
     bool internal_{};
     /// Focus mode.
@@ -856,6 +878,8 @@ protected:
     MouseButtonFlags dragButtonCombo_{};
     /// Drag button count.
     i32 dragButtonCount_{};
+    /// Exclude from batch caching flag. Appearance changes do not dirty parent batch caches. Used by elements rendered separately, such as the cursor.
+    bool batchCacheExcluded_{};
 
 private:
     /// Return child elements recursively.
@@ -872,6 +896,8 @@ private:
             const Vector<float>& flexScales, int targetSize, int begin, int end, int spacing);
     /// Get child element constant position in a layout.
     IntVector2 GetLayoutChildPosition(UIElement* child);
+    /// Mark screen position and cached batches as needing an update recursively.
+    void MarkDirtyRecursive();
     /// Detach from parent.
     void Detach();
     /// Verify that child elements have proper alignment for layout mode.
@@ -925,6 +951,10 @@ private:
     TraversalMode traversalMode_{TM_BREADTH_FIRST};
     /// Flag whether node should send child added / removed events by itself.
     bool elementEventSender_{};
+    /// Keep child batches between frames flag.
+    bool cacheBatches_{};
+    /// Cached batches of child elements.
+    std::unique_ptr<UIBatchCache> batchCache_;
     /// XPath query for selecting UI-style.
     /// 用于样式查询的 XPath（使用函数局部静态，避免跨单元初始化顺序问题）
     static XPathQuery& GetStyleXPathQuery();
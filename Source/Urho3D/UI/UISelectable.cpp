@@ -34,17 +34,19 @@ void UISelectable::GetBatches(Vector<UIBatch>& batches, Vector<float>& vertexDat
     }
 
     // Reset hovering for next frame
-    hovering_ = false;
+    ResetHovering();
 }
 
 void UISelectable::SetSelectionColor(const Color& color)
 {
     selectionColor_ = color;
+    MarkBatchesDirty();
 }
 
 void UISelectable::SetHoverColor(const Color& color)
 {
     hoverColor_ = color;
+    MarkBatchesDirty();
 }
 
 }
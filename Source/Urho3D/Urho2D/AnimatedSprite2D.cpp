@@ -7,9 +7,9 @@
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/Scene.h"
-#include "../Scene/SceneEvents.h"
 #include "../Urho2D/AnimatedSprite2D.h"
 #include "../Urho2D/AnimationSet2D.h"
+#include "../Urho2D/Renderer2D.h"
 #include "../Urho2D/Sprite2D.h"
 #include "../Urho2D/SpriterInstance2D.h"
 
@@ -49,6 +49,9 @@ AnimatedSprite2D::AnimatedSprite2D(Context* context) :
 
 AnimatedSprite2D::~AnimatedSprite2D()
 {
+    if (renderer_)
+        renderer_->RemoveAnimatedSprite(this);
+
     Dispose();
 }
 
@@ -70,15 +73,12 @@ void AnimatedSprite2D::OnSetEnabled()
 {
     StaticSprite2D::OnSetEnabled();
 
-    bool enabled = IsEnabledEffective();
-
-    Scene* scene = GetScene();
-    if (scene)
+    if (renderer_)
     {
-        if (enabled)
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedSprite2D, HandleScenePostUpdate));
+        if (IsEnabledEffective())
+            renderer_->AddAnimatedSprite(this);
         else
-            UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+            renderer_->RemoveAnimatedSprite(this);
     }
 }
 
@@ -200,11 +200,12 @@ void AnimatedSprite2D::OnSceneSet(Scene* scene)
     {
         if (scene == node_)
             URHO3D_LOGWARNING(GetTypeName() + " should not be created to the root scene node");
-        if (IsEnabledEffective())
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedSprite2D, HandleScenePostUpdate));
+        // Renderer2D updates the animations of all enabled animated sprites of the scene on scene post-update
+        if (renderer_ && IsEnabledEffective())
+            renderer_->AddAnimatedSprite(this);
     }
-    else
-        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+    else if (renderer_)
+        renderer_->RemoveAnimatedSprite(this);
 }
 
 void AnimatedSprite2D::SetAnimationAttr(const String& name)
@@ -213,6 +214,23 @@ void AnimatedSprite2D::SetAnimationAttr(const String& name)
     SetAnimation(animationName_, loopMode_);
 }
 
+void AnimatedSprite2D::OnWorldBoundingBoxUpdate()
+{
+    boundingBox_.Clear();
+    worldBoundingBox_.Clear();
+
+    // 动画姿态决定顶点范围，只能从源批次计算
+    const Vector<SourceBatch2D>& sourceBatches = GetSourceBatches();
+    for (const SourceBatch2D& batch : sourceBatches)
+    {
+        for (const Vertex2D& vertex : batch.vertices_)
+            worldBoundingBox_.Merge(vertex.position_);
+    }
+
+    if (worldBoundingBox_.Defined())
+        boundingBox_ = worldBoundingBox_.Transformed(node_->GetWorldTransform().Inverse());
+}
+
 void AnimatedSprite2D::UpdateSourceBatches()
 {
 #ifdef URHO3D_SPINE
@@ -225,14 +243,13 @@ void AnimatedSprite2D::UpdateSourceBatches()
     sourceBatchesDirty_ = false;
 }
 
-void AnimatedSprite2D::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+void AnimatedSprite2D::UpdateAnimation(float timeStep)
 {
-    using namespace ScenePostUpdate;
-    float timeStep = eventData[P_TIMESTEP].GetFloat();
-    UpdateAnimation(timeStep);
+    AdvanceAnimation(timeStep);
+    FinishAnimationUpdate();
 }
 
-void AnimatedSprite2D::UpdateAnimation(float timeStep)
+void AnimatedSprite2D::AdvanceAnimation(float timeStep)
 {
 #ifdef URHO3D_SPINE
     if (skeleton_ && animationState_)
@@ -242,6 +259,22 @@ void AnimatedSprite2D::UpdateAnimation(float timeStep)
         UpdateSpriterAnimation(timeStep);
 }
 
+void AnimatedSprite2D::FinishAnimationUpdate()
+{
+    bool animated = spriterInstance_ && spriterInstance_->GetAnimation();
+#ifdef URHO3D_SPINE
+    animated = animated || (skeleton_ && animationState_);
+#endif
+    if (!animated)
+        return;
+
+    sourceBatchesDirty_ = true;
+    MarkBoundingBoxDirty();
+
+    if (spriterInstance_)
+        spriterInstance_->SendFinishedEvent();
+}
+
 #ifdef URHO3D_SPINE
 void AnimatedSprite2D::SetSpineAnimation()
 {
@@ -284,9 +317,6 @@ void AnimatedSprite2D::UpdateSpineAnimation(float timeStep)
     spAnimationState_update(animationState_, timeStep);
     spAnimationState_apply(animationState_, skeleton_);
     spSkeleton_updateWorldTransform(skeleton_);
-
-    sourceBatchesDirty_ = true;
-    worldBoundingBoxDirty_ = true;
 }
 
 // This enum used to be defined in spine/RegionAttachment.h but it got moved inside RegionAttachment.c so it's no longer accessible.
@@ -397,8 +427,6 @@ void AnimatedSprite2D::SetSpriterAnimation()
 void AnimatedSprite2D::UpdateSpriterAnimation(float timeStep)
 {
     spriterInstance_->Update(timeStep * speed_);
-    sourceBatchesDirty_ = true;
-    worldBoundingBoxDirty_ = true;
 }
 
 void AnimatedSprite2D::UpdateSourceBatchesSpriter()
@@ -92,13 +92,18 @@ public:
     /// @property{set_animation}
     void SetAnimationAttr(const String& name);
 
+    /// Advance the animation pose. Marking dirty and animation events are deferred to FinishAnimationUpdate(). May be called from a worker thread.
+    void AdvanceAnimation(float timeStep);
+    /// Mark dirty and send animation events after AdvanceAnimation(). Called from the main thread.
+    void FinishAnimationUpdate();
+
 protected:
     /// Handle scene being assigned.
     void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box from the animated vertices.
+    void OnWorldBoundingBoxUpdate() override;
     /// Handle update vertices.
     void UpdateSourceBatches() override;
-    /// Handle scene post update.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
     /// Update animation.
     void UpdateAnimation(float timeStep);
 #ifdef URHO3D_SPINE
@@ -90,7 +90,8 @@ AnimationSet2D::AnimationSet2D(Context* context) :
     skeletonData_(0),
     atlas_(0),
 #endif
-    hasSpriteSheet_(false)
+    hasSpriteSheet_(false),
+    spriterBakeFrameRate_(0.0f)
 {
 }
 
@@ -283,6 +284,8 @@ bool AnimationSet2D::BeginLoadSpriter(Deserializer& source)
         return false;
     }
 
+    BakeSpriterAnimations();
+
     // Check has sprite sheet
     String parentPath = GetParentPath(GetName());
     auto* cache = GetSubsystem<ResourceCache>();
@@ -488,6 +491,28 @@ bool AnimationSet2D::EndLoadSpriter()
     return true;
 }
 
+void AnimationSet2D::SetSpriterBakeFrameRate(float frameRate)
+{
+    frameRate = Max(frameRate, 0.0f);
+    if (frameRate == spriterBakeFrameRate_)
+        return;
+
+    spriterBakeFrameRate_ = frameRate;
+    BakeSpriterAnimations();
+}
+
+void AnimationSet2D::BakeSpriterAnimations()
+{
+    if (!spriterData_)
+        return;
+
+    for (Spriter::Entity* entity : spriterData_->entities_)
+    {
+        for (Spriter::Animation* animation : entity->animations_)
+            animation->Bake(spriterBakeFrameRate_);
+    }
+}
+
 void AnimationSet2D::Dispose()
 {
 #ifdef URHO3D_SPINE
@@ -66,6 +66,11 @@ public:
     /// Return spriter file sprite.
     Sprite2D* GetSpriterFileSprite(int folderId, int fileId) const;
 
+    /// Bake Spriter animations into tracks sampled at a fixed rate, which are played back without evaluating key curves. Zero rate removes the baked tracks. Kept over reloads. Do not call while animations are updating.
+    void SetSpriterBakeFrameRate(float frameRate);
+    /// Return Spriter bake frame rate, zero if not baked.
+    float GetSpriterBakeFrameRate() const { return spriterBakeFrameRate_; }
+
 private:
     /// Return sprite by hash.
     Sprite2D* GetSpriterFileSprite(const StringHash& hash) const;
@@ -79,6 +84,8 @@ private:
     bool BeginLoadSpriter(Deserializer& source);
     /// Finish load scml.
     bool EndLoadSpriter();
+    /// Bake or remove baked tracks of all Spriter animations.
+    void BakeSpriterAnimations();
     /// Dispose all data.
     void Dispose();
 
@@ -108,6 +115,9 @@ private:
 
     /// Spriter sprites.
     HashMap<unsigned, SharedPtr<Sprite2D>> spriterFileSprites_;
+
+    /// Spriter bake frame rate.
+    float spriterBakeFrameRate_;
 };
 
 }
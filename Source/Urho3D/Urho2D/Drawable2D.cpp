@@ -18,7 +18,8 @@ namespace Urho3D
 
 SourceBatch2D::SourceBatch2D() :
     distance_(0.0f),
-    drawOrder_(0)
+    drawOrder_(0),
+    poolStart_(0)
 {
 }
 
@@ -26,7 +27,14 @@ Drawable2D::Drawable2D(Context* context) :
     Drawable(context, DrawableTypes::Geometry2D),
     layer_(0),
     orderInLayer_(0),
-    sourceBatchesDirty_(true)
+    sourceBatchesDirty_(true),
+    spatialUpdateQueued_(false),
+    spatialCell_(M_MAX_UNSIGNED),
+    spatialIndex_(0),
+    sourceBatchesVersion_(1),
+    poolStart_(0),
+    poolCapacity_(0),
+    poolVersion_(0)
 {
 }
 
@@ -78,7 +86,12 @@ void Drawable2D::SetOrderInLayer(int orderInLayer)
 const Vector<SourceBatch2D>& Drawable2D::GetSourceBatches()
 {
     if (sourceBatchesDirty_)
+    {
         UpdateSourceBatches();
+        // Zero is reserved for "never uploaded"
+        if (++sourceBatchesVersion_ == 0)
+            sourceBatchesVersion_ = 1;
+    }
 
     return sourceBatches_;
 }
@@ -106,6 +119,26 @@ void Drawable2D::OnMarkedDirty(Node* node)
     Drawable::OnMarkedDirty(node);
 
     sourceBatchesDirty_ = true;
+
+    // Source batches are rebuilt on worker threads, which must not update world transforms. Let the renderer resolve it first
+    if (renderer_ && !spatialUpdateQueued_)
+    {
+        Scene* scene = GetScene();
+        if (scene && scene->IsThreadedUpdate())
+        {
+            scene->DelayedMarkedDirty(this);
+            return;
+        }
+
+        renderer_->QueueSpatialUpdate(this);
+    }
+}
+
+void Drawable2D::MarkBoundingBoxDirty()
+{
+    worldBoundingBoxDirty_ = true;
+    if (renderer_ && !spatialUpdateQueued_)
+        renderer_->QueueSpatialUpdate(this);
 }
 
 }
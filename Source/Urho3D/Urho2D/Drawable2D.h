@@ -42,6 +42,8 @@ struct SourceBatch2D
     SharedPtr<Material> material_;
     /// Vertices.
     Vector<Vertex2D> vertices_;
+    /// Start vertex in Renderer2D's persistent vertex pool.
+    mutable unsigned poolStart_;
 };
 
 /// Base class for 2D visible components.
@@ -49,6 +51,9 @@ class URHO3D_API Drawable2D : public Drawable
 {
     URHO3D_OBJECT(Drawable2D, Drawable);
 
+    friend class Renderer2D;
+    friend class SpatialGrid2D;
+
 public:
     /// Construct.
     explicit Drawable2D(Context* context);
@@ -78,6 +83,8 @@ public:
 
     /// Return all source batches (called by Renderer2D).
     const Vector<SourceBatch2D>& GetSourceBatches();
+    /// Return source batches version, which changes whenever the source batches are rebuilt.
+    u32 GetSourceBatchesVersion() const { return sourceBatchesVersion_; }
 
 protected:
     /// Handle scene being assigned.
@@ -88,6 +95,8 @@ protected:
     virtual void OnDrawOrderChanged() = 0;
     /// Update source batches.
     virtual void UpdateSourceBatches() = 0;
+    /// Mark the world bounding box changed without a node transform change, so that Renderer2D moves the drawable in its spatial index. Main thread only.
+    void MarkBoundingBoxDirty();
 
     /// Return draw order by layer and order in layer.
     int GetDrawOrder() const { return layer_ << 16u | orderInLayer_; }
@@ -102,6 +111,22 @@ protected:
     bool sourceBatchesDirty_;
     /// Renderer2D.
     WeakPtr<Renderer2D> renderer_;
+
+private:
+    /// Whether the node's world transform and bounding box are queued to be resolved by Renderer2D on the main thread.
+    bool spatialUpdateQueued_;
+    /// Cell index in Renderer2D's spatial index, M_MAX_UNSIGNED if not inserted.
+    unsigned spatialCell_;
+    /// Index within the spatial index cell.
+    unsigned spatialIndex_;
+    /// Source batches version.
+    u32 sourceBatchesVersion_;
+    /// Start of the vertex range in Renderer2D's persistent vertex pool.
+    unsigned poolStart_;
+    /// Size of the vertex range in the persistent vertex pool, zero if not allocated.
+    unsigned poolCapacity_;
+    /// Source batches version last uploaded to the persistent vertex pool, zero if none.
+    u32 poolVersion_;
 };
 
 }
@@ -4,7 +4,9 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Scene/Scene.h"
 #include "../Urho2D/Light2D.h"
+#include "../Urho2D/Renderer2D.h"
 #include "../Urho2D/Urho2D.h"
 
 #include "../DebugNew.h"
@@ -18,6 +20,12 @@ Light2D::Light2D(Context* context) : Component(context)
 {
 }
 
+Light2D::~Light2D()
+{
+    if (renderer_)
+        renderer_->RemoveLight(this);
+}
+
 void Light2D::RegisterObject(Context* context)
 {
     context->RegisterFactory<Light2D>(URHO2D_CATEGORY);
@@ -28,4 +36,30 @@ void Light2D::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Radius", radius_, 2.0f, AM_DEFAULT);
 }
 
+void Light2D::OnSetEnabled()
+{
+    bool enabled = IsEnabledEffective();
+
+    if (enabled && renderer_)
+        renderer_->AddLight(this);
+    else if (!enabled && renderer_)
+        renderer_->RemoveLight(this);
+}
+
+void Light2D::OnSceneSet(Scene* scene)
+{
+    if (scene)
+    {
+        renderer_ = scene->GetOrCreateComponent<Renderer2D>();
+
+        if (IsEnabledEffective())
+            renderer_->AddLight(this);
+    }
+    else
+    {
+        if (renderer_)
+            renderer_->RemoveLight(this);
+    }
+}
+
 }
@@ -10,6 +10,8 @@
 namespace Urho3D
 {
 
+class Renderer2D;
+
 /// 2D 轻量光源组件（仅用于 2.5D 效果的顶点色调制）。
 class URHO3D_API Light2D : public Component
 {
@@ -23,10 +25,13 @@ public:
     };
 
     explicit Light2D(Context* context);
-    ~Light2D() override = default;
+    ~Light2D() override;
 
     static void RegisterObject(Context* context);
 
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+
     void SetLightType(Type t) { type_ = t; }
     void SetColor(const Color& c) { color_ = c; }
     void SetIntensity(float i) { intensity_ = i; }
@@ -41,11 +46,17 @@ public:
     void SetLightTypeAttr(int v) { type_ = (Type)Clamp(v, 0, 1); }
     int GetLightTypeAttr() const { return (int)type_; }
 
+protected:
+    /// Handle scene being assigned. Registers the light with the scene's Renderer2D.
+    void OnSceneSet(Scene* scene) override;
+
 private:
     Type type_ { POINT };
     Color color_ { Color::WHITE };
     float intensity_ { 1.0f };
     float radius_ { 2.0f };
+    /// Renderer2D the light is registered with.
+    WeakPtr<Renderer2D> renderer_;
 };
 
 }
@@ -15,6 +15,10 @@
 #include "../Urho2D/Sprite2D.h"
 #include "../Urho2D/Urho2DEvents.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -23,12 +27,303 @@ namespace Urho3D
 extern const char* URHO2D_CATEGORY;
 extern const char* blendModeNames[];
 
+namespace
+{
+
+#ifdef URHO3D_SSE
+/// Four floats processed with SSE.
+struct Float4
+{
+    static constexpr unsigned SIZE = 4;
+
+    Float4() = default;
+    Float4(__m128 v) : v_(v) {}
+    explicit Float4(float x) : v_(_mm_set1_ps(x)) {}
+
+    static Float4 Load(const float* src) { return _mm_loadu_ps(src); }
+    void Store(float* dest) const { _mm_storeu_ps(dest, v_); }
+
+    __m128 v_;
+};
+
+inline Float4 operator +(Float4 lhs, Float4 rhs) { return _mm_add_ps(lhs.v_, rhs.v_); }
+inline Float4 operator -(Float4 lhs, Float4 rhs) { return _mm_sub_ps(lhs.v_, rhs.v_); }
+inline Float4 operator *(Float4 lhs, Float4 rhs) { return _mm_mul_ps(lhs.v_, rhs.v_); }
+inline Float4 operator /(Float4 lhs, Float4 rhs) { return _mm_div_ps(lhs.v_, rhs.v_); }
+inline Float4 VMin(Float4 lhs, Float4 rhs) { return _mm_min_ps(lhs.v_, rhs.v_); }
+inline Float4 VMax(Float4 lhs, Float4 rhs) { return _mm_max_ps(lhs.v_, rhs.v_); }
+inline Float4 VSqrt(Float4 x) { return _mm_sqrt_ps(x.v_); }
+inline Float4 VRound(Float4 x) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(x.v_)); }
+#else
+/// Four floats processed lane by lane. Plain loops that the compiler can vectorize, e.g. with NEON.
+struct Float4
+{
+    static constexpr unsigned SIZE = 4;
+
+    Float4() = default;
+    explicit Float4(float x) : v_{x, x, x, x} {}
+
+    static Float4 Load(const float* src) { Float4 ret; for (unsigned i = 0; i < SIZE; ++i) ret.v_[i] = src[i]; return ret; }
+    void Store(float* dest) const { for (unsigned i = 0; i < SIZE; ++i) dest[i] = v_[i]; }
+
+    float v_[SIZE];
+};
+
+#define URHO3D_FLOAT4_OP(name, expr) inline Float4 name(Float4 lhs, Float4 rhs) \
+    { Float4 ret; for (unsigned i = 0; i < Float4::SIZE; ++i) { float a = lhs.v_[i]; float b = rhs.v_[i]; ret.v_[i] = (expr); } return ret; }
+URHO3D_FLOAT4_OP(operator +, a + b)
+URHO3D_FLOAT4_OP(operator -, a - b)
+URHO3D_FLOAT4_OP(operator *, a * b)
+URHO3D_FLOAT4_OP(operator /, a / b)
+URHO3D_FLOAT4_OP(VMin, a < b ? a : b)
+URHO3D_FLOAT4_OP(VMax, a > b ? a : b)
+#undef URHO3D_FLOAT4_OP
+inline Float4 VSqrt(Float4 x) { for (float& v : x.v_) v = sqrtf(v); return x; }
+inline Float4 VRound(Float4 x) { for (float& v : x.v_) v = floorf(v + 0.5f); return x; }
+#endif
+
+/// Single float with the same interface as Float4, for the remainder of a particle range.
+struct Float1
+{
+    static constexpr unsigned SIZE = 1;
+
+    Float1() = default;
+    explicit Float1(float x) : v_(x) {}
+
+    static Float1 Load(const float* src) { return Float1(*src); }
+    void Store(float* dest) const { *dest = v_; }
+
+    float v_;
+};
+
+inline Float1 operator +(Float1 lhs, Float1 rhs) { return Float1(lhs.v_ + rhs.v_); }
+inline Float1 operator -(Float1 lhs, Float1 rhs) { return Float1(lhs.v_ - rhs.v_); }
+inline Float1 operator *(Float1 lhs, Float1 rhs) { return Float1(lhs.v_ * rhs.v_); }
+inline Float1 operator /(Float1 lhs, Float1 rhs) { return Float1(lhs.v_ / rhs.v_); }
+inline Float1 VMin(Float1 lhs, Float1 rhs) { return Float1(lhs.v_ < rhs.v_ ? lhs.v_ : rhs.v_); }
+inline Float1 VMax(Float1 lhs, Float1 rhs) { return Float1(lhs.v_ > rhs.v_ ? lhs.v_ : rhs.v_); }
+inline Float1 VSqrt(Float1 x) { return Float1(sqrtf(x.v_)); }
+inline Float1 VRound(Float1 x) { return Float1(floorf(x.v_ + 0.5f)); }
+
+/// Return sine of angles in radians. Reduced to -pi/2...pi/2 and evaluated as a Taylor polynomial.
+template <class V> V VSinRad(V x)
+{
+    x = x - VRound(x * V(0.5f / M_PI)) * V(2.0f * M_PI);
+    x = VMin(x, V(M_PI) - x);
+    x = VMax(x, V(-M_PI) - x);
+
+    V x2 = x * x;
+    V p = V(-2.5052108e-8f);
+    p = p * x2 + V(2.7557319e-6f);
+    p = p * x2 + V(-1.9841270e-4f);
+    p = p * x2 + V(8.3333333e-3f);
+    p = p * x2 + V(-1.6666667e-1f);
+    p = p * x2 + V(1.0f);
+    return p * x;
+}
+
+/// Calculate sine and cosine of angles in degrees.
+template <class V> void VSinCos(V degrees, V& sin, V& cos)
+{
+    V radians = degrees * V(M_DEGTORAD);
+    sin = VSinRad(radians);
+    cos = VSinRad(radians + V(M_HALF_PI));
+}
+
+/// Particle bounds accumulated by the update kernel.
+template <class V> struct ParticleBounds2D
+{
+    explicit ParticleBounds2D(const Vector3& min, const Vector3& max) :
+        minX_(min.x_), minY_(min.y_), minZ_(min.z_),
+        maxX_(max.x_), maxY_(max.y_), maxZ_(max.z_)
+    {
+    }
+
+    /// Merge lanes to a bounding box.
+    void Reduce(Vector3& min, Vector3& max) const
+    {
+        float lanes[6][V::SIZE];
+        minX_.Store(lanes[0]); minY_.Store(lanes[1]); minZ_.Store(lanes[2]);
+        maxX_.Store(lanes[3]); maxY_.Store(lanes[4]); maxZ_.Store(lanes[5]);
+        for (unsigned i = 0; i < V::SIZE; ++i)
+        {
+            min.x_ = Min(min.x_, lanes[0][i]); min.y_ = Min(min.y_, lanes[1][i]); min.z_ = Min(min.z_, lanes[2][i]);
+            max.x_ = Max(max.x_, lanes[3][i]); max.y_ = Max(max.y_, lanes[4][i]); max.z_ = Max(max.z_, lanes[5][i]);
+        }
+    }
+
+    V minX_, minY_, minZ_;
+    V maxX_, maxY_, maxZ_;
+};
+
+/// Update particles in groups of V::SIZE starting from begin while a whole group fits before end. Return the first particle not updated.
+template <class V, bool Radial> unsigned UpdateParticleKernel(float* data, unsigned stride, unsigned begin, unsigned end,
+    float timeStep, float gravityX, float gravityY, ParticleBounds2D<V>& bounds)
+{
+    float* timeToLive = data + PS_TIME_TO_LIVE * stride;
+    float* positionX = data + PS_POSITION_X * stride;
+    float* positionY = data + PS_POSITION_Y * stride;
+    const float* positionZ = data + PS_POSITION_Z * stride;
+    float* size = data + PS_SIZE * stride;
+    const float* sizeDelta = data + PS_SIZE_DELTA * stride;
+    float* rotation = data + PS_ROTATION * stride;
+    const float* rotationDelta = data + PS_ROTATION_DELTA * stride;
+    const float* startX = data + PS_START_X * stride;
+    const float* startY = data + PS_START_Y * stride;
+
+    const V maxTimeStep(timeStep);
+    const V half(0.5f);
+
+    unsigned i = begin;
+    for (; i + V::SIZE <= end; i += V::SIZE)
+    {
+        V ttl = V::Load(timeToLive + i);
+        V dt = VMin(maxTimeStep, ttl);
+        (ttl - dt).Store(timeToLive + i);
+
+        V x;
+        V y;
+        if (Radial)
+        {
+            float* emitRotation = data + PS_EMIT_ROTATION * stride + i;
+            float* emitRadius = data + PS_EMIT_RADIUS * stride + i;
+            V angle = V::Load(emitRotation) + V::Load(data + PS_EMIT_ROTATION_DELTA * stride + i) * dt;
+            V radius = V::Load(emitRadius) + V::Load(data + PS_EMIT_RADIUS_DELTA * stride + i) * dt;
+            angle.Store(emitRotation);
+            radius.Store(emitRadius);
+
+            V sin;
+            V cos;
+            VSinCos(angle, sin, cos);
+            x = V::Load(startX + i) - cos * radius;
+            y = V::Load(startY + i) + sin * radius;
+        }
+        else
+        {
+            float* velocityX = data + PS_VELOCITY_X * stride + i;
+            float* velocityY = data + PS_VELOCITY_Y * stride + i;
+            const V radialAcceleration = V::Load(data + PS_RADIAL_ACCELERATION * stride + i);
+            const V tangentialAcceleration = V::Load(data + PS_TANGENTIAL_ACCELERATION * stride + i);
+
+            x = V::Load(positionX + i);
+            y = V::Load(positionY + i);
+            V distanceX = x - V::Load(startX + i);
+            V distanceY = y - V::Load(startY + i);
+            V distance = VMax(VSqrt(distanceX * distanceX + distanceY * distanceY), V(0.0001f));
+            V radialX = distanceX / distance;
+            V radialY = distanceY / distance;
+
+            // Tangential direction is the radial direction rotated by 90 degrees
+            V vx = V::Load(velocityX) + (V(gravityX) + radialX * radialAcceleration + radialY * tangentialAcceleration) * dt;
+            V vy = V::Load(velocityY) - (V(gravityY) - radialY * radialAcceleration + radialX * tangentialAcceleration) * dt;
+            vx.Store(velocityX);
+            vy.Store(velocityY);
+            x = x + vx * dt;
+            y = y + vy * dt;
+        }
+
+        x.Store(positionX + i);
+        y.Store(positionY + i);
+
+        V newSize = V::Load(size + i) + V::Load(sizeDelta + i) * dt;
+        newSize.Store(size + i);
+        (V::Load(rotation + i) + V::Load(rotationDelta + i) * dt).Store(rotation + i);
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            float* color = data + (PS_COLOR_R + c) * stride + i;
+            (V::Load(color) + V::Load(data + (PS_COLOR_DELTA_R + c) * stride + i) * dt).Store(color);
+        }
+
+        V halfSize = newSize * half;
+        V z = V::Load(positionZ + i);
+        bounds.minX_ = VMin(bounds.minX_, x - halfSize);
+        bounds.minY_ = VMin(bounds.minY_, y - halfSize);
+        bounds.minZ_ = VMin(bounds.minZ_, z);
+        bounds.maxX_ = VMax(bounds.maxX_, x + halfSize);
+        bounds.maxY_ = VMax(bounds.maxY_, y + halfSize);
+        bounds.maxZ_ = VMax(bounds.maxZ_, z);
+    }
+
+    return i;
+}
+
+/// Expand particles to quads in groups of V::SIZE starting from begin while a whole group fits before end. Return the first particle not expanded.
+template <class V> unsigned ExpandParticleQuads(const float* data, unsigned stride, unsigned begin, unsigned end,
+    const Rect& textureRect, Vertex2D* vertices)
+{
+    const float* positionX = data + PS_POSITION_X * stride;
+    const float* positionY = data + PS_POSITION_Y * stride;
+    const float* positionZ = data + PS_POSITION_Z * stride;
+    const float* size = data + PS_SIZE * stride;
+    const float* rotation = data + PS_ROTATION * stride;
+
+    const V zero(0.0f);
+    const V maxChannel(255.0f);
+
+    unsigned i = begin;
+    for (; i + V::SIZE <= end; i += V::SIZE)
+    {
+        V sin;
+        V cos;
+        VSinCos(zero - V::Load(rotation + i), sin, cos);
+
+        V halfSize = V::Load(size + i) * V(0.5f);
+        V add = (cos + sin) * halfSize;
+        V sub = (cos - sin) * halfSize;
+        V x = V::Load(positionX + i);
+        V y = V::Load(positionY + i);
+
+        float corners[8][V::SIZE];
+        (x - sub).Store(corners[0]); (y - add).Store(corners[1]);
+        (x - add).Store(corners[2]); (y + sub).Store(corners[3]);
+        (x + sub).Store(corners[4]); (y + add).Store(corners[5]);
+        (x + add).Store(corners[6]); (y - sub).Store(corners[7]);
+
+        // Same conversion as Color::ToU32(): clamping before truncation gives the same result
+        float channels[4][V::SIZE];
+        for (unsigned c = 0; c < 4; ++c)
+            VMin(VMax(V::Load(data + (PS_COLOR_R + c) * stride + i) * maxChannel, zero), maxChannel).Store(channels[c]);
+
+        for (unsigned j = 0; j < V::SIZE; ++j)
+        {
+            const float z = positionZ[i + j];
+            const unsigned color = ((unsigned)channels[3][j] << 24u) | ((unsigned)channels[2][j] << 16u) |
+                ((unsigned)channels[1][j] << 8u) | (unsigned)channels[0][j];
+
+            /*
+            V1---------V2
+            |         / |
+            |       /   |
+            |     /     |
+            |   /       |
+            | /         |
+            V0---------V3
+            */
+            Vertex2D* quad = vertices + (i + j) * 4;
+            quad[0] = {Vector3(corners[0][j], corners[1][j], z), color, textureRect.min_};
+            quad[1] = {Vector3(corners[2][j], corners[3][j], z), color, Vector2(textureRect.min_.x_, textureRect.max_.y_)};
+            quad[2] = {Vector3(corners[4][j], corners[5][j], z), color, textureRect.max_};
+            quad[3] = {Vector3(corners[6][j], corners[7][j], z), color, Vector2(textureRect.max_.x_, textureRect.min_.y_)};
+        }
+    }
+
+    return i;
+}
+
+}
+
 ParticleEmitter2D::ParticleEmitter2D(Context* context) :
     Drawable2D(context),
     blendMode_(BLEND_ADDALPHA),
     numParticles_(0),
     emissionTime_(0.0f),
     emitParticleTime_(0.0f),
+    particleCapacity_(0),
+    randomSeed_(((u32)Rand() * 2654435761u) | 1u),
+    emitterAngle_(0.0f),
+    emitterScale_(1.0f),
+    hadParticles_(false),
+    wasEmitting_(false),
     boundingBoxMinPoint_(Vector3::ZERO),
     boundingBoxMaxPoint_(Vector3::ZERO),
     emitting_(true)
@@ -37,7 +332,11 @@ ParticleEmitter2D::ParticleEmitter2D(Context* context) :
     sourceBatches_[0].owner_ = this;
 }
 
-ParticleEmitter2D::~ParticleEmitter2D() = default;
+ParticleEmitter2D::~ParticleEmitter2D()
+{
+    if (renderer_)
+        renderer_->RemoveParticleEmitter(this);
+}
 
 void ParticleEmitter2D::RegisterObject(Context* context)
 {
@@ -65,6 +364,14 @@ void ParticleEmitter2D::OnSetEnabled()
         else
             UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
     }
+
+    if (renderer_)
+    {
+        if (IsEnabledEffective())
+            renderer_->AddParticleEmitter(this);
+        else
+            renderer_->RemoveParticleEmitter(this);
+    }
 }
 
 void ParticleEmitter2D::SetEffect(ParticleEffect2D* effect)
@@ -111,11 +418,18 @@ void ParticleEmitter2D::SetBlendMode(BlendMode blendMode)
 void ParticleEmitter2D::SetMaxParticles(unsigned maxParticles)
 {
     maxParticles = Max(maxParticles, 1U);
+    if (maxParticles == particleCapacity_)
+        return;
 
-    particles_.Resize(maxParticles);
-    sourceBatches_[0].vertices_.Reserve(maxParticles * 4);
-
+    // Streams are laid out by capacity, so move the live particles of each stream to the new layout
     numParticles_ = Min(maxParticles, numParticles_);
+    Vector<float> particleData(MAX_PARTICLE_STREAMS_2D * maxParticles);
+    for (unsigned i = 0; i < MAX_PARTICLE_STREAMS_2D && numParticles_; ++i)
+        memcpy(&particleData[i * maxParticles], &particleData_[i * particleCapacity_], numParticles_ * sizeof(float));
+
+    particleData_.swap(particleData);
+    particleCapacity_ = maxParticles;
+    sourceBatches_[0].vertices_.Reserve(maxParticles * 4);
 }
 
 ParticleEffect2D* ParticleEmitter2D::GetEffect() const
@@ -167,9 +481,17 @@ void ParticleEmitter2D::OnSceneSet(Scene* scene)
     Drawable2D::OnSceneSet(scene);
 
     if (scene && IsEnabledEffective())
+    {
         SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(ParticleEmitter2D, HandleScenePostUpdate));
+        if (renderer_)
+            renderer_->AddParticleEmitter(this);
+    }
     else if (!scene)
+    {
         UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        if (renderer_)
+            renderer_->RemoveParticleEmitter(this);
+    }
 }
 
 void ParticleEmitter2D::OnWorldBoundingBoxUpdate()
@@ -202,47 +524,11 @@ void ParticleEmitter2D::UpdateSourceBatches()
     if (!sprite_->GetTextureRectangle(textureRect))
         return;
 
-    /*
-    V1---------V2
-    |         / |
-    |       /   |
-    |     /     |
-    |   /       |
-    | /         |
-    V0---------V3
-    */
-    Vertex2D vertex0;
-    Vertex2D vertex1;
-    Vertex2D vertex2;
-    Vertex2D vertex3;
-
-    vertex0.uv_ = textureRect.min_;
-    vertex1.uv_ = Vector2(textureRect.min_.x_, textureRect.max_.y_);
-    vertex2.uv_ = textureRect.max_;
-    vertex3.uv_ = Vector2(textureRect.max_.x_, textureRect.min_.y_);
-
-    for (unsigned i = 0; i < numParticles_; ++i)
-    {
-        Particle2D& p = particles_[i];
-
-        float rotation = -p.rotation_;
-        float c = Cos(rotation);
-        float s = Sin(rotation);
-        float add = (c + s) * p.size_ * 0.5f;
-        float sub = (c - s) * p.size_ * 0.5f;
+    vertices.Resize(numParticles_ * 4);
 
-        vertex0.position_ = Vector3(p.position_.x_ - sub, p.position_.y_ - add, p.position_.z_);
-        vertex1.position_ = Vector3(p.position_.x_ - add, p.position_.y_ + sub, p.position_.z_);
-        vertex2.position_ = Vector3(p.position_.x_ + sub, p.position_.y_ + add, p.position_.z_);
-        vertex3.position_ = Vector3(p.position_.x_ + add, p.position_.y_ - sub, p.position_.z_);
-
-        vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = p.color_.ToU32();
-
-        vertices.Push(vertex0);
-        vertices.Push(vertex1);
-        vertices.Push(vertex2);
-        vertices.Push(vertex3);
-    }
+    const float* data = particleData_.Buffer();
+    unsigned i = ExpandParticleQuads<Float4>(data, particleCapacity_, 0, numParticles_, textureRect, vertices.Buffer());
+    ExpandParticleQuads<Float1>(data, particleCapacity_, i, numParticles_, textureRect, vertices.Buffer());
 
     sourceBatchesDirty_ = false;
 }
@@ -257,35 +543,55 @@ void ParticleEmitter2D::UpdateMaterial()
 
 void ParticleEmitter2D::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
 {
+    // Renderer2D updates all emitters of the scene itself when updating them in parallel
+    if (renderer_ && renderer_->GetParallelParticleUpdate())
+        return;
+
     using namespace ScenePostUpdate;
-    bool hasParticles = numParticles_ > 0;
-    bool emitting = emissionTime_ > 0.0f;
-    float timeStep = eventData[P_TIMESTEP].GetFloat();
-    Update(timeStep);
+    PrepareUpdate();
+    Update(eventData[P_TIMESTEP].GetFloat());
+    FinishUpdate();
+}
+
+void ParticleEmitter2D::PrepareUpdate()
+{
+    hadParticles_ = numParticles_ > 0;
+    wasEmitting_ = emissionTime_ > 0.0f;
+
+    if (!effect_)
+        return;
+
+    emitterPosition_ = GetNode()->GetWorldPosition();
+    emitterAngle_ = GetNode()->GetWorldRotation().RollAngle();
+    emitterScale_ = GetNode()->GetWorldScale().x_ * PIXEL_SIZE;
+}
+
+void ParticleEmitter2D::FinishUpdate()
+{
+    if (!effect_)
+        return;
+
+    OnMarkedDirty(node_);
 
-    if (emitting && emissionTime_ == 0.0f)
+    if (wasEmitting_ && emissionTime_ == 0.0f)
     {
         // Make a weak pointer to self to check for destruction during event handling
         WeakPtr<ParticleEmitter2D> self(this);
-        using namespace ParticlesDuration;
 
-        VariantMap& eventData = GetEventDataMap();
-        eventData[P_NODE] = node_;
-        eventData[P_EFFECT] = effect_;
-        SendEvent(E_PARTICLESDURATION, eventData); // Emitting particles stopped
+        Particles2DPayload payload;
+        payload.node_ = node_;
+        payload.effect_ = effect_;
+        SendTypedEvent(E_PARTICLESDURATION, payload); // Emitting particles stopped
 
         if (self.Expired())
             return;
     }
-    if (hasParticles && numParticles_ == 0)
+    if (hadParticles_ && numParticles_ == 0)
     {
-        using namespace ParticlesEnd;
-
-        VariantMap& eventData = GetEventDataMap();
-        eventData[P_NODE] = node_;
-        eventData[P_EFFECT] = effect_;
-
-        SendEvent(E_PARTICLESEND, eventData);      // All particles over
+        Particles2DPayload payload;
+        payload.node_ = node_;
+        payload.effect_ = effect_;
+        SendTypedEvent(E_PARTICLESEND, payload);      // All particles over
     }
 }
 
@@ -294,40 +600,39 @@ void ParticleEmitter2D::Update(float timeStep)
     if (!effect_)
         return;
 
-    Vector3 worldPosition = GetNode()->GetWorldPosition();
-    float worldScale = GetNode()->GetWorldScale().x_ * PIXEL_SIZE;
-
     boundingBoxMinPoint_ = Vector3(M_INFINITY, M_INFINITY, M_INFINITY);
     boundingBoxMaxPoint_ = Vector3(-M_INFINITY, -M_INFINITY, -M_INFINITY);
 
-    unsigned particleIndex = 0;
-    while (particleIndex < numParticles_)
+    // Remove expired particles by moving the last particle in their place
+    float* data = particleData_.Buffer();
+    const float* timeToLive = GetStream(PS_TIME_TO_LIVE);
+    for (unsigned i = 0; i < numParticles_;)
     {
-        Particle2D& particle = particles_[particleIndex];
-        if (particle.timeToLive_ > 0.0f)
+        if (timeToLive[i] > 0.0f)
         {
-            UpdateParticle(particle, timeStep, worldPosition, worldScale);
-            ++particleIndex;
+            ++i;
+            continue;
         }
-        else
+
+        --numParticles_;
+        if (i != numParticles_)
         {
-            if (particleIndex != numParticles_ - 1)
-                particles_[particleIndex] = particles_[numParticles_ - 1];
-            --numParticles_;
+            for (unsigned j = 0; j < MAX_PARTICLE_STREAMS_2D; ++j)
+                data[j * particleCapacity_ + i] = data[j * particleCapacity_ + numParticles_];
         }
     }
 
+    UpdateParticles(0, numParticles_, timeStep);
+
     if (emitting_ && emissionTime_ > 0.0f)
     {
-        float worldAngle = GetNode()->GetWorldRotation().RollAngle();
-
-        float timeBetweenParticles = effect_->GetParticleLifeSpan() / particles_.Size();
+        float timeBetweenParticles = effect_->GetParticleLifeSpan() / particleCapacity_;
         emitParticleTime_ += timeStep;
 
         while (emitParticleTime_ > 0.0f)
         {
-            if (EmitParticle(worldPosition, worldAngle, worldScale))
-                UpdateParticle(particles_[numParticles_ - 1], emitParticleTime_, worldPosition, worldScale);
+            if (EmitParticle())
+                UpdateParticles(numParticles_ - 1, numParticles_, emitParticleTime_);
 
             emitParticleTime_ -= timeBetweenParticles;
         }
@@ -337,118 +642,128 @@ void ParticleEmitter2D::Update(float timeStep)
     }
 
     sourceBatchesDirty_ = true;
-
-    OnMarkedDirty(node_);
 }
 
-bool ParticleEmitter2D::EmitParticle(const Vector3& worldPosition, float worldAngle, float worldScale)
+bool ParticleEmitter2D::EmitParticle()
 {
-    if (numParticles_ >= (unsigned)effect_->GetMaxParticles() || numParticles_ >= particles_.Size())
+    if (numParticles_ >= (unsigned)effect_->GetMaxParticles() || numParticles_ >= particleCapacity_)
         return false;
 
-    float lifespan = effect_->GetParticleLifeSpan() + effect_->GetParticleLifespanVariance() * Random(-1.0f, 1.0f);
+    float lifespan = effect_->GetParticleLifeSpan() + effect_->GetParticleLifespanVariance() * RandomUnit();
     if (lifespan <= 0.0f)
         return false;
 
     float invLifespan = 1.0f / lifespan;
-
-    Particle2D& particle = particles_[numParticles_++];
-    particle.timeToLive_ = lifespan;
-
-    particle.position_.x_ = worldPosition.x_ + worldScale * effect_->GetSourcePositionVariance().x_ * Random(-1.0f, 1.0f);
-    particle.position_.y_ = worldPosition.y_ + worldScale * effect_->GetSourcePositionVariance().y_ * Random(-1.0f, 1.0f);
-    particle.position_.z_ = worldPosition.z_;
-    particle.startPos_.x_ = worldPosition.x_;
-    particle.startPos_.y_ = worldPosition.y_;
-
-    float angle = worldAngle + effect_->GetAngle() + effect_->GetAngleVariance() * Random(-1.0f, 1.0f);
-    float speed = worldScale * (effect_->GetSpeed() + effect_->GetSpeedVariance() * Random(-1.0f, 1.0f));
-    particle.velocity_.x_ = speed * Cos(angle);
-    particle.velocity_.y_ = speed * Sin(angle);
-
-    float maxRadius = Max(0.0f, worldScale * (effect_->GetMaxRadius() + effect_->GetMaxRadiusVariance() * Random(-1.0f, 1.0f)));
-    float minRadius = Max(0.0f, worldScale * (effect_->GetMinRadius() + effect_->GetMinRadiusVariance() * Random(-1.0f, 1.0f)));
-    particle.emitRadius_ = maxRadius;
-    particle.emitRadiusDelta_ = (minRadius - maxRadius) * invLifespan;
-    particle.emitRotation_ = worldAngle + effect_->GetAngle() + effect_->GetAngleVariance() * Random(-1.0f, 1.0f);
-    particle.emitRotationDelta_ = effect_->GetRotatePerSecond() + effect_->GetRotatePerSecondVariance() * Random(-1.0f, 1.0f);
-    particle.radialAcceleration_ =
-        worldScale * (effect_->GetRadialAcceleration() + effect_->GetRadialAccelVariance() * Random(-1.0f, 1.0f));
-    particle.tangentialAcceleration_ =
-        worldScale * (effect_->GetTangentialAcceleration() + effect_->GetTangentialAccelVariance() * Random(-1.0f, 1.0f));
+    const float worldScale = emitterScale_;
+    const float worldAngle = emitterAngle_;
+
+    float* data = particleData_.Buffer() + numParticles_++;
+    const unsigned stride = particleCapacity_;
+    auto write = [data, stride](ParticleStream2D stream, float value) { data[stream * stride] = value; };
+
+    write(PS_TIME_TO_LIVE, lifespan);
+
+    write(PS_POSITION_X, emitterPosition_.x_ + worldScale * effect_->GetSourcePositionVariance().x_ * RandomUnit());
+    write(PS_POSITION_Y, emitterPosition_.y_ + worldScale * effect_->GetSourcePositionVariance().y_ * RandomUnit());
+    write(PS_POSITION_Z, emitterPosition_.z_);
+    write(PS_START_X, emitterPosition_.x_);
+    write(PS_START_Y, emitterPosition_.y_);
+
+    float angle = worldAngle + effect_->GetAngle() + effect_->GetAngleVariance() * RandomUnit();
+    float speed = worldScale * (effect_->GetSpeed() + effect_->GetSpeedVariance() * RandomUnit());
+    write(PS_VELOCITY_X, speed * Cos(angle));
+    write(PS_VELOCITY_Y, speed * Sin(angle));
+
+    float maxRadius = Max(0.0f, worldScale * (effect_->GetMaxRadius() + effect_->GetMaxRadiusVariance() * RandomUnit()));
+    float minRadius = Max(0.0f, worldScale * (effect_->GetMinRadius() + effect_->GetMinRadiusVariance() * RandomUnit()));
+    write(PS_EMIT_RADIUS, maxRadius);
+    write(PS_EMIT_RADIUS_DELTA, (minRadius - maxRadius) * invLifespan);
+    write(PS_EMIT_ROTATION, worldAngle + effect_->GetAngle() + effect_->GetAngleVariance() * RandomUnit());
+    write(PS_EMIT_ROTATION_DELTA, effect_->GetRotatePerSecond() + effect_->GetRotatePerSecondVariance() * RandomUnit());
+    write(PS_RADIAL_ACCELERATION,
+        worldScale * (effect_->GetRadialAcceleration() + effect_->GetRadialAccelVariance() * RandomUnit()));
+    write(PS_TANGENTIAL_ACCELERATION,
+        worldScale * (effect_->GetTangentialAcceleration() + effect_->GetTangentialAccelVariance() * RandomUnit()));
 
     float startSize =
-        worldScale * Max(0.1f, effect_->GetStartParticleSize() + effect_->GetStartParticleSizeVariance() * Random(-1.0f, 1.0f));
+        worldScale * Max(0.1f, effect_->GetStartParticleSize() + effect_->GetStartParticleSizeVariance() * RandomUnit());
     float finishSize =
-        worldScale * Max(0.1f, effect_->GetFinishParticleSize() + effect_->GetFinishParticleSizeVariance() * Random(-1.0f, 1.0f));
-    particle.size_ = startSize;
-    particle.sizeDelta_ = (finishSize - startSize) * invLifespan;
-
-    particle.color_ = effect_->GetStartColor() + effect_->GetStartColorVariance() * Random(-1.0f, 1.0f);
-    Color endColor = effect_->GetFinishColor() + effect_->GetFinishColorVariance() * Random(-1.0f, 1.0f);
-    particle.colorDelta_ = (endColor - particle.color_) * invLifespan;
-
-    particle.rotation_ = worldAngle + effect_->GetRotationStart() + effect_->GetRotationStartVariance() * Random(-1.0f, 1.0f);
-    float endRotation = worldAngle + effect_->GetRotationEnd() + effect_->GetRotationEndVariance() * Random(-1.0f, 1.0f);
-    particle.rotationDelta_ = (endRotation - particle.rotation_) * invLifespan;
+        worldScale * Max(0.1f, effect_->GetFinishParticleSize() + effect_->GetFinishParticleSizeVariance() * RandomUnit());
+    write(PS_SIZE, startSize);
+    write(PS_SIZE_DELTA, (finishSize - startSize) * invLifespan);
+
+    Color startColor = effect_->GetStartColor() + effect_->GetStartColorVariance() * RandomUnit();
+    Color endColor = effect_->GetFinishColor() + effect_->GetFinishColorVariance() * RandomUnit();
+    Color colorDelta = (endColor - startColor) * invLifespan;
+    write(PS_COLOR_R, startColor.r_);
+    write(PS_COLOR_G, startColor.g_);
+    write(PS_COLOR_B, startColor.b_);
+    write(PS_COLOR_A, startColor.a_);
+    write(PS_COLOR_DELTA_R, colorDelta.r_);
+    write(PS_COLOR_DELTA_G, colorDelta.g_);
+    write(PS_COLOR_DELTA_B, colorDelta.b_);
+    write(PS_COLOR_DELTA_A, colorDelta.a_);
+
+    float startRotation = worldAngle + effect_->GetRotationStart() + effect_->GetRotationStartVariance() * RandomUnit();
+    float endRotation = worldAngle + effect_->GetRotationEnd() + effect_->GetRotationEndVariance() * RandomUnit();
+    write(PS_ROTATION, startRotation);
+    write(PS_ROTATION_DELTA, (endRotation - startRotation) * invLifespan);
 
     return true;
 }
 
-void ParticleEmitter2D::UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale)
+void ParticleEmitter2D::UpdateParticles(unsigned begin, unsigned end, float timeStep)
 {
-    if (timeStep > particle.timeToLive_)
-        timeStep = particle.timeToLive_;
-
-    particle.timeToLive_ -= timeStep;
-
+    float* data = particleData_.Buffer();
+    const unsigned stride = particleCapacity_;
+    const float gravityX = effect_->GetGravity().x_ * emitterScale_;
+    const float gravityY = effect_->GetGravity().y_ * emitterScale_;
+
+    // Whole groups of four with SIMD, then the remainder one by one. The emitter type branch is hoisted out of the loops
+    ParticleBounds2D<Float4> bounds4(boundingBoxMinPoint_, boundingBoxMaxPoint_);
+    ParticleBounds2D<Float1> bounds1(boundingBoxMinPoint_, boundingBoxMaxPoint_);
     if (effect_->GetEmitterType() == EMITTER_TYPE_RADIAL)
     {
-        particle.emitRotation_ += particle.emitRotationDelta_ * timeStep;
-        particle.emitRadius_ += particle.emitRadiusDelta_ * timeStep;
-
-        particle.position_.x_ = particle.startPos_.x_ - Cos(particle.emitRotation_) * particle.emitRadius_;
-        particle.position_.y_ = particle.startPos_.y_ + Sin(particle.emitRotation_) * particle.emitRadius_;
+        unsigned i = UpdateParticleKernel<Float4, true>(data, stride, begin, end, timeStep, gravityX, gravityY, bounds4);
+        UpdateParticleKernel<Float1, true>(data, stride, i, end, timeStep, gravityX, gravityY, bounds1);
     }
     else
     {
-        float distanceX = particle.position_.x_ - particle.startPos_.x_;
-        float distanceY = particle.position_.y_ - particle.startPos_.y_;
-
-        float distanceScalar = Vector2(distanceX, distanceY).Length();
-        if (distanceScalar < 0.0001f)
-            distanceScalar = 0.0001f;
+        unsigned i = UpdateParticleKernel<Float4, false>(data, stride, begin, end, timeStep, gravityX, gravityY, bounds4);
+        UpdateParticleKernel<Float1, false>(data, stride, i, end, timeStep, gravityX, gravityY, bounds1);
+    }
 
-        float radialX = distanceX / distanceScalar;
-        float radialY = distanceY / distanceScalar;
+    bounds4.Reduce(boundingBoxMinPoint_, boundingBoxMaxPoint_);
+    bounds1.Reduce(boundingBoxMinPoint_, boundingBoxMaxPoint_);
+}
 
-        float tangentialX = radialX;
-        float tangentialY = radialY;
+float ParticleEmitter2D::RandomUnit()
+{
+    // Xorshift32
+    u32 x = randomSeed_;
+    x ^= x << 13u;
+    x ^= x >> 17u;
+    x ^= x << 5u;
+    randomSeed_ = x;
+    return (float)(x >> 8u) * (2.0f / 16777216.0f) - 1.0f;
+}
 
-        radialX *= particle.radialAcceleration_;
-        radialY *= particle.radialAcceleration_;
+void Particles2DPayload::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace ParticlesEnd;
 
-        float newY = tangentialX;
-        tangentialX = -tangentialY * particle.tangentialAcceleration_;
-        tangentialY = newY * particle.tangentialAcceleration_;
+    eventData[P_NODE] = node_;
+    eventData[P_EFFECT] = effect_;
+}
 
-        particle.velocity_.x_ += (effect_->GetGravity().x_ * worldScale + radialX - tangentialX) * timeStep;
-        particle.velocity_.y_ -= (effect_->GetGravity().y_ * worldScale - radialY + tangentialY) * timeStep;
-        particle.position_.x_ += particle.velocity_.x_ * timeStep;
-        particle.position_.y_ += particle.velocity_.y_ * timeStep;
-    }
+void Particles2DPayload::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace ParticlesEnd;
 
-    particle.size_ += particle.sizeDelta_ * timeStep;
-    particle.rotation_ += particle.rotationDelta_ * timeStep;
-    particle.color_ += particle.colorDelta_ * timeStep;
-
-    float halfSize = particle.size_ * 0.5f;
-    boundingBoxMinPoint_.x_ = Min(boundingBoxMinPoint_.x_, particle.position_.x_ - halfSize);
-    boundingBoxMinPoint_.y_ = Min(boundingBoxMinPoint_.y_, particle.position_.y_ - halfSize);
-    boundingBoxMinPoint_.z_ = Min(boundingBoxMinPoint_.z_, particle.position_.z_);
-    boundingBoxMaxPoint_.x_ = Max(boundingBoxMaxPoint_.x_, particle.position_.x_ + halfSize);
-    boundingBoxMaxPoint_.y_ = Max(boundingBoxMaxPoint_.y_, particle.position_.y_ + halfSize);
-    boundingBoxMaxPoint_.z_ = Max(boundingBoxMaxPoint_.z_, particle.position_.z_);
+    auto i = eventData.find(P_NODE);
+    node_ = i != eventData.end() ? static_cast<Node*>(i->second.GetPtr()) : nullptr;
+    i = eventData.find(P_EFFECT);
+    effect_ = i != eventData.end() ? static_cast<ParticleEffect2D*>(i->second.GetPtr()) : nullptr;
 }
 
 }
@@ -11,46 +11,38 @@ namespace Urho3D
 class ParticleEffect2D;
 class Sprite2D;
 
-/// 2D particle.
-struct Particle2D
+/// Particle data streams of ParticleEmitter2D, stored as a structure of arrays.
+enum ParticleStream2D
 {
-    /// Time to live.
-    float timeToLive_;
-
-    /// Position.
-    Vector3 position_;
-    /// Size.
-    float size_;
-    /// Size delta.
-    float sizeDelta_;
-    /// Rotation.
-    float rotation_;
-    /// Rotation delta.
-    float rotationDelta_;
-    /// Color.
-    Color color_;
-    /// Color delta.
-    Color colorDelta_;
-
+    PS_TIME_TO_LIVE = 0,
+    PS_POSITION_X,
+    PS_POSITION_Y,
+    PS_POSITION_Z,
+    PS_SIZE,
+    PS_SIZE_DELTA,
+    PS_ROTATION,
+    PS_ROTATION_DELTA,
+    PS_COLOR_R,
+    PS_COLOR_G,
+    PS_COLOR_B,
+    PS_COLOR_A,
+    PS_COLOR_DELTA_R,
+    PS_COLOR_DELTA_G,
+    PS_COLOR_DELTA_B,
+    PS_COLOR_DELTA_A,
     // EMITTER_TYPE_GRAVITY parameters
-    /// Start position.
-    Vector2 startPos_;
-    /// Velocity.
-    Vector2 velocity_;
-    /// Radial acceleration.
-    float radialAcceleration_;
-    /// Tangential acceleration.
-    float tangentialAcceleration_;
-
+    PS_START_X,
+    PS_START_Y,
+    PS_VELOCITY_X,
+    PS_VELOCITY_Y,
+    PS_RADIAL_ACCELERATION,
+    PS_TANGENTIAL_ACCELERATION,
     // EMITTER_TYPE_RADIAL parameters
-    /// Emit radius.
-    float emitRadius_;
-    /// Emit radius delta.
-    float emitRadiusDelta_;
-    /// Emit rotation.
-    float emitRotation_;
-    /// Emit rotation delta.
-    float emitRotationDelta_;
+    PS_EMIT_RADIUS,
+    PS_EMIT_RADIUS_DELTA,
+    PS_EMIT_ROTATION,
+    PS_EMIT_ROTATION_DELTA,
+    MAX_PARTICLE_STREAMS_2D
 };
 
 /// 2D particle emitter component.
@@ -97,7 +89,7 @@ public:
     BlendMode GetBlendMode() const { return blendMode_; }
 
     /// Return max particles.
-    unsigned GetMaxParticles() const { return particles_.Size(); }
+    unsigned GetMaxParticles() const { return particleCapacity_; }
 
     /// Set particle model attr.
     void SetParticleEffectAttr(const ResourceRef& value);
@@ -111,6 +103,13 @@ public:
     /// @property
     bool IsEmitting() const { return emitting_; }
 
+    /// Cache the node transform and emission state for the next particle update. Called from the main thread.
+    void PrepareUpdate();
+    /// Simulate particles with the prepared node transform. May be called from a worker thread.
+    void Update(float timeStep);
+    /// Mark dirty and send particle events after a particle update. Called from the main thread.
+    void FinishUpdate();
+
 private:
     /// Handle scene being assigned.
     void OnSceneSet(Scene* scene) override;
@@ -124,12 +123,14 @@ private:
     void UpdateMaterial();
     /// Handle scene post update.
     void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
-    /// Update.
-    void Update(float timeStep);
     /// Emit particle.
-    bool EmitParticle(const Vector3& worldPosition, float worldAngle, float worldScale);
-    /// Update particle.
-    void UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale);
+    bool EmitParticle();
+    /// Update a range of particles and merge them to the bounding box.
+    void UpdateParticles(unsigned begin, unsigned end, float timeStep);
+    /// Return next value of the emitter's random generator in range -1...1. Emitters may update in parallel, so the global Random() is not used.
+    float RandomUnit();
+    /// Return a particle data stream.
+    float* GetStream(ParticleStream2D stream) { return particleData_.Buffer() + stream * particleCapacity_; }
 
     /// Particle effect.
     SharedPtr<ParticleEffect2D> effect_;
@@ -145,8 +146,22 @@ private:
     float emitParticleTime_;
     /// Currently emitting flag.
     bool emitting_;
-    /// Particles.
-    Vector<Particle2D> particles_;
+    /// Particle data, MAX_PARTICLE_STREAMS_2D streams of particleCapacity_ floats.
+    Vector<float> particleData_;
+    /// Particle capacity.
+    unsigned particleCapacity_;
+    /// Random generator state.
+    u32 randomSeed_;
+    /// Node world position cached for the update.
+    Vector3 emitterPosition_;
+    /// Node world roll angle cached for the update.
+    float emitterAngle_;
+    /// Node world scale cached for the update.
+    float emitterScale_;
+    /// Whether had particles before the update.
+    bool hadParticles_;
+    /// Whether was emitting before the update.
+    bool wasEmitting_;
     /// Bounding box min point.
     Vector3 boundingBoxMinPoint_;
     /// Bounding box max point.
@@ -5,6 +5,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
 #include "../Core/WorkQueue.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/Geometry.h"
@@ -21,9 +22,12 @@
 #include "../IO/Log.h"
 #include "../Scene/Node.h"
 #include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+#include "../Urho2D/AnimatedSprite2D.h"
 #include "../Urho2D/Drawable2D.h"
 #include "../Urho2D/Renderer2D.h"
 #include "../Urho2D/Light2D.h"
+#include "../Urho2D/ParticleEmitter2D.h"
 
 #include "../DebugNew.h"
 
@@ -34,6 +38,77 @@ extern const char* blendModeNames[];
 
 static const VertexElements MASK_VERTEX2D = VertexElements::Position | VertexElements::Color | VertexElements::TexCoord1;
 
+const char* light2DModeNames[] =
+{
+    "None",
+    "Shader",
+    "Vertex",
+    nullptr
+};
+
+/// Point light parameters resolved once per frame for the per-vertex CPU path.
+struct VertexLight2D
+{
+    /// World position.
+    Vector2 position_;
+    /// Reciprocal of radius.
+    float invRadius_;
+    /// Color premultiplied by intensity.
+    Vector3 color_;
+};
+
+static void CollectVertexLights(const Vector<Light2D*>& frameLights, Vector<VertexLight2D>& lights, Vector3& directionalAdd)
+{
+    lights.Reserve(frameLights.Size());
+    for (Light2D* light : frameLights)
+    {
+        if (!light)
+            continue;
+
+        const Color& c = light->GetColor();
+        const Vector3 color(c.r_, c.g_, c.b_);
+        if (light->GetLightType() == Light2D::POINT)
+        {
+            VertexLight2D vl;
+            const Vector3 lp = light->GetNode()->GetWorldPosition();
+            vl.position_ = Vector2(lp.x_, lp.y_);
+            vl.invRadius_ = 1.0f / Max(light->GetRadius(), 0.0001f);
+            vl.color_ = color * light->GetIntensity();
+            lights.Push(vl);
+        }
+        else
+            directionalAdd += color * (0.1f * light->GetIntensity());
+    }
+}
+
+static void ApplyVertexLighting(Vertex2D* vertices, unsigned count, const Vector<VertexLight2D>& lights, const Vector3& directionalAdd)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        Vertex2D& v = vertices[i];
+        Vector3 add = directionalAdd;
+        for (const VertexLight2D& l : lights)
+        {
+            const float dx = v.position_.x_ - l.position_.x_;
+            const float dy = v.position_.y_ - l.position_.y_;
+            const float att = 1.0f - Sqrt(dx * dx + dy * dy) * l.invRadius_;
+            if (att > 0.0f)
+                add += l.color_ * att;
+        }
+        add = Vector3(Clamp(add.x_, 0.0f, 1.0f), Clamp(add.y_, 0.0f, 1.0f), Clamp(add.z_, 0.0f, 1.0f));
+
+        // 与 Urho2D_Lit2D 着色器一致：rgb + add * (1 - rgb)
+        const u32 c = v.color_;
+        const float r = (float)(c & 0xFFu) / 255.0f;
+        const float g = (float)((c >> 8u) & 0xFFu) / 255.0f;
+        const float b = (float)((c >> 16u) & 0xFFu) / 255.0f;
+        const u32 lr = (u32)Clamp((int)((r + add.x_ * (1.0f - r)) * 255.0f), 0, 255);
+        const u32 lg = (u32)Clamp((int)((g + add.y_ * (1.0f - g)) * 255.0f), 0, 255);
+        const u32 lb = (u32)Clamp((int)((b + add.z_ * (1.0f - b)) * 255.0f), 0, 255);
+        v.color_ = (c & 0xFF000000u) | (lb << 16u) | (lg << 8u) | lr;
+    }
+}
+
 ViewBatchInfo2D::ViewBatchInfo2D() :
     vertexBufferUpdateFrameNumber_(0),
     indexCount_(0),
@@ -45,9 +120,18 @@ ViewBatchInfo2D::ViewBatchInfo2D() :
 
 Renderer2D::Renderer2D(Context* context) :
     Drawable(context, DrawableTypes::Geometry),
-    material_(new Material(context)),
     indexBuffer_(new IndexBuffer(context_)),
-    viewMask_(DEFAULT_VIEWMASK)
+    material_(new Material(context)),
+    viewMask_(DEFAULT_VIEWMASK),
+    lightMode_(LIGHT2D_SHADER),
+    vertexPool_(0xFFFF),
+    vertexPoolCapacity_(0),
+    vertexPoolSize_(0),
+    vertexPoolUnsupported_(false),
+    particleTimeStep_(0.0f),
+    parallelParticleUpdate_(false),
+    animationTimeStep_(0.0f),
+    parallelAnimationUpdate_(false)
 {
     material_->SetName("Urho2D");
 
@@ -67,11 +151,19 @@ Renderer2D::Renderer2D(Context* context) :
     SubscribeToEvent(E_BEGINVIEWUPDATE, URHO3D_HANDLER(Renderer2D, HandleBeginViewUpdate));
 }
 
-Renderer2D::~Renderer2D() = default;
+Renderer2D::~Renderer2D()
+{
+    ResetVertexPool();
+}
 
 void Renderer2D::RegisterObject(Context* context)
 {
     context->RegisterFactory<Renderer2D>();
+
+    URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Light Mode", GetLightMode, SetLightMode, light2DModeNames, LIGHT2D_SHADER, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Parallel Particle Update", GetParallelParticleUpdate, SetParallelParticleUpdate, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Parallel Animation Update", GetParallelAnimationUpdate, SetParallelAnimationUpdate, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Spatial Cell Size", GetSpatialCellSize, SetSpatialCellSize, DEFAULT_SPATIAL_CELL_SIZE_2D, AM_DEFAULT);
 }
 
 static inline bool CompareRayQueryResults(const RayQueryResult& lr, const RayQueryResult& rr)
@@ -87,13 +179,30 @@ static inline bool CompareRayQueryResults(const RayQueryResult& lr, const RayQue
     return lhs->GetID() > rhs->GetID();
 }
 
+static inline bool CompareDrawable2Ds(const Drawable2D* lhs, const Drawable2D* rhs)
+{
+    if (lhs->GetLayer() != rhs->GetLayer())
+        return lhs->GetLayer() > rhs->GetLayer();
+
+    if (lhs->GetOrderInLayer() != rhs->GetOrderInLayer())
+        return lhs->GetOrderInLayer() > rhs->GetOrderInLayer();
+
+    return lhs->GetID() > rhs->GetID();
+}
+
 void Renderer2D::ProcessRayQuery(const RayOctreeQuery& query, Vector<RayQueryResult>& results)
 {
+    // 空间索引只能在主线程更新；工作线程中的查询使用上次更新后的索引
+    Vector<Drawable2D*> candidates;
+    if (Thread::IsMainThread())
+        UpdateSpatialIndex();
+    spatialGrid_.GetDrawables(candidates, query.ray_, query.maxDistance_);
+
     unsigned resultSize = results.Size();
-    for (unsigned i = 0; i < static_cast<unsigned>(drawables_.Size()); ++i)
-        {
-        if (drawables_[i]->GetViewMask() & query.viewMask_)
-            drawables_[i]->ProcessRayQuery(query, results);
+    for (Drawable2D* drawable : candidates)
+    {
+        if (drawable->GetViewMask() & query.viewMask_)
+            drawable->ProcessRayQuery(query, results);
     }
 
     if (results.Size() != resultSize)
@@ -183,6 +292,13 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
 
         if (vertexCount)
         {
+            // 旧管线没有 lit 着色器，除 LIGHT2D_NONE 外都在 CPU 上逐顶点调制；灯光参数每帧只解析一次
+            const bool vertexLighting = lightMode_ != LIGHT2D_NONE && !frameLights_.Empty();
+            Vector<VertexLight2D> lights;
+            Vector3 directionalAdd(Vector3::ZERO);
+            if (vertexLighting)
+                CollectVertexLights(frameLights_, lights, directionalAdd);
+
             auto* dest = reinterpret_cast<Vertex2D*>(vertexBuffer->Lock(0, vertexCount, true));
             if (dest)
             {
@@ -196,60 +312,9 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
                         // 2.5D: y→z 映射，利用深度测试实现层级遮挡
                         // 经验系数：0.001f，可按项目世界坐标范围调节
                         dest[i].position_.z_ = -dest[i].position_.y_ * 0.001f;
-
-                        // Light2D 顶点色调制（简版）
-                        if (!frameLights_.Empty())
-                        {
-                            auto decode = [](u32 c){
-                                float r = (float)(c & 0xFF) / 255.f;
-                                float g = (float)((c >> 8) & 0xFF) / 255.f;
-                                float b = (float)((c >> 16) & 0xFF) / 255.f;
-                                float a = (float)((c >> 24) & 0xFF) / 255.f;
-                                return Color(r,g,b,a);
-                            };
-                            auto encode = [](const Color& col){
-                                u32 r = (u32)Clamp((int)(col.r_ * 255.f), 0, 255);
-                                u32 g = (u32)Clamp((int)(col.g_ * 255.f), 0, 255);
-                                u32 b = (u32)Clamp((int)(col.b_ * 255.f), 0, 255);
-                                u32 a = (u32)Clamp((int)(col.a_ * 255.f), 0, 255);
-                                return (a<<24) | (b<<16) | (g<<8) | r;
-                            };
-
-                            Color base = decode(dest[i].color_);
-                            Vector3 rgb(base.r_, base.g_, base.b_);
-                            Vector3 add(0,0,0);
-
-                            Vector3 wp = dest[i].position_;
-                            for (Light2D* l : frameLights_)
-                            {
-                                if (!l) continue;
-                                if (l->GetLightType() == Light2D::POINT)
-                                {
-                                    Vector3 lp = l->GetNode()->GetWorldPosition();
-                                    float dx = wp.x_ - lp.x_;
-                                    float dy = wp.y_ - lp.y_;
-                                    float dist = Sqrt(dx*dx + dy*dy);
-                                    float r = Max(l->GetRadius(), 0.0001f);
-                                    float att = 1.0f - (dist / r);
-                                    if (att > 0.f)
-                                    {
-                                        float k = l->GetIntensity() * att;
-                                        add += Vector3(l->GetColor().r_, l->GetColor().g_, l->GetColor().b_) * k;
-                                    }
-                                }
-                                else
-                                {
-                                    add += Vector3(l->GetColor().r_, l->GetColor().g_, l->GetColor().b_) * (0.1f * l->GetIntensity());
-                                }
-                            }
-                            add = Vector3(Clamp(add.x_, 0.f, 1.f), Clamp(add.y_, 0.f, 1.f), Clamp(add.z_, 0.f, 1.f));
-                            rgb = rgb + add * (Vector3::ONE - rgb);
-                            base.r_ = Clamp(rgb.x_, 0.f, 1.f);
-                            base.g_ = Clamp(rgb.y_, 0.f, 1.f);
-                            base.b_ = Clamp(rgb.z_, 0.f, 1.f);
-                            dest[i].color_ = encode(base);
-                        }
                     }
+                    if (vertexLighting)
+                        ApplyVertexLighting(dest, vertices.Size(), lights, directionalAdd);
                     dest += vertices.Size();
                 }
 
@@ -265,6 +330,11 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
 
 UpdateGeometryType Renderer2D::GetUpdateGeometryType()
 {
+    // BGFX 下 2D 批次已在 HandleBeginViewUpdate 中直接提交，旧管线的顶点/索引缓冲无需再填充
+    auto* graphics = GetSubsystem<Graphics>();
+    if (graphics && graphics->IsBgfxActive())
+        return UPDATE_NONE;
+
     return UPDATE_MAIN_THREAD;
 }
 
@@ -273,7 +343,14 @@ void Renderer2D::AddDrawable(Drawable2D* drawable)
     if (!drawable)
         return;
 
+    // The drawable may have held a range in the pool of a previous renderer
+    drawable->poolCapacity_ = 0;
+    drawable->poolVersion_ = 0;
     drawables_.Push(drawable);
+
+    // 插入空间索引需要最新的包围盒，推迟到下次视图更新或查询时进行
+    drawable->spatialUpdateQueued_ = false;
+    QueueSpatialUpdate(drawable);
 }
 
 void Renderer2D::RemoveDrawable(Drawable2D* drawable)
@@ -281,7 +358,52 @@ void Renderer2D::RemoveDrawable(Drawable2D* drawable)
     if (!drawable)
         return;
 
+    ReleaseVertexRange(drawable);
     drawables_.Remove(drawable);
+    spatialGrid_.Remove(drawable);
+
+    if (drawable->spatialUpdateQueued_)
+    {
+        spatialUpdateQueue_.Remove(drawable);
+        drawable->spatialUpdateQueued_ = false;
+    }
+}
+
+void Renderer2D::QueueSpatialUpdate(Drawable2D* drawable)
+{
+    if (!drawable || drawable->spatialUpdateQueued_)
+        return;
+
+    drawable->spatialUpdateQueued_ = true;
+    spatialUpdateQueue_.Push(drawable);
+}
+
+void Renderer2D::GetDrawables(Vector<Drawable2D*>& result, const Rect& rect, unsigned viewMask)
+{
+    UpdateSpatialIndex();
+
+    queryDrawables_.Clear();
+    spatialGrid_.GetDrawables(queryDrawables_, rect);
+    for (Drawable2D* drawable : queryDrawables_)
+    {
+        if (drawable->GetViewMask() & viewMask)
+            result.Push(drawable);
+    }
+}
+
+void Renderer2D::GetDrawables(Vector<Drawable2D*>& result, const Vector2& point, unsigned viewMask)
+{
+    i32 resultSize = result.Size();
+    GetDrawables(result, Rect(point, point), viewMask);
+
+    if (result.Size() != resultSize)
+        Sort(result.Begin() + resultSize, result.End(), CompareDrawable2Ds);
+}
+
+void Renderer2D::SetSpatialCellSize(float size)
+{
+    UpdateSpatialIndex();
+    spatialGrid_.SetCellSize(size);
 }
 
 Material* Renderer2D::GetMaterial(Texture2D* texture, BlendMode blendMode)
@@ -308,6 +430,87 @@ Material* Renderer2D::GetMaterial(Texture2D* texture, BlendMode blendMode)
     return newMaterial;
 }
 
+void Renderer2D::SetLightMode(Light2DMode mode)
+{
+    // BGFX 路径直接提交源批次，没有逐顶点 CPU 光照
+    auto* graphics = GetSubsystem<Graphics>();
+    if (mode == LIGHT2D_VERTEX && graphics && graphics->IsBgfxActive())
+    {
+        URHO3D_LOGWARNING("Vertex 2D lighting is not supported with BGFX, falling back to shader lighting");
+        mode = LIGHT2D_SHADER;
+    }
+
+    lightMode_ = mode;
+}
+
+void Renderer2D::AddLight(Light2D* light)
+{
+    if (!light || lights_.Contains(light))
+        return;
+
+    lights_.Push(light);
+}
+
+void Renderer2D::RemoveLight(Light2D* light)
+{
+    if (!light)
+        return;
+
+    lights_.Remove(light);
+}
+
+void Renderer2D::AddParticleEmitter(ParticleEmitter2D* emitter)
+{
+    if (!emitter || particleEmitters_.Contains(emitter))
+        return;
+
+    particleEmitters_.Push(emitter);
+}
+
+void Renderer2D::RemoveParticleEmitter(ParticleEmitter2D* emitter)
+{
+    if (!emitter)
+        return;
+
+    particleEmitters_.Remove(emitter);
+}
+
+void Renderer2D::AddAnimatedSprite(AnimatedSprite2D* animatedSprite)
+{
+    if (!animatedSprite || animatedSprites_.Contains(animatedSprite))
+        return;
+
+    animatedSprites_.Push(animatedSprite);
+}
+
+void Renderer2D::RemoveAnimatedSprite(AnimatedSprite2D* animatedSprite)
+{
+    if (!animatedSprite)
+        return;
+
+    animatedSprites_.Remove(animatedSprite);
+}
+
+void Renderer2D::SetParallelParticleUpdate(bool enable)
+{
+    parallelParticleUpdate_ = enable;
+}
+
+void Renderer2D::SetParallelAnimationUpdate(bool enable)
+{
+    parallelAnimationUpdate_ = enable;
+}
+
+void Renderer2D::OnSceneSet(Scene* scene)
+{
+    Drawable::OnSceneSet(scene);
+
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(Renderer2D, HandleScenePostUpdate));
+    else
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
 bool Renderer2D::CheckVisibility(Drawable2D* drawable) const
 {
     if ((viewMask_ & drawable->GetViewMask()) == 0)
@@ -356,11 +559,130 @@ void CheckDrawableVisibilityWork(const WorkItem* item, i32 threadIndex)
     auto** start = reinterpret_cast<Drawable2D**>(item->start_);
     auto** end = reinterpret_cast<Drawable2D**>(item->end_);
 
+    // 视锥测试已由空间索引完成，这里只检查视图掩码
     while (start != end)
     {
         Drawable2D* drawable = *start++;
-        if (renderer->CheckVisibility(drawable))
+        if (renderer->viewMask_ & drawable->GetViewMask())
+        {
             drawable->MarkInView(renderer->frame_);
+            // Rebuild dirty source batches of visible drawables here rather than serially when gathering batches
+            drawable->GetSourceBatches();
+        }
+    }
+}
+
+static void UpdateBoundingBoxesWork(const WorkItem* item, i32 /*threadIndex*/)
+{
+    auto** start = reinterpret_cast<Drawable2D**>(item->start_);
+    auto** end = reinterpret_cast<Drawable2D**>(item->end_);
+
+    while (start != end)
+        (*start++)->GetWorldBoundingBox();
+}
+
+void UpdateParticleEmittersWork(const WorkItem* item, i32 threadIndex)
+{
+    auto* renderer = reinterpret_cast<Renderer2D*>(item->aux_);
+    auto** start = reinterpret_cast<ParticleEmitter2D**>(item->start_);
+    auto** end = reinterpret_cast<ParticleEmitter2D**>(item->end_);
+
+    while (start != end)
+        (*start++)->Update(renderer->particleTimeStep_);
+}
+
+void UpdateAnimatedSpritesWork(const WorkItem* item, i32 threadIndex)
+{
+    auto* renderer = reinterpret_cast<Renderer2D*>(item->aux_);
+    auto** start = reinterpret_cast<AnimatedSprite2D**>(item->start_);
+    auto** end = reinterpret_cast<AnimatedSprite2D**>(item->end_);
+
+    while (start != end)
+        (*start++)->AdvanceAnimation(renderer->animationTimeStep_);
+}
+
+void Renderer2D::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ScenePostUpdate;
+    float timeStep = eventData[P_TIMESTEP].GetFloat();
+
+    if (!animatedSprites_.Empty())
+        UpdateAnimatedSprites(timeStep);
+    if (parallelParticleUpdate_ && !particleEmitters_.Empty())
+        UpdateParticleEmitters(timeStep);
+}
+
+void Renderer2D::UpdateParticleEmitters(float timeStep)
+{
+    URHO3D_PROFILE(UpdateParticleEmitters2D);
+
+    particleTimeStep_ = timeStep;
+
+    // 节点变换只能在主线程读取，先缓存到发射器
+    updatingEmitters_.Clear();
+    updatingEmitterPtrs_.Clear();
+    for (ParticleEmitter2D* emitter : particleEmitters_)
+    {
+        if (!emitter->IsEnabledEffective())
+            continue;
+
+        emitter->PrepareUpdate();
+        updatingEmitters_.Push(WeakPtr<ParticleEmitter2D>(emitter));
+        updatingEmitterPtrs_.Push(emitter);
+    }
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    queue->ParallelFor(updatingEmitterPtrs_.Buffer(), updatingEmitterPtrs_.Buffer() + updatingEmitterPtrs_.Size(),
+        UpdateParticleEmittersWork, this, 1);
+
+    // 事件处理可能删除发射器，用弱引用检查
+    for (const WeakPtr<ParticleEmitter2D>& emitter : updatingEmitters_)
+    {
+        if (!emitter.Expired())
+            emitter->FinishUpdate();
+    }
+}
+
+void Renderer2D::UpdateAnimatedSprites(float timeStep)
+{
+    URHO3D_PROFILE(UpdateAnimatedSprites2D);
+
+    animationTimeStep_ = timeStep;
+
+    updatingAnimatedSprites_.Clear();
+    updatingAnimatedSpritePtrs_.Clear();
+    for (AnimatedSprite2D* animatedSprite : animatedSprites_)
+    {
+        if (!animatedSprite->IsEnabledEffective())
+            continue;
+
+        updatingAnimatedSprites_.Push(WeakPtr<AnimatedSprite2D>(animatedSprite));
+        updatingAnimatedSpritePtrs_.Push(animatedSprite);
+    }
+
+    // 串行更新时逐个发送事件，事件处理可能删除后面的动画精灵，同样用弱引用检查
+    if (!parallelAnimationUpdate_)
+    {
+        for (const WeakPtr<AnimatedSprite2D>& animatedSprite : updatingAnimatedSprites_)
+        {
+            if (!animatedSprite.Expired())
+            {
+                animatedSprite->AdvanceAnimation(timeStep);
+                animatedSprite->FinishAnimationUpdate();
+            }
+        }
+        return;
+    }
+
+    // 工作线程只推进骨骼姿态，标记脏与 AnimationFinished 事件延迟到主线程统一处理
+    auto* queue = GetSubsystem<WorkQueue>();
+    queue->ParallelFor(updatingAnimatedSpritePtrs_.Buffer(),
+        updatingAnimatedSpritePtrs_.Buffer() + updatingAnimatedSpritePtrs_.Size(), UpdateAnimatedSpritesWork, this, 1);
+
+    for (const WeakPtr<AnimatedSprite2D>& animatedSprite : updatingAnimatedSprites_)
+    {
+        if (!animatedSprite.Expired())
+            animatedSprite->FinishAnimationUpdate();
     }
 }
 
@@ -380,30 +702,12 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
     frustum_ = camera->GetFrustum();
     viewMask_ = camera->GetViewMask();
 
-    // 收集本帧 2D 光源（非持有，仅遍历）
-    frameLights_.Clear();
-    if (Scene* scene = GetScene())
-    {
-        Vector<Node*> stack;
-        stack.Push(scene);
-        while (!stack.Empty())
-        {
-            Node* n = stack.Back();
-            stack.Pop();
-            const Vector<SharedPtr<Component>>& comps = n->GetComponents();
-            for (const SharedPtr<Component>& c : comps)
-            {
-                if (auto* l = dynamic_cast<Light2D*>(c.Get()))
-                    if (l->IsEnabledEffective())
-                        frameLights_.Push(l);
-            }
-            const Vector<SharedPtr<Node>>& children = n->GetChildren();
-            for (const SharedPtr<Node>& ch : children)
-                stack.Push(ch.Get());
-        }
-    }
+    // 从注册表中筛选本帧可见的 2D 光源，按相关度排序
+    UpdateFrameLights(camera);
 
-    // BGFX 后端：将本帧 2D 光源写入 uniforms（便于 lit 技术使用）
+    // BGFX 后端：将本帧 2D 光源写入 uniforms，由 Urho2D_Lit2D 程序逐像素计算。
+    // LIGHT2D_VERTEX 在 BGFX 下已由 SetLightMode() 回落为 LIGHT2D_SHADER；
+    // LIGHT2D_NONE 时 frameLights_ 为空，灯光数置 0 使 DrawQuads 回落到 unlit 程序。
     if (auto* graphics = GetSubsystem<Graphics>())
     {
         if (graphics->IsBgfxActive())
@@ -429,34 +733,19 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
         }
     }
 
-    // Check visibility
+    // World transforms are resolved lazily, which is not thread-safe. Resolve the dirty ones before the worker threads read them
+    UpdateSpatialIndex();
+
+    // Cull against the spatial index, then rebuild dirty source batches of the visible drawables
     {
         URHO3D_PROFILE(CheckDrawableVisibility);
 
-        auto* queue = GetSubsystem<WorkQueue>();
-        unsigned numWorkItems = (unsigned)queue->GetNumThreads() + 1; // Worker threads + main thread
-        unsigned drawablesPerItem = drawables_.Size() / Max(numWorkItems, 1u);
-
-        Vector<Drawable2D*>::Iterator start = drawables_.Begin();
-        for (unsigned i = 0; i < numWorkItems; ++i)
-        {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = WI_MAX_PRIORITY;
-            item->workFunction_ = CheckDrawableVisibilityWork;
-            item->aux_ = this;
-
-            Vector<Drawable2D*>::Iterator end = drawables_.End();
-            if (i < numWorkItems - 1 && (unsigned)(end - start) > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
+        visibleDrawables_.Clear();
+        spatialGrid_.GetDrawables(visibleDrawables_, frustum_);
 
-            start = end;
-        }
-
-        queue->Complete(WI_MAX_PRIORITY);
+        auto* queue = GetSubsystem<WorkQueue>();
+        queue->ParallelFor(visibleDrawables_.Buffer(), visibleDrawables_.Buffer() + visibleDrawables_.Size(),
+            CheckDrawableVisibilityWork, this, 64);
     }
 
     ViewBatchInfo2D& viewBatchInfo = viewBatchInfos_[camera];
@@ -482,18 +771,44 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
             );
             const Matrix4 mvp = proj * view;
 
-            // 逐批提交（按 material 分组已在 UpdateViewBatchInfo 中完成并排序）
+            // 常驻顶点池：只上传本帧有变化的可见 drawable，未变化的静态精灵不再拷贝顶点
+            const bool usePool = UpdateVertexPool(viewBatchInfo.sourceBatches_);
+
+            // 合并提交：排序后的源批次按顺序引用顶点池（或写入同一个 transient 顶点缓冲），仅在材质（纹理/混合模式）变化处切分 drawcall
+            bgfxQuadBatches_.Clear();
+            Material* currMaterial = nullptr;
+            Texture2D* currTexture = nullptr;
+            BlendMode currBlendMode = BLEND_REPLACE;
             for (const SourceBatch2D* src : viewBatchInfo.sourceBatches_)
             {
                 if (!src || src->vertices_.Empty())
                     continue;
 
-                Texture2D* tex = nullptr;
-                if (src->material_)
-                    tex = static_cast<Texture2D*>(src->material_->GetTexture(TU_DIFFUSE));
+                if (src->material_ != currMaterial)
+                {
+                    currMaterial = src->material_;
+                    currTexture = static_cast<Texture2D*>(currMaterial->GetTexture(TU_DIFFUSE));
+                    Technique* tech = currMaterial->GetTechnique(0);
+                    Pass* pass = tech ? tech->GetPass(Technique::alphaPassIndex) : nullptr;
+                    currBlendMode = pass ? pass->GetBlendMode() : BLEND_REPLACE;
+                }
+
+                BgfxQuadBatch batch;
+                // Vertex2D 布局为: Vector3 position_, u32 color_, Vector2 uv_，与 BGFX 四边形顶点布局一致
+                batch.vertices_ = src->vertices_.Buffer();
+                batch.numVertices_ = src->vertices_.Size();
+                batch.texture_ = currTexture;
+                batch.blendMode_ = currBlendMode;
+                batch.poolStart_ = src->poolStart_;
+                bgfxQuadBatches_.Push(batch);
+            }
 
-                // Vertex2D 布局为: Vector3 position_, u32 color_, Vector2 uv_，与 BgfxDrawQuads 的 QVertex 对齐
-                graphics->BgfxDrawQuads(src->vertices_.Buffer(), src->vertices_.Size(), tex, mvp);
+            if (!bgfxQuadBatches_.Empty())
+            {
+                if (usePool)
+                    graphics->BgfxDrawQuadPoolBatches(vertexPool_, bgfxQuadBatches_.Buffer(), bgfxQuadBatches_.Size(), mvp);
+                else
+                    graphics->BgfxDrawQuadBatches(bgfxQuadBatches_.Buffer(), bgfxQuadBatches_.Size(), mvp);
             }
 
             // 清空批次数，避免旧管线继续绘制
@@ -516,22 +831,74 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
     }
 }
 
-void Renderer2D::GetDrawables(Vector<Drawable2D*>& drawables, Node* node)
+void Renderer2D::UpdateSpatialIndex()
+{
+    if (spatialUpdateQueue_.Empty())
+        return;
+
+    URHO3D_PROFILE(UpdateSpatialIndex2D);
+
+    for (Drawable2D* drawable : spatialUpdateQueue_)
+    {
+        drawable->spatialUpdateQueued_ = false;
+        if (Node* node = drawable->GetNode())
+            node->GetWorldTransform();
+    }
+
+    // 动画精灵的包围盒需要重建源批次，世界变换已解析完毕，可在工作线程中并行计算
+    auto* queue = GetSubsystem<WorkQueue>();
+    queue->ParallelFor(spatialUpdateQueue_.Buffer(), spatialUpdateQueue_.Buffer() + spatialUpdateQueue_.Size(),
+        UpdateBoundingBoxesWork, nullptr, 64);
+
+    for (Drawable2D* drawable : spatialUpdateQueue_)
+        spatialGrid_.Update(drawable);
+    spatialGrid_.UpdateCellBounds();
+
+    spatialUpdateQueue_.Clear();
+}
+
+static inline bool CompareLight2DRelevance(const Pair<float, Light2D*>& lhs, const Pair<float, Light2D*>& rhs)
 {
-    if (!node || !node->IsEnabled())
+    return lhs.first_ > rhs.first_;
+}
+
+void Renderer2D::UpdateFrameLights(Camera* camera)
+{
+    frameLights_.Clear();
+    visibleLights_.Clear();
+    if (lightMode_ == LIGHT2D_NONE || lights_.Empty())
         return;
 
-    const Vector<SharedPtr<Component>>& components = node->GetComponents();
-    for (Vector<SharedPtr<Component>>::ConstIterator i = components.Begin(); i != components.End(); ++i)
+    URHO3D_PROFILE(CullLights2D);
+
+    const Vector3 viewPos = camera->GetNode()->GetWorldPosition();
+    for (Light2D* light : lights_)
     {
-        auto* drawable = dynamic_cast<Drawable2D*>(i->Get());
-        if (drawable && drawable->IsEnabled())
-            drawables.Push(drawable);
+        if (light->GetLightType() == Light2D::POINT)
+        {
+            const Vector3 lightPos = light->GetNode()->GetWorldPosition();
+            const float radius = light->GetRadius();
+            if (radius <= 0.0f || frustum_.IsInsideFast(Sphere(lightPos, radius)) == OUTSIDE)
+                continue;
+
+            // 覆盖视野中心越近、半径越大、强度越高的点光源越优先
+            const float dx = lightPos.x_ - viewPos.x_;
+            const float dy = lightPos.y_ - viewPos.y_;
+            const float distance = Sqrt(dx * dx + dy * dy);
+            visibleLights_.Push(MakePair(light->GetIntensity() * radius / (radius + distance), light));
+        }
+        else
+        {
+            // 方向光影响整个画面，总是优先于点光源
+            visibleLights_.Push(MakePair(M_LARGE_VALUE + light->GetIntensity(), light));
+        }
     }
 
-    const Vector<SharedPtr<Node>>& children = node->GetChildren();
-    for (Vector<SharedPtr<Node>>::ConstIterator i = children.Begin(); i != children.End(); ++i)
-        GetDrawables(drawables, i->Get());
+    Sort(visibleLights_.Begin(), visibleLights_.End(), CompareLight2DRelevance);
+
+    frameLights_.Reserve(visibleLights_.Size());
+    for (const Pair<float, Light2D*>& visible : visibleLights_)
+        frameLights_.Push(visible.second_);
 }
 
 static inline bool CompareSourceBatch2Ds(const SourceBatch2D* lhs, const SourceBatch2D* rhs)
@@ -548,6 +915,193 @@ static inline bool CompareSourceBatch2Ds(const SourceBatch2D* lhs, const SourceB
     return lhs < rhs;
 }
 
+bool Renderer2D::UpdateVertexPool(const Vector<const SourceBatch2D*>& sourceBatches)
+{
+    if (vertexPoolUnsupported_)
+        return false;
+
+    URHO3D_PROFILE(UpdateVertexPool2D);
+
+    // 收集源批次有变化的 drawable，必要时（重新）分配其顶点区间
+    staleDrawables_.Clear();
+    for (const SourceBatch2D* sourceBatch : sourceBatches)
+    {
+        Drawable2D* drawable = sourceBatch->owner_;
+        if (!drawable || drawable->poolVersion_ == drawable->sourceBatchesVersion_)
+            continue;
+
+        unsigned numVertices = 0;
+        for (const SourceBatch2D& batch : drawable->sourceBatches_)
+            numVertices += batch.vertices_.Size();
+
+        if (numVertices > drawable->poolCapacity_)
+        {
+            ReleaseVertexRange(drawable);
+            // 按 2 的幂预留，顶点数小幅波动（粒子、动画）时不必反复迁移
+            drawable->poolCapacity_ = NextPowerOfTwo(numVertices);
+            drawable->poolStart_ = AllocateVertexRange(drawable->poolCapacity_);
+        }
+
+        // 标记为已处理，同一 drawable 的其他源批次不再重复收集
+        drawable->poolVersion_ = drawable->sourceBatchesVersion_;
+        staleDrawables_.Push(drawable);
+    }
+
+    auto* graphics = GetSubsystem<Graphics>();
+    if (vertexPoolSize_ > vertexPoolCapacity_ || vertexPool_ == 0xFFFF)
+    {
+        // 顶点池扩容会丢失原有内容，重新创建后所有已分配区间都需要重传
+        unsigned capacity = Max(vertexPoolCapacity_, 4096u);
+        while (capacity < vertexPoolSize_)
+            capacity <<= 1u;
+
+        if (vertexPool_ != 0xFFFF)
+            graphics->BgfxDestroyQuadVertexPool(vertexPool_);
+        vertexPool_ = graphics->BgfxCreateQuadVertexPool(capacity);
+        if (vertexPool_ == 0xFFFF)
+        {
+            URHO3D_LOGWARNING("Persistent 2D vertex pool is not supported, copying source batches every frame");
+            ResetVertexPool();
+            vertexPoolUnsupported_ = true;
+            return false;
+        }
+        vertexPoolCapacity_ = capacity;
+
+        staleDrawables_.Clear();
+        for (Drawable2D* drawable : drawables_)
+        {
+            if (!drawable->poolCapacity_)
+                continue;
+
+            // 不可见的 drawable 的源批次可能在上次上传后增长，超出其区间；释放区间，等可见时重新分配
+            if (drawable->poolVersion_ != drawable->sourceBatchesVersion_)
+            {
+                ReleaseVertexRange(drawable);
+                continue;
+            }
+
+            staleDrawables_.Push(drawable);
+        }
+    }
+
+    for (Drawable2D* drawable : staleDrawables_)
+        UploadToVertexPool(drawable);
+
+    return true;
+}
+
+void Renderer2D::UploadToVertexPool(Drawable2D* drawable)
+{
+    Vector<SourceBatch2D>& batches = drawable->sourceBatches_;
+    unsigned offset = drawable->poolStart_;
+    for (SourceBatch2D& batch : batches)
+    {
+        batch.poolStart_ = offset;
+        offset += batch.vertices_.Size();
+    }
+
+    const unsigned numVertices = offset - drawable->poolStart_;
+    if (!numVertices)
+        return;
+
+    // 每个 drawable 只提交一次局部更新，多个源批次先拼接
+    const Vertex2D* vertices;
+    if (batches.Size() == 1)
+        vertices = batches[0].vertices_.Buffer();
+    else
+    {
+        poolUploadVertices_.Clear();
+        for (const SourceBatch2D& batch : batches)
+            poolUploadVertices_.Insert(poolUploadVertices_.End(), batch.vertices_.Begin(), batch.vertices_.End());
+        vertices = poolUploadVertices_.Buffer();
+    }
+
+    GetSubsystem<Graphics>()->BgfxUpdateQuadVertexPool(vertexPool_, drawable->poolStart_, vertices, numVertices);
+}
+
+unsigned Renderer2D::AllocateVertexRange(unsigned count)
+{
+    // 首次适配；没有合适的空闲区间时从末尾增长
+    for (i32 i = 0; i < freeVertexRanges_.Size(); ++i)
+    {
+        Pair<unsigned, unsigned>& range = freeVertexRanges_[i];
+        if (range.second_ < count)
+            continue;
+
+        unsigned start = range.first_;
+        range.first_ += count;
+        range.second_ -= count;
+        if (!range.second_)
+            freeVertexRanges_.Erase(i);
+        return start;
+    }
+
+    unsigned start = vertexPoolSize_;
+    vertexPoolSize_ += count;
+    return start;
+}
+
+void Renderer2D::FreeVertexRange(unsigned start, unsigned count)
+{
+    // 按起点有序插入，并与相邻空闲区间合并
+    i32 i = 0;
+    while (i < freeVertexRanges_.Size() && freeVertexRanges_[i].first_ < start)
+        ++i;
+
+    if (i > 0 && freeVertexRanges_[i - 1].first_ + freeVertexRanges_[i - 1].second_ == start)
+    {
+        --i;
+        freeVertexRanges_[i].second_ += count;
+    }
+    else
+        freeVertexRanges_.Insert(i, MakePair(start, count));
+
+    if (i + 1 < freeVertexRanges_.Size() && freeVertexRanges_[i].first_ + freeVertexRanges_[i].second_ == freeVertexRanges_[i + 1].first_)
+    {
+        freeVertexRanges_[i].second_ += freeVertexRanges_[i + 1].second_;
+        freeVertexRanges_.Erase(i + 1);
+    }
+
+    // 末尾的空闲区间直接归还
+    const Pair<unsigned, unsigned>& last = freeVertexRanges_.Back();
+    if (last.first_ + last.second_ == vertexPoolSize_)
+    {
+        vertexPoolSize_ = last.first_;
+        freeVertexRanges_.Pop();
+    }
+}
+
+void Renderer2D::ReleaseVertexRange(Drawable2D* drawable)
+{
+    if (drawable->poolCapacity_)
+        FreeVertexRange(drawable->poolStart_, drawable->poolCapacity_);
+
+    drawable->poolStart_ = 0;
+    drawable->poolCapacity_ = 0;
+    drawable->poolVersion_ = 0;
+}
+
+void Renderer2D::ResetVertexPool()
+{
+    if (vertexPool_ != 0xFFFF)
+    {
+        if (auto* graphics = GetSubsystem<Graphics>())
+            graphics->BgfxDestroyQuadVertexPool(vertexPool_);
+        vertexPool_ = 0xFFFF;
+    }
+
+    for (Drawable2D* drawable : drawables_)
+    {
+        drawable->poolStart_ = 0;
+        drawable->poolCapacity_ = 0;
+        drawable->poolVersion_ = 0;
+    }
+
+    freeVertexRanges_.Clear();
+    vertexPoolCapacity_ = 0;
+    vertexPoolSize_ = 0;
+}
+
 void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* camera)
 {
     // Already update in same frame
@@ -556,12 +1110,12 @@ void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* cam
 
     Vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
     sourceBatches.Clear();
-    for (unsigned d = 0; d < static_cast<unsigned>(drawables_.Size()); ++d)
+    for (Drawable2D* drawable : visibleDrawables_)
     {
-        if (!drawables_[d]->IsInView(camera))
+        if (!drawable->IsInView(camera))
             continue;
 
-        const Vector<SourceBatch2D>& batches = drawables_[d]->GetSourceBatches();
+        const Vector<SourceBatch2D>& batches = drawable->GetSourceBatches();
 
         for (const SourceBatch2D& batch : batches)
         {
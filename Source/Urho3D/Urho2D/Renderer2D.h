@@ -5,10 +5,12 @@
 
 #include "../Graphics/Drawable.h"
 #include "../Math/Frustum.h"
+#include "../Urho2D/SpatialGrid2D.h"
 
 namespace Urho3D
 {
 
+class AnimatedSprite2D;
 class Drawable2D;
 class IndexBuffer;
 class Material;
@@ -16,8 +18,22 @@ class Technique;
 class Texture2D;
 class VertexBuffer;
 class Light2D;
+class ParticleEmitter2D;
+struct BgfxQuadBatch;
 struct FrameInfo;
 struct SourceBatch2D;
+struct Vertex2D;
+
+/// 2D light shading mode.
+enum Light2DMode
+{
+    /// Light2D components are ignored.
+    LIGHT2D_NONE = 0,
+    /// Per-pixel lighting in the Urho2D_Lit2D shader under BGFX. The legacy geometry path has no lit shader and modulates vertex colors on the CPU instead.
+    LIGHT2D_SHADER,
+    /// Per-vertex CPU modulation of vertex colors. Not supported under BGFX, where it falls back to shader lighting with a warning.
+    LIGHT2D_VERTEX
+};
 
 /// 2D view batch info.
 /// @nobind
@@ -54,6 +70,8 @@ class URHO3D_API Renderer2D : public Drawable
     URHO3D_OBJECT(Renderer2D, Drawable);
 
     friend void CheckDrawableVisibilityWork(const WorkItem* item, i32 threadIndex);
+    friend void UpdateParticleEmittersWork(const WorkItem* item, i32 threadIndex);
+    friend void UpdateAnimatedSpritesWork(const WorkItem* item, i32 threadIndex);
 
 public:
     /// Construct.
@@ -77,21 +95,89 @@ public:
     void AddDrawable(Drawable2D* drawable);
     /// Remove Drawable2D.
     void RemoveDrawable(Drawable2D* drawable);
+    /// Queue the node world transform and bounding box of a Drawable2D to be resolved on the main thread before the next view update or query, and the drawable to be moved in the spatial index.
+    void QueueSpatialUpdate(Drawable2D* drawable);
+    /// Resolve queued world transforms and bounding boxes and update the spatial index. Main thread only. Called automatically before culling and queries.
+    void UpdateSpatialIndex();
+    /// Add Light2D.
+    void AddLight(Light2D* light);
+    /// Remove Light2D.
+    void RemoveLight(Light2D* light);
+    /// Add ParticleEmitter2D.
+    void AddParticleEmitter(ParticleEmitter2D* emitter);
+    /// Remove ParticleEmitter2D.
+    void RemoveParticleEmitter(ParticleEmitter2D* emitter);
+    /// Add AnimatedSprite2D. Its animation is updated by the renderer on scene post-update.
+    void AddAnimatedSprite(AnimatedSprite2D* animatedSprite);
+    /// Remove AnimatedSprite2D.
+    void RemoveAnimatedSprite(AnimatedSprite2D* animatedSprite);
     /// Return material by texture and blend mode.
     Material* GetMaterial(Texture2D* texture, BlendMode blendMode);
 
     /// Check visibility.
     bool CheckVisibility(Drawable2D* drawable) const;
+    /// Return drawables whose bounding box overlaps a world-space rectangle on the XY plane. Call from the main thread.
+    void GetDrawables(Vector<Drawable2D*>& result, const Rect& rect, unsigned viewMask = DEFAULT_VIEWMASK);
+    /// Return drawables whose bounding box contains a world-space point on the XY plane, topmost first. Call from the main thread.
+    void GetDrawables(Vector<Drawable2D*>& result, const Vector2& point, unsigned viewMask = DEFAULT_VIEWMASK);
+
+    /// Set cell size of the spatial index used for culling and queries, in world units. Should be about the size of the largest common sprite.
+    /// @property
+    void SetSpatialCellSize(float size);
+    /// Return cell size of the spatial index.
+    /// @property
+    float GetSpatialCellSize() const { return spatialGrid_.GetCellSize(); }
+
+    /// Set 2D light shading mode. Vertex mode falls back to shader mode under BGFX.
+    /// @property
+    void SetLightMode(Light2DMode mode);
+    /// Return 2D light shading mode.
+    /// @property
+    Light2DMode GetLightMode() const { return lightMode_; }
+
+    /// Set whether particle emitters of the scene are updated in parallel on the work queue.
+    /// @property
+    void SetParallelParticleUpdate(bool enable);
+    /// Return whether particle emitters are updated in parallel.
+    /// @property
+    bool GetParallelParticleUpdate() const { return parallelParticleUpdate_; }
+
+    /// Set whether animated sprites of the scene are updated in parallel on the work queue. Animation events are then sent after all animations have been updated.
+    /// @property
+    void SetParallelAnimationUpdate(bool enable);
+    /// Return whether animated sprites are updated in parallel.
+    /// @property
+    bool GetParallelAnimationUpdate() const { return parallelAnimationUpdate_; }
 
 private:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
     /// Recalculate the world-space bounding box.
     void OnWorldBoundingBoxUpdate() override;
     /// Create material by texture and blend mode.
     SharedPtr<Material> CreateMaterial(Texture2D* texture, BlendMode blendMode);
     /// Handle view update begin event. Determine Drawable2D's and their batches here.
     void HandleBeginViewUpdate(StringHash eventType, VariantMap& eventData);
-    /// Get all drawables in node.
-    void GetDrawables(Vector<Drawable2D*>& drawables, Node* node);
+    /// Handle scene post-update event. Update animated sprites, and particle emitters in parallel.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Update particle emitters in parallel.
+    void UpdateParticleEmitters(float timeStep);
+    /// Update animated sprites, in parallel if enabled.
+    void UpdateAnimatedSprites(float timeStep);
+    /// Cull registered lights against the current frustum and sort the visible ones by relevance into frameLights_.
+    void UpdateFrameLights(Camera* camera);
+    /// Upload changed source batches of visible drawables to the persistent vertex pool. Return false if the pool can not be used.
+    bool UpdateVertexPool(const Vector<const SourceBatch2D*>& sourceBatches);
+    /// Upload all source batches of a drawable to its range in the persistent vertex pool.
+    void UploadToVertexPool(Drawable2D* drawable);
+    /// Allocate a vertex range from the persistent vertex pool. Return the start vertex.
+    unsigned AllocateVertexRange(unsigned count);
+    /// Return a vertex range to the persistent vertex pool.
+    void FreeVertexRange(unsigned start, unsigned count);
+    /// Release the vertex range of a drawable.
+    void ReleaseVertexRange(Drawable2D* drawable);
+    /// Destroy the persistent vertex pool and release the vertex ranges of all drawables.
+    void ResetVertexPool();
     /// Update view batch info.
     void UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* camera);
     /// Add view batch.
@@ -104,6 +190,14 @@ private:
     SharedPtr<Material> material_;
     /// Drawables.
     Vector<Drawable2D*> drawables_;
+    /// Drawables whose node world transform or bounding box is dirty.
+    Vector<Drawable2D*> spatialUpdateQueue_;
+    /// Spatial index of the drawables.
+    SpatialGrid2D spatialGrid_;
+    /// Drawables that passed frustum culling in the current view, before the view mask check.
+    Vector<Drawable2D*> visibleDrawables_;
+    /// Spatial index query results.
+    Vector<Drawable2D*> queryDrawables_;
     /// View frame info for current frame.
     FrameInfo frame_;
     /// View batch info.
@@ -116,8 +210,50 @@ private:
     HashMap<Texture2D*, HashMap<int, SharedPtr<Material>>> cachedMaterials_;
     /// Cached techniques per blend mode.
     HashMap<int, SharedPtr<Technique>> cachedTechniques_;
-    /// Lights collected for current frame (2D-only).
+    /// Registered Light2D components.
+    Vector<Light2D*> lights_;
+    /// Visible lights with their relevance for current frame.
+    Vector<Pair<float, Light2D*>> visibleLights_;
+    /// Visible lights for current frame, most relevant first (2D-only).
     Vector<Light2D*> frameLights_;
+    /// Merged BGFX submission ranges for current view, reused between frames.
+    Vector<BgfxQuadBatch> bgfxQuadBatches_;
+    /// 2D light shading mode.
+    Light2DMode lightMode_;
+    /// Persistent vertex pool shared by all views (BGFX dynamic vertex buffer), 0xFFFF if not created.
+    unsigned short vertexPool_;
+    /// Vertex capacity of the persistent vertex pool.
+    unsigned vertexPoolCapacity_;
+    /// Allocated size of the persistent vertex pool, including free ranges.
+    unsigned vertexPoolSize_;
+    /// Free ranges of the persistent vertex pool as (start, count), sorted by start.
+    Vector<Pair<unsigned, unsigned>> freeVertexRanges_;
+    /// Drawables whose source batches changed since the last upload.
+    Vector<Drawable2D*> staleDrawables_;
+    /// Scratch vertices for uploading drawables with several source batches.
+    Vector<Vertex2D> poolUploadVertices_;
+    /// Whether the persistent vertex pool is unsupported and the source batches are copied every frame instead.
+    bool vertexPoolUnsupported_;
+    /// Registered ParticleEmitter2D components.
+    Vector<ParticleEmitter2D*> particleEmitters_;
+    /// Emitters being updated in parallel for current frame.
+    Vector<WeakPtr<ParticleEmitter2D>> updatingEmitters_;
+    /// Raw pointers of the emitters being updated, split into work items.
+    Vector<ParticleEmitter2D*> updatingEmitterPtrs_;
+    /// Time step of the current parallel particle update.
+    float particleTimeStep_;
+    /// Parallel particle update flag.
+    bool parallelParticleUpdate_;
+    /// Registered AnimatedSprite2D components.
+    Vector<AnimatedSprite2D*> animatedSprites_;
+    /// Animated sprites being updated for current frame.
+    Vector<WeakPtr<AnimatedSprite2D>> updatingAnimatedSprites_;
+    /// Raw pointers of the animated sprites being updated, split into work items.
+    Vector<AnimatedSprite2D*> updatingAnimatedSpritePtrs_;
+    /// Time step of the current parallel animation update.
+    float animationTimeStep_;
+    /// Parallel animation update flag.
+    bool parallelAnimationUpdate_;
 };
 
 }
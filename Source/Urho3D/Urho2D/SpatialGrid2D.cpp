@@ -0,0 +1,367 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#include "../Precompiled.h"
+
+#include "../Container/Sort.h"
+#include "../Math/Frustum.h"
+#include "../Math/Ray.h"
+#include "../Urho2D/Drawable2D.h"
+#include "../Urho2D/SpatialGrid2D.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+// 单元坐标的范围，避免极端坐标转换为整数时溢出
+static const float MAX_CELL_COORDINATE = 1.0e9f;
+
+static inline i32 ToCellCoordinate(float value, float invCellSize)
+{
+    return (i32)floorf(Clamp(value * invCellSize, -MAX_CELL_COORDINATE, MAX_CELL_COORDINATE));
+}
+
+static inline u64 PackCellCoordinates(i32 x, i32 y)
+{
+    return (u64)(u32)x << 32u | (u32)y;
+}
+
+static inline bool OverlapsXY(const BoundingBox& box, const Vector2& min, const Vector2& max)
+{
+    return box.min_.x_ <= max.x_ && box.max_.x_ >= min.x_ && box.min_.y_ <= max.y_ && box.max_.y_ >= min.y_;
+}
+
+SpatialGrid2D::SpatialGrid2D() :
+    cellSize_(DEFAULT_SPATIAL_CELL_SIZE_2D),
+    invCellSize_(1.0f / DEFAULT_SPATIAL_CELL_SIZE_2D)
+{
+}
+
+SpatialGrid2D::~SpatialGrid2D()
+{
+    Clear();
+}
+
+void SpatialGrid2D::SetCellSize(float size)
+{
+    size = Max(size, M_EPSILON);
+    if (size == cellSize_)
+        return;
+
+    // 收集全部 drawable 后按新的单元大小重新插入
+    Vector<Drawable2D*> drawables(largeDrawables_.drawables_);
+    for (const Cell& cell : cells_)
+        drawables.Insert(drawables.End(), cell.drawables_.Begin(), cell.drawables_.End());
+
+    Clear();
+    cellSize_ = size;
+    invCellSize_ = 1.0f / size;
+
+    for (Drawable2D* drawable : drawables)
+        Update(drawable);
+    UpdateCellBounds();
+}
+
+void SpatialGrid2D::Update(Drawable2D* drawable)
+{
+    const BoundingBox& box = drawable->GetWorldBoundingBox();
+    unsigned cellIndex = GetCellIndex(box);
+
+    // 仍在同一单元内时只更新包围盒，单元边界只增不减，直到有成员离开时才重新计算
+    if (cellIndex == drawable->spatialCell_)
+    {
+        Cell& cell = GetCell(cellIndex);
+        cell.boxes_[drawable->spatialIndex_] = box;
+        if (box.Defined())
+            cell.bounds_.Merge(box);
+        return;
+    }
+
+    Remove(drawable);
+
+    Cell& cell = GetCell(cellIndex);
+    drawable->spatialCell_ = cellIndex;
+    drawable->spatialIndex_ = cell.drawables_.Size();
+    cell.drawables_.Push(drawable);
+    cell.boxes_.Push(box);
+    if (box.Defined())
+        cell.bounds_.Merge(box);
+}
+
+void SpatialGrid2D::Remove(Drawable2D* drawable)
+{
+    unsigned cellIndex = drawable->spatialCell_;
+    if (cellIndex == M_MAX_UNSIGNED)
+        return;
+
+    Cell& cell = GetCell(cellIndex);
+    unsigned index = drawable->spatialIndex_;
+    unsigned last = cell.drawables_.Size() - 1;
+    if (index != last)
+    {
+        cell.drawables_[index] = cell.drawables_[last];
+        cell.boxes_[index] = cell.boxes_[last];
+        cell.drawables_[index]->spatialIndex_ = index;
+    }
+    cell.drawables_.Pop();
+    cell.boxes_.Pop();
+
+    if (!cell.boundsDirty_ && cellIndex != LARGE_CELL)
+    {
+        cell.boundsDirty_ = true;
+        dirtyCells_.Push(cellIndex);
+    }
+
+    drawable->spatialCell_ = M_MAX_UNSIGNED;
+}
+
+void SpatialGrid2D::UpdateCellBounds()
+{
+    i32 numEmpty = 0;
+    for (unsigned cellIndex : dirtyCells_)
+    {
+        Cell& cell = cells_[cellIndex];
+        cell.bounds_.Clear();
+        for (const BoundingBox& box : cell.boxes_)
+        {
+            if (box.Defined())
+                cell.bounds_.Merge(box);
+        }
+        cell.boundsDirty_ = false;
+
+        // 空单元稍后释放，先留在列表前部
+        if (cell.drawables_.Empty())
+            dirtyCells_[numEmpty++] = cellIndex;
+    }
+
+    // 从大到小释放，被移动的末尾单元不会是仍待释放的空单元
+    dirtyCells_.Resize(numEmpty);
+    Sort(dirtyCells_.Begin(), dirtyCells_.End(), [](unsigned lhs, unsigned rhs) { return lhs > rhs; });
+    for (unsigned cellIndex : dirtyCells_)
+        FreeCell(cellIndex);
+
+    dirtyCells_.Clear();
+}
+
+void SpatialGrid2D::FreeCell(unsigned index)
+{
+    cellIndices_.erase(cells_[index].key_);
+
+    unsigned last = cells_.Size() - 1;
+    if (index != last)
+    {
+        Cell& cell = cells_[index];
+        cell = std::move(cells_[last]);
+        cellIndices_[cell.key_] = index;
+        for (Drawable2D* drawable : cell.drawables_)
+            drawable->spatialCell_ = index;
+    }
+
+    cells_.Pop();
+}
+
+void SpatialGrid2D::Clear()
+{
+    for (Drawable2D* drawable : largeDrawables_.drawables_)
+        drawable->spatialCell_ = M_MAX_UNSIGNED;
+    for (const Cell& cell : cells_)
+    {
+        for (Drawable2D* drawable : cell.drawables_)
+            drawable->spatialCell_ = M_MAX_UNSIGNED;
+    }
+
+    cells_.Clear();
+    cellIndices_.Clear();
+    largeDrawables_.drawables_.Clear();
+    largeDrawables_.boxes_.Clear();
+    dirtyCells_.Clear();
+}
+
+void SpatialGrid2D::GetDrawables(Vector<Drawable2D*>& result, const Frustum& frustum) const
+{
+    BoundingBox frustumBox(frustum);
+    auto testCell = [&](const Cell& cell)
+    {
+        Intersection cellResult = frustum.IsInsideFast(cell.bounds_);
+        if (cellResult == OUTSIDE)
+            return;
+
+        if (cellResult == INSIDE)
+            result.Insert(result.End(), cell.drawables_.Begin(), cell.drawables_.End());
+        else
+        {
+            for (i32 i = 0; i < cell.boxes_.Size(); ++i)
+            {
+                if (frustum.IsInsideFast(cell.boxes_[i]) != OUTSIDE)
+                    result.Push(cell.drawables_[i]);
+            }
+        }
+    };
+
+    ForEachCell(Vector2(frustumBox.min_.x_, frustumBox.min_.y_), Vector2(frustumBox.max_.x_, frustumBox.max_.y_), testCell);
+
+    for (i32 i = 0; i < largeDrawables_.boxes_.Size(); ++i)
+    {
+        const BoundingBox& box = largeDrawables_.boxes_[i];
+        if (box.Defined() && frustum.IsInsideFast(box) != OUTSIDE)
+            result.Push(largeDrawables_.drawables_[i]);
+    }
+}
+
+void SpatialGrid2D::GetDrawables(Vector<Drawable2D*>& result, const Rect& rect) const
+{
+    const Vector2& min = rect.min_;
+    const Vector2& max = rect.max_;
+    auto testCell = [&](const Cell& cell)
+    {
+        if (!OverlapsXY(cell.bounds_, min, max))
+            return;
+
+        for (i32 i = 0; i < cell.boxes_.Size(); ++i)
+        {
+            if (OverlapsXY(cell.boxes_[i], min, max))
+                result.Push(cell.drawables_[i]);
+        }
+    };
+
+    ForEachCell(min, max, testCell);
+
+    for (i32 i = 0; i < largeDrawables_.boxes_.Size(); ++i)
+    {
+        const BoundingBox& box = largeDrawables_.boxes_[i];
+        if (box.Defined() && OverlapsXY(box, min, max))
+            result.Push(largeDrawables_.drawables_[i]);
+    }
+}
+
+void SpatialGrid2D::GetDrawables(Vector<Drawable2D*>& result, const Ray& ray, float maxDistance) const
+{
+    auto testCell = [&](const Cell& cell)
+    {
+        if (ray.HitDistance(cell.bounds_) < maxDistance)
+            result.Insert(result.End(), cell.drawables_.Begin(), cell.drawables_.End());
+    };
+
+    // 射线在 XY 平面上的投影线段，沿 Z 轴拾取时退化为一个点
+    Vector2 start(ray.origin_.x_, ray.origin_.y_);
+    Vector2 delta(ray.direction_.x_, ray.direction_.y_);
+    Vector2 end = delta.LengthSquared() > M_EPSILON * M_EPSILON ? start + delta * maxDistance : start;
+
+    i32 x = ToCellCoordinate(start.x_, invCellSize_);
+    i32 y = ToCellCoordinate(start.y_, invCellSize_);
+    i32 endX = ToCellCoordinate(end.x_, invCellSize_);
+    i32 endY = ToCellCoordinate(end.y_, invCellSize_);
+
+    // 经过的单元多于已分配单元时（包括无限远的射线），直接测试全部单元
+    float numSteps = Abs((float)endX - (float)x) + Abs((float)endY - (float)y);
+    if (!(numSteps * 3.0f + 9.0f < (float)cells_.Size()))
+    {
+        for (const Cell& cell : cells_)
+        {
+            if (!cell.drawables_.Empty())
+                testCell(cell);
+        }
+    }
+    else
+    {
+        // 成员最多越出所在单元半个单元，因此测试经过单元周围的一圈单元。
+        // 经过的单元沿两个轴单调前进，每步只有前方的一列或一行是新的
+        for (i32 dy = -1; dy <= 1; ++dy)
+        {
+            for (i32 dx = -1; dx <= 1; ++dx)
+                ForCell(x + dx, y + dy, testCell);
+        }
+
+        Vector2 direction = end - start;
+        i32 stepX = endX >= x ? 1 : -1;
+        i32 stepY = endY >= y ? 1 : -1;
+        float tDeltaX = direction.x_ != 0.0f ? cellSize_ / Abs(direction.x_) : M_INFINITY;
+        float tDeltaY = direction.y_ != 0.0f ? cellSize_ / Abs(direction.y_) : M_INFINITY;
+        float tMaxX = direction.x_ != 0.0f ? ((float)(x + (stepX > 0 ? 1 : 0)) * cellSize_ - start.x_) / direction.x_ : M_INFINITY;
+        float tMaxY = direction.y_ != 0.0f ? ((float)(y + (stepY > 0 ? 1 : 0)) * cellSize_ - start.y_) / direction.y_ : M_INFINITY;
+
+        while (x != endX || y != endY)
+        {
+            if (y == endY || (x != endX && tMaxX < tMaxY))
+            {
+                x += stepX;
+                tMaxX += tDeltaX;
+                for (i32 dy = -1; dy <= 1; ++dy)
+                    ForCell(x + stepX, y + dy, testCell);
+            }
+            else
+            {
+                y += stepY;
+                tMaxY += tDeltaY;
+                for (i32 dx = -1; dx <= 1; ++dx)
+                    ForCell(x + dx, y + stepY, testCell);
+            }
+        }
+    }
+
+    for (i32 i = 0; i < largeDrawables_.boxes_.Size(); ++i)
+    {
+        if (largeDrawables_.boxes_[i].Defined())
+            result.Push(largeDrawables_.drawables_[i]);
+    }
+}
+
+unsigned SpatialGrid2D::GetCellIndex(const BoundingBox& box)
+{
+    if (!box.Defined())
+        return LARGE_CELL;
+
+    Vector3 size = box.Size();
+    if (size.x_ > cellSize_ || size.y_ > cellSize_)
+        return LARGE_CELL;
+
+    Vector3 center = box.Center();
+    u64 key = PackCellCoordinates(ToCellCoordinate(center.x_, invCellSize_), ToCellCoordinate(center.y_, invCellSize_));
+    auto it = cellIndices_.find(key);
+    if (it != cellIndices_.end())
+        return it->second;
+
+    unsigned index = cells_.Size();
+    cells_.Resize(index + 1);
+    cells_[index].key_ = key;
+    cellIndices_[key] = index;
+    return index;
+}
+
+template <class T> void SpatialGrid2D::ForCell(i32 x, i32 y, T func) const
+{
+    auto it = cellIndices_.find(PackCellCoordinates(x, y));
+    if (it != cellIndices_.end() && !cells_[it->second].drawables_.Empty())
+        func(cells_[it->second]);
+}
+
+template <class T> void SpatialGrid2D::ForEachCell(const Vector2& min, const Vector2& max, T func) const
+{
+    // 成员的半尺寸不超过半个单元，只可能越过相邻一个单元
+    float width = (max.x_ - min.x_) * invCellSize_ + 3.0f;
+    float height = (max.y_ - min.y_) * invCellSize_ + 3.0f;
+
+    // 查询范围覆盖的单元数多于已分配单元时，直接遍历全部单元
+    if (!(width * height < (float)cells_.Size()))
+    {
+        for (const Cell& cell : cells_)
+        {
+            if (!cell.drawables_.Empty())
+                func(cell);
+        }
+        return;
+    }
+
+    i32 x0 = ToCellCoordinate(min.x_, invCellSize_) - 1;
+    i32 x1 = ToCellCoordinate(max.x_, invCellSize_) + 1;
+    i32 y0 = ToCellCoordinate(min.y_, invCellSize_) - 1;
+    i32 y1 = ToCellCoordinate(max.y_, invCellSize_) + 1;
+    for (i32 y = y0; y <= y1; ++y)
+    {
+        for (i32 x = x0; x <= x1; ++x)
+            ForCell(x, y, func);
+    }
+}
+
+}
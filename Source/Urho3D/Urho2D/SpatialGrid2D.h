@@ -0,0 +1,104 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#pragma once
+
+#include "../Container/HashMap.h"
+#include "../Container/Vector.h"
+#include "../Math/BoundingBox.h"
+#include "../Math/Rect.h"
+
+namespace Urho3D
+{
+
+class Drawable2D;
+class Frustum;
+class Ray;
+
+/// Default cell size of the 2D spatial index.
+static const float DEFAULT_SPATIAL_CELL_SIZE_2D = 4.0f;
+
+/// Loose grid of Drawable2D's for culling and picking. Each drawable is stored in the cell containing the center of its
+/// world bounding box, and each cell keeps the union of its drawables' boxes. Drawables larger than a cell are kept in
+/// a separate list that is always tested. Cells are freed when they become empty.
+class URHO3D_API SpatialGrid2D
+{
+public:
+    /// Construct.
+    SpatialGrid2D();
+    /// Destruct. Detach remaining drawables.
+    ~SpatialGrid2D();
+
+    /// Prevent copy construction.
+    SpatialGrid2D(const SpatialGrid2D& rhs) = delete;
+    /// Prevent assignment.
+    SpatialGrid2D& operator =(const SpatialGrid2D& rhs) = delete;
+
+    /// Set cell size. Reinserts all drawables.
+    void SetCellSize(float size);
+    /// Insert or move a drawable according to its current world bounding box, which must be up to date.
+    void Update(Drawable2D* drawable);
+    /// Remove a drawable.
+    void Remove(Drawable2D* drawable);
+    /// Recalculate bounds of cells that drawables have left and free the cells that became empty. Call after updates and before queries.
+    void UpdateCellBounds();
+    /// Remove all drawables.
+    void Clear();
+
+    /// Return drawables whose bounding box is inside or intersects the frustum.
+    void GetDrawables(Vector<Drawable2D*>& result, const Frustum& frustum) const;
+    /// Return drawables whose bounding box overlaps the rectangle on the XY plane.
+    void GetDrawables(Vector<Drawable2D*>& result, const Rect& rect) const;
+    /// Return drawables in cells hit by the ray up to the maximum distance. Only the cells along the ray are visited. The drawables' own boxes are not tested.
+    void GetDrawables(Vector<Drawable2D*>& result, const Ray& ray, float maxDistance) const;
+
+    /// Return cell size.
+    float GetCellSize() const { return cellSize_; }
+    /// Return number of allocated cells.
+    unsigned GetNumCells() const { return cells_.Size(); }
+
+private:
+    /// Grid cell.
+    struct Cell
+    {
+        /// Drawables.
+        Vector<Drawable2D*> drawables_;
+        /// World bounding boxes of the drawables, kept contiguous for testing.
+        Vector<BoundingBox> boxes_;
+        /// Union of the boxes. May be larger than necessary until recalculated.
+        BoundingBox bounds_;
+        /// Packed cell coordinates.
+        u64 key_{};
+        /// Whether bounds need to be recalculated.
+        bool boundsDirty_{};
+    };
+
+    /// Return cell index for a world bounding box, or LARGE_CELL if the box does not fit a cell. Create the cell if necessary.
+    unsigned GetCellIndex(const BoundingBox& box);
+    /// Return cell by index.
+    Cell& GetCell(unsigned index) { return index == LARGE_CELL ? largeDrawables_ : cells_[index]; }
+    /// Call a function for each cell which may contain drawables overlapping an XY range.
+    template <class T> void ForEachCell(const Vector2& min, const Vector2& max, T func) const;
+    /// Call a function for each non-empty cell at the specified cell coordinates.
+    template <class T> void ForCell(i32 x, i32 y, T func) const;
+    /// Free an empty cell. The last cell is moved to its index.
+    void FreeCell(unsigned index);
+
+    /// Cell index of drawables larger than a cell.
+    static const unsigned LARGE_CELL = M_MAX_UNSIGNED - 1;
+
+    /// Cells.
+    Vector<Cell> cells_;
+    /// Cell indices by packed cell coordinates.
+    HashMap<u64, unsigned> cellIndices_;
+    /// Drawables larger than a cell or without a defined bounding box.
+    Cell largeDrawables_;
+    /// Cells whose bounds need to be recalculated.
+    Vector<unsigned> dirtyCells_;
+    /// Cell size.
+    float cellSize_;
+    /// Reciprocal of cell size.
+    float invCellSize_;
+};
+
+}
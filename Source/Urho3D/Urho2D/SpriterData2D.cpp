@@ -234,6 +234,9 @@ void Animation::Reset()
     for (const Timeline* timeline : timelines_)
         delete timeline;
     timelines_.clear();
+
+    delete baked_;
+    baked_ = nullptr;
 }
 
 bool Animation::Load(const pugi::xml_node& node)
@@ -266,6 +269,90 @@ bool Animation::Load(const pugi::xml_node& node)
     return true;
 }
 
+unsigned Animation::FindMainlineKey(float time, unsigned startIndex) const
+{
+    // 从上次的位置继续向后查找，时间回绕时从头开始
+    unsigned index = startIndex < (unsigned)mainlineKeys_.Size() && mainlineKeys_[startIndex]->time_ <= time ? startIndex : 0;
+    while (index + 1 < (unsigned)mainlineKeys_.Size() && mainlineKeys_[index + 1]->time_ <= time)
+        ++index;
+    return index;
+}
+
+void Animation::SampleTimelineKey(const Ref* ref, float time, SpatialTimelineKey& result) const
+{
+    Timeline* timeline = timelines_[ref->timeline_];
+    const SpatialTimelineKey* timelineKey = timeline->keys_[ref->key_];
+    if (timeline->objectType_ == BONE)
+        (BoneTimelineKey&)result = *(const BoneTimelineKey*)timelineKey;
+    else
+        (SpriteTimelineKey&)result = *(const SpriteTimelineKey*)timelineKey;
+    result.timeline_ = timeline;
+
+    if (timeline->keys_.Size() == 1 || result.curveType_ == INSTANT)
+        return;
+
+    unsigned nextTimelineKeyIndex = ref->key_ + 1;
+    if (nextTimelineKeyIndex >= (unsigned)timeline->keys_.Size())
+    {
+        if (looping_)
+            nextTimelineKeyIndex = 0;
+        else
+            return;
+    }
+
+    const TimelineKey* nextTimelineKey = timeline->keys_[nextTimelineKeyIndex];
+
+    float nextTimelineKeyTime = nextTimelineKey->time_;
+    if (nextTimelineKey->time_ < result.time_)
+        nextTimelineKeyTime += length_;
+
+    float t = result.GetTByCurveType(time, nextTimelineKeyTime);
+    result.Interpolate(*nextTimelineKey, t);
+}
+
+void Animation::Bake(float frameRate)
+{
+    delete baked_;
+    baked_ = nullptr;
+
+    if (frameRate <= 0.0f || mainlineKeys_.Empty())
+        return;
+
+    auto* baked = new BakedAnimation();
+    baked->frameRate_ = frameRate;
+    baked->numFrames_ = (unsigned)CeilToInt(length_ * frameRate) + 1;
+
+    BoneTimelineKey boneKey(nullptr);
+    SpriteTimelineKey spriteKey(nullptr);
+    unsigned mainlineKeyIndex = 0;
+
+    for (unsigned i = 0; i < baked->numFrames_; ++i)
+    {
+        float time = Min((float)i / frameRate, length_);
+        mainlineKeyIndex = FindMainlineKey(time, mainlineKeyIndex);
+        const MainlineKey* mainlineKey = mainlineKeys_[mainlineKeyIndex];
+
+        baked->mainlineKeys_.Push(mainlineKeyIndex);
+        baked->boneOffsets_.Push(baked->boneKeys_.Size());
+        baked->spriteOffsets_.Push(baked->spriteKeys_.Size());
+
+        for (const Ref* ref : mainlineKey->boneRefs_)
+        {
+            SampleTimelineKey(ref, time, boneKey);
+            baked->boneKeys_.Push(BakedBoneKey{boneKey.info_, boneKey.length_, boneKey.width_});
+        }
+
+        for (const Ref* ref : mainlineKey->objectRefs_)
+        {
+            SampleTimelineKey(ref, time, spriteKey);
+            baked->spriteKeys_.Push(BakedSpriteKey{spriteKey.info_, spriteKey.folderId_, spriteKey.fileId_,
+                spriteKey.useDefaultPivot_, spriteKey.pivotX_, spriteKey.pivotY_});
+        }
+    }
+
+    baked_ = baked;
+}
+
 MainlineKey::~MainlineKey()
 {
     Reset();
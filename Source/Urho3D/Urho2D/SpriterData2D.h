@@ -19,6 +19,7 @@ namespace Spriter
 {
 
 struct Animation;
+struct BakedAnimation;
 struct BoneTimelineKey;
 struct CharacterMap;
 struct Entity;
@@ -133,6 +134,12 @@ struct Animation
 
     void Reset();
     bool Load(const pugi::xml_node& node);
+    /// Return index of the last mainline key at or before time. Searches forward from startIndex unless time is before it.
+    unsigned FindMainlineKey(float time, unsigned startIndex = 0) const;
+    /// Evaluate the timeline key of a ref at time into result, which must be of the timeline's key type. Result is in the local space of the parent.
+    void SampleTimelineKey(const Ref* ref, float time, SpatialTimelineKey& result) const;
+    /// Bake into tracks sampled at a fixed rate. Zero frame rate removes the baked tracks.
+    void Bake(float frameRate);
 
     int id_{};
     String name_;
@@ -140,6 +147,8 @@ struct Animation
     bool looping_{};
     Vector<MainlineKey*> mainlineKeys_;
     Vector<Timeline*> timelines_;
+    /// Baked tracks, null if not baked.
+    BakedAnimation* baked_{};
 };
 
 /// Mainline key.
@@ -294,6 +303,40 @@ struct SpriteTimelineKey : SpatialTimelineKey
     int zIndex_{};
 };
 
+/// Baked bone key.
+struct BakedBoneKey
+{
+    SpatialInfo info_;
+    float length_;
+    float width_;
+};
+
+/// Baked sprite key.
+struct BakedSpriteKey
+{
+    SpatialInfo info_;
+    int folderId_;
+    int fileId_;
+    bool useDefaultPivot_;
+    float pivotX_;
+    float pivotY_;
+};
+
+/// Animation sampled at a fixed rate. Keys are in the local space of their parents, in mainline ref order.
+struct BakedAnimation
+{
+    float frameRate_{};
+    unsigned numFrames_{};
+    /// Mainline key index of each frame.
+    Vector<unsigned> mainlineKeys_;
+    /// First bone key of each frame.
+    Vector<unsigned> boneOffsets_;
+    /// First sprite key of each frame.
+    Vector<unsigned> spriteOffsets_;
+    Vector<BakedBoneKey> boneKeys_;
+    Vector<BakedSpriteKey> spriteKeys_;
+};
+
 }
 
 }
@@ -29,6 +29,11 @@ SpriterInstance::~SpriterInstance()
 
     OnSetAnimation(nullptr);
     OnSetEntity(nullptr);
+
+    for (const BoneTimelineKey* key : boneKeys_)
+        delete key;
+    for (const SpriteTimelineKey* key : spriteKeys_)
+        delete key;
 }
 
 bool SpriterInstance::SetEntity(int index)
@@ -108,8 +113,6 @@ void SpriterInstance::Update(float deltaTime)
     if (!animation_)
         return;
 
-    Clear();
-
     float lastTime = currentTime_;
     currentTime_ += deltaTime;
     if (currentTime_ > animation_->length_)
@@ -127,28 +130,38 @@ void SpriterInstance::Update(float deltaTime)
             sendFinishEvent = lastTime != currentTime_;
         }
 
-        if (sendFinishEvent && owner_)
-        {
-            Node* senderNode = owner_->GetNode();
-            if (senderNode)
-            {
-                using namespace AnimationFinished;
-
-                VariantMap& eventData = senderNode->GetEventDataMap();
-                eventData[P_NODE] = senderNode;
-                eventData[P_ANIMATION] = animation_;
-                eventData[P_NAME] = animation_->name_;
-                eventData[P_LOOPED] = looping_;
-
-                senderNode->SendEvent(E_ANIMATIONFINISHED, eventData);
-            }
-        }
+        if (sendFinishEvent)
+            finishedEventPending_ = true;
     }
 
     UpdateMainlineKey();
     UpdateTimelineKeys();
 }
 
+void SpriterInstance::SendFinishedEvent()
+{
+    if (!finishedEventPending_)
+        return;
+
+    finishedEventPending_ = false;
+    if (!owner_ || !animation_)
+        return;
+
+    Node* senderNode = owner_->GetNode();
+    if (senderNode)
+    {
+        using namespace AnimationFinished;
+
+        VariantMap& eventData = senderNode->GetEventDataMap();
+        eventData[P_NODE] = senderNode;
+        eventData[P_ANIMATION] = animation_;
+        eventData[P_NAME] = animation_->name_;
+        eventData[P_LOOPED] = looping_;
+
+        senderNode->SendEvent(E_ANIMATIONFINISHED, eventData);
+    }
+}
+
 void SpriterInstance::OnSetEntity(Entity* entity)
 {
     if (entity == this->entity_)
@@ -176,114 +189,138 @@ void SpriterInstance::OnSetAnimation(Animation* animation, LoopMode loopMode)
     }
 
     currentTime_ = 0.0f;
+    finishedEventPending_ = false;
     Clear();
 }
 
 void SpriterInstance::UpdateTimelineKeys()
 {
-    for (Ref* ref : mainlineKey_->boneRefs_)
+    timelineKeys_.Clear();
+
+    if (animation_->baked_)
     {
-        BoneTimelineKey* timelineKey = (BoneTimelineKey*)GetTimelineKey(ref);
-        if (ref->parent_ >= 0)
-        {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(timelineKeys_[ref->parent_]->info_);
-        }
-        else
-        {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(spatialInfo_);
-        }
-        timelineKeys_.push_back(timelineKey);
+        UpdateBakedTimelineKeys();
+        return;
     }
 
-    for (Ref* ref : mainlineKey_->objectRefs_)
+    // 父骨骼总是排在前面，骨骼键的序号与 timelineKeys_ 中的序号一致
+    for (i32 i = 0; i < mainlineKey_->boneRefs_.Size(); ++i)
     {
-        SpriteTimelineKey* timelineKey = (SpriteTimelineKey*)GetTimelineKey(ref);
-
-        if (ref->parent_ >= 0)
-        {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(timelineKeys_[ref->parent_]->info_);
-        }
-        else
-        {
-            timelineKey->info_ = timelineKey->info_.UnmapFromParent(spatialInfo_);
-        }
+        const Ref* ref = mainlineKey_->boneRefs_[i];
+        BoneTimelineKey* timelineKey = GetBoneKey(i);
+        animation_->SampleTimelineKey(ref, currentTime_, *timelineKey);
+        AddTimelineKey(ref, timelineKey);
+    }
 
+    for (i32 i = 0; i < mainlineKey_->objectRefs_.Size(); ++i)
+    {
+        const Ref* ref = mainlineKey_->objectRefs_[i];
+        SpriteTimelineKey* timelineKey = GetSpriteKey(i);
+        animation_->SampleTimelineKey(ref, currentTime_, *timelineKey);
         timelineKey->zIndex_ = ref->zIndex_;
-
-        timelineKeys_.push_back(timelineKey);
+        AddTimelineKey(ref, timelineKey);
     }
 }
 
-void SpriterInstance::UpdateMainlineKey()
+void SpriterInstance::UpdateBakedTimelineKeys()
 {
-    const Vector<MainlineKey*>& mainlineKeys = animation_->mainlineKeys_;
-    for (MainlineKey* key : mainlineKeys)
-    {
-        if (key->time_ <= currentTime_)
-        {
-            mainlineKey_ = key;
-        }
+    const BakedAnimation* baked = animation_->baked_;
 
-        if (key->time_ >= currentTime_)
-        {
-            break;
-        }
-    }
+    float frame = currentTime_ * baked->frameRate_;
+    unsigned frameIndex = Min((unsigned)Max(frame, 0.0f), baked->numFrames_ - 1);
+    unsigned nextFrameIndex = Min(frameIndex + 1, baked->numFrames_ - 1);
+    float t = Clamp(frame - (float)frameIndex, 0.0f, 1.0f);
 
-    if (!mainlineKey_)
-    {
-        mainlineKey_ = mainlineKeys[0];
-    }
-}
+    // 相邻两帧使用同一个主线关键帧时引用结构相同，可以逐个插值
+    bool interpolate = nextFrameIndex != frameIndex && t > 0.0f &&
+        baked->mainlineKeys_[nextFrameIndex] == baked->mainlineKeys_[frameIndex];
 
-TimelineKey* SpriterInstance::GetTimelineKey(Ref* ref) const
-{
-    Timeline* timeline = animation_->timelines_[ref->timeline_];
-    TimelineKey* timelineKey = timeline->keys_[ref->key_]->Clone();
-    if (timeline->keys_.size() == 1 || timelineKey->curveType_ == INSTANT)
+    const BakedBoneKey* boneKeys = baked->boneKeys_.data() + baked->boneOffsets_[frameIndex];
+    const BakedBoneKey* nextBoneKeys = baked->boneKeys_.data() + baked->boneOffsets_[nextFrameIndex];
+    for (i32 i = 0; i < mainlineKey_->boneRefs_.Size(); ++i)
     {
-        return timelineKey;
+        const Ref* ref = mainlineKey_->boneRefs_[i];
+        BoneTimelineKey* timelineKey = GetBoneKey(i);
+        timelineKey->timeline_ = animation_->timelines_[ref->timeline_];
+        timelineKey->info_ = boneKeys[i].info_;
+        timelineKey->length_ = boneKeys[i].length_;
+        timelineKey->width_ = boneKeys[i].width_;
+        if (interpolate)
+        {
+            timelineKey->info_.Interpolate(nextBoneKeys[i].info_, t);
+            timelineKey->length_ = Lerp(timelineKey->length_, nextBoneKeys[i].length_, t);
+            timelineKey->width_ = Lerp(timelineKey->width_, nextBoneKeys[i].width_, t);
+        }
+        AddTimelineKey(ref, timelineKey);
     }
 
-    i32 nextTimelineKeyIndex = ref->key_ + 1;
-    if (nextTimelineKeyIndex >= timeline->keys_.size())
+    const BakedSpriteKey* spriteKeys = baked->spriteKeys_.data() + baked->spriteOffsets_[frameIndex];
+    const BakedSpriteKey* nextSpriteKeys = baked->spriteKeys_.data() + baked->spriteOffsets_[nextFrameIndex];
+    for (i32 i = 0; i < mainlineKey_->objectRefs_.Size(); ++i)
     {
-        if (animation_->looping_)
+        const Ref* ref = mainlineKey_->objectRefs_[i];
+        SpriteTimelineKey* timelineKey = GetSpriteKey(i);
+        timelineKey->timeline_ = animation_->timelines_[ref->timeline_];
+        timelineKey->info_ = spriteKeys[i].info_;
+        timelineKey->folderId_ = spriteKeys[i].folderId_;
+        timelineKey->fileId_ = spriteKeys[i].fileId_;
+        timelineKey->useDefaultPivot_ = spriteKeys[i].useDefaultPivot_;
+        timelineKey->pivotX_ = spriteKeys[i].pivotX_;
+        timelineKey->pivotY_ = spriteKeys[i].pivotY_;
+        if (interpolate)
         {
-            nextTimelineKeyIndex = 0;
-        }
-        else
-        {
-            return timelineKey;
+            timelineKey->info_.Interpolate(nextSpriteKeys[i].info_, t);
+            timelineKey->pivotX_ = Lerp(timelineKey->pivotX_, nextSpriteKeys[i].pivotX_, t);
+            timelineKey->pivotY_ = Lerp(timelineKey->pivotY_, nextSpriteKeys[i].pivotY_, t);
         }
+        timelineKey->zIndex_ = ref->zIndex_;
+        AddTimelineKey(ref, timelineKey);
     }
+}
+
+void SpriterInstance::AddTimelineKey(const Ref* ref, SpatialTimelineKey* timelineKey)
+{
+    if (ref->parent_ >= 0)
+        timelineKey->info_ = timelineKey->info_.UnmapFromParent(timelineKeys_[ref->parent_]->info_);
+    else
+        timelineKey->info_ = timelineKey->info_.UnmapFromParent(spatialInfo_);
 
-    TimelineKey* nextTimelineKey = timeline->keys_[nextTimelineKeyIndex];
+    timelineKeys_.Push(timelineKey);
+}
 
-    float nextTimelineKeyTime = nextTimelineKey->time_;
-    if (nextTimelineKey->time_ < timelineKey->time_)
+void SpriterInstance::UpdateMainlineKey()
+{
+    if (animation_->baked_)
     {
-        nextTimelineKeyTime += animation_->length_;
+        const BakedAnimation* baked = animation_->baked_;
+        unsigned frameIndex = Min((unsigned)Max(currentTime_ * baked->frameRate_, 0.0f), baked->numFrames_ - 1);
+        mainlineKeyIndex_ = baked->mainlineKeys_[frameIndex];
     }
+    else
+        mainlineKeyIndex_ = animation_->FindMainlineKey(currentTime_, mainlineKeyIndex_);
+
+    mainlineKey_ = animation_->mainlineKeys_[mainlineKeyIndex_];
+}
 
-    float t = timelineKey->GetTByCurveType(currentTime_, nextTimelineKeyTime);
-    timelineKey->Interpolate(*nextTimelineKey, t);
+BoneTimelineKey* SpriterInstance::GetBoneKey(i32 index)
+{
+    while (boneKeys_.Size() <= index)
+        boneKeys_.Push(new BoneTimelineKey(nullptr));
+    return boneKeys_[index];
+}
 
-    return timelineKey;
+SpriteTimelineKey* SpriterInstance::GetSpriteKey(i32 index)
+{
+    while (spriteKeys_.Size() <= index)
+        spriteKeys_.Push(new SpriteTimelineKey(nullptr));
+    return spriteKeys_[index];
 }
 
 void SpriterInstance::Clear()
 {
     mainlineKey_ = nullptr;
-
-    if (!timelineKeys_.Empty())
-    {
-        for (const SpatialTimelineKey* key : timelineKeys_)
-        {
-            delete key;
-        }
-        timelineKeys_.clear();
-    }
+    mainlineKeyIndex_ = 0;
+    timelineKeys_.Clear();
 }
 
 } // namespace Spriter
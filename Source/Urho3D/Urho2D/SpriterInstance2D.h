@@ -44,8 +44,10 @@ public:
     void setSpatialInfo(const SpatialInfo& spatialInfo);
     /// Set root spatial info.
     void setSpatialInfo(float x, float y, float angle, float scaleX, float scaleY);
-    /// Update animation.
+    /// Update animation. AnimationFinished event is deferred to SendFinishedEvent(). May be called from a worker thread.
     void Update(float deltaTime);
+    /// Send AnimationFinished event if the animation finished during the last update.
+    void SendFinishedEvent();
 
     /// Return current entity.
     Entity* GetEntity() const { return entity_; }
@@ -65,8 +67,14 @@ private:
     void UpdateMainlineKey();
     /// Update timeline keys.
     void UpdateTimelineKeys();
-    /// Get timeline key by ref.
-    TimelineKey* GetTimelineKey(Ref* ref) const;
+    /// Update timeline keys from baked tracks.
+    void UpdateBakedTimelineKeys();
+    /// Transform a timeline key from the local space of its parent and add it to the result keys.
+    void AddTimelineKey(const Ref* ref, SpatialTimelineKey* timelineKey);
+    /// Return pooled bone key by index, create if necessary.
+    BoneTimelineKey* GetBoneKey(i32 index);
+    /// Return pooled sprite key by index, create if necessary.
+    SpriteTimelineKey* GetSpriteKey(i32 index);
     /// Clear mainline key and timeline keys.
     void Clear();
 
@@ -84,10 +92,18 @@ private:
     SpatialInfo spatialInfo_;
     /// Current time.
     float currentTime_{};
+    /// Animation finished during the last update, event not sent yet.
+    bool finishedEventPending_{};
     /// Current mainline key.
     MainlineKey* mainlineKey_{};
-    /// Current timeline keys.
+    /// Current mainline key index, where the next lookup starts.
+    unsigned mainlineKeyIndex_{};
+    /// Current timeline keys. Point to the pooled keys.
     Vector<SpatialTimelineKey*> timelineKeys_;
+    /// Pooled bone keys, reused every update.
+    Vector<BoneTimelineKey*> boneKeys_;
+    /// Pooled sprite keys, reused every update.
+    Vector<SpriteTimelineKey*> spriteKeys_;
 };
 
 }
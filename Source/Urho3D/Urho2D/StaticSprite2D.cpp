@@ -83,6 +83,7 @@ void StaticSprite2D::SetDrawRect(const Rect& rect)
     if(useDrawRect_)
     {
         sourceBatchesDirty_ = true;
+        MarkBoundingBoxDirty();
     }
 }
 
@@ -116,6 +117,7 @@ void StaticSprite2D::SetFlip(bool flipX, bool flipY, bool swapXY)
     flipY_ = flipY;
     swapXY_ = swapXY;
     sourceBatchesDirty_ = true;
+    MarkBoundingBoxDirty();
 
     MarkNetworkUpdate();
 }
@@ -261,11 +263,13 @@ void StaticSprite2D::OnWorldBoundingBoxUpdate()
     boundingBox_.Clear();
     worldBoundingBox_.Clear();
 
-    const Vector<SourceBatch2D>& sourceBatches = GetSourceBatches();
-    for (unsigned i = 0; i < sourceBatches[0].vertices_.size(); ++i)
-        worldBoundingBox_.Merge(sourceBatches[0].vertices_[i].position_);
+    // 包围盒由绘制矩形决定，不可见的精灵无需生成顶点
+    if (!sprite_)
+        return;
 
-    boundingBox_ = worldBoundingBox_.Transformed(node_->GetWorldTransform().Inverse());
+    boundingBox_.Merge(Vector3(drawRect_.min_, 0.0f));
+    boundingBox_.Merge(Vector3(drawRect_.max_, 0.0f));
+    worldBoundingBox_ = boundingBox_.Transformed(node_->GetWorldTransform());
 }
 
 void StaticSprite2D::OnDrawOrderChanged()
@@ -341,6 +345,9 @@ void StaticSprite2D::UpdateMaterial()
 
 void StaticSprite2D::UpdateDrawRect()
 {
+    // 绘制矩形决定包围盒，通知 Renderer2D 更新空间索引
+    MarkBoundingBoxDirty();
+
     if (!useDrawRect_)
     {
         if (useHotSpot_)
@@ -0,0 +1,230 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Material.h"
+#include "../Scene/Node.h"
+#include "../Urho2D/Sprite2D.h"
+#include "../Urho2D/TileMap2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
+#include "../Urho2D/TileMapLayer2D.h"
+#include "../Urho2D/TmxFile2D.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+TileMapChunk2D::TileMapChunk2D(Context* context) :
+    Drawable2D(context)
+{
+}
+
+TileMapChunk2D::~TileMapChunk2D() = default;
+
+void TileMapChunk2D::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TileMapChunk2D>();
+
+    URHO3D_COPY_BASE_ATTRIBUTES(Drawable2D);
+}
+
+void TileMapChunk2D::SetTileRange(TileMapLayer2D* tileMapLayer, const IntRect& tileRange)
+{
+    tileMapLayer_ = tileMapLayer;
+    tileRange_ = tileRange;
+
+    MarkTilesDirty();
+}
+
+void TileMapChunk2D::MarkTilesDirty()
+{
+    UpdateBatchLayout();
+
+    sourceBatchesDirty_ = true;
+    MarkBoundingBoxDirty();
+}
+
+TileMapLayer2D* TileMapChunk2D::GetTileMapLayer() const
+{
+    return tileMapLayer_;
+}
+
+void TileMapChunk2D::OnWorldBoundingBoxUpdate()
+{
+    // 局部包围盒在 UpdateBatchLayout() 中计算，不可见的分块无需生成顶点
+    if (boundingBox_.Defined())
+        worldBoundingBox_ = boundingBox_.Transformed(node_->GetWorldTransform());
+    else
+        worldBoundingBox_.Clear();
+}
+
+void TileMapChunk2D::OnDrawOrderChanged()
+{
+    UpdateBatchLayout();
+}
+
+void TileMapChunk2D::UpdateSourceBatches()
+{
+    if (!sourceBatchesDirty_)
+        return;
+
+    for (SourceBatch2D& batch : sourceBatches_)
+        batch.vertices_.Clear();
+
+    TileMapLayer2D* tileMapLayer = tileMapLayer_;
+    TileMap2D* tileMap = tileMapLayer ? tileMapLayer->GetTileMap() : nullptr;
+    if (!tileMap || !tileMapLayer->tileLayer_)
+    {
+        sourceBatchesDirty_ = false;
+        return;
+    }
+
+    const TileMapInfo2D& info = tileMap->GetInfo();
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+    const Vector<u32>& tileGids = tileMapLayer->GetTileGids();
+    int width = tileMapLayer->tileLayer_->GetWidth();
+    unsigned color = Color::WHITE.ToU32();
+
+    // 与 UpdateBatchLayout() 按相同顺序遍历，换行或材质变化时进入下一个批次
+    i32 batchIndex = -1;
+    for (int y = tileRange_.top_; y < tileRange_.bottom_; ++y)
+    {
+        unsigned materialIndex = M_MAX_UNSIGNED;
+        for (int x = tileRange_.left_; x < tileRange_.right_; ++x)
+        {
+            u32 gid = tileGids[y * width + x];
+            const TileRenderInfo2D* tile = GetDrawableTile(gid);
+            if (!tile)
+                continue;
+
+            if (tile->materialIndex_ != materialIndex)
+            {
+                materialIndex = tile->materialIndex_;
+                ++batchIndex;
+            }
+            if (batchIndex >= sourceBatches_.Size())
+                continue;
+
+            bool flipX = (gid & FLIP_HORIZONTAL) != 0;
+            bool flipY = (gid & FLIP_VERTICAL) != 0;
+            bool swapXY = (gid & FLIP_DIAGONAL) != 0;
+
+            Rect drawRect;
+            Rect textureRect;
+            if (!tile->sprite_->GetDrawRectangle(drawRect, flipX, flipY) ||
+                !tile->sprite_->GetTextureRectangle(textureRect, flipX, flipY))
+                continue;
+
+            Vector2 position = info.TileIndexToPosition(x, y);
+            drawRect.min_ += position;
+            drawRect.max_ += position;
+
+            /*
+            V1---------V2
+            |         / |
+            |       /   |
+            |     /     |
+            |   /       |
+            | /         |
+            V0---------V3
+            */
+            Vertex2D vertex0;
+            Vertex2D vertex1;
+            Vertex2D vertex2;
+            Vertex2D vertex3;
+
+            vertex0.position_ = worldTransform * Vector3(drawRect.min_.x_, drawRect.min_.y_, 0.0f);
+            vertex1.position_ = worldTransform * Vector3(drawRect.min_.x_, drawRect.max_.y_, 0.0f);
+            vertex2.position_ = worldTransform * Vector3(drawRect.max_.x_, drawRect.max_.y_, 0.0f);
+            vertex3.position_ = worldTransform * Vector3(drawRect.max_.x_, drawRect.min_.y_, 0.0f);
+
+            vertex0.uv_ = textureRect.min_;
+            (swapXY ? vertex3.uv_ : vertex1.uv_) = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+            vertex2.uv_ = textureRect.max_;
+            (swapXY ? vertex1.uv_ : vertex3.uv_) = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+
+            vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = color;
+
+            Vector<Vertex2D>& vertices = sourceBatches_[batchIndex].vertices_;
+            vertices.Push(vertex0);
+            vertices.Push(vertex1);
+            vertices.Push(vertex2);
+            vertices.Push(vertex3);
+        }
+    }
+
+    sourceBatchesDirty_ = false;
+}
+
+void TileMapChunk2D::UpdateBatchLayout()
+{
+    TileMapLayer2D* tileMapLayer = tileMapLayer_;
+    if (!tileMapLayer || !tileMapLayer->tileLayer_)
+        return;
+
+    // 行优先遍历，每行开头或纹理变化时开始新批次，使不同图块集的瓦片仍按逐瓦片的顺序绘制。
+    // 批次不跨行，因为相邻分块同一行的瓦片排序位于两行之间。
+    // 批次在主线程创建并设置材质，工作线程重建时无需创建批次或修改引用计数
+    const Vector<SharedPtr<Material>>& materials = tileMapLayer->tileMaterials_;
+    const Vector<u32>& tileGids = tileMapLayer->GetTileGids();
+    TileMap2D* tileMap = tileMapLayer->GetTileMap();
+    int width = tileMapLayer->tileLayer_->GetWidth();
+    int firstTile = tileRange_.top_ * width + tileRange_.left_;
+
+    boundingBox_.Clear();
+
+    i32 numBatches = 0;
+    for (int y = tileRange_.top_; y < tileRange_.bottom_; ++y)
+    {
+        unsigned materialIndex = M_MAX_UNSIGNED;
+        for (int x = tileRange_.left_; x < tileRange_.right_; ++x)
+        {
+            u32 gid = tileGids[y * width + x];
+            const TileRenderInfo2D* tile = GetDrawableTile(gid);
+            if (!tile)
+                continue;
+
+            Rect drawRect;
+            if (tileMap && tile->sprite_->GetDrawRectangle(drawRect, (gid & FLIP_HORIZONTAL) != 0, (gid & FLIP_VERTICAL) != 0))
+            {
+                Vector2 position = tileMap->GetInfo().TileIndexToPosition(x, y);
+                boundingBox_.Merge(Vector3(drawRect.min_ + position, 0.0f));
+                boundingBox_.Merge(Vector3(drawRect.max_ + position, 0.0f));
+            }
+
+            if (tile->materialIndex_ == materialIndex)
+                continue;
+
+            materialIndex = tile->materialIndex_;
+            if (numBatches == sourceBatches_.Size())
+            {
+                sourceBatches_.Push(SourceBatch2D());
+                sourceBatches_.Back().owner_ = this;
+            }
+
+            SourceBatch2D& batch = sourceBatches_[numBatches++];
+            batch.material_ = materials[materialIndex];
+            batch.drawOrder_ = GetDrawOrder() + y * width + x - firstTile;
+        }
+    }
+
+    sourceBatches_.Resize(numBatches);
+}
+
+const TileRenderInfo2D* TileMapChunk2D::GetDrawableTile(u32 gid) const
+{
+    if (!(gid & ~FLIP_ALL))
+        return nullptr;
+
+    TileMapLayer2D* tileMapLayer = tileMapLayer_;
+    const TileRenderInfo2D* tile = tileMapLayer->GetTileRenderInfo(gid & ~FLIP_ALL);
+    if (!tile || !tile->sprite_ || tile->materialIndex_ >= (unsigned)tileMapLayer->tileMaterials_.Size())
+        return nullptr;
+
+    return tile;
+}
+
+}
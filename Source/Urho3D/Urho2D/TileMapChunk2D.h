@@ -0,0 +1,60 @@
+// Copyright (c) 2008-2023 the Urho3D project
+// License: MIT
+
+#pragma once
+
+#include "../Urho2D/Drawable2D.h"
+
+namespace Urho3D
+{
+
+class TileMapLayer2D;
+struct TileRenderInfo2D;
+
+/// Drawable for a rectangular block of tiles of a tile map layer. Built and culled as a unit, instead of one drawable per tile.
+/// Tiles are drawn in row-major order. Each run of tiles with the same texture within a row is one source batch, whose draw order is the chunk's draw order plus the offset of its first tile from the chunk's first tile (y * width + x). Runs do not continue to the next row, as tiles of neighbouring chunks are ordered between the rows.
+class URHO3D_API TileMapChunk2D : public Drawable2D
+{
+    URHO3D_OBJECT(TileMapChunk2D, Drawable2D);
+
+public:
+    /// Construct.
+    explicit TileMapChunk2D(Context* context);
+    /// Destruct.
+    ~TileMapChunk2D() override;
+    /// Register object factory. Drawable2D must be registered first.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Set owner layer and tile range, right and bottom exclusive.
+    void SetTileRange(TileMapLayer2D* tileMapLayer, const IntRect& tileRange);
+    /// Mark tiles changed. The vertices are rebuilt when the chunk is next visible.
+    void MarkTilesDirty();
+
+    /// Return owner layer.
+    TileMapLayer2D* GetTileMapLayer() const;
+
+    /// Return tile range, right and bottom exclusive.
+    const IntRect& GetTileRange() const { return tileRange_; }
+
+protected:
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+    /// Handle draw order changed.
+    void OnDrawOrderChanged() override;
+    /// Update source batches. May be called from a worker thread.
+    void UpdateSourceBatches() override;
+
+private:
+    /// Split each row of tiles into runs of the same tile material, one source batch per run, and compute the local bounding box. Called from the main thread, so that worker threads only fill vertices.
+    void UpdateBatchLayout();
+    /// Return render info of a tile that can be drawn, or null for an empty cell or a tile without a sprite.
+    const TileRenderInfo2D* GetDrawableTile(u32 gid) const;
+
+    /// Owner layer.
+    WeakPtr<TileMapLayer2D> tileMapLayer_;
+    /// Tile range.
+    IntRect tileRange_;
+};
+
+}
@@ -140,7 +140,7 @@ public:
     const String& GetProperty(const String& name) const;
 
 private:
-    friend class TmxTileLayer2D;
+    friend class TmxFile2D;
 
     /// Gid.
     unsigned gid_;
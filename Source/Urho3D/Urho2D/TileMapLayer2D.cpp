@@ -5,10 +5,14 @@
 
 #include "../Core/Context.h"
 #include "../Graphics/DebugRenderer.h"
+#include "../Graphics/Material.h"
+#include "../GraphicsAPI/Texture2D.h"
 #include "../Resource/ResourceCache.h"
-#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+#include "../Urho2D/Renderer2D.h"
 #include "../Urho2D/StaticSprite2D.h"
 #include "../Urho2D/TileMap2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
 #include "../Urho2D/TileMapLayer2D.h"
 #include "../Urho2D/TmxFile2D.h"
 
@@ -165,6 +169,11 @@ void TileMapLayer2D::Initialize(TileMap2D* tileMap, const TmxLayer2D* tmxLayer)
     }
 
     tileLayer_ = nullptr;
+    tileGids_.Clear();
+    tileRenderInfos_.clear();
+    tileTextures_.Clear();
+    tileMaterials_.Clear();
+    chunks_.Clear();
     objectGroup_ = nullptr;
     imageLayer_ = nullptr;
 
@@ -202,6 +211,12 @@ void TileMapLayer2D::SetDrawOrder(int drawOrder)
 
     drawOrder_ = drawOrder;
 
+    for (const WeakPtr<TileMapChunk2D>& chunk : chunks_)
+    {
+        if (chunk)
+            chunk->SetLayer(drawOrder_);
+    }
+
     for (unsigned i = 0; i < nodes_.size(); ++i)
     {
         if (!nodes_[i])
@@ -227,6 +242,45 @@ void TileMapLayer2D::SetVisible(bool visible)
     }
 }
 
+void TileMapLayer2D::SetChunkSize(int chunkSize)
+{
+    chunkSize = Max(chunkSize, 1);
+    if (chunkSize == chunkSize_)
+        return;
+
+    chunkSize_ = chunkSize;
+
+    if (tileLayer_)
+        CreateChunks();
+}
+
+void TileMapLayer2D::SetTileGid(int x, int y, u32 gid)
+{
+    if (!tileLayer_)
+        return;
+
+    int width = tileLayer_->GetWidth();
+    if (x < 0 || x >= width || y < 0 || y >= tileLayer_->GetHeight())
+        return;
+
+    if (GetTileGids()[y * width + x] == gid)
+        return;
+
+    // 首次修改时才复制 tmx 层的 gid 数组，未修改的层与其共享
+    if (tileGids_.Empty())
+        tileGids_ = tileLayer_->GetTileGids();
+
+    tileGids_[y * width + x] = gid;
+    if (gid & ~FLIP_ALL)
+        AddTileRenderInfo(gid & ~FLIP_ALL);
+
+    // 只重建该瓦片所在的分块
+    int numChunksX = (width + chunkSize_ - 1) / chunkSize_;
+    i32 chunkIndex = (y / chunkSize_) * numChunksX + x / chunkSize_;
+    if (chunkIndex < chunks_.Size() && chunks_[chunkIndex])
+        chunks_[chunkIndex]->MarkTilesDirty();
+}
+
 TileMap2D* TileMapLayer2D::GetTileMap() const
 {
     return tileMap_;
@@ -267,18 +321,24 @@ Tile2D* TileMapLayer2D::GetTile(int x, int y) const
     if (!tileLayer_)
         return nullptr;
 
-    return tileLayer_->GetTile(x, y);
+    TmxFile2D* tmxFile = tileLayer_->GetTmxFile();
+    return tmxFile ? tmxFile->GetTile(GetTileGid(x, y)) : nullptr;
 }
 
-Node* TileMapLayer2D::GetTileNode(int x, int y) const
+u32 TileMapLayer2D::GetTileGid(int x, int y) const
 {
     if (!tileLayer_)
-        return nullptr;
+        return 0;
 
     if (x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
-        return nullptr;
+        return 0;
+
+    return GetTileGids()[y * tileLayer_->GetWidth() + x];
+}
 
-    return nodes_[y * tileLayer_->GetWidth() + x];
+TileMapChunk2D* TileMapLayer2D::GetChunk(unsigned index) const
+{
+    return index < (unsigned)chunks_.Size() ? chunks_[index].Get() : nullptr;
 }
 
 unsigned TileMapLayer2D::GetNumObjects() const
@@ -316,35 +376,118 @@ Node* TileMapLayer2D::GetImageNode() const
     return nodes_[0];
 }
 
+void TileMapLayer2D::OnSceneSet(Scene* scene)
+{
+    // Materials come from the scene's Renderer2D
+    if (scene && tileLayer_)
+        UpdateTileMaterials();
+}
+
 void TileMapLayer2D::SetTileLayer(const TmxTileLayer2D* tileLayer)
 {
     tileLayer_ = tileLayer;
+    tileGids_.Clear();
+
+    // 相邻瓦片多为同一 gid，跳过重复查找
+    u32 lastGid = 0;
+    for (u32 gid : tileLayer->GetTileGids())
+    {
+        gid &= ~FLIP_ALL;
+        if (gid && gid != lastGid)
+            AddTileRenderInfo(gid);
+        lastGid = gid;
+    }
+
+    UpdateTileMaterials();
+    CreateChunks();
+}
+
+void TileMapLayer2D::CreateChunks()
+{
+    // 瓦片层只有一个分块节点
+    for (i32 i = 0; i < nodes_.Size(); ++i)
+    {
+        if (nodes_[i])
+            nodes_[i]->Remove();
+    }
+    nodes_.Clear();
+    chunks_.Clear();
 
-    int width = tileLayer->GetWidth();
-    int height = tileLayer->GetHeight();
-    nodes_.resize((unsigned)(width * height));
+    int width = tileLayer_->GetWidth();
+    int height = tileLayer_->GetHeight();
+    int numChunksX = (width + chunkSize_ - 1) / chunkSize_;
+    int numChunksY = (height + chunkSize_ - 1) / chunkSize_;
 
-    const TileMapInfo2D& info = tileMap_->GetInfo();
-    for (int y = 0; y < height; ++y)
+    SharedPtr<Node> chunkNode(GetNode()->CreateTemporaryChild("TileChunks"));
+    for (int y = 0; y < numChunksY; ++y)
     {
-        for (int x = 0; x < width; ++x)
+        for (int x = 0; x < numChunksX; ++x)
         {
-            const Tile2D* tile = tileLayer->GetTile(x, y);
-            if (!tile)
-                continue;
+            IntRect tileRange(x * chunkSize_, y * chunkSize_, Min((x + 1) * chunkSize_, width),
+                Min((y + 1) * chunkSize_, height));
+
+            auto* chunk = chunkNode->CreateComponent<TileMapChunk2D>();
+            chunk->SetLayer(drawOrder_);
+            // 与逐瓦片精灵一致，分块的层内顺序取其首个瓦片的 y * width + x
+            chunk->SetOrderInLayer(tileRange.top_ * width + tileRange.left_);
+            chunk->SetTileRange(this, tileRange);
+            chunks_.Push(WeakPtr<TileMapChunk2D>(chunk));
+        }
+    }
+
+    chunkNode->SetEnabled(visible_);
+    nodes_.Push(chunkNode);
+}
 
-            SharedPtr<Node> tileNode(GetNode()->CreateTemporaryChild("Tile"));
-            tileNode->SetPosition(Vector3(info.TileIndexToPosition(x, y)));
+void TileMapLayer2D::AddTileRenderInfo(u32 gid)
+{
+    if (tileRenderInfos_.Contains(gid))
+        return;
 
-            auto* staticSprite = tileNode->CreateComponent<StaticSprite2D>();
-            staticSprite->SetSprite(tile->GetSprite());
-            staticSprite->SetFlip(tile->GetFlipX(), tile->GetFlipY(), tile->GetSwapXY());
-            staticSprite->SetLayer(drawOrder_);
-            staticSprite->SetOrderInLayer(y * width + x);
+    TileRenderInfo2D& info = tileRenderInfos_[gid];
+    info.sprite_ = tmxLayer_->GetTmxFile()->GetTileSprite(gid);
 
-            nodes_[y * width + x] = tileNode;
+    Texture2D* texture = info.sprite_ ? info.sprite_->GetTexture() : nullptr;
+    for (i32 i = 0; i < tileTextures_.Size(); ++i)
+    {
+        if (tileTextures_[i] == texture)
+        {
+            info.materialIndex_ = i;
+            return;
         }
     }
+
+    info.materialIndex_ = tileTextures_.Size();
+    tileTextures_.Push(SharedPtr<Texture2D>(texture));
+
+    Scene* scene = GetScene();
+    auto* renderer = scene ? scene->GetOrCreateComponent<Renderer2D>() : nullptr;
+    tileMaterials_.Push(SharedPtr<Material>(renderer ? renderer->GetMaterial(texture, BLEND_ALPHA) : nullptr));
+}
+
+const TileRenderInfo2D* TileMapLayer2D::GetTileRenderInfo(u32 gid) const
+{
+    auto i = tileRenderInfos_.find(gid);
+    return i != tileRenderInfos_.end() ? &i->second : nullptr;
+}
+
+const Vector<u32>& TileMapLayer2D::GetTileGids() const
+{
+    return tileGids_.Empty() ? tileLayer_->GetTileGids() : tileGids_;
+}
+
+void TileMapLayer2D::UpdateTileMaterials()
+{
+    Scene* scene = GetScene();
+    auto* renderer = scene ? scene->GetOrCreateComponent<Renderer2D>() : nullptr;
+    for (i32 i = 0; i < tileTextures_.Size(); ++i)
+        tileMaterials_[i] = renderer ? renderer->GetMaterial(tileTextures_[i], BLEND_ALPHA) : nullptr;
+
+    for (const WeakPtr<TileMapChunk2D>& chunk : chunks_)
+    {
+        if (chunk)
+            chunk->MarkTilesDirty();
+    }
 }
 
 void TileMapLayer2D::SetObjectGroup(const TmxObjectGroup2D* objectGroup)
@@ -14,13 +14,28 @@ namespace Urho3D
 {
 
 class DebugRenderer;
+class Material;
 class Node;
+class Texture2D;
 class TileMap2D;
+class TileMapChunk2D;
 class TmxImageLayer2D;
 class TmxLayer2D;
 class TmxObjectGroup2D;
 class TmxTileLayer2D;
 
+/// Default tile chunk size of tile layers, in tiles.
+static const int DEFAULT_TILE_CHUNK_SIZE = 16;
+
+/// Rendering data shared by all tiles with the same gid.
+struct TileRenderInfo2D
+{
+    /// Sprite.
+    SharedPtr<Sprite2D> sprite_;
+    /// Index to the layer's tile materials.
+    unsigned materialIndex_{};
+};
+
 /// Tile map component.
 class URHO3D_API TileMapLayer2D : public Component
 {
@@ -46,6 +61,11 @@ public:
     /// Set visible.
     /// @property
     void SetVisible(bool visible);
+    /// Set tile chunk size in tiles. Rebuilds the chunks of a tile layer.
+    /// @property
+    void SetChunkSize(int chunkSize);
+    /// Set tile gid including flip flags, or zero to clear the cell (for tile layer only). Rebuilds only the tile's chunk.
+    void SetTileGid(int x, int y, u32 gid);
 
     /// Return tile map.
     TileMap2D* GetTileMap() const;
@@ -61,6 +81,10 @@ public:
     /// @property
     bool IsVisible() const { return visible_; }
 
+    /// Return tile chunk size in tiles.
+    /// @property
+    int GetChunkSize() const { return chunkSize_; }
+
     /// Return has property.
     bool HasProperty(const String& name) const;
     /// Return property.
@@ -75,10 +99,15 @@ public:
     /// Return height (for tile layer only).
     /// @property
     int GetHeight() const;
-    /// Return tile node (for tile layer only).
-    Node* GetTileNode(int x, int y) const;
-    /// Return tile (for tile layer only).
+    /// Return tile (for tile layer only), shared by all cells with the same gid and flip bits.
     Tile2D* GetTile(int x, int y) const;
+    /// Return tile gid including flip flags, or zero if the cell is empty (for tile layer only).
+    u32 GetTileGid(int x, int y) const;
+    /// Return number of tile chunks (for tile layer only).
+    /// @property
+    unsigned GetNumChunks() const { return chunks_.Size(); }
+    /// Return tile chunk at index (for tile layer only).
+    TileMapChunk2D* GetChunk(unsigned index) const;
 
     /// Return number of tile map objects (for object group only).
     /// @property
@@ -92,9 +121,25 @@ public:
     /// @property
     Node* GetImageNode() const;
 
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
 private:
+    friend class TileMapChunk2D;
+
     /// Set tile layer.
     void SetTileLayer(const TmxTileLayer2D* tileLayer);
+    /// Create the tile chunk drawables.
+    void CreateChunks();
+    /// Register the sprite and material of a tile gid (flip flags excluded) if not registered yet.
+    void AddTileRenderInfo(u32 gid);
+    /// Return rendering data of a tile gid (flip flags excluded), or null if not registered.
+    const TileRenderInfo2D* GetTileRenderInfo(u32 gid) const;
+    /// Return tile gids including flip flags, row by row. Shared with the tmx layer until a tile is edited.
+    const Vector<u32>& GetTileGids() const;
+    /// Resolve tile materials from Renderer2D and pass them to the chunks.
+    void UpdateTileMaterials();
     /// Set object group.
     void SetObjectGroup(const TmxObjectGroup2D* objectGroup);
     /// Set image layer.
@@ -114,8 +159,20 @@ private:
     int drawOrder_{};
     /// Visible.
     bool visible_{true};
-    /// Tile node or image nodes.
+    /// Tile chunk size in tiles.
+    int chunkSize_{DEFAULT_TILE_CHUNK_SIZE};
+    /// Tile chunk node, object nodes or image node.
     Vector<SharedPtr<Node>> nodes_;
+    /// Edited tile gids including flip flags, row by row. Zero is an empty cell. Empty until the first SetTileGid(), which copies the tmx layer's gids.
+    Vector<u32> tileGids_;
+    /// Rendering data by tile gid (flip flags excluded).
+    HashMap<u32, TileRenderInfo2D> tileRenderInfos_;
+    /// Distinct tile textures.
+    Vector<SharedPtr<Texture2D>> tileTextures_;
+    /// Materials of the tile textures.
+    Vector<SharedPtr<Material>> tileMaterials_;
+    /// Tile chunk drawables, row by row.
+    Vector<WeakPtr<TileMapChunk2D>> chunks_;
 };
 
 }
@@ -6,14 +6,19 @@
 #include "../Core/Context.h"
 #include "../Graphics/Graphics.h"
 #include "../GraphicsAPI/Texture2D.h"
+#include "../IO/Compression.h"
+#include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../Math/AreaAllocator.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/XMLFile.h"
 #include "../Urho2D/Sprite2D.h"
 #include "../Urho2D/TmxFile2D.h"
 
+#include <PugiXml/pugixml.hpp>
+
 #include "../DebugNew.h"
 
 
@@ -71,9 +76,81 @@ enum LayerEncoding {
     XML,
     CSV,
     Base64,
+    Cooked,
+};
+
+enum LayerCompression {
+    NoCompression,
+    Zlib,
+    Gzip,
+    Zstd,
 };
 
-bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
+/// Return value of a base64 character, or -1 if the character is not part of the alphabet.
+static inline int Base64Value(char c)
+{
+    if (c >= 'A' && c <= 'Z')
+        return c - 'A';
+    if (c >= 'a' && c <= 'z')
+        return c - 'a' + 26;
+    if (c >= '0' && c <= '9')
+        return c - '0' + 52;
+    if (c == '+')
+        return 62;
+    if (c == '/')
+        return 63;
+    return -1;
+}
+
+/// Decode base64 text directly into a buffer, skipping whitespace. Return the number of bytes written.
+static unsigned DecodeBase64Text(const char* text, unsigned char* dest, unsigned destSize)
+{
+    unsigned written = 0;
+    u32 bits = 0;
+    unsigned numBits = 0;
+
+    for (const char* ptr = text; *ptr && *ptr != '=' && written < destSize; ++ptr)
+    {
+        int value = Base64Value(*ptr);
+        if (value < 0)
+            continue;
+
+        bits = (bits << 6u) | (u32)value;
+        numBits += 6;
+        if (numBits >= 8)
+        {
+            numBits -= 8;
+            dest[written++] = (unsigned char)(bits >> numBits);
+        }
+    }
+
+    return written;
+}
+
+/// Parse comma separated gids directly into a buffer. Return the number of gids parsed.
+static unsigned ParseCSVText(const char* text, u32* dest, unsigned destSize)
+{
+    unsigned parsed = 0;
+    const char* ptr = text;
+
+    while (parsed < destSize)
+    {
+        while (*ptr && (*ptr < '0' || *ptr > '9'))
+            ++ptr;
+        if (!*ptr)
+            break;
+
+        u32 gid = 0;
+        while (*ptr >= '0' && *ptr <= '9')
+            gid = gid * 10 + (u32)(*ptr++ - '0');
+
+        dest[parsed++] = gid;
+    }
+
+    return parsed;
+}
+
+bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info, Deserializer* cookedSource)
 {
     LoadInfo(element);
 
@@ -85,12 +162,6 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
     }
 
     LayerEncoding encoding;
-    if (dataElem.HasAttribute("compression"))
-    {
-        URHO3D_LOGERROR("Compression not supported now");
-        return false;
-    }
-
     if (dataElem.HasAttribute("encoding"))
     {
         String encodingAttribute = dataElem.GetAttribute("encoding");
@@ -100,6 +171,8 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
             encoding = CSV;
         else if (encodingAttribute == "base64")
             encoding = Base64;
+        else if (encodingAttribute == "cooked" && cookedSource)
+            encoding = Cooked;
         else
         {
             URHO3D_LOGERROR("Invalid encoding: " + encodingAttribute);
@@ -109,83 +182,92 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
     else
         encoding = XML;
 
-    tiles_.resize((unsigned)(width_ * height_));
+    LayerCompression compression = NoCompression;
+    if (dataElem.HasAttribute("compression"))
+    {
+        String compressionAttribute = dataElem.GetAttribute("compression");
+        if (compressionAttribute == "zlib")
+            compression = Zlib;
+        else if (compressionAttribute == "gzip")
+            compression = Gzip;
+        else if (compressionAttribute == "zstd")
+            compression = Zstd;
+        else
+        {
+            URHO3D_LOGERROR("Invalid compression: " + compressionAttribute);
+            return false;
+        }
+
+        if (encoding != Base64)
+        {
+            URHO3D_LOGERROR("Compression is only supported with base64 encoding");
+            return false;
+        }
+        if (compression == Zstd)
+        {
+            URHO3D_LOGERROR("Zstd compression is not supported, save the map with zlib or gzip compression instead");
+            return false;
+        }
+    }
+
+    // 只保存 gid（含翻转位），瓦片定义由 TmxFile2D 按 gid 共享
+    auto numTiles = (unsigned)(width_ * height_);
+    gids_.Resize(numTiles);
+    unsigned dataSize = numTiles * sizeof(u32);
+
+    // CSV 和 base64 直接从 XML 文本解析到 gid 数组，不产生中间字符串
+    const char* dataText = pugi::xml_node(dataElem.GetNode()).child_value();
+
     if (encoding == XML)
     {
         XMLElement tileElem = dataElem.GetChild("tile");
 
-        for (int y = 0; y < height_; ++y)
+        for (unsigned i = 0; i < numTiles; ++i)
         {
-            for (int x = 0; x < width_; ++x)
-            {
-                if (!tileElem)
-                    return false;
-
-                unsigned gid = tileElem.GetU32("gid");
-                if (gid > 0)
-                {
-                    SharedPtr<Tile2D> tile(new Tile2D());
-                    tile->gid_ = gid;
-                    tile->sprite_ = tmxFile_->GetTileSprite(gid & ~FLIP_ALL);
-                    tile->propertySet_ = tmxFile_->GetTilePropertySet(gid & ~FLIP_ALL);
-                    tiles_[y * width_ + x] = tile;
-                }
+            if (!tileElem)
+                return false;
 
-                tileElem = tileElem.GetNext("tile");
-            }
+            gids_[i] = tileElem.GetU32("gid");
+            tileElem = tileElem.GetNext("tile");
         }
     }
     else if (encoding == CSV)
     {
-        String dataValue = dataElem.GetValue();
-        Vector<String> gidVector = dataValue.Split(',');
-        int currentIndex = 0;
-        for (int y = 0; y < height_; ++y)
+        if (ParseCSVText(dataText, gids_.Buffer(), numTiles) != numTiles)
         {
-            for (int x = 0; x < width_; ++x)
-            {
-                gidVector[currentIndex].Replace("\n", "");
-                unsigned gid = ToU32(gidVector[currentIndex]);
-                if (gid > 0)
-                {
-                    SharedPtr<Tile2D> tile(new Tile2D());
-                    tile->gid_ = gid;
-                    tile->sprite_ = tmxFile_->GetTileSprite(gid & ~FLIP_ALL);
-                    tile->propertySet_ = tmxFile_->GetTilePropertySet(gid & ~FLIP_ALL);
-                    tiles_[y * width_ + x] = tile;
-                }
-                ++currentIndex;
-            }
+            URHO3D_LOGERROR("Not enough tiles in CSV layer data");
+            return false;
         }
     }
     else if (encoding == Base64)
     {
-        String dataValue = dataElem.GetValue();
-        int startPosition = 0;
-        while (!IsAlpha(dataValue[startPosition]) && !IsDigit(dataValue[startPosition])
-              && dataValue[startPosition] != '+' && dataValue[startPosition] != '/') ++startPosition;
-        dataValue = dataValue.Substring(startPosition);
-        Vector<unsigned char> buffer = DecodeBase64(dataValue);
-        int currentIndex = 0;
-        for (int y = 0; y < height_; ++y)
+        // Gids are 32-bit little-endian integers, the same as the in-memory layout
+        unsigned written;
+        if (compression == NoCompression)
+            written = DecodeBase64Text(dataText, (unsigned char*)gids_.Buffer(), dataSize);
+        else
         {
-            for (int x = 0; x < width_; ++x)
-            {
-                // buffer contains 32-bit integers in little-endian format
-                unsigned gid = ((unsigned)buffer[currentIndex+3] << 24u)
-                             | ((unsigned)buffer[currentIndex+2] << 16u)
-                             | ((unsigned)buffer[currentIndex+1] << 8u)
-                             | (unsigned)buffer[currentIndex];
-                if (gid > 0)
-                {
-                    SharedPtr<Tile2D> tile(new Tile2D());
-                    tile->gid_ = gid;
-                    tile->sprite_ = tmxFile_->GetTileSprite(gid & ~FLIP_ALL);
-                    tile->propertySet_ = tmxFile_->GetTilePropertySet(gid & ~FLIP_ALL);
-                    tiles_[y * width_ + x] = tile;
-                }
-                currentIndex += 4;
-            }
+            // Base64 yields 3 bytes for every 4 characters
+            Vector<unsigned char> compressed((unsigned)(strlen(dataText) / 4 * 3 + 3));
+            unsigned compressedSize = DecodeBase64Text(dataText, compressed.Buffer(), compressed.Size());
+            if (compression == Zlib)
+                written = DecompressZlib(gids_.Buffer(), dataSize, compressed.Buffer(), compressedSize);
+            else
+                written = DecompressGzip(gids_.Buffer(), dataSize, compressed.Buffer(), compressedSize);
+        }
+
+        if (written != dataSize)
+        {
+            URHO3D_LOGERROR("Invalid base64 layer data");
+            return false;
+        }
+    }
+    else if (encoding == Cooked)
+    {
+        if (cookedSource->ReadU32() != numTiles || (unsigned)cookedSource->Read(gids_.Buffer(), dataSize) != dataSize)
+        {
+            URHO3D_LOGERROR("Invalid cooked layer data");
+            return false;
         }
     }
 
@@ -197,10 +279,18 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
 
 Tile2D* TmxTileLayer2D::GetTile(int x, int y) const
 {
-    if (x < 0 || x >= width_ || y < 0 || y >= height_)
+    if (x < 0 || x >= width_ || y < 0 || y >= height_ || !tmxFile_)
         return nullptr;
 
-    return tiles_[y * width_ + x];
+    return tmxFile_->GetTile(gids_[y * width_ + x]);
+}
+
+u32 TmxTileLayer2D::GetTileGid(int x, int y) const
+{
+    if (x < 0 || x >= width_ || y < 0 || y >= height_)
+        return 0;
+
+    return gids_[y * width_ + x];
 }
 
 TmxObjectGroup2D::TmxObjectGroup2D(TmxFile2D* tmxFile) :
@@ -375,7 +465,41 @@ bool TmxFile2D::BeginLoad(Deserializer& source)
         SetName(source.GetName());
 
     loadXMLFile_ = new XMLFile(context_);
-    if (!loadXMLFile_->Load(source))
+    loadCookedData_.Reset();
+    loadCookedDataSize_ = 0;
+    loadCookedDataOffset_ = 0;
+
+    if (source.ReadFileID() == "UTMX")
+    {
+        // 预处理过的二进制格式：一次读入全部数据，瓦片层数据在 EndLoad() 中直接复制
+        auto dataSize = (unsigned)(source.GetSize() - source.GetPosition());
+        loadCookedData_ = new unsigned char[dataSize];
+        if ((unsigned)source.Read(loadCookedData_.Get(), dataSize) != dataSize || dataSize < sizeof(u32))
+        {
+            URHO3D_LOGERROR("Load cooked tile map failed " + source.GetName());
+            loadXMLFile_.Reset();
+            loadCookedData_.Reset();
+            return false;
+        }
+
+        u32 xmlSize;
+        memcpy(&xmlSize, loadCookedData_.Get(), sizeof(u32));
+        if (xmlSize > dataSize - sizeof(u32))
+            xmlSize = 0;
+
+        MemoryBuffer xmlSource(loadCookedData_.Get() + sizeof(u32), xmlSize);
+        if (!xmlSize || !loadXMLFile_->Load(xmlSource))
+        {
+            URHO3D_LOGERROR("Load XML failed " + source.GetName());
+            loadXMLFile_.Reset();
+            loadCookedData_.Reset();
+            return false;
+        }
+
+        loadCookedDataSize_ = dataSize;
+        loadCookedDataOffset_ = sizeof(u32) + xmlSize;
+    }
+    else if (source.Seek(0) != 0 || !loadXMLFile_->Load(source))
     {
         URHO3D_LOGERROR("Load XML failed " + source.GetName());
         loadXMLFile_.Reset();
@@ -463,6 +587,11 @@ bool TmxFile2D::EndLoad()
     for (const TmxLayer2D* layer : layers_)
         delete layer;
     layers_.clear();
+    gidToTileMapping_.clear();
+
+    // Tile layer data of the cooked format, in document order
+    MemoryBuffer cookedSource(loadCookedData_.Get() + loadCookedDataOffset_, loadCookedData_ ?
+        loadCookedDataSize_ - loadCookedDataOffset_ : 0);
 
     for (XMLElement childElement = rootElem.GetChild(); childElement; childElement = childElement.GetNext())
     {
@@ -473,7 +602,7 @@ bool TmxFile2D::EndLoad()
         else if (name == "layer")
         {
             auto* tileLayer = new TmxTileLayer2D(this);
-            ret = tileLayer->Load(childElement, info_);
+            ret = tileLayer->Load(childElement, info_, loadCookedData_ ? &cookedSource : nullptr);
 
             layers_.push_back(tileLayer);
         }
@@ -496,16 +625,77 @@ bool TmxFile2D::EndLoad()
         if (!ret)
         {
             loadXMLFile_.Reset();
+            loadCookedData_.Reset();
             tsxXMLFiles_.clear();
             return false;
         }
     }
 
     loadXMLFile_.Reset();
+    loadCookedData_.Reset();
     tsxXMLFiles_.clear();
     return true;
 }
 
+bool TmxFile2D::Save(Serializer& dest) const
+{
+    // 重新读取源文件中的地图 XML，瓦片层数据改为当前的 gid 数组
+    SharedPtr<File> file = GetSubsystem<ResourceCache>()->GetFile(GetName());
+    if (!file)
+        return false;
+
+    SharedPtr<XMLFile> xmlFile(new XMLFile(context_));
+    if (file->ReadFileID() == "UTMX")
+    {
+        unsigned xmlSize = file->ReadU32();
+        SharedArrayPtr<unsigned char> xmlData(new unsigned char[xmlSize]);
+        if ((unsigned)file->Read(xmlData.Get(), xmlSize) != xmlSize)
+            return false;
+
+        MemoryBuffer xmlSource(xmlData.Get(), xmlSize);
+        if (!xmlFile->Load(xmlSource))
+            return false;
+    }
+    else if (file->Seek(0) != 0 || !xmlFile->Load(*file))
+        return false;
+
+    Vector<const TmxTileLayer2D*> tileLayers;
+    for (const TmxLayer2D* layer : layers_)
+    {
+        if (layer->GetType() == LT_TILE_LAYER)
+            tileLayers.Push(static_cast<const TmxTileLayer2D*>(layer));
+    }
+
+    i32 numLayerElems = 0;
+    XMLElement rootElem = xmlFile->GetRoot("map");
+    for (XMLElement layerElem = rootElem.GetChild("layer"); layerElem; layerElem = layerElem.GetNext("layer"))
+    {
+        layerElem.RemoveChild("data");
+        layerElem.CreateChild("data").SetAttribute("encoding", "cooked");
+        ++numLayerElems;
+    }
+
+    if (numLayerElems != tileLayers.Size())
+    {
+        URHO3D_LOGERROR("Tile layers do not match the source file " + GetName());
+        return false;
+    }
+
+    String xml = xmlFile->ToString(String::EMPTY);
+    dest.WriteFileID("UTMX");
+    dest.WriteU32(xml.Length());
+    dest.Write(xml.CString(), xml.Length());
+
+    for (const TmxTileLayer2D* tileLayer : tileLayers)
+    {
+        const Vector<u32>& gids = tileLayer->GetTileGids();
+        dest.WriteU32(gids.Size());
+        dest.Write(gids.Buffer(), gids.Size() * sizeof(u32));
+    }
+
+    return true;
+}
+
 bool TmxFile2D::SetInfo(Orientation2D orientation, int width, int height, float tileWidth, float tileHeight)
 {
     if (layers_.size() > 0)
@@ -558,6 +748,24 @@ PropertySet2D* TmxFile2D::GetTilePropertySet(unsigned gid) const
     return i->second;
 }
 
+Tile2D* TmxFile2D::GetTile(u32 gid) const
+{
+    if (!(gid & ~FLIP_ALL))
+        return nullptr;
+
+    // 每种 gid（含翻转位）只创建一个共享的瓦片对象，首次访问时创建
+    auto i = gidToTileMapping_.find(gid);
+    if (i != gidToTileMapping_.end())
+        return i->second;
+
+    SharedPtr<Tile2D> tile(new Tile2D());
+    tile->gid_ = gid;
+    tile->sprite_ = GetTileSprite(gid & ~FLIP_ALL);
+    tile->propertySet_ = GetTilePropertySet(gid & ~FLIP_ALL);
+    gidToTileMapping_[gid] = tile;
+    return tile;
+}
+
 const TmxLayer2D* TmxFile2D::GetLayer(unsigned index) const
 {
     if (index >= layers_.size())
@@ -3,12 +3,14 @@
 
 #pragma once
 
+#include "../Container/ArrayPtr.h"
 #include "../Resource/Resource.h"
 #include "../Urho2D/TileMapDefs2D.h"
 
 namespace Urho3D
 {
 
+class Deserializer;
 class Sprite2D;
 class Texture2D;
 class TmxFile2D;
@@ -74,14 +76,19 @@ class TmxTileLayer2D : public TmxLayer2D
 public:
     explicit TmxTileLayer2D(TmxFile2D* tmxFile);
 
-    /// Load from XML element.
-    bool Load(const XMLElement& element, const TileMapInfo2D& info);
-    /// Return tile.
+    /// Load from XML element. Cooked tile data is read from the given source.
+    bool Load(const XMLElement& element, const TileMapInfo2D& info, Deserializer* cookedSource = nullptr);
+    /// Return tile, shared by all cells with the same gid and flip bits. Null if the cell is empty.
     Tile2D* GetTile(int x, int y) const;
+    /// Return tile gid including flip bits, 0 if the cell is empty.
+    u32 GetTileGid(int x, int y) const;
+
+    /// Return tile gids including flip bits, in row-major order.
+    const Vector<u32>& GetTileGids() const { return gids_; }
 
 protected:
-    /// Tiles.
-    Vector<SharedPtr<Tile2D>> tiles_;
+    /// Tile gids including flip bits, in row-major order.
+    Vector<u32> gids_;
 };
 
 /// Tmx objects layer.
@@ -152,6 +159,8 @@ public:
     bool BeginLoad(Deserializer& source) override;
     /// Finish resource loading. Always called from the main thread. Return true if successful.
     bool EndLoad() override;
+    /// Save in the cooked binary format: the map XML without tile data, followed by the raw gid arrays of the tile layers. Loads without parsing tile data. Tile set paths stay relative, so save next to the source file.
+    bool Save(Serializer& dest) const override;
 
     /// Set Tilemap information.
     bool SetInfo(Orientation2D orientation, int width, int height, float tileWidth, float tileHeight);
@@ -174,6 +183,9 @@ public:
     /// Return tile property set by gid, if not exist return 0.
     PropertySet2D* GetTilePropertySet(unsigned gid) const;
 
+    /// Return shared tile for a gid including flip bits, if gid is 0 return null.
+    Tile2D* GetTile(u32 gid) const;
+
     /// Return number of layers.
     unsigned GetNumLayers() const { return layers_.Size(); }
 
@@ -196,6 +208,12 @@ private:
 
     /// XML file used during loading.
     SharedPtr<XMLFile> loadXMLFile_;
+    /// Cooked file data used during loading.
+    SharedArrayPtr<unsigned char> loadCookedData_;
+    /// Cooked file data size.
+    unsigned loadCookedDataSize_{};
+    /// Offset of the tile layer data in the cooked file data.
+    unsigned loadCookedDataOffset_{};
     /// TSX name to XML file mapping.
     HashMap<String, SharedPtr<XMLFile>> tsxXMLFiles_;
     /// Tile map information.
@@ -206,6 +224,8 @@ private:
     HashMap<unsigned, SharedPtr<PropertySet2D>> gidToPropertySetMapping_;
     /// Gid to tile collision shape mapping.
     HashMap<unsigned, Vector<SharedPtr<TileMapObject2D>>> gidToCollisionShapeMapping_;
+    /// Gid including flip bits to shared tile mapping, filled on demand.
+    mutable HashMap<u32, SharedPtr<Tile2D>> gidToTileMapping_;
     /// Layers.
     Vector<TmxLayer2D*> layers_;
     /// Texture edge offset.
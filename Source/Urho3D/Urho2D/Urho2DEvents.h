@@ -8,6 +8,9 @@
 namespace Urho3D
 {
 
+class Node;
+class ParticleEffect2D;
+
 /// Emitting ParticleEmitter2D particles stopped.
 URHO3D_EVENT(E_PARTICLESEND, ParticlesEnd)
 {
@@ -22,4 +25,18 @@ URHO3D_EVENT(E_PARTICLESDURATION, ParticlesDuration)
     URHO3D_PARAM(P_EFFECT, Effect);                // ParticleEffect2D pointer
 }
 
+/// Typed payload of E_PARTICLESEND and E_PARTICLESDURATION for Object::SendTypedEvent().
+struct URHO3D_API Particles2DPayload
+{
+    /// Fill event data.
+    void ToVariantMap(VariantMap& eventData) const;
+    /// Read from event data.
+    void FromVariantMap(const VariantMap& eventData);
+
+    /// Emitter node.
+    Node* node_{};
+    /// Particle effect.
+    ParticleEffect2D* effect_{};
+};
+
 }